@@ -19,7 +19,20 @@
 
 #pragma once
 
+#include "mdl/Brush.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/WorldNode.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
 #include <chrono>
+#include <cmath>
+#include <memory>
 #include <string>
 
 #ifdef __GNUC__
@@ -41,3 +54,35 @@ TB_NOINLINE static void timeLambda(L&& lambda, const std::string& message)
     message.c_str(),
     std::chrono::duration<double>(end - start).count() * 1000.0);
 }
+
+namespace tb::mdl
+{
+
+/**
+ * Creates a world with the given number of brushes in its default layer. The brushes are
+ * laid out in a cubic grid with a spacing of 64 units, starting at -2048 on every axis.
+ * Each brush is created by calling createBrush with its index and its 48 unit cube
+ * bounds.
+ */
+template <typename F>
+std::unique_ptr<WorldNode> makeGridWorld(
+  const MapFormat mapFormat, const size_t brushCount, const F& createBrush)
+{
+  auto world = std::make_unique<WorldNode>(EntityPropertyConfig{}, Entity{}, mapFormat);
+
+  const auto gridSize = size_t(std::ceil(std::cbrt(double(brushCount))));
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    const auto x = double(i % gridSize);
+    const auto y = double((i / gridSize) % gridSize);
+    const auto z = double(i / (gridSize * gridSize));
+    const auto min = vm::vec3d{x, y, z} * 64.0 - vm::vec3d{2048, 2048, 2048};
+    const auto bounds = vm::bbox3d{min, min + vm::vec3d{48, 48, 48}};
+
+    world->defaultLayer()->addChild(new BrushNode{createBrush(i, bounds)});
+  }
+
+  return world;
+}
+
+} // namespace tb::mdl
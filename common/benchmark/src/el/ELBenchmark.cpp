@@ -0,0 +1,116 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "el/EvaluationContext.h"
+#include "el/Expression.h"
+#include "el/Value.h"
+#include "el/VariableStore.h"
+#include "io/ELParser.h"
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+thread_local auto allocationCount = std::size_t(0);
+} // namespace
+
+// Count the allocations made by the current thread. This file is built into its own
+// executable because these replace the global operators.
+void* operator new(const std::size_t size)
+{
+  ++allocationCount;
+  if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace tb::el
+{
+namespace
+{
+
+constexpr size_t NumEvaluations = 100'000;
+
+} // namespace
+
+TEST_CASE("ELBenchmark.evaluate")
+{
+  using T = std::tuple<std::string, std::string>;
+
+  // clang-format off
+  const auto
+  [name,         expression] = GENERATE(values<T>({
+  {"arithmetic", R"((x + 1) * 2 - y / 4 % 3)"},
+  {"comparison", R"(x < y && y >= 2 || !(x == 3))"},
+  {"switch",     R"({{ x == 1 -> "a", x == 2 -> "b", x > y -> "c", "d" }})"},
+  {"string",     R"(s + "/" + s == "a/a")"},
+  {"array",      R"([x, y, x + y][1..2])"},
+  }));
+  // clang-format on
+
+  const auto parsedExpression = io::ELParser::parseStrict(expression).value();
+  const auto variables = VariableTable{{
+    {"x", Value{3.0}},
+    {"y", Value{7.0}},
+    {"s", Value{"a"}},
+  }};
+
+  auto count = size_t(0);
+  const auto allocationsBefore = allocationCount;
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumEvaluations; ++i)
+      {
+        const auto result = withEvaluationContext(
+          [&](auto& context) { return parsedExpression.evaluate(context); }, variables);
+        count += result.is_success() ? 1u : 0u;
+      }
+    },
+    fmt::format("evaluate {} expression {} times", name, NumEvaluations));
+  const auto allocations = allocationCount - allocationsBefore;
+
+  printf(
+    "Allocations per evaluation of %s expression: %f\n",
+    name.c_str(),
+    double(allocations) / double(NumEvaluations));
+
+  CHECK(count == NumEvaluations);
+}
+
+} // namespace tb::el
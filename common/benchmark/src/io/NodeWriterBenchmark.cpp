@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "io/NodeWriter.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/MapFormat.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include "vm/mat_ext.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr size_t NumBrushes = 50'000;
+constexpr size_t NumRuns = 5;
+
+/**
+ * Creates a world with a grid of brushes. If rotate is true, the brushes are rotated
+ * with material lock enabled, which yields arbitrary plane points and UV attributes
+ * instead of small integers.
+ */
+auto makeWorld(const mdl::MapFormat mapFormat, const bool rotate)
+{
+  const auto worldBounds = vm::bbox3d{32768.0};
+  const auto builder = mdl::BrushBuilder{mapFormat, worldBounds};
+
+  return mdl::makeGridWorld(
+    mapFormat, NumBrushes, [&](const size_t i, const vm::bbox3d& bounds) {
+      auto brush = builder.createCuboid(bounds, "material") | kdl::value();
+
+      if (rotate)
+      {
+        const auto center = brush.bounds().center();
+        const auto transform = vm::translation_matrix(center)
+                               * vm::rotation_matrix(
+                                 vm::to_radians(double(i % 90)),
+                                 vm::to_radians(15.0),
+                                 vm::to_radians(double(i % 45)))
+                               * vm::translation_matrix(-center);
+        REQUIRE(brush.transform(worldBounds, transform, true).is_success());
+      }
+
+      return brush;
+    });
+}
+
+void benchmarkSave(
+  const mdl::WorldNode& world, kdl::task_manager& taskManager, const std::string& name)
+{
+  auto bestTime = std::chrono::duration<double>::max();
+  auto bytes = size_t(0);
+
+  for (size_t i = 0; i < NumRuns; ++i)
+  {
+    auto stream = std::stringstream{};
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    auto writer = NodeWriter{world, stream};
+    writer.writeMap(taskManager);
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    bestTime = std::min(bestTime, std::chrono::duration<double>(end - start));
+    bytes = stream.str().size();
+  }
+
+  const auto seconds = bestTime.count();
+  printf(
+    "Save '%s': %.2fms, %.1f MB/s, %.0f brushes/s\n",
+    name.c_str(),
+    seconds * 1000.0,
+    double(bytes) / (1024.0 * 1024.0) / seconds,
+    double(NumBrushes) / seconds);
+}
+
+} // namespace
+
+TEST_CASE("NodeWriterBenchmark.saveThroughput")
+{
+  auto singleThreaded = kdl::task_manager{1};
+  auto multiThreaded = kdl::task_manager{};
+  const auto threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+  using T = std::tuple<mdl::MapFormat, bool, std::string>;
+  const auto [mapFormat, rotate, name] = GENERATE(values<T>({
+    {mdl::MapFormat::Standard, false, "Standard, axis aligned"},
+    {mdl::MapFormat::Standard, true, "Standard, rotated"},
+    {mdl::MapFormat::Valve, true, "Valve, rotated"},
+  }));
+
+  const auto world = makeWorld(mapFormat, rotate);
+
+  benchmarkSave(
+    *world, singleThreaded, fmt::format("{} brushes, {}, 1 thread", NumBrushes, name));
+  benchmarkSave(
+    *world,
+    multiThreaded,
+    fmt::format("{} brushes, {}, {} threads", NumBrushes, name, threadCount));
+}
+
+} // namespace tb::io
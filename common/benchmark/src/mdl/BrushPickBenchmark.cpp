@@ -0,0 +1,200 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushFacePlanes.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EditorContext.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/PickResult.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto PickWorldBounds = vm::bbox3d{65536.0};
+constexpr auto PickRayCount = size_t(10000);
+
+Brush makeIcoSphereBrush(const vm::vec3d& center)
+{
+  const auto brushBuilder = BrushBuilder{MapFormat::Valve, PickWorldBounds};
+  const auto halfSize = vm::vec3d{12, 12, 12};
+  const auto bounds = vm::bbox3d{center - halfSize, center + halfSize};
+  return brushBuilder.createIcoSphere(bounds, 1, "material") | kdl::value();
+}
+
+std::vector<Brush> makeBrushGrid(const size_t gridSize)
+{
+  auto brushes = std::vector<Brush>{};
+  for (size_t x = 0; x < gridSize; ++x)
+  {
+    for (size_t y = 0; y < gridSize; ++y)
+    {
+      brushes.push_back(
+        makeIcoSphereBrush(vm::vec3d{double(x) * 32.0, double(y) * 32.0, 0.0}));
+    }
+  }
+  return brushes;
+}
+
+/**
+ * Returns rays from above a grid of the given size towards random points in it, like a
+ * camera looking down at the grid.
+ */
+std::vector<vm::ray3d> makeRays(const size_t gridSize)
+{
+  const auto extent = double(gridSize) * 32.0;
+
+  auto engine = std::mt19937{};
+  auto coordinate = std::uniform_real_distribution<double>{0.0, extent};
+
+  auto rays = std::vector<vm::ray3d>{};
+  rays.reserve(PickRayCount);
+  for (size_t i = 0; i < PickRayCount; ++i)
+  {
+    const auto origin = vm::vec3d{coordinate(engine), coordinate(engine), 512.0};
+    const auto target = vm::vec3d{coordinate(engine), coordinate(engine), 0.0};
+    rays.emplace_back(origin, vm::normalize(target - origin));
+  }
+  return rays;
+}
+
+template <typename L>
+void timeRayPicks(L&& lambda, const size_t pickCount, const std::string& message)
+{
+  const auto start = std::chrono::steady_clock::now();
+  lambda();
+  const auto end = std::chrono::steady_clock::now();
+
+  const auto seconds = std::chrono::duration<double>(end - start).count();
+  printf(
+    "Ray picks per second for '%s': %.0f (%fms)\n",
+    message.c_str(),
+    double(pickCount) / seconds,
+    seconds * 1000.0);
+}
+
+} // namespace
+
+TEST_CASE("BrushPickBenchmark.intersectWithRay")
+{
+  const auto gridSize = size_t(8);
+  const auto brushes = makeBrushGrid(gridSize);
+  const auto facePlanes = kdl::vec_transform(
+    brushes, [](const auto& brush) { return BrushFacePlanes{brush}; });
+  const auto rays = makeRays(gridSize);
+  const auto pickCount = rays.size() * brushes.size();
+
+  auto faceHits = size_t(0);
+  timeRayPicks(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        for (const auto& brush : brushes)
+        {
+          for (const auto& face : brush.faces())
+          {
+            if (face.intersectWithRay(ray))
+            {
+              ++faceHits;
+              break;
+            }
+          }
+        }
+      }
+    },
+    pickCount,
+    fmt::format("faces of {} brushes", brushes.size()));
+
+  auto planeHits = size_t(0);
+  timeRayPicks(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        for (const auto& planes : facePlanes)
+        {
+          if (planes.intersectWithRay(ray))
+          {
+            ++planeHits;
+          }
+        }
+      }
+    },
+    pickCount,
+    fmt::format("face planes of {} brushes", brushes.size()));
+
+  CHECK(faceHits > 0u);
+  CHECK(planeHits > 0u);
+}
+
+TEST_CASE("BrushPickBenchmark.pick")
+{
+  const auto gridSize = GENERATE(values<size_t>({32, 128}));
+
+  auto worldNode =
+    std::make_unique<WorldNode>(EntityPropertyConfig{}, Entity{}, MapFormat::Valve);
+  for (auto& brush : makeBrushGrid(gridSize))
+  {
+    worldNode->defaultLayer()->addChild(new BrushNode{std::move(brush)});
+  }
+
+  const auto editorContext = EditorContext{};
+  const auto rays = makeRays(gridSize);
+
+  auto hitCount = size_t(0);
+  timeRayPicks(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        auto pickResult = PickResult{};
+        worldNode->pick(editorContext, ray, pickResult);
+        hitCount += pickResult.size();
+      }
+    },
+    rays.size(),
+    fmt::format("world with {} brushes", gridSize * gridSize));
+
+  CHECK(hitCount > 0u);
+}
+
+} // namespace tb::mdl
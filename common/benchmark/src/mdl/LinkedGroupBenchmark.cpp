@@ -0,0 +1,180 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/Group.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/LinkedGroupUtils.h"
+#include "mdl/MapFormat.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include "vm/bbox.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+
+#include <fmt/format.h>
+
+#include <memory>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto PrefabSize = size_t(8);
+constexpr auto WorldBounds = vm::bbox3d{65536.0};
+
+void translateNode(Node& node, const vm::vec3d& offset)
+{
+  const auto transformation = vm::translation_matrix(offset);
+  node.accept(kdl::overload(
+    [](const WorldNode*) {},
+    [](const LayerNode*) {},
+    [&](auto&& thisLambda, GroupNode* groupNode) {
+      auto group = groupNode->group();
+      group.transform(transformation);
+      groupNode->setGroup(std::move(group));
+
+      groupNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, EntityNode* entityNode) {
+      auto entity = entityNode->entity();
+      entity.transform(transformation, false);
+      entityNode->setEntity(std::move(entity));
+
+      entityNode->visitChildren(thisLambda);
+    },
+    [&](BrushNode* brushNode) {
+      auto brush = brushNode->brush();
+      if (brush.transform(WorldBounds, transformation, false).is_success())
+      {
+        brushNode->setBrush(std::move(brush));
+      }
+    },
+    [&](PatchNode* patchNode) {
+      auto patch = patchNode->patch();
+      patch.transform(transformation);
+      patchNode->setPatch(std::move(patch));
+    }));
+}
+
+std::unique_ptr<GroupNode> makePrefab()
+{
+  const auto brushBuilder = BrushBuilder{MapFormat::Valve, WorldBounds};
+
+  auto groupNode = std::make_unique<GroupNode>(Group{"prefab"});
+  for (size_t x = 0; x < PrefabSize; ++x)
+  {
+    for (size_t y = 0; y < PrefabSize; ++y)
+    {
+      auto* brushNode =
+        new BrushNode{brushBuilder.createCube(16.0, "material") | kdl::value()};
+      translateNode(*brushNode, vm::vec3d{double(x) * 32.0, double(y) * 32.0, 0.0});
+      groupNode->addChild(brushNode);
+    }
+    groupNode->addChild(new EntityNode{Entity{{
+      {"classname", "light"},
+      {"origin", fmt::format("{} 0 32", double(x) * 32.0)},
+    }}});
+  }
+  return groupNode;
+}
+
+std::vector<std::unique_ptr<GroupNode>> makeTargets(
+  const GroupNode& sourceGroupNode, const size_t count)
+{
+  auto result = std::vector<std::unique_ptr<GroupNode>>{};
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto& targetGroupNode = result.emplace_back(
+      static_cast<GroupNode*>(sourceGroupNode.cloneRecursively(WorldBounds)));
+    translateNode(*targetGroupNode, vm::vec3d{0.0, 0.0, double(i + 1) * 64.0});
+  }
+  return result;
+}
+
+size_t propagate(
+  const GroupNode& sourceGroupNode,
+  const std::vector<std::unique_ptr<GroupNode>>& targetGroupNodes,
+  kdl::task_manager& taskManager)
+{
+  auto targetGroupNodePtrs = std::vector<GroupNode*>{};
+  targetGroupNodePtrs.reserve(targetGroupNodes.size());
+  for (const auto& targetGroupNode : targetGroupNodes)
+  {
+    targetGroupNodePtrs.push_back(targetGroupNode.get());
+  }
+
+  auto result =
+    updateLinkedGroups(sourceGroupNode, targetGroupNodePtrs, WorldBounds, taskManager)
+    | kdl::value();
+
+  const auto count = result.size();
+  for (auto& [targetNode, newChildren] : result)
+  {
+    targetNode->replaceChildren(std::move(newChildren));
+  }
+  return count;
+}
+
+} // namespace
+
+TEST_CASE("LinkedGroupBenchmark.updateLinkedGroups")
+{
+  auto taskManager = kdl::task_manager{};
+
+  const auto targetCount = GENERATE(values<size_t>({1, 10, 100, 300}));
+
+  auto sourceGroupNode = makePrefab();
+  auto targetGroupNodes = makeTargets(*sourceGroupNode, targetCount);
+
+  auto updatedCount = size_t(0);
+  timeLambda(
+    [&]() { updatedCount = propagate(*sourceGroupNode, targetGroupNodes, taskManager); },
+    fmt::format("propagate linked group to {} targets", targetCount));
+  CHECK(updatedCount == targetCount);
+
+  timeLambda(
+    [&]() { updatedCount = propagate(*sourceGroupNode, targetGroupNodes, taskManager); },
+    fmt::format("propagate unchanged linked group to {} targets", targetCount));
+  CHECK(updatedCount == 0u);
+
+  auto* sourceBrushNode = sourceGroupNode->children().front();
+  translateNode(*sourceBrushNode, vm::vec3d{0.0, 0.0, 8.0});
+
+  timeLambda(
+    [&]() { updatedCount = propagate(*sourceGroupNode, targetGroupNodes, taskManager); },
+    fmt::format("propagate single node change to {} targets", targetCount));
+  CHECK(updatedCount == targetCount);
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "el/EvaluationContext.h"
+#include "el/Expression.h"
+#include "el/VariableStore.h"
+#include "io/ELParser.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/EntityPropertiesVariableStore.h"
+#include "mdl/ModelDefinition.h"
+
+#include <fmt/format.h>
+
+#include <string>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumEntities = 20'000;
+
+const auto ModelExpression = std::string{R"(
+{{
+  spawnflags == 1 -> "progs/armor.mdl",
+  spawnflags == 2 -> { "path": "progs/armor.mdl", "skin": 1 },
+  spawnflags == 4 -> { "path": "progs/armor.mdl", "skin": 2 },
+  model -> { "path": model, "scale": scale },
+  "progs/g_shot.mdl"
+}}
+)"};
+
+std::vector<Entity> makeEntities()
+{
+  const auto models = std::vector<std::string>{
+    "", "progs/player.mdl", "progs/soldier.mdl", "progs/dog.mdl", "progs/ogre.mdl"};
+
+  auto result = std::vector<Entity>{};
+  result.reserve(NumEntities);
+  for (size_t i = 0; i < NumEntities; ++i)
+  {
+    result.emplace_back(std::vector<EntityProperty>{
+      {EntityPropertyKeys::Classname, "item_armor"},
+      {EntityPropertyKeys::Origin, fmt::format("{} {} 0", i % 256, i / 256)},
+      {EntityPropertyKeys::Spawnflags, fmt::format("{}", (i / 3) % 8)},
+      {"model", models[i % models.size()]},
+      {"scale", "1"},
+    });
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("ModelDefinitionBenchmark.modelSpecification")
+{
+  const auto entities = makeEntities();
+  const auto expression = io::ELParser::parseStrict(ModelExpression).value();
+
+  auto evaluationCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& entity : entities)
+      {
+        const auto variableStore = EntityPropertiesVariableStore{entity};
+        const auto result = el::withEvaluationContext(
+          [&](auto& context) { return expression.evaluate(context); }, variableStore);
+        evaluationCount += result.is_success() ? 1u : 0u;
+      }
+    },
+    fmt::format("evaluate model expression for {} entities", NumEntities));
+
+  const auto modelDefinition = ModelDefinition{expression};
+
+  auto specificationCount = size_t(0);
+  const auto evaluateModelDefinition = [&]() {
+    for (const auto& entity : entities)
+    {
+      const auto variableStore = EntityPropertiesVariableStore{entity};
+      const auto result = modelDefinition.modelSpecification(variableStore);
+      specificationCount += result.is_success() ? 1u : 0u;
+    }
+  };
+
+  timeLambda(
+    evaluateModelDefinition,
+    fmt::format("compute model specification for {} entities", NumEntities));
+  timeLambda(
+    evaluateModelDefinition,
+    fmt::format(
+      "compute model specification for {} entities with memoized results",
+      NumEntities));
+
+  CHECK(evaluationCount == NumEntities);
+  CHECK(specificationCount == 2 * NumEntities);
+}
+
+} // namespace tb::mdl
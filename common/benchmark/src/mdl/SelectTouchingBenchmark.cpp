@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/ModelUtils.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include "vm/bbox.h"
+#include "vm/mat_ext.h"
+
+#include <fmt/format.h>
+
+#include <memory>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto SelectionWorldBounds = vm::bbox3d{65536.0};
+
+BrushNode* makeCubeBrushNode(const double size, const vm::vec3d& center)
+{
+  const auto brushBuilder = BrushBuilder{MapFormat::Valve, SelectionWorldBounds};
+  auto brush = brushBuilder.createCube(size, "material") | kdl::value();
+  REQUIRE(brush.transform(SelectionWorldBounds, vm::translation_matrix(center), false)
+            .is_success());
+  return new BrushNode{std::move(brush)};
+}
+
+std::unique_ptr<WorldNode> makeBrushGridWorld(const size_t gridSize)
+{
+  auto worldNode = std::make_unique<WorldNode>(
+    EntityPropertyConfig{}, Entity{}, MapFormat::Valve);
+  for (size_t x = 0; x < gridSize; ++x)
+  {
+    for (size_t y = 0; y < gridSize; ++y)
+    {
+      for (size_t z = 0; z < 4; ++z)
+      {
+        worldNode->defaultLayer()->addChild(makeCubeBrushNode(
+          16.0, vm::vec3d{double(x) * 32.0, double(y) * 32.0, double(z) * 32.0}));
+      }
+    }
+  }
+  return worldNode;
+}
+
+} // namespace
+
+TEST_CASE("SelectTouchingBenchmark.collectMatchingNodes")
+{
+  auto taskManager = kdl::task_manager{};
+
+  const auto gridSize = GENERATE(values<size_t>({32, 128}));
+  auto worldNode = makeBrushGridWorld(gridSize);
+
+  // a few selection brushes that each cover a small part of the grid
+  auto selectionBrushNodes = std::vector<std::unique_ptr<BrushNode>>{};
+  auto selectionBrushes = std::vector<BrushNode*>{};
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const auto center = double(i * gridSize / 4) * 32.0;
+    selectionBrushes.push_back(
+      selectionBrushNodes
+        .emplace_back(makeCubeBrushNode(256.0, vm::vec3d{center, center, 48.0}))
+        .get());
+  }
+
+  const auto nodes = std::vector<Node*>{worldNode.get()};
+  const auto brushCount = gridSize * gridSize * 4;
+
+  auto touchingCount = size_t(0);
+  timeLambda(
+    [&]() {
+      touchingCount = collectTouchingNodes(nodes, selectionBrushes, taskManager).size();
+    },
+    fmt::format("select touching among {} brushes", brushCount));
+  CHECK(touchingCount > 0u);
+
+  auto containedCount = size_t(0);
+  timeLambda(
+    [&]() {
+      containedCount = collectContainedNodes(nodes, selectionBrushes, taskManager).size();
+    },
+    fmt::format("select inside among {} brushes", brushCount));
+  CHECK(containedCount > 0u);
+  CHECK(containedCount <= touchingCount);
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,188 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/Tag.h"
+#include "mdl/TagManager.h"
+#include "mdl/TagMatcher.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumBrushes = 100'000;
+constexpr size_t NumMaterials = 256;
+
+std::vector<std::string> makeMaterialNames()
+{
+  const auto prefixes = std::vector<std::string>{
+    "base/wall", "base/floor", "liquids/water", "liquids/slime", "sky/sky", "tech/metal"};
+
+  auto result = std::vector<std::string>{"trigger", "clip", "skip", "hint", "origin"};
+  for (size_t i = result.size(); i < NumMaterials; ++i)
+  {
+    result.push_back(fmt::format("{}{}", prefixes[i % prefixes.size()], i));
+  }
+  return result;
+}
+
+auto makeWorld()
+{
+  const auto worldBounds = vm::bbox3d{32768.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  const auto materialNames = makeMaterialNames();
+
+  return makeGridWorld(
+    MapFormat::Standard, NumBrushes, [&](const size_t i, const vm::bbox3d& bounds) {
+      const auto material = [&](const size_t face) -> const std::string& {
+        return materialNames[(i * 7 + face * 13) % materialNames.size()];
+      };
+
+      return builder.createCuboid(
+               bounds,
+               material(0),
+               material(1),
+               material(2),
+               material(3),
+               material(4),
+               material(5))
+             | kdl::value();
+    });
+}
+
+std::vector<SmartTag> makeSmartTags()
+{
+  auto result = std::vector<SmartTag>{};
+  result.emplace_back(
+    "Trigger",
+    std::vector<TagAttribute>{},
+    std::make_unique<MaterialNameTagMatcher>("trigger"));
+  result.emplace_back(
+    "Clip",
+    std::vector<TagAttribute>{},
+    std::make_unique<MaterialNameTagMatcher>("clip"));
+  result.emplace_back(
+    "Skip",
+    std::vector<TagAttribute>{},
+    std::make_unique<MaterialNameTagMatcher>("skip"));
+  result.emplace_back(
+    "Hint",
+    std::vector<TagAttribute>{},
+    std::make_unique<MaterialNameTagMatcher>("hint*"));
+  result.emplace_back(
+    "Liquid",
+    std::vector<TagAttribute>{},
+    std::make_unique<MaterialNameTagMatcher>("liquids/*"));
+  result.emplace_back(
+    "Sky", std::vector<TagAttribute>{}, std::make_unique<MaterialNameTagMatcher>("sky*"));
+  result.emplace_back(
+    "Detail",
+    std::vector<TagAttribute>{},
+    std::make_unique<EntityClassNameTagMatcher>("func_detail*", ""));
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("TagManagerBenchmark.updateTags")
+{
+  auto world = makeWorld();
+
+  auto tagManager = TagManager{};
+  tagManager.registerSmartTags(makeSmartTags());
+
+  auto brushNodes = std::vector<BrushNode*>{};
+  brushNodes.reserve(NumBrushes);
+  for (auto* node : world->defaultLayer()->children())
+  {
+    brushNodes.push_back(static_cast<BrushNode*>(node));
+  }
+
+  auto matchCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& smartTag : tagManager.smartTags())
+      {
+        for (const auto* brushNode : brushNodes)
+        {
+          for (const auto& face : brushNode->brush().faces())
+          {
+            matchCount += smartTag.matches(face) ? 1u : 0u;
+          }
+        }
+      }
+    },
+    fmt::format("match every smart tag against every face of {} brushes", NumBrushes));
+
+  timeLambda(
+    [&]() {
+      for (auto* brushNode : brushNodes)
+      {
+        brushNode->initializeTags(tagManager);
+      }
+    },
+    fmt::format("initialize tags of {} brushes", NumBrushes));
+
+  timeLambda(
+    [&]() {
+      for (auto* brushNode : brushNodes)
+      {
+        brushNode->updateTags(tagManager);
+      }
+    },
+    fmt::format("update tags of {} brushes", NumBrushes));
+
+  tagManager.clearMaterialTagMasks();
+  timeLambda(
+    [&]() {
+      for (auto* brushNode : brushNodes)
+      {
+        brushNode->updateTags(tagManager);
+      }
+    },
+    fmt::format("update tags of {} brushes after clearing the cache", NumBrushes));
+
+  const auto liquidTag = tagManager.smartTag("Liquid").type();
+  const auto liquidBrushCount = std::ranges::count_if(
+    brushNodes, [&](const auto* brushNode) {
+      return brushNode->anyFacesHaveAnyTagInMask(liquidTag);
+    });
+  CHECK(matchCount > 0u);
+  CHECK(liquidBrushCount > 0);
+}
+
+} // namespace tb::mdl
@@ -27,8 +27,10 @@
 #include "mdl/Texture.h"
 #include "mdl/WorldNode.h"
 #include "render/BrushRenderer.h"
+#include "render/BrushRendererBrushCache.h"
 
 #include "kdl/result.h"
+#include "kdl/task_manager.h"
 
 #include <fmt/format.h>
 
@@ -149,4 +151,51 @@ TEST_CASE("BrushRendererBenchmark.benchBrushRenderer")
     "validate remaining brushes");
 }
 
+TEST_CASE("BrushRendererBenchmark.benchParallelValidate")
+{
+  auto [brushes, materials] = makeBrushes();
+
+  auto taskManager = kdl::task_manager{};
+
+  const auto invalidateVertexCaches = [&]() {
+    for (const auto& brush : brushes)
+    {
+      brush->brushRendererBrushCache().invalidateVertexCache();
+    }
+  };
+
+  const auto benchValidate = [&](BrushRenderer& r, const std::string& name) {
+    for (const auto& brush : brushes)
+    {
+      r.addBrush(brush.get());
+    }
+    timeLambda(
+      [&]() { r.validate(); },
+      fmt::format(
+        "{} validate of {} brushes with cached vertices", name, brushes.size()));
+
+    r.clear();
+    invalidateVertexCaches();
+    for (const auto& brush : brushes)
+    {
+      r.addBrush(brush.get());
+    }
+    timeLambda(
+      [&]() { r.validate(); },
+      fmt::format(
+        "{} validate of {} brushes without cached vertices", name, brushes.size()));
+
+    r.invalidate();
+    timeLambda(
+      [&]() { r.validate(); },
+      fmt::format("{} validate after invalidating {} brushes", name, brushes.size()));
+  };
+
+  auto serialRenderer = BrushRenderer{};
+  benchValidate(serialRenderer, "serial");
+
+  auto parallelRenderer = BrushRenderer{taskManager};
+  benchValidate(parallelRenderer, "parallel");
+}
+
 } // namespace tb::render
@@ -0,0 +1,326 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "Exceptions.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/TestGame.h"
+#include "mdl/WorldNode.h"
+#include "render/GL.h"
+#include "render/MapRenderer.h"
+#include "render/PerspectiveCamera.h"
+#include "render/RenderBatch.h"
+#include "render/RenderContext.h"
+#include "render/RenderStatistics.h"
+#include "render/VboManager.h"
+#include "ui/GLContextManager.h"
+#include "ui/MapDocument.h"
+#include "ui/MapDocumentCommandFacade.h"
+
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include "vm/constants.h"
+#include "vm/vec.h"
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr auto ViewportWidth = 1280;
+constexpr auto ViewportHeight = 720;
+constexpr size_t FramesPerPath = 240;
+constexpr size_t MaterialCount = 64;
+
+/**
+ * An offscreen framebuffer with a current GL context. On machines without a GPU, the
+ * context is provided by a software rasterizer, e.g. Mesa's llvmpipe when running under
+ * xvfb.
+ */
+class OffscreenContext
+{
+private:
+  QOffscreenSurface m_surface;
+  QOpenGLContext m_context;
+  std::unique_ptr<QOpenGLFramebufferObject> m_framebuffer;
+
+public:
+  OffscreenContext()
+  {
+    m_surface.create();
+    if (m_context.create() && m_context.makeCurrent(&m_surface))
+    {
+      m_framebuffer = std::make_unique<QOpenGLFramebufferObject>(
+        ViewportWidth, ViewportHeight, QOpenGLFramebufferObject::Depth);
+      m_framebuffer->bind();
+    }
+  }
+
+  ~OffscreenContext()
+  {
+    if (m_framebuffer)
+    {
+      m_framebuffer->release();
+    }
+    m_context.doneCurrent();
+  }
+
+  bool valid() const { return m_framebuffer && m_framebuffer->isValid(); }
+};
+
+/**
+ * Creates a cubic grid of brushes with the given number of brushes per side.
+ */
+std::vector<mdl::Node*> makeFixture(const ui::MapDocument& document, const size_t side)
+{
+  constexpr auto spacing = 128.0;
+  constexpr auto size = 96.0;
+
+  const auto builder =
+    mdl::BrushBuilder{document.world()->mapFormat(), document.worldBounds()};
+  const auto origin = -spacing * static_cast<double>(side) / 2.0;
+
+  auto result = std::vector<mdl::Node*>{};
+  result.reserve(side * side * side);
+
+  size_t materialIndex = 0;
+  for (size_t x = 0; x < side; ++x)
+  {
+    for (size_t y = 0; y < side; ++y)
+    {
+      for (size_t z = 0; z < side; ++z)
+      {
+        const auto min = vm::vec3d{
+          origin + spacing * static_cast<double>(x),
+          origin + spacing * static_cast<double>(y),
+          origin + spacing * static_cast<double>(z)};
+        const auto materialName =
+          fmt::format("material{}", materialIndex++ % MaterialCount);
+        const auto bounds = vm::bbox3d{min, min + vm::vec3d{size, size, size}};
+        auto brush = builder.createCuboid(bounds, materialName) | kdl::value();
+        result.push_back(new mdl::BrushNode{std::move(brush)});
+      }
+    }
+  }
+
+  return result;
+}
+
+struct CameraPath
+{
+  std::string name;
+  std::function<void(PerspectiveCamera&, float)> update;
+};
+
+/**
+ * Camera paths are parameterized by t in [0, 1] and scaled to the extents of the
+ * fixture.
+ */
+std::vector<CameraPath> makeCameraPaths(const float extent)
+{
+  return {
+    {"orbit",
+     [=](auto& camera, const auto t) {
+       const auto angle = 2.0f * vm::Cf::pi() * t;
+       const auto position =
+         vm::vec3f{std::cos(angle), std::sin(angle), 0.5f} * extent * 1.5f;
+       camera.moveTo(position);
+       camera.lookAt(vm::vec3f{0, 0, 0}, vm::vec3f{0, 0, 1});
+     }},
+    {"fly-through",
+     [=](auto& camera, const auto t) {
+       const auto x = extent * (2.0f * t - 1.0f);
+       camera.moveTo(vm::vec3f{x, extent * 0.1f, extent * 0.05f});
+       camera.setDirection(vm::vec3f{1, 0, 0}, vm::vec3f{0, 0, 1});
+     }},
+  };
+}
+
+double percentile(std::vector<double> values, const double p)
+{
+  if (values.empty())
+  {
+    return 0.0;
+  }
+
+  std::ranges::sort(values);
+  const auto index =
+    static_cast<size_t>(std::ceil(p * static_cast<double>(values.size()))) - 1u;
+  return values[std::min(index, values.size() - 1u)];
+}
+
+void renderFrame(
+  ui::GLContextManager& contextManager,
+  MapRenderer& mapRenderer,
+  const PerspectiveCamera& camera,
+  RenderStatistics& statistics)
+{
+  statistics.beginFrame();
+  {
+    const auto scopedStatistics = ScopedRenderStatistics{statistics};
+
+    glAssert(glViewport(0, 0, ViewportWidth, ViewportHeight));
+    glAssert(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    glAssert(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+    glAssert(glEnable(GL_BLEND));
+    glAssert(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+    auto renderContext = RenderContext{
+      RenderMode::Render3D,
+      camera,
+      contextManager.fontManager(),
+      contextManager.shaderManager()};
+    auto renderBatch = RenderBatch{contextManager.vboManager(), &statistics};
+
+    mapRenderer.render(renderContext, renderBatch);
+    renderBatch.render(renderContext);
+
+    contextManager.vboManager().endFrame();
+
+    // wait for the GPU so that the frame time includes the actual rendering
+    glAssert(glFinish());
+  }
+  statistics.endFrame();
+}
+
+void reportPath(
+  const size_t brushCount,
+  const CameraPath& path,
+  const std::vector<double>& frameTimes,
+  const RenderStatistics& statistics)
+{
+  const auto& history = statistics.history();
+  const auto firstFrame = history.front().total();
+  const auto average = statistics.average(history.size() - 1u).total();
+
+  // the first frame uploads all vertices and is reported separately
+  const auto steadyFrameTimes =
+    std::vector<double>(std::next(frameTimes.begin()), frameTimes.end());
+
+  printf(
+    "%zu brushes, %s: first frame %.2fms (%zu KiB uploaded), p50 %.2fms, p90 %.2fms, "
+    "p99 %.2fms, max %.2fms, %zu draw calls/frame, %zu KiB uploaded/frame\n",
+    brushCount,
+    path.name.c_str(),
+    frameTimes.front(),
+    firstFrame.uploadedBytes / 1024u,
+    percentile(steadyFrameTimes, 0.5),
+    percentile(steadyFrameTimes, 0.9),
+    percentile(steadyFrameTimes, 0.99),
+    percentile(steadyFrameTimes, 1.0),
+    average.drawCallCount,
+    average.uploadedBytes / 1024u);
+}
+
+} // namespace
+
+TEST_CASE("MapRendererBenchmark.renderCameraPaths")
+{
+  // must be created before and destroyed after everything that owns GL resources
+  auto offscreenContext = OffscreenContext{};
+  if (!offscreenContext.valid())
+  {
+    WARN("Could not create an offscreen OpenGL context, skipping benchmark");
+    return;
+  }
+
+  auto contextManager = ui::GLContextManager{};
+  try
+  {
+    contextManager.initialize();
+  }
+  catch (const RenderException& e)
+  {
+    WARN(fmt::format("Could not initialize OpenGL, skipping benchmark: {}", e.what()));
+    return;
+  }
+
+  printf(
+    "Rendering with %s (%s)\n",
+    ui::GLContextManager::GLRenderer.c_str(),
+    ui::GLContextManager::GLVersion.c_str());
+
+  for (const size_t side : {10u, 20u, 32u})
+  {
+    auto taskManager = kdl::task_manager{};
+    auto document = ui::MapDocumentCommandFacade::newMapDocument(taskManager);
+    auto mapRenderer = MapRenderer{document};
+
+    auto game = std::make_shared<mdl::TestGame>();
+    game->config().forceEmptyNewMap = true;
+    document->newDocument(mdl::MapFormat::Standard, vm::bbox3d{8192.0}, game)
+      | kdl::transform_error([](auto e) { throw std::runtime_error{e.msg}; });
+
+    const auto brushCount = side * side * side;
+    document->addNodes({{document->parentForNodes(), makeFixture(*document, side)}});
+
+    const auto extent = 128.0f * static_cast<float>(side) / 2.0f;
+    for (const auto& path : makeCameraPaths(extent))
+    {
+      auto camera = PerspectiveCamera{
+        90.0f,
+        1.0f,
+        8192.0f,
+        Camera::Viewport{0, 0, ViewportWidth, ViewportHeight},
+        vm::vec3f{0, 0, 0},
+        vm::vec3f{1, 0, 0},
+        vm::vec3f{0, 0, 1}};
+
+      auto statistics = RenderStatistics{FramesPerPath};
+      auto frameTimes = std::vector<double>{};
+      frameTimes.reserve(FramesPerPath);
+
+      for (size_t i = 0; i < FramesPerPath; ++i)
+      {
+        path.update(
+          camera, static_cast<float>(i) / static_cast<float>(FramesPerPath - 1));
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        renderFrame(contextManager, mapRenderer, camera, statistics);
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        frameTimes.push_back(
+          std::chrono::duration<double, std::milli>(end - start).count());
+      }
+
+      reportPath(brushCount, path, frameTimes, statistics);
+      CHECK(statistics.history().back().total().drawCallCount > 0u);
+    }
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "ui/CellLayout.h"
+
+#include <fmt/format.h>
+
+#include <string>
+
+namespace tb::ui
+{
+namespace
+{
+
+constexpr auto ItemCount = size_t(50000);
+constexpr auto ViewportHeight = 800.0f;
+constexpr auto ScrollStep = 40.0f;
+
+void setupLayout(CellLayout& layout, const bool virtualized)
+{
+  layout.setOuterMargin(5.0f);
+  layout.setGroupMargin(5.0f);
+  layout.setRowMargin(15.0f);
+  layout.setCellMargin(10.0f);
+  layout.setTitleMargin(2.0f);
+  layout.setCellWidth(64.0f, 64.0f);
+  layout.setCellHeight(64.0f, 128.0f);
+  layout.setVirtualized(virtualized);
+  layout.setWidth(600.0f);
+}
+
+void addItems(CellLayout& layout)
+{
+  for (size_t i = 0; i < ItemCount; ++i)
+  {
+    if (i % 5000 == 0)
+    {
+      layout.addGroup(fmt::format("textures/group{}", i / 5000), 14.0f);
+    }
+    layout.addItem(
+      i,
+      fmt::format("textures/group{}/material_{}", i / 5000, i),
+      float(32 << (i % 3)),
+      float(32 << (i % 4)),
+      float(60 + i % 40),
+      14.0f);
+  }
+}
+
+} // namespace
+
+TEST_CASE("CellLayoutBenchmark.layoutAndScroll")
+{
+  for (const auto virtualized : {false, true})
+  {
+    const auto mode = virtualized ? "virtualized" : "eager";
+
+    auto layout = CellLayout{};
+    setupLayout(layout, virtualized);
+
+    timeLambda(
+      [&]() {
+        addItems(layout);
+        layout.height();
+      },
+      fmt::format("lay out {} items ({})", ItemCount, mode));
+
+    timeLambda(
+      [&]() {
+        layout.setWidth(800.0f);
+        layout.height();
+      },
+      fmt::format("resize layout ({})", mode));
+
+    auto visibleCells = size_t(0);
+    timeLambda(
+      [&]() {
+        for (auto y = 0.0f; y < layout.height(); y += ScrollStep)
+        {
+          layout.materializeRows(y, ViewportHeight);
+          for (const auto& group : layout.groups())
+          {
+            if (group.intersectsY(y, ViewportHeight))
+            {
+              for (const auto& row : group.rows())
+              {
+                if (row.intersectsY(y, ViewportHeight))
+                {
+                  visibleCells += row.cells().size();
+                }
+              }
+            }
+          }
+        }
+      },
+      fmt::format("scroll through layout ({})", mode));
+    CHECK(visibleCells > 0u);
+
+    timeLambda(
+      [&]() {
+        for (auto y = 0.0f; y < layout.height(); y += ScrollStep)
+        {
+          layout.cellAt(300.0f, y);
+        }
+      },
+      fmt::format("hit test while scrolling ({})", mode));
+  }
+}
+
+} // namespace tb::ui
@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/PickResult.h"
+#include "render/PerspectiveCamera.h"
+#include "ui/VertexHandleManager.h"
+
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <vector>
+
+namespace tb::ui
+{
+namespace
+{
+
+// 47^3 is a little more than 100k handles
+constexpr auto HandleGridSize = size_t(47);
+constexpr auto HandleSpacing = 32.0;
+
+std::vector<vm::vec3d> makeHandleGrid()
+{
+  auto result = std::vector<vm::vec3d>{};
+  result.reserve(HandleGridSize * HandleGridSize * HandleGridSize);
+  for (size_t x = 0; x < HandleGridSize; ++x)
+  {
+    for (size_t y = 0; y < HandleGridSize; ++y)
+    {
+      for (size_t z = 0; z < HandleGridSize; ++z)
+      {
+        result.push_back(vm::vec3d{double(x), double(y), double(z)} * HandleSpacing);
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("VertexHandleManagerBenchmark.pick")
+{
+  const auto handles = makeHandleGrid();
+
+  auto handleManager = VertexHandleManager{};
+  timeLambda(
+    [&]() {
+      for (const auto& handle : handles)
+      {
+        handleManager.add(handle);
+      }
+    },
+    fmt::format("add {} handles", handles.size()));
+  REQUIRE(handleManager.totalHandleCount() == handles.size());
+
+  const auto cameraPosition = vm::vec3f{-512.0f, -512.0f, 2048.0f};
+  const auto camera = render::PerspectiveCamera{
+    90.0f,
+    1.0f,
+    65536.0f,
+    render::Camera::Viewport{0, 0, 1920, 1080},
+    cameraPosition,
+    vm::normalize(vm::vec3f{1.0f, 1.0f, -1.0f}),
+    vm::vec3f{0.0f, 0.0f, 1.0f}};
+
+  // aim a picking ray at every 1000th handle
+  auto pickRays = std::vector<vm::ray3d>{};
+  for (size_t i = 0; i < handles.size(); i += 1000)
+  {
+    const auto origin = vm::vec3d{cameraPosition};
+    pickRays.emplace_back(origin, vm::normalize(handles[i] - origin));
+  }
+
+  auto hitCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& pickRay : pickRays)
+      {
+        auto pickResult = mdl::PickResult{};
+        handleManager.pick(pickRay, camera, pickResult);
+        hitCount += pickResult.size();
+      }
+    },
+    fmt::format("pick {} rays among {} handles", pickRays.size(), handles.size()));
+  CHECK(hitCount >= pickRays.size());
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < handles.size(); i += 100)
+      {
+        handleManager.select(handles[i]);
+      }
+    },
+    fmt::format("select {} handles", handles.size() / 100 + 1));
+  CHECK(handleManager.selectedHandleCount() == handles.size() / 100 + 1);
+
+  timeLambda(
+    [&]() {
+      for (const auto& handle : handles)
+      {
+        handleManager.remove(handle);
+      }
+    },
+    fmt::format("remove {} handles", handles.size()));
+  CHECK(handleManager.totalHandleCount() == 0u);
+}
+
+} // namespace tb::ui
@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogQueue.h"
+
+#include <algorithm>
+
+namespace tb
+{
+
+LogQueue::~LogQueue()
+{
+  deleteEntries(m_head.exchange(nullptr));
+}
+
+bool LogQueue::empty() const
+{
+  return m_head.load(std::memory_order_acquire) == nullptr;
+}
+
+void LogQueue::push(const LogLevel level, const std::string_view message)
+{
+  auto* entry = new Entry{LogMessage{level, std::string{message}}, nullptr};
+
+  entry->next = m_head.load(std::memory_order_relaxed);
+  while (!m_head.compare_exchange_weak(
+    entry->next, entry, std::memory_order_release, std::memory_order_relaxed))
+  {
+  }
+}
+
+std::vector<LogMessage> LogQueue::popAll()
+{
+  // the entries form a stack, so the most recent message comes first
+  auto* head = m_head.exchange(nullptr, std::memory_order_acquire);
+
+  auto result = std::vector<LogMessage>{};
+  for (auto* entry = head; entry; entry = entry->next)
+  {
+    result.push_back(std::move(entry->message));
+  }
+  deleteEntries(head);
+
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+void LogQueue::deleteEntries(Entry* entry)
+{
+  while (entry)
+  {
+    auto* next = entry->next;
+    delete entry;
+    entry = next;
+  }
+}
+
+} // namespace tb
@@ -0,0 +1,87 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tb
+{
+enum class LogLevel;
+
+struct LogMessage
+{
+  LogLevel level;
+  std::string str;
+
+  bool operator==(const LogMessage& other) const = default;
+};
+
+/**
+ * A lock-free multi-producer queue of log messages.
+ *
+ * Any number of threads can push messages concurrently without blocking each other.
+ * A consumer takes all pending messages at once, which makes it cheap to forward them to
+ * a UI in batches. Messages pushed by one thread are returned in the order in which that
+ * thread pushed them.
+ */
+class LogQueue
+{
+private:
+  struct Entry
+  {
+    LogMessage message;
+    Entry* next;
+  };
+
+  std::atomic<Entry*> m_head = nullptr;
+
+public:
+  LogQueue() = default;
+  ~LogQueue();
+
+  LogQueue(const LogQueue&) = delete;
+  LogQueue& operator=(const LogQueue&) = delete;
+
+  bool empty() const;
+
+  void push(LogLevel level, std::string_view message);
+
+  /**
+   * Removes all pending messages from this queue and returns them in push order.
+   */
+  std::vector<LogMessage> popAll();
+
+  template <typename F>
+  void popAll(const F& f)
+  {
+    for (const auto& message : popAll())
+    {
+      f(message.level, message.str);
+    }
+  }
+
+private:
+  static void deleteEntries(Entry* entry);
+};
+
+} // namespace tb
@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NotificationBatch.h"
+
+#include <cassert>
+#include <utility>
+
+namespace tb
+{
+
+NotificationBatch::NotificationBatch() = default;
+
+bool NotificationBatch::active() const
+{
+  return m_depth > 0;
+}
+
+void NotificationBatch::begin()
+{
+  ++m_depth;
+}
+
+void NotificationBatch::end()
+{
+  assert(m_depth > 0);
+  if (--m_depth == 0)
+  {
+    // a delivery may start another batch, which must collect its own notifications
+    const auto deliveries = std::exchange(m_pendingDeliveries, {});
+    for (const auto& delivery : deliveries)
+    {
+      ++m_deliveryCount;
+      delivery();
+    }
+  }
+}
+
+size_t NotificationBatch::deferredNotificationCount() const
+{
+  return m_deferredNotificationCount;
+}
+
+size_t NotificationBatch::deliveryCount() const
+{
+  return m_deliveryCount;
+}
+
+void NotificationBatch::defer(std::function<void()> delivery)
+{
+  assert(active());
+  m_pendingDeliveries.push_back(std::move(delivery));
+}
+
+} // namespace tb
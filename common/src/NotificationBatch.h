@@ -0,0 +1,158 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Notifier.h"
+#include "NotifierConnection.h"
+
+#include "kdl/vector_utils.h"
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tb
+{
+
+/**
+ * Collects notifications while a batch is active and delivers them once the outermost
+ * batch ends.
+ *
+ * Only observers that were connected via one of the connect functions of this class are
+ * affected. Such an observer receives at most one notification per batch, and the
+ * notification contains the deduplicated union of all arguments that the notifier was
+ * called with while the batch was active. If no batch is active, the observer is
+ * notified immediately.
+ *
+ * Deliveries happen in the order in which the observers were first notified during the
+ * batch. Since a batch may span the addition and the subsequent deletion of an object,
+ * batched observers must not dereference the objects they are passed.
+ */
+class NotificationBatch
+{
+private:
+  size_t m_depth = 0;
+  std::vector<std::function<void()>> m_pendingDeliveries;
+  size_t m_deferredNotificationCount = 0;
+  size_t m_deliveryCount = 0;
+
+public:
+  NotificationBatch();
+
+  NotificationBatch(const NotificationBatch&) = delete;
+  NotificationBatch& operator=(const NotificationBatch&) = delete;
+
+  /**
+   * Indicates whether a batch is currently active.
+   */
+  bool active() const;
+
+  /**
+   * Starts a batch. Batches can be nested.
+   */
+  void begin();
+
+  /**
+   * Ends a batch. If the outermost batch ends, all pending notifications are delivered.
+   */
+  void end();
+
+  /**
+   * Returns the number of notifications that were deferred by this batch.
+   */
+  size_t deferredNotificationCount() const;
+
+  /**
+   * Returns the number of batched notifications that were delivered by this batch.
+   */
+  size_t deliveryCount() const;
+
+  /**
+   * Connects the given callback to the given notifier so that it receives batched
+   * notifications.
+   *
+   * The given notifier must not outlive this batch.
+   */
+  template <typename T>
+  [[nodiscard]] NotifierConnection connect(
+    Notifier<const std::vector<T>&>& notifier,
+    std::type_identity_t<std::function<void(const std::vector<T>&)>> callback)
+  {
+    struct Observer
+    {
+      std::function<void(const std::vector<T>&)> callback;
+      std::vector<T> pending;
+      bool scheduled = false;
+    };
+
+    auto observer = std::make_shared<Observer>(Observer{std::move(callback), {}});
+    return notifier.connect([&, observer](const std::vector<T>& items) {
+      if (!active())
+      {
+        observer->callback(items);
+        return;
+      }
+
+      ++m_deferredNotificationCount;
+      observer->pending.insert(observer->pending.end(), items.begin(), items.end());
+      if (!observer->scheduled)
+      {
+        observer->scheduled = true;
+        defer([weakObserver = std::weak_ptr{observer}]() {
+          // skip observers that were disconnected while the batch was active
+          if (auto lockedObserver = weakObserver.lock())
+          {
+            lockedObserver->scheduled = false;
+            const auto batchedItems = kdl::vec_sort_and_remove_duplicates(
+              std::exchange(lockedObserver->pending, {}));
+            lockedObserver->callback(batchedItems);
+          }
+        });
+      }
+    });
+  }
+
+  /**
+   * Connects the given member function to the given notifier so that it receives batched
+   * notifications.
+   *
+   * @param notifier the notifier to connect to
+   * @param receiver the receiver object, i.e. the owner of the member function
+   * @param callback the observer callback to call when the batch is delivered
+   */
+  template <typename T, typename R, typename MemberCallback>
+  [[nodiscard]] NotifierConnection connect(
+    Notifier<const std::vector<T>&>& notifier, R* receiver_, MemberCallback callback_)
+  {
+    return connect(
+      notifier,
+      [receiver = receiver_,
+       callback = std::move(callback_)](const std::vector<T>& items) {
+        std::invoke(callback, receiver, items);
+      });
+  }
+
+private:
+  void defer(std::function<void()> delivery);
+};
+
+} // namespace tb
@@ -26,12 +26,26 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <vector>
 
 namespace tb
 {
+/**
+ * Statistics about the notifications received by a single observer.
+ */
+struct ObserverStatistics
+{
+  /** The observer's id. Ids increase in the order in which observers were connected. */
+  size_t id;
+  /** The number of times the observer was notified. */
+  size_t notificationCount;
+  /** The total time spent in the observer callback, including nested notifications. */
+  std::chrono::nanoseconds notificationTime;
+};
+
 /**
  * Base class for notifier state. This is only necessary so that NotifierConnection is
  * independent of the Notifier type.
@@ -65,6 +79,8 @@ private:
     Callback callback;
     size_t id;
     bool pendingRemove = false;
+    size_t notificationCount = 0;
+    std::chrono::nanoseconds notificationTime{0};
 
     Observer(Callback i_callback, const size_t i_id)
       : callback{std::move(i_callback)}
@@ -119,13 +135,40 @@ private:
       processPendingObservers();
 
       const auto notifying = kdl::set_temp{m_notifying};
-      for (const auto& observer : m_observers)
+      for (auto& observer : m_observers)
       {
         if (!observer.pendingRemove)
         {
+          const auto start = std::chrono::steady_clock::now();
           observer.callback(std::forward<NA>(a)...);
+          observer.notificationTime += std::chrono::steady_clock::now() - start;
+          ++observer.notificationCount;
+        }
+      }
+    }
+
+    std::vector<ObserverStatistics> statistics() const
+    {
+      auto result = std::vector<ObserverStatistics>{};
+      result.reserve(m_observers.size());
+      for (const auto& observer : m_observers)
+      {
+        if (!observer.pendingRemove)
+        {
+          result.push_back(
+            {observer.id, observer.notificationCount, observer.notificationTime});
         }
       }
+      return result;
+    }
+
+    void resetStatistics()
+    {
+      for (auto& observer : m_observers)
+      {
+        observer.notificationCount = 0;
+        observer.notificationTime = std::chrono::nanoseconds{0};
+      }
     }
 
     void disconnect(const size_t id) override
@@ -263,6 +306,18 @@ public:
   {
     notify(std::forward<NA>(a)...);
   }
+
+  /**
+   * Returns the number of notifications and the time spent for each connected observer.
+   * Observers that were connected during a notification are reported once the next
+   * notification starts.
+   */
+  std::vector<ObserverStatistics> statistics() const { return m_state->statistics(); }
+
+  /**
+   * Resets the notification counts and times of all connected observers.
+   */
+  void resetStatistics() { m_state->resetStatistics(); }
 };
 
 /**
@@ -66,6 +66,7 @@ Preference<Color> PortalFileBorderColor(
 Preference<Color> PortalFileFillColor(
   "render/Colors/Portal file fill", Color(1.0f, 0.4f, 0.4f, 0.2f));
 Preference<bool> ShowFPS("render/Show FPS", false);
+Preference<bool> ShowRenderStatistics("render/Show render statistics", false);
 
 Preference<Color>& axisColor(vm::axis::type axis)
 {
@@ -194,6 +195,7 @@ Preference<bool> EnableMSAA("render/Enable multisampling", true);
 
 Preference<bool> AlignmentLock("Editor/Texture lock", true);
 Preference<bool> UVLock("Editor/UV lock", false);
+Preference<int> UndoMemoryBudget("Editor/Undo memory budget", 1024);
 
 Preference<std::filesystem::path>& RendererFontPath()
 {
@@ -337,6 +339,7 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &PortalFileBorderColor,
     &PortalFileFillColor,
     &ShowFPS,
+    &ShowRenderStatistics,
     &CompassBackgroundColor,
     &CompassBackgroundOutlineColor,
     &CompassAxisOutlineColor,
@@ -392,6 +395,7 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &TextureMagFilter,
     &AlignmentLock,
     &UVLock,
+    &UndoMemoryBudget,
     &RendererFontPath(),
     &RendererFontSize,
     &BrowserFontSize,
@@ -61,6 +61,7 @@ extern Preference<Color> PointFileColor;
 extern Preference<Color> PortalFileBorderColor;
 extern Preference<Color> PortalFileFillColor;
 extern Preference<bool> ShowFPS;
+extern Preference<bool> ShowRenderStatistics;
 
 Preference<Color>& axisColor(vm::axis::type axis);
 
@@ -139,6 +140,9 @@ extern Preference<bool> EnableMSAA;
 extern Preference<bool> AlignmentLock;
 extern Preference<bool> UVLock;
 
+/** The memory budget of the undo history in megabytes, or 0 for no limit. */
+extern Preference<int> UndoMemoryBudget;
+
 Preference<std::filesystem::path>& RendererFontPath();
 extern Preference<int> RendererFontSize;
 
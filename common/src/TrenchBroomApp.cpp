@@ -615,7 +615,7 @@ void TrenchBroomApp::openDocument()
     nullptr,
     tr("Open Map"),
     fileDialogDefaultDirectory(FileDialogDir::Map),
-    "Map files (*.map);;Any files (*.*)");
+    "Map files (*.map *.tbmap);;Any files (*.*)");
 
   if (const auto path = io::pathFromQString(pathStr); !path.empty())
   {
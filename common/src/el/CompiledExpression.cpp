@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CompiledExpression.h"
+
+#include "kdl/overload.h"
+#include "kdl/vector_utils.h"
+
+namespace tb::el
+{
+namespace
+{
+
+void collectVariableNames(
+  const ExpressionNode& expression, std::vector<std::string>& variableNames)
+{
+  const auto collect = [&](const ExpressionNode& node) {
+    collectVariableNames(node, variableNames);
+  };
+
+  expression.accept(kdl::overload(
+    [](const LiteralExpression&) {},
+    [&](const VariableExpression& variableExpression) {
+      variableNames.push_back(variableExpression.variableName);
+    },
+    [&](const ArrayExpression& arrayExpression) {
+      for (const auto& element : arrayExpression.elements)
+      {
+        collect(element);
+      }
+    },
+    [&](const MapExpression& mapExpression) {
+      for (const auto& [key, element] : mapExpression.elements)
+      {
+        collect(element);
+      }
+    },
+    [&](const UnaryExpression& unaryExpression) { collect(unaryExpression.operand); },
+    [&](const BinaryExpression& binaryExpression) {
+      collect(binaryExpression.leftOperand);
+      collect(binaryExpression.rightOperand);
+    },
+    [&](const SubscriptExpression& subscriptExpression) {
+      collect(subscriptExpression.leftOperand);
+      collect(subscriptExpression.rightOperand);
+    },
+    [&](const SwitchExpression& switchExpression) {
+      for (const auto& switchCase : switchExpression.cases)
+      {
+        collect(switchCase);
+      }
+    }));
+}
+
+} // namespace
+
+std::vector<std::string> collectVariableNames(const ExpressionNode& expression)
+{
+  auto result = std::vector<std::string>{};
+  collectVariableNames(expression, result);
+  return kdl::vec_sort_and_remove_duplicates(std::move(result));
+}
+
+bool appendToMemoizationKey(std::string& key, const Value& value)
+{
+  switch (value.type())
+  {
+  case ValueType::String:
+  case ValueType::Boolean:
+  case ValueType::Null:
+  case ValueType::Undefined:
+    // strings are quoted and escaped, so their string representations are unique
+    key += value.asString();
+    key += '\n';
+    return true;
+  case ValueType::Number:
+  case ValueType::Array:
+  case ValueType::Map:
+  case ValueType::Range:
+    break;
+  }
+  return false;
+}
+
+} // namespace tb::el
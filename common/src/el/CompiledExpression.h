@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "el/Expression.h"
+#include "el/Value.h"
+#include "el/VariableStore.h"
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::el
+{
+
+/**
+ * Returns the names of the variables that the given expression reads, sorted and without
+ * duplicates.
+ */
+std::vector<std::string> collectVariableNames(const ExpressionNode& expression);
+
+/**
+ * Appends a string to the given key that uniquely identifies the given value. Returns
+ * false if the value cannot be used as part of a memoization key, in which case the key
+ * is left in an unspecified state.
+ *
+ * Only strings, booleans, null and undefined can be used in keys. Numbers, arrays, maps
+ * and ranges cannot be identified by their string representations.
+ */
+bool appendToMemoizationKey(std::string& key, const Value& value);
+
+/**
+ * Prepares an expression for repeated evaluation with different variable values.
+ *
+ * When the expression is compiled, the variables that it reads are collected. Evaluating
+ * the expression reads the values of these variables from the given variable store into a
+ * variable table that only contains them. The result of the evaluation is memoized by the
+ * values of the variables, so that the expression is evaluated only once for all entities
+ * that share the relevant property values.
+ *
+ * Copies share the memoized results. The results are not invalidated, so the function
+ * passed to evaluate must only depend on the expression and the variables.
+ *
+ * This class is thread safe.
+ */
+template <typename T>
+class CompiledExpression
+{
+private:
+  static constexpr auto MaxCachedResults = size_t(1024);
+
+  struct Cache
+  {
+    std::mutex mutex;
+    std::unordered_map<std::string, T> results;
+  };
+
+  ExpressionNode m_expression;
+  std::vector<std::string> m_variableNames;
+  std::shared_ptr<Cache> m_cache;
+
+public:
+  explicit CompiledExpression(ExpressionNode expression)
+    : m_expression{std::move(expression)}
+    , m_variableNames{collectVariableNames(m_expression)}
+    , m_cache{std::make_shared<Cache>()}
+  {
+  }
+
+  const ExpressionNode& expression() const { return m_expression; }
+
+  const std::vector<std::string>& variableNames() const { return m_variableNames; }
+
+  /**
+   * Evaluates the expression by calling the given function with the expression and a
+   * variable store containing the variables read by the expression. If the function was
+   * already called for the same variable values, the memoized result is returned
+   * instead.
+   *
+   * @param variableStore the variable store to read the variable values from
+   * @param evaluateExpression a function that takes an expression node and a variable
+   * store and returns a T
+   */
+  template <typename F>
+  T evaluate(const VariableStore& variableStore, const F& evaluateExpression) const
+  {
+    auto variables = VariableTable{};
+    auto key = std::optional<std::string>{std::string{}};
+    for (const auto& name : m_variableNames)
+    {
+      auto value = variableStore.value(name);
+      if (key && !appendToMemoizationKey(*key, value))
+      {
+        key = std::nullopt;
+      }
+      variables.set(name, std::move(value));
+    }
+
+    if (!key)
+    {
+      return evaluateExpression(m_expression, variables);
+    }
+
+    {
+      const auto lock = std::lock_guard{m_cache->mutex};
+      if (const auto it = m_cache->results.find(*key); it != m_cache->results.end())
+      {
+        return it->second;
+      }
+    }
+
+    auto result = evaluateExpression(m_expression, variables);
+
+    {
+      const auto lock = std::lock_guard{m_cache->mutex};
+      if (m_cache->results.size() >= MaxCachedResults)
+      {
+        m_cache->results.clear();
+      }
+      m_cache->results.emplace(std::move(*key), result);
+    }
+
+    return result;
+  }
+};
+
+} // namespace tb::el
@@ -46,7 +46,7 @@ Value EvaluationContext::variableValue(const std::string& name) const
 
 std::optional<ExpressionNode> EvaluationContext::expression(const Value& value) const
 {
-  const auto it = m_trace.find(value);
+  const auto it = m_trace.find(value.m_identity);
   return it != m_trace.end() ? std::optional{it->second} : std::nullopt;
 }
 
@@ -61,7 +61,7 @@ std::optional<FileLocation> EvaluationContext::location(const Value& value) cons
 
 Value EvaluationContext::trace(Value value, const ExpressionNode& expression)
 {
-  m_trace.emplace(value, expression);
+  m_trace.emplace(value.m_identity, expression);
   return value;
 }
 
@@ -26,6 +26,7 @@
 #include "el/Expression.h"
 #include "el/Value.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -38,7 +39,7 @@ class EvaluationContext
 {
 private:
   std::unique_ptr<VariableStore> m_variables;
-  std::unordered_map<Value, ExpressionNode> m_trace;
+  std::unordered_map<std::uint64_t, ExpressionNode> m_trace;
 
   EvaluationContext();
   explicit EvaluationContext(const VariableStore& variables);
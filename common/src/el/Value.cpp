@@ -30,6 +30,7 @@
 #include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
+#include <atomic>
 #include <cmath>
 #include <iterator>
 #include <ranges>
@@ -38,6 +39,27 @@
 
 namespace tb::el
 {
+namespace
+{
+
+std::uint64_t nextIdentity()
+{
+  // Identities are handed out in blocks so that threads rarely touch the shared counter.
+  static constexpr auto BlockSize = std::uint64_t(1) << 16;
+  static auto nextBlock = std::atomic<std::uint64_t>{0};
+
+  thread_local auto next = std::uint64_t(0);
+  thread_local auto end = std::uint64_t(0);
+
+  if (next == end)
+  {
+    next = nextBlock.fetch_add(BlockSize, std::memory_order_relaxed);
+    end = next + BlockSize;
+  }
+  return next++;
+}
+
+} // namespace
 
 NullType::NullType() = default;
 const NullType NullType::Value = NullType{};
@@ -48,84 +70,120 @@ const UndefinedType UndefinedType::Value = UndefinedType{};
 const Value Value::Null = Value{NullType::Value};
 const Value Value::Undefined = Value{UndefinedType::Value};
 
+template <typename F>
+decltype(auto) Value::visit(const F& f) const
+{
+  switch (m_type)
+  {
+  case ValueType::Boolean:
+    return f(m_boolean);
+  case ValueType::Number:
+    return f(m_number);
+  case ValueType::Null:
+    return f(NullType::Value);
+  case ValueType::Undefined:
+    return f(UndefinedType::Value);
+  case ValueType::String:
+  case ValueType::Array:
+  case ValueType::Map:
+  case ValueType::Range:
+    break;
+  }
+
+  return std::visit(f, *m_shared);
+}
+
 Value::Value()
-  : m_value{std::make_shared<VariantType>(NullType::Value)}
+  : m_type{ValueType::Null}
+  , m_identity{nextIdentity()}
 {
 }
 
 Value::Value(const BooleanType value)
-  : m_value{std::make_shared<VariantType>(value)}
+  : m_type{ValueType::Boolean}
+  , m_boolean{value}
+  , m_identity{nextIdentity()}
 {
 }
 
 Value::Value(StringType value)
-  : m_value{std::make_shared<VariantType>(std::move(value))}
+  : m_type{ValueType::String}
+  , m_shared{std::make_shared<const SharedType>(std::move(value))}
+  , m_identity{nextIdentity()}
 {
 }
 
 Value::Value(const char* value)
-  : m_value{std::make_shared<VariantType>(StringType(value))}
+  : m_type{ValueType::String}
+  , m_shared{std::make_shared<const SharedType>(StringType{value})}
+  , m_identity{nextIdentity()}
 {
 }
 
 Value::Value(const NumberType value)
-  : m_value{std::make_shared<VariantType>(value)}
+  : m_type{ValueType::Number}
+  , m_number{value}
+  , m_identity{nextIdentity()}
 {
 }
 
 Value::Value(const int value)
-  : m_value{std::make_shared<VariantType>(static_cast<NumberType>(value))}
+  : m_type{ValueType::Number}
+  , m_number{static_cast<NumberType>(value)}
+  , m_identity{nextIdentity()}
 {
 }
 
 Value::Value(const long value)
-  : m_value{std::make_shared<VariantType>(static_cast<NumberType>(value))}
+  : m_type{ValueType::Number}
+  , m_number{static_cast<NumberType>(value)}
+  , m_identity{nextIdentity()}
 {
 }
 
 Value::Value(const size_t value)
-  : m_value{std::make_shared<VariantType>(static_cast<NumberType>(value))}
+  : m_type{ValueType::Number}
+  , m_number{static_cast<NumberType>(value)}
+  , m_identity{nextIdentity()}
 {
 }
 
 Value::Value(ArrayType value)
-  : m_value{std::make_shared<VariantType>(std::move(value))}
+  : m_type{ValueType::Array}
+  , m_shared{std::make_shared<const SharedType>(std::move(value))}
+  , m_identity{nextIdentity()}
 {
 }
 
 Value::Value(MapType value)
-  : m_value{std::make_shared<VariantType>(std::move(value))}
+  : m_type{ValueType::Map}
+  , m_shared{std::make_shared<const SharedType>(std::move(value))}
+  , m_identity{nextIdentity()}
 {
 }
 
 Value::Value(RangeType value)
-  : m_value{std::make_shared<VariantType>(std::move(value))}
+  : m_type{ValueType::Range}
+  , m_shared{std::make_shared<const SharedType>(std::move(value))}
+  , m_identity{nextIdentity()}
 {
 }
 
-Value::Value(NullType value)
-  : m_value{std::make_shared<VariantType>(value)}
+Value::Value(NullType)
+  : m_type{ValueType::Null}
+  , m_identity{nextIdentity()}
 {
 }
 
-Value::Value(UndefinedType value)
-  : m_value{std::make_shared<VariantType>(value)}
+Value::Value(UndefinedType)
+  : m_type{ValueType::Undefined}
+  , m_identity{nextIdentity()}
 {
 }
 
 ValueType Value::type() const
 {
-  return std::visit(
-    kdl::overload(
-      [](const BooleanType&) { return ValueType::Boolean; },
-      [](const StringType&) { return ValueType::String; },
-      [](const NumberType&) { return ValueType::Number; },
-      [](const ArrayType&) { return ValueType::Array; },
-      [](const MapType&) { return ValueType::Map; },
-      [](const RangeType&) { return ValueType::Range; },
-      [](const NullType&) { return ValueType::Null; },
-      [](const UndefinedType&) { return ValueType::Undefined; }),
-    *m_value);
+  return m_type;
 }
 
 bool Value::hasType(ValueType type) const
@@ -145,7 +203,7 @@ std::string Value::describe() const
 
 const BooleanType& Value::booleanValue(const EvaluationContext& context) const
 {
-  return std::visit(
+  return visit(
     kdl::overload(
       [&](const BooleanType& b) -> const BooleanType& { return b; },
       [&](const NullType&) -> const BooleanType& {
@@ -155,13 +213,12 @@ const BooleanType& Value::booleanValue(const EvaluationContext& context) const
       [&](const auto&) -> const BooleanType& {
         throw DereferenceError{
           context.location(*this), describe(), type(), ValueType::String};
-      }),
-    *m_value);
+      }));
 }
 
 const StringType& Value::stringValue(const EvaluationContext& context) const
 {
-  return std::visit(
+  return visit(
     kdl::overload(
       [&](const StringType& s) -> const StringType& { return s; },
       [&](const NullType&) -> const StringType& {
@@ -171,13 +228,12 @@ const StringType& Value::stringValue(const EvaluationContext& context) const
       [&](const auto&) -> const StringType& {
         throw DereferenceError{
           context.location(*this), describe(), type(), ValueType::Boolean};
-      }),
-    *m_value);
+      }));
 }
 
 const NumberType& Value::numberValue(const EvaluationContext& context) const
 {
-  return std::visit(
+  return visit(
     kdl::overload(
       [&](const NumberType& n) -> const NumberType& { return n; },
       [&](const NullType&) -> const NumberType& {
@@ -187,8 +243,7 @@ const NumberType& Value::numberValue(const EvaluationContext& context) const
       [&](const auto&) -> const NumberType& {
         throw DereferenceError{
           context.location(*this), describe(), type(), ValueType::Boolean};
-      }),
-    *m_value);
+      }));
 }
 
 IntegerType Value::integerValue(const EvaluationContext& context) const
@@ -198,7 +253,7 @@ IntegerType Value::integerValue(const EvaluationContext& context) const
 
 const ArrayType& Value::arrayValue(const EvaluationContext& context) const
 {
-  return std::visit(
+  return visit(
     kdl::overload(
       [&](const ArrayType& a) -> const ArrayType& { return a; },
       [&](const NullType&) -> const ArrayType& {
@@ -208,13 +263,12 @@ const ArrayType& Value::arrayValue(const EvaluationContext& context) const
       [&](const auto&) -> const ArrayType& {
         throw DereferenceError{
           context.location(*this), describe(), type(), ValueType::Boolean};
-      }),
-    *m_value);
+      }));
 }
 
 const MapType& Value::mapValue(const EvaluationContext& context) const
 {
-  return std::visit(
+  return visit(
     kdl::overload(
       [&](const MapType& m) -> const MapType& { return m; },
       [&](const NullType&) -> const MapType& {
@@ -224,20 +278,18 @@ const MapType& Value::mapValue(const EvaluationContext& context) const
       [&](const auto&) -> const MapType& {
         throw DereferenceError{
           context.location(*this), describe(), type(), ValueType::Boolean};
-      }),
-    *m_value);
+      }));
 }
 
 const RangeType& Value::rangeValue(const EvaluationContext& context) const
 {
-  return std::visit(
+  return visit(
     kdl::overload(
       [&](const RangeType& r) -> const RangeType& { return r; },
       [&](const auto&) -> const RangeType& {
         throw DereferenceError{
           context.location(*this), describe(), type(), ValueType::Boolean};
-      }),
-    *m_value);
+      }));
 }
 
 std::vector<std::string> Value::asStringList(const EvaluationContext& context) const
@@ -255,7 +307,7 @@ std::vector<std::string> Value::asStringSet(const EvaluationContext& context) co
 
 size_t Value::length() const
 {
-  return std::visit(
+  return visit(
     kdl::overload(
       [](const BooleanType&) -> size_t { return 1u; },
       [](const StringType& s) -> size_t { return s.length(); },
@@ -264,13 +316,12 @@ size_t Value::length() const
       [](const MapType& m) -> size_t { return m.size(); },
       [](const RangeType&) -> size_t { return 2u; },
       [](const NullType&) -> size_t { return 0u; },
-      [](const UndefinedType&) -> size_t { return 0u; }),
-    *m_value);
+      [](const UndefinedType&) -> size_t { return 0u; }));
 }
 
 bool Value::convertibleTo(const ValueType toType) const
 {
-  return std::visit(
+  return visit(
     kdl::overload(
       [&](const BooleanType&) {
         switch (toType)
@@ -408,13 +459,12 @@ bool Value::convertibleTo(const ValueType toType) const
         }
 
         return false;
-      }),
-    *m_value);
+      }));
 }
 
 Value Value::convertTo(EvaluationContext& context, const ValueType toType) const
 {
-  return std::visit(
+  return visit(
     kdl::overload(
       [&](const BooleanType& b) -> Value {
         switch (toType)
@@ -572,8 +622,7 @@ Value Value::convertTo(EvaluationContext& context, const ValueType toType) const
         }
 
         throw ConversionError{context.location(*this), describe(), type(), toType};
-      }),
-    *m_value);
+      }));
 }
 
 std::optional<Value> Value::tryConvertTo(
@@ -599,7 +648,7 @@ std::string Value::asString(const bool multiline) const
 void Value::appendToStream(
   std::ostream& str, const bool multiline, const std::string& indent) const
 {
-  std::visit(
+  visit(
     kdl::overload(
       [&](const BooleanType& b) { str << (b ? "true" : "false"); },
       [&](const StringType& s) {
@@ -724,8 +773,7 @@ void Value::appendToStream(
         str << "]";
       },
       [&](const NullType&) { str << "null"; },
-      [&](const UndefinedType&) { str << "undefined"; }),
-    *m_value);
+      [&](const UndefinedType&) { str << "undefined"; }));
 }
 
 bool Value::contains(const EvaluationContext&, const size_t index) const
@@ -876,31 +924,31 @@ Value Value::atOrDefault(
 
 bool operator==(const Value& lhs, const Value& rhs)
 {
-  return lhs.m_value == rhs.m_value
-         || std::visit(
-           kdl::overload(
-             [](const BooleanType& lhsBool, const BooleanType& rhsBool) {
-               return lhsBool == rhsBool;
-             },
-             [](const StringType& lhsString, const StringType& rhsString) {
-               return lhsString == rhsString;
-             },
-             [](const NumberType& lhsNumber, const NumberType& rhsNumber) {
-               return lhsNumber == rhsNumber;
-             },
-             [](const ArrayType& lhsArray, const ArrayType& rhsArray) {
-               return lhsArray == rhsArray;
-             },
-             [](
-               const MapType& lhsMap, const MapType& rhsMap) { return lhsMap == rhsMap; },
-             [](const RangeType& lhsRange, const RangeType& rhsRange) {
-               return lhsRange == rhsRange;
-             },
-             [](const NullType&, const NullType&) { return true; },
-             [](const UndefinedType&, const UndefinedType&) { return true; },
-             [](const auto&, const auto&) { return false; }),
-           *lhs.m_value,
-           *rhs.m_value);
+  const auto equal = kdl::overload(
+    [](const BooleanType& lhsBool, const BooleanType& rhsBool) {
+      return lhsBool == rhsBool;
+    },
+    [](const StringType& lhsString, const StringType& rhsString) {
+      return lhsString == rhsString;
+    },
+    [](const NumberType& lhsNumber, const NumberType& rhsNumber) {
+      return lhsNumber == rhsNumber;
+    },
+    [](const ArrayType& lhsArray, const ArrayType& rhsArray) {
+      return lhsArray == rhsArray;
+    },
+    [](const MapType& lhsMap, const MapType& rhsMap) { return lhsMap == rhsMap; },
+    [](const RangeType& lhsRange, const RangeType& rhsRange) {
+      return lhsRange == rhsRange;
+    },
+    [](const NullType&, const NullType&) { return true; },
+    [](const UndefinedType&, const UndefinedType&) { return true; },
+    [](const auto&, const auto&) { return false; });
+
+  return lhs.m_identity == rhs.m_identity || lhs.visit([&](const auto& lhsValue) {
+           return rhs.visit(
+             [&](const auto& rhsValue) { return equal(lhsValue, rhsValue); });
+         });
 }
 
 bool operator!=(const Value& lhs, const Value& rhs)
@@ -22,6 +22,7 @@
 #include "el/Types.h"
 
 // FIXME: try to remove some of these headers
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
 #include <optional>
@@ -56,19 +57,29 @@ public:
   static const UndefinedType Value;
 };
 
+/**
+ * An EL value.
+ *
+ * Null, undefined, boolean and number values are stored inline. Strings, arrays, maps and
+ * ranges are immutable and shared between copies of a value.
+ *
+ * Every value has an identity that is shared by its copies, but not by equal values that
+ * were created independently. Its hash is derived from its identity so that an
+ * evaluation context can map each value to the expression that produced it.
+ */
 class Value
 {
 private:
-  using VariantType = std::variant<
-    BooleanType,
-    StringType,
-    NumberType,
-    ArrayType,
-    MapType,
-    RangeType,
-    NullType,
-    UndefinedType>;
-  std::shared_ptr<VariantType> m_value;
+  using SharedType = std::variant<StringType, ArrayType, MapType, RangeType>;
+
+  ValueType m_type;
+  union
+  {
+    BooleanType m_boolean;
+    NumberType m_number = 0.0;
+  };
+  std::shared_ptr<const SharedType> m_shared;
+  std::uint64_t m_identity;
 
 public:
   static const Value Null;
@@ -143,6 +154,11 @@ public:
   friend std::ostream& operator<<(std::ostream& lhs, const Value& rhs);
 
   friend struct std::hash<tb::el::Value>;
+  friend class EvaluationContext;
+
+private:
+  template <typename F>
+  decltype(auto) visit(const F& f) const;
 };
 
 } // namespace tb::el
@@ -153,6 +169,6 @@ struct std::hash<tb::el::Value>
 {
   std::size_t operator()(const tb::el::Value& value) const noexcept
   {
-    return std::hash<std::shared_ptr<tb::el::Value::VariantType>>{}(value.m_value);
+    return std::hash<std::uint64_t>{}(value.m_identity);
   }
 };
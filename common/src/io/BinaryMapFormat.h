@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace tb::io::BinaryMapFormat
+{
+
+/**
+ * Layout of a binary map file. All values are little endian, all offsets are relative to
+ * the start of the magic string. The file may be preceded by the map header comments
+ * written by writeMapHeader so that the game and map format can be detected just like for
+ * a .map file.
+ *
+ * Header:
+ *   char[8] magic
+ *   u32     version
+ *   u32     map format (mdl::MapFormat)
+ *   u64     string table offset
+ *   u64     chunk table offset
+ *   u32     chunk count
+ *   u32     object count
+ *
+ * String table, holding every entity property key and value and every material name:
+ *   u32     string count
+ *   per string: u32 length, followed by the characters
+ *
+ * Chunk table:
+ *   per chunk: u64 offset, u64 size, u32 index of the first object, u32 object count,
+ *              u32 index of the entity that is open at the start of the chunk, or
+ *              NoEntity
+ *
+ * Chunks contain a sequence of records. Since every chunk records which entity its
+ * brushes and patches belong to, chunks can be decoded independently of each other even
+ * if they split an entity. Entity, brush and patch records count as objects.
+ *
+ *   u8      record type
+ *   Entity: u32 property count, per property: u32 key string, u32 value string
+ *   EndEntity: no data
+ *   Brush:  u32 face count, followed by the faces
+ *   Patch:  u32 row count, u32 column count, u32 material string,
+ *           row count * column count * 5 f64 control point values
+ *
+ * Face:
+ *   f64[9]  plane points
+ *   u32     material string
+ *   f32[5]  x offset, y offset, rotation, x scale, y scale
+ *   u8      face flags
+ *   f64[6]  u axis and v axis, if the HasUVAxes flag is set
+ *   i32     surface contents, if the HasSurfaceContents flag is set
+ *   i32     surface flags, if the HasSurfaceFlags flag is set
+ *   f32     surface value, if the HasSurfaceValue flag is set
+ *   f32[4]  color, if the HasColor flag is set
+ */
+
+constexpr auto Extension = std::string_view{".tbmap"};
+constexpr auto Magic = std::string_view{"TBBINMAP"};
+constexpr auto Version = std::uint32_t(1);
+
+constexpr auto HeaderSize = Magic.size() + 2 * 4 + 2 * 8 + 2 * 4;
+constexpr auto ChunkTableEntrySize = 2 * 8 + 3 * 4;
+
+/**
+ * Chunks are closed after the first object that makes them exceed this size.
+ */
+constexpr auto ChunkSize = std::uint64_t(256 * 1024);
+
+constexpr auto NoEntity = std::uint32_t(0xffffffff);
+
+namespace RecordType
+{
+constexpr auto Entity = std::uint8_t(1);
+constexpr auto EndEntity = std::uint8_t(2);
+constexpr auto Brush = std::uint8_t(3);
+constexpr auto Patch = std::uint8_t(4);
+} // namespace RecordType
+
+namespace FaceFlags
+{
+constexpr auto HasUVAxes = std::uint8_t(1 << 0);
+constexpr auto HasSurfaceContents = std::uint8_t(1 << 1);
+constexpr auto HasSurfaceFlags = std::uint8_t(1 << 2);
+constexpr auto HasSurfaceValue = std::uint8_t(1 << 3);
+constexpr auto HasColor = std::uint8_t(1 << 4);
+} // namespace FaceFlags
+
+} // namespace tb::io::BinaryMapFormat
@@ -0,0 +1,461 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BinaryMapReader.h"
+
+#include "FileLocation.h"
+#include "io/BinaryMapFormat.h"
+#include "io/ParserStatus.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+#include "io/WorldReader.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushFaceAttributes.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/MapFormat.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/result_fold.h"
+#include "kdl/task_manager.h"
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+namespace tb::io
+{
+namespace
+{
+
+struct ChunkInfo
+{
+  std::uint64_t offset;
+  std::uint64_t size;
+  std::uint32_t firstObjectIndex;
+  std::uint32_t objectCount;
+  std::uint32_t entityIndex;
+};
+
+struct DecodedChunk
+{
+  std::vector<MapReader::ObjectInfo> objectInfos;
+  std::vector<std::tuple<size_t, FileLocation>> entityEndLocations;
+  std::vector<std::tuple<FileLocation, std::string>> errors;
+};
+
+std::optional<size_t> findMagic(const std::string_view data)
+{
+  // skip the map header comments
+  auto position = size_t(0);
+  while (data.substr(position).starts_with("//"))
+  {
+    position = data.find('\n', position);
+    if (position == std::string_view::npos)
+    {
+      return std::nullopt;
+    }
+    ++position;
+  }
+
+  return data.substr(position).starts_with(BinaryMapFormat::Magic)
+           ? std::optional{position}
+           : std::nullopt;
+}
+
+// the smallest number of bytes that the records counted in the file can occupy
+constexpr auto MinStringSize = sizeof(std::uint32_t);
+constexpr auto MinObjectSize = sizeof(std::uint8_t);
+constexpr auto MinPropertySize = 2 * sizeof(std::uint32_t);
+constexpr auto MinFaceSize =
+  9 * sizeof(double) + sizeof(std::uint32_t) + 5 * sizeof(float) + sizeof(std::uint8_t);
+constexpr auto ControlPointSize = 5 * sizeof(double);
+
+/**
+ * Throws a ReaderException unless the remaining data can hold the given number of
+ * elements of the given minimal size. Counts read from the file must be checked before
+ * they are used to allocate memory, since a corrupt file could contain any value.
+ */
+void checkCount(const Reader& reader, const size_t count, const size_t minElementSize)
+{
+  const auto remaining = reader.size() - reader.position();
+  if (count > remaining / minElementSize)
+  {
+    throw ReaderException{fmt::format("Invalid count {}", count)};
+  }
+}
+
+std::vector<std::string> readStringTable(Reader reader)
+{
+  const auto count = reader.readSize<std::uint32_t>();
+  checkCount(reader, count, MinStringSize);
+
+  auto result = std::vector<std::string>{};
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto length = reader.readSize<std::uint32_t>();
+    if (!reader.canRead(length))
+    {
+      throw ReaderException{"Invalid string length"};
+    }
+
+    auto& str = result.emplace_back(length, '\0');
+    reader.read(str.data(), length);
+  }
+  return result;
+}
+
+const std::string& readString(Reader& reader, const std::vector<std::string>& strings)
+{
+  const auto index = reader.readSize<std::uint32_t>();
+  if (index >= strings.size())
+  {
+    throw ReaderException{fmt::format("Invalid string index {}", index)};
+  }
+  return strings[index];
+}
+
+Result<mdl::BrushFace> readFace(
+  Reader& reader, const std::vector<std::string>& strings, const mdl::MapFormat mapFormat)
+{
+  const auto point1 = reader.readVec<double, 3>();
+  const auto point2 = reader.readVec<double, 3>();
+  const auto point3 = reader.readVec<double, 3>();
+
+  auto attributes = mdl::BrushFaceAttributes{readString(reader, strings)};
+  attributes.setXOffset(reader.readFloat<float>());
+  attributes.setYOffset(reader.readFloat<float>());
+  attributes.setRotation(reader.readFloat<float>());
+  attributes.setXScale(reader.readFloat<float>());
+  attributes.setYScale(reader.readFloat<float>());
+
+  const auto flags = reader.readUnsignedChar<std::uint8_t>();
+  const auto hasFlag = [&](const auto flag) { return (flags & flag) != 0; };
+
+  auto uvAxes = std::optional<std::tuple<vm::vec3d, vm::vec3d>>{};
+  if (hasFlag(BinaryMapFormat::FaceFlags::HasUVAxes))
+  {
+    const auto uAxis = reader.readVec<double, 3>();
+    const auto vAxis = reader.readVec<double, 3>();
+    uvAxes = {uAxis, vAxis};
+  }
+  if (hasFlag(BinaryMapFormat::FaceFlags::HasSurfaceContents))
+  {
+    attributes.setSurfaceContents(reader.readInt<std::int32_t>());
+  }
+  if (hasFlag(BinaryMapFormat::FaceFlags::HasSurfaceFlags))
+  {
+    attributes.setSurfaceFlags(reader.readInt<std::int32_t>());
+  }
+  if (hasFlag(BinaryMapFormat::FaceFlags::HasSurfaceValue))
+  {
+    attributes.setSurfaceValue(reader.readFloat<float>());
+  }
+  if (hasFlag(BinaryMapFormat::FaceFlags::HasColor))
+  {
+    attributes.setColor(Color{reader.readVec<float, 4>()});
+  }
+
+  if (uvAxes)
+  {
+    const auto& [uAxis, vAxis] = *uvAxes;
+    return mdl::BrushFace::createFromValve(
+      point1, point2, point3, attributes, uAxis, vAxis, mapFormat);
+  }
+  return mdl::BrushFace::createFromStandard(
+    point1, point2, point3, attributes, mapFormat);
+}
+
+/**
+ * Decodes the objects of a chunk. Only called from worker threads, so errors about
+ * individual faces are collected and reported by the caller. Since an entity can span
+ * several chunks, the end locations of entities are also collected and applied by the
+ * caller.
+ */
+Result<DecodedChunk> readChunk(
+  Reader reader,
+  const ChunkInfo& chunkInfo,
+  const std::vector<std::string>& strings,
+  const mdl::MapFormat mapFormat)
+{
+  try
+  {
+    auto result = DecodedChunk{};
+    auto& objectInfos = result.objectInfos;
+    checkCount(reader, chunkInfo.objectCount, MinObjectSize);
+    objectInfos.reserve(chunkInfo.objectCount);
+
+    auto currentEntityIndex =
+      chunkInfo.entityIndex != BinaryMapFormat::NoEntity
+        ? std::optional<size_t>{chunkInfo.entityIndex}
+        : std::nullopt;
+    const auto nextLocation = [&]() {
+      return FileLocation{chunkInfo.firstObjectIndex + objectInfos.size() + 1};
+    };
+
+    while (!reader.eof())
+    {
+      const auto recordType = reader.readUnsignedChar<std::uint8_t>();
+      switch (recordType)
+      {
+      case BinaryMapFormat::RecordType::Entity: {
+        const auto location = nextLocation();
+        const auto propertyCount = reader.readSize<std::uint32_t>();
+        checkCount(reader, propertyCount, MinPropertySize);
+
+        auto properties = std::vector<mdl::EntityProperty>{};
+        properties.reserve(propertyCount);
+        for (size_t i = 0; i < propertyCount; ++i)
+        {
+          const auto& key = readString(reader, strings);
+          const auto& value = readString(reader, strings);
+          properties.emplace_back(key, value);
+        }
+
+        currentEntityIndex = chunkInfo.firstObjectIndex + objectInfos.size();
+        objectInfos.emplace_back(
+          MapReader::EntityInfo{std::move(properties), location, std::nullopt});
+        break;
+      }
+      case BinaryMapFormat::RecordType::EndEntity: {
+        if (!currentEntityIndex)
+        {
+          return Error{"Unexpected end of entity"};
+        }
+
+        result.entityEndLocations.emplace_back(
+          *currentEntityIndex,
+          FileLocation{chunkInfo.firstObjectIndex + objectInfos.size()});
+        currentEntityIndex = std::nullopt;
+        break;
+      }
+      case BinaryMapFormat::RecordType::Brush: {
+        const auto location = nextLocation();
+        const auto faceCount = reader.readSize<std::uint32_t>();
+        checkCount(reader, faceCount, MinFaceSize);
+
+        auto faces = std::vector<mdl::BrushFace>{};
+        faces.reserve(faceCount);
+        for (size_t i = 0; i < faceCount; ++i)
+        {
+          readFace(reader, strings, mapFormat) | kdl::transform([&](auto face) {
+            face.setFilePosition(location.line, 1);
+            faces.push_back(std::move(face));
+          }) | kdl::transform_error([&](auto e) {
+            result.errors.emplace_back(location, fmt::format("Skipping face: {}", e.msg));
+          });
+        }
+
+        objectInfos.emplace_back(MapReader::BrushInfo{
+          std::move(faces), location, location, currentEntityIndex});
+        break;
+      }
+      case BinaryMapFormat::RecordType::Patch: {
+        const auto location = nextLocation();
+        const auto rowCount = reader.readSize<std::uint32_t>();
+        const auto columnCount = reader.readSize<std::uint32_t>();
+        auto materialName = readString(reader, strings);
+        checkCount(reader, rowCount * columnCount, ControlPointSize);
+
+        auto controlPoints = std::vector<mdl::BezierPatch::Point>{};
+        controlPoints.reserve(rowCount * columnCount);
+        for (size_t i = 0; i < rowCount * columnCount; ++i)
+        {
+          controlPoints.push_back(reader.readVec<double, 5>());
+        }
+
+        objectInfos.emplace_back(MapReader::PatchInfo{
+          rowCount,
+          columnCount,
+          std::move(controlPoints),
+          std::move(materialName),
+          location,
+          location,
+          currentEntityIndex});
+        break;
+      }
+      default:
+        return Error{fmt::format("Unknown record type {}", recordType)};
+      }
+    }
+
+    if (objectInfos.size() != chunkInfo.objectCount)
+    {
+      return Error{fmt::format(
+        "Expected {} objects in chunk, but found {}",
+        chunkInfo.objectCount,
+        objectInfos.size())};
+    }
+
+    return result;
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
+} // namespace
+
+bool isBinaryMap(const std::string_view data)
+{
+  return findMagic(data) != std::nullopt;
+}
+
+Result<std::unique_ptr<mdl::WorldNode>> readBinaryMap(
+  const std::string_view data,
+  const vm::bbox3d& worldBounds,
+  const mdl::EntityPropertyConfig& entityPropertyConfig,
+  ParserStatus& status,
+  kdl::task_manager& taskManager)
+{
+  const auto magicPosition = findMagic(data);
+  if (!magicPosition)
+  {
+    return Error{"Not a binary map"};
+  }
+
+  const auto mapData = data.substr(*magicPosition);
+
+  try
+  {
+    auto reader = Reader::from(mapData.data(), mapData.data() + mapData.size());
+    reader.seekFromBegin(BinaryMapFormat::Magic.size());
+
+    const auto version = reader.readUnsignedInt<std::uint32_t>();
+    if (version != BinaryMapFormat::Version)
+    {
+      return Error{fmt::format("Unsupported binary map version {}", version)};
+    }
+
+    const auto mapFormat =
+      static_cast<mdl::MapFormat>(reader.readUnsignedInt<std::uint32_t>());
+    if (mapFormat <= mdl::MapFormat::Unknown || mapFormat > mdl::MapFormat::Quake3)
+    {
+      return Error{"Unknown map format"};
+    }
+
+    const auto stringTableOffset = reader.readSize<std::uint64_t>();
+    const auto chunkTableOffset = reader.readSize<std::uint64_t>();
+    const auto chunkCount = reader.readSize<std::uint32_t>();
+    const auto objectCount = reader.readSize<std::uint32_t>();
+    checkCount(reader, objectCount, MinObjectSize);
+
+    const auto strings = readStringTable(reader.subReaderFromBegin(stringTableOffset));
+
+    reader.seekFromBegin(chunkTableOffset);
+    checkCount(reader, chunkCount, BinaryMapFormat::ChunkTableEntrySize);
+
+    auto chunkInfos = std::vector<ChunkInfo>{};
+    chunkInfos.reserve(chunkCount);
+    auto expectedFirstObjectIndex = size_t(0);
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+      auto chunkInfo = ChunkInfo{};
+      chunkInfo.offset = reader.readSize<std::uint64_t>();
+      chunkInfo.size = reader.readSize<std::uint64_t>();
+      chunkInfo.firstObjectIndex = reader.readUnsignedInt<std::uint32_t>();
+      chunkInfo.objectCount = reader.readUnsignedInt<std::uint32_t>();
+      chunkInfo.entityIndex = reader.readUnsignedInt<std::uint32_t>();
+
+      if (
+        chunkInfo.firstObjectIndex != expectedFirstObjectIndex
+        || (chunkInfo.entityIndex != BinaryMapFormat::NoEntity
+            && chunkInfo.entityIndex >= chunkInfo.firstObjectIndex))
+      {
+        return Error{fmt::format("Invalid chunk {}", i)};
+      }
+
+      expectedFirstObjectIndex += chunkInfo.objectCount;
+      chunkInfos.push_back(chunkInfo);
+    }
+
+    if (expectedFirstObjectIndex != objectCount)
+    {
+      return Error{"Invalid object count"};
+    }
+
+    auto tasks = chunkInfos | std::views::transform([&](const auto& chunkInfo) {
+                   return std::function{[&]() {
+                     return readChunk(
+                       reader.subReaderFromBegin(chunkInfo.offset, chunkInfo.size),
+                       chunkInfo,
+                       strings,
+                       mapFormat);
+                   }};
+                 });
+
+    return taskManager.run_tasks_and_wait(std::move(tasks)) | kdl::fold
+           | kdl::and_then(
+             [&](auto decodedChunks) -> Result<std::unique_ptr<mdl::WorldNode>> {
+                 auto objectInfos = std::vector<MapReader::ObjectInfo>{};
+                 objectInfos.reserve(objectCount);
+
+                 for (auto& decodedChunk : decodedChunks)
+                 {
+                   for (const auto& [location, error] : decodedChunk.errors)
+                   {
+                     status.error(location, error);
+                   }
+                   std::move(
+                     decodedChunk.objectInfos.begin(),
+                     decodedChunk.objectInfos.end(),
+                     std::back_inserter(objectInfos));
+                 }
+
+                 const auto isEntity = [&](const size_t index) {
+                   return std::holds_alternative<MapReader::EntityInfo>(objectInfos[index]);
+                 };
+
+                 for (size_t i = 0; i < decodedChunks.size(); ++i)
+                 {
+                   const auto entityIndex = chunkInfos[i].entityIndex;
+                   if (entityIndex != BinaryMapFormat::NoEntity && !isEntity(entityIndex))
+                   {
+                     return Error{fmt::format("Invalid chunk {}", i)};
+                   }
+
+                   for (const auto& [index, location] :
+                        decodedChunks[i].entityEndLocations)
+                   {
+                     std::get<MapReader::EntityInfo>(objectInfos[index]).endLocation =
+                       location;
+                   }
+                 }
+
+                 auto worldReader = WorldReader{"", mapFormat, entityPropertyConfig};
+                 return worldReader.read(
+                   std::move(objectInfos), worldBounds, status, taskManager);
+               });
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
+} // namespace tb::io
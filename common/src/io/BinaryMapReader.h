@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include "vm/bbox.h"
+
+#include <memory>
+#include <string_view>
+
+namespace kdl
+{
+class task_manager;
+}
+
+namespace tb::mdl
+{
+struct EntityPropertyConfig;
+class WorldNode;
+} // namespace tb::mdl
+
+namespace tb::io
+{
+class ParserStatus;
+
+/**
+ * Indicates whether the given data contains a binary map, possibly preceded by map header
+ * comments.
+ */
+bool isBinaryMap(std::string_view data);
+
+/**
+ * Reads a world from the given binary map data. The map format is taken from the binary
+ * map. The chunks of the binary map are decoded in parallel, and the resulting objects
+ * are turned into nodes in the same way as when reading a .map file.
+ */
+Result<std::unique_ptr<mdl::WorldNode>> readBinaryMap(
+  std::string_view data,
+  const vm::bbox3d& worldBounds,
+  const mdl::EntityPropertyConfig& entityPropertyConfig,
+  ParserStatus& status,
+  kdl::task_manager& taskManager);
+
+} // namespace tb::io
@@ -0,0 +1,296 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BinaryMapSerializer.h"
+
+#include "Ensure.h"
+#include "io/BinaryWriter.h"
+#include "mdl/BezierPatch.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/PatchNode.h"
+
+#include <cassert>
+#include <ostream>
+
+namespace tb::io
+{
+namespace
+{
+
+bool hasUVAxes(const mdl::MapFormat mapFormat)
+{
+  return mapFormat == mdl::MapFormat::Valve || mapFormat == mdl::MapFormat::Quake2_Valve
+         || mapFormat == mdl::MapFormat::Quake3_Valve;
+}
+
+} // namespace
+
+BinaryMapSerializer::BinaryMapSerializer(
+  std::ostream& stream, const mdl::MapFormat mapFormat)
+  : m_stream{stream}
+  , m_mapFormat{mapFormat}
+{
+}
+
+BinaryMapSerializer::~BinaryMapSerializer() = default;
+
+void BinaryMapSerializer::doBeginFile(
+  const std::vector<const mdl::Node*>& /* rootNodes */,
+  kdl::task_manager& /* taskManager */)
+{
+  ensure(m_objectCount == 0, "BinaryMapSerializer may not be reused");
+}
+
+void BinaryMapSerializer::doEndFile()
+{
+  closeChunk();
+
+  auto stringTable = FormatBuffer{};
+  writeValue(stringTable, static_cast<std::uint32_t>(m_strings.size()));
+  for (const auto* str : m_strings)
+  {
+    writeValue(stringTable, static_cast<std::uint32_t>(str->size()));
+    stringTable.append(*str);
+  }
+
+  const auto stringTableOffset = std::uint64_t(BinaryMapFormat::HeaderSize);
+  const auto chunkTableOffset = stringTableOffset + stringTable.size();
+  const auto chunkDataOffset =
+    chunkTableOffset + m_chunks.size() * BinaryMapFormat::ChunkTableEntrySize;
+
+  auto header = FormatBuffer{};
+  header.append(BinaryMapFormat::Magic);
+  writeValue(header, BinaryMapFormat::Version);
+  writeValue(header, static_cast<std::uint32_t>(m_mapFormat));
+  writeValue(header, stringTableOffset);
+  writeValue(header, chunkTableOffset);
+  writeValue(header, static_cast<std::uint32_t>(m_chunks.size()));
+  writeValue(header, m_objectCount);
+  assert(header.size() == BinaryMapFormat::HeaderSize);
+
+  auto chunkTable = FormatBuffer{};
+  for (const auto& chunk : m_chunks)
+  {
+    writeValue(chunkTable, chunkDataOffset + chunk.offset);
+    writeValue(chunkTable, chunk.size);
+    writeValue(chunkTable, chunk.firstObjectIndex);
+    writeValue(chunkTable, chunk.objectCount);
+    writeValue(chunkTable, chunk.entityIndex);
+  }
+
+  for (const auto* buffer : {&header, &stringTable, &chunkTable, &m_chunkData})
+  {
+    const auto data = buffer->view();
+    m_stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+  }
+}
+
+void BinaryMapSerializer::doBeginEntity(const mdl::Node* /* node */)
+{
+  m_pendingEntityProperties = std::vector<mdl::EntityProperty>{};
+}
+
+void BinaryMapSerializer::doEndEntity(const mdl::Node* node)
+{
+  writePendingEntity();
+  writeValue(m_chunkData, BinaryMapFormat::RecordType::EndEntity);
+
+  node->setFilePosition(m_entityObjectIndex + 1, m_objectCount - m_entityObjectIndex);
+  m_entityObjectIndex = BinaryMapFormat::NoEntity;
+
+  closeChunkIfFull();
+}
+
+void BinaryMapSerializer::doEntityProperty(const mdl::EntityProperty& property)
+{
+  assert(m_pendingEntityProperties);
+  m_pendingEntityProperties->push_back(property);
+}
+
+void BinaryMapSerializer::doBrush(const mdl::BrushNode* brushNode)
+{
+  writePendingEntity();
+
+  const auto objectIndex = beginObject();
+  const auto& brush = brushNode->brush();
+
+  writeValue(m_chunkData, BinaryMapFormat::RecordType::Brush);
+  writeValue(m_chunkData, static_cast<std::uint32_t>(brush.faceCount()));
+  for (const auto& face : brush.faces())
+  {
+    writeFace(face);
+  }
+
+  brushNode->setFilePosition(objectIndex + 1, 1);
+
+  closeChunkIfFull();
+}
+
+void BinaryMapSerializer::doBrushFace(const mdl::BrushFace& /* face */)
+{
+  ensure(false, "individual brush faces cannot be written to a binary map");
+}
+
+void BinaryMapSerializer::doPatch(const mdl::PatchNode* patchNode)
+{
+  writePendingEntity();
+
+  const auto objectIndex = beginObject();
+  const auto& patch = patchNode->patch();
+
+  writeValue(m_chunkData, BinaryMapFormat::RecordType::Patch);
+  writeValue(m_chunkData, static_cast<std::uint32_t>(patch.pointRowCount()));
+  writeValue(m_chunkData, static_cast<std::uint32_t>(patch.pointColumnCount()));
+  writeValue(m_chunkData, intern(patch.materialName()));
+  for (const auto& controlPoint : patch.controlPoints())
+  {
+    writeVec(m_chunkData, controlPoint);
+  }
+
+  patchNode->setFilePosition(objectIndex + 1, 1);
+
+  closeChunkIfFull();
+}
+
+void BinaryMapSerializer::writePendingEntity()
+{
+  if (m_pendingEntityProperties)
+  {
+    m_entityObjectIndex = beginObject();
+
+    writeValue(m_chunkData, BinaryMapFormat::RecordType::Entity);
+    writeValue(
+      m_chunkData, static_cast<std::uint32_t>(m_pendingEntityProperties->size()));
+    for (const auto& property : *m_pendingEntityProperties)
+    {
+      writeValue(m_chunkData, intern(property.key()));
+      writeValue(m_chunkData, intern(property.value()));
+    }
+
+    m_pendingEntityProperties = std::nullopt;
+  }
+}
+
+void BinaryMapSerializer::writeFace(const mdl::BrushFace& face)
+{
+  const auto& attributes = face.attributes();
+
+  for (const auto& point : face.points())
+  {
+    writeVec(m_chunkData, point);
+  }
+
+  writeValue(m_chunkData, intern(attributes.materialName()));
+  writeValue(m_chunkData, attributes.xOffset());
+  writeValue(m_chunkData, attributes.yOffset());
+  writeValue(m_chunkData, attributes.rotation());
+  writeValue(m_chunkData, attributes.xScale());
+  writeValue(m_chunkData, attributes.yScale());
+
+  auto flags = std::uint8_t(0);
+  if (hasUVAxes(m_mapFormat))
+  {
+    flags |= BinaryMapFormat::FaceFlags::HasUVAxes;
+  }
+  if (attributes.surfaceContents())
+  {
+    flags |= BinaryMapFormat::FaceFlags::HasSurfaceContents;
+  }
+  if (attributes.surfaceFlags())
+  {
+    flags |= BinaryMapFormat::FaceFlags::HasSurfaceFlags;
+  }
+  if (attributes.surfaceValue())
+  {
+    flags |= BinaryMapFormat::FaceFlags::HasSurfaceValue;
+  }
+  if (attributes.color())
+  {
+    flags |= BinaryMapFormat::FaceFlags::HasColor;
+  }
+  writeValue(m_chunkData, flags);
+
+  if (hasUVAxes(m_mapFormat))
+  {
+    writeVec(m_chunkData, face.uAxis());
+    writeVec(m_chunkData, face.vAxis());
+  }
+  if (const auto& surfaceContents = attributes.surfaceContents())
+  {
+    writeValue(m_chunkData, static_cast<std::int32_t>(*surfaceContents));
+  }
+  if (const auto& surfaceFlags = attributes.surfaceFlags())
+  {
+    writeValue(m_chunkData, static_cast<std::int32_t>(*surfaceFlags));
+  }
+  if (const auto& surfaceValue = attributes.surfaceValue())
+  {
+    writeValue(m_chunkData, *surfaceValue);
+  }
+  if (const auto& color = attributes.color())
+  {
+    writeVec(m_chunkData, *color);
+  }
+}
+
+void BinaryMapSerializer::closeChunkIfFull()
+{
+  if (m_chunkData.size() - m_chunkOffset >= BinaryMapFormat::ChunkSize)
+  {
+    closeChunk();
+  }
+}
+
+void BinaryMapSerializer::closeChunk()
+{
+  const auto chunkEnd = std::uint64_t(m_chunkData.size());
+  if (chunkEnd > m_chunkOffset)
+  {
+    m_chunks.push_back(ChunkInfo{
+      m_chunkOffset,
+      chunkEnd - m_chunkOffset,
+      m_chunkFirstObjectIndex,
+      m_objectCount - m_chunkFirstObjectIndex,
+      m_chunkEntityIndex});
+
+    m_chunkOffset = chunkEnd;
+    m_chunkFirstObjectIndex = m_objectCount;
+    m_chunkEntityIndex = m_entityObjectIndex;
+  }
+}
+
+std::uint32_t BinaryMapSerializer::beginObject()
+{
+  return m_objectCount++;
+}
+
+std::uint32_t BinaryMapSerializer::intern(const std::string& str)
+{
+  const auto [it, inserted] =
+    m_stringIndices.emplace(str, static_cast<std::uint32_t>(m_strings.size()));
+  if (inserted)
+  {
+    m_strings.push_back(&it->first);
+  }
+  return it->second;
+}
+
+} // namespace tb::io
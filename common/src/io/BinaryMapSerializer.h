@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "io/BinaryMapFormat.h"
+#include "io/FormatBuffer.h"
+#include "io/NodeSerializer.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/MapFormat.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::mdl
+{
+class BrushFace;
+class Node;
+} // namespace tb::mdl
+
+namespace tb::io
+{
+
+/**
+ * Serializes nodes into the binary map format described in BinaryMapFormat.h.
+ *
+ * The binary format stores the same information as a .map file in the given map format,
+ * so converting a map between the two formats is lossless. Only whole entities, brushes
+ * and patches can be serialized; serializing individual brush faces is not supported.
+ */
+class BinaryMapSerializer : public NodeSerializer
+{
+private:
+  struct ChunkInfo
+  {
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint32_t firstObjectIndex;
+    std::uint32_t objectCount;
+    std::uint32_t entityIndex;
+  };
+
+  std::ostream& m_stream;
+  mdl::MapFormat m_mapFormat;
+
+  std::unordered_map<std::string, std::uint32_t> m_stringIndices;
+  std::vector<const std::string*> m_strings;
+
+  FormatBuffer m_chunkData;
+  std::vector<ChunkInfo> m_chunks;
+  std::uint64_t m_chunkOffset = 0;
+  std::uint32_t m_chunkFirstObjectIndex = 0;
+  std::uint32_t m_chunkEntityIndex = BinaryMapFormat::NoEntity;
+  std::uint32_t m_objectCount = 0;
+
+  std::optional<std::vector<mdl::EntityProperty>> m_pendingEntityProperties;
+  std::uint32_t m_entityObjectIndex = BinaryMapFormat::NoEntity;
+
+public:
+  BinaryMapSerializer(std::ostream& stream, mdl::MapFormat mapFormat);
+  ~BinaryMapSerializer() override;
+
+private:
+  void doBeginFile(
+    const std::vector<const mdl::Node*>& rootNodes,
+    kdl::task_manager& taskManager) override;
+  void doEndFile() override;
+
+  void doBeginEntity(const mdl::Node* node) override;
+  void doEndEntity(const mdl::Node* node) override;
+  void doEntityProperty(const mdl::EntityProperty& property) override;
+  void doBrush(const mdl::BrushNode* brushNode) override;
+  void doBrushFace(const mdl::BrushFace& face) override;
+
+  void doPatch(const mdl::PatchNode* patchNode) override;
+
+private:
+  void writePendingEntity();
+  void writeFace(const mdl::BrushFace& face);
+  void closeChunkIfFull();
+  void closeChunk();
+  std::uint32_t beginObject();
+  std::uint32_t intern(const std::string& str);
+};
+
+} // namespace tb::io
@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "io/FormatBuffer.h"
+
+#include "vm/vec.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+
+namespace tb::io
+{
+
+// Binary files written by TrenchBroom are stored in native byte order and read back
+// without conversion, so they are only portable between little endian platforms.
+static_assert(
+  std::endian::native == std::endian::little,
+  "binary files are only supported on little endian platforms");
+
+/**
+ * Appends the bytes of the given trivially copyable value to the given buffer.
+ */
+template <typename T>
+void writeValue(FormatBuffer& buffer, const T value)
+{
+  buffer.write(sizeof(T), [&](char* out) {
+    std::memcpy(out, &value, sizeof(T));
+    return out + sizeof(T);
+  });
+}
+
+/**
+ * Appends the components of the given vector to the given buffer.
+ */
+template <typename T, size_t S>
+void writeVec(FormatBuffer& buffer, const vm::vec<T, S>& vec)
+{
+  for (size_t i = 0; i < S; ++i)
+  {
+    writeValue(buffer, vec[i]);
+  }
+}
+
+} // namespace tb::io
@@ -1,5 +1,5 @@
 /*
- Copyright (C) 2024 Kristian Duske
+ Copyright (C) 2025 Kristian Duske
 
  This file is part of TrenchBroom.
 
@@ -17,43 +17,33 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#pragma once
+#include "BufferedParserStatus.h"
 
 #include <string>
-#include <string_view>
-#include <vector>
 
-namespace tb
+namespace tb::io
 {
-enum class LogLevel;
-}
 
-namespace tb::ui
+NullLogger BufferedParserStatus::_logger;
+
+BufferedParserStatus::BufferedParserStatus(const ParserStatus& target)
+  : ParserStatus{_logger, target.m_prefix}
 {
+}
 
-class LoggerCache
+void BufferedParserStatus::forwardTo(ParserStatus& target) const
 {
-private:
-  struct Message
+  for (const auto& [level, str] : m_messages)
   {
-    LogLevel level;
-    std::string str;
-  };
-
-  std::vector<Message> m_cachedMessages;
+    target.doLog(level, str);
+  }
+}
 
-public:
-  void cacheMessage(LogLevel level, std::string_view message);
+void BufferedParserStatus::doProgress(const double /* progress */) {}
 
-  template <typename F>
-  void getCachedMessages(const F& f)
-  {
-    for (const auto& message : m_cachedMessages)
-    {
-      f(message.level, message.str);
-    }
-    m_cachedMessages.clear();
-  }
-};
+void BufferedParserStatus::doLog(const LogLevel level, const std::string& str)
+{
+  m_messages.emplace_back(level, str);
+}
 
-} // namespace tb::ui
+} // namespace tb::io
@@ -0,0 +1,53 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Logger.h"
+#include "io/ParserStatus.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tb::io
+{
+
+/**
+ * Records all messages so that they can be forwarded to the given target status later,
+ * e.g. after parsing on a worker thread. Messages are formatted using the target's prefix.
+ * Progress is not recorded.
+ */
+class BufferedParserStatus : public ParserStatus
+{
+private:
+  static NullLogger _logger;
+  std::vector<std::pair<LogLevel, std::string>> m_messages;
+
+public:
+  explicit BufferedParserStatus(const ParserStatus& target);
+
+  void forwardTo(ParserStatus& target) const;
+
+private:
+  void doProgress(double progress) override;
+  void doLog(LogLevel level, const std::string& str) override;
+};
+
+} // namespace tb::io
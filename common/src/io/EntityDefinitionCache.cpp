@@ -0,0 +1,954 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityDefinitionCache.h"
+
+#include "FileLocation.h"
+#include "Macros.h"
+#include "el/EvaluationContext.h"
+#include "el/Expression.h"
+#include "el/Value.h"
+#include "io/BinaryWriter.h"
+#include "io/DiskIO.h"
+#include "io/File.h"
+#include "io/FormatBuffer.h"
+#include "io/PathMatcher.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+#include "io/TraversalMode.h"
+#include "mdl/EntityDefinition.h"
+#include "mdl/PropertyDefinition.h"
+
+#include "kdl/hash_utils.h"
+#include "kdl/overload.h"
+#include "kdl/path_utils.h"
+#include "kdl/result.h"
+#include "kdl/result_fold.h"
+#include "kdl/vector_utils.h"
+
+#include <fmt/format.h>
+#include <fmt/std.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace tb::io
+{
+namespace
+{
+
+/*
+ * Layout of a cache file. All values are little endian, strings are stored as a u32
+ * length followed by the characters, optional values are stored as a u8 flag followed by
+ * the value if the flag is set.
+ *
+ * Header:
+ *   char[8] magic
+ *   u32     version
+ *   f32[4]  default entity color
+ *   u32     input file count, the entity definition file comes first
+ *   per input file: string path, u8 exists, u64 size, u64 hash of the contents
+ *   u32     entity definition count
+ *
+ * Entity definition:
+ *   u8      type (mdl::EntityDefinitionType)
+ *   string  name
+ *   f32[4]  color
+ *   string  description
+ *   u32     property definition count, followed by the property definitions
+ *   f64[6]  bounds, point entity definitions only
+ *   model expression and decal expression, point entity definitions only
+ *
+ * Property definition:
+ *   u8      kind (PropertyKind)
+ *   string  key, short description, long description
+ *   u8      read only
+ *   String, Unknown, Boolean, Integer, Float: optional default value
+ *   Choice: u32 option count, per option: string value, string description,
+ *           optional string default value
+ *   Flags:  u32 option count, per option: i32 value, string short description,
+ *           string long description, u8 is default
+ *
+ * Expression:
+ *   u8      kind (index of the alternative in el::Expression)
+ *   optional location: u64 line, optional u64 column
+ *   followed by the value, variable name, operation or operands of the expression
+ *
+ * Value:
+ *   u8      type (el::ValueType) followed by the value
+ */
+
+constexpr auto Magic = std::string_view{"TBDEFCCH"};
+constexpr auto Version = std::uint32_t(1);
+constexpr auto Extension = std::string_view{".tbdefcache"};
+
+// type, name, color, description and property definition count
+constexpr auto MinEntityDefinitionSize = sizeof(std::uint8_t) + 2 * sizeof(std::uint32_t)
+                                         + 4 * sizeof(float) + sizeof(std::uint32_t);
+
+enum class PropertyKind : std::uint8_t
+{
+  TargetSource,
+  TargetDestination,
+  String,
+  Boolean,
+  Integer,
+  Float,
+  Choice,
+  Flags,
+  Unknown,
+};
+
+enum class ExpressionKind : std::uint8_t
+{
+  Literal,
+  Variable,
+  Array,
+  Map,
+  Unary,
+  Binary,
+  Subscript,
+  Switch,
+};
+
+enum class RangeKind : std::uint8_t
+{
+  LeftBounded,
+  RightBounded,
+  Bounded,
+};
+
+std::string pathToString(const std::filesystem::path& path)
+{
+  const auto str = path.u8string();
+  return std::string{str.begin(), str.end()};
+}
+
+std::filesystem::path pathFromString(const std::string& str)
+{
+  return std::filesystem::path{std::u8string{str.begin(), str.end()}};
+}
+
+struct InputFileInfo
+{
+  std::filesystem::path path;
+  bool exists;
+  std::uint64_t size;
+  std::uint64_t hash;
+
+  friend bool operator==(const InputFileInfo&, const InputFileInfo&) = default;
+};
+
+InputFileInfo getInputFileInfo(const std::filesystem::path& path)
+{
+  return Disk::openFile(path) | kdl::transform([&](auto file) {
+           auto reader = file->reader().buffer();
+           const auto contents = reader.stringView();
+           return InputFileInfo{path, true, contents.size(), kdl::fnv1a_64(contents)};
+         })
+         | kdl::transform_error([&](auto) { return InputFileInfo{path, false, 0, 0}; })
+         | kdl::value();
+}
+
+// Writing
+
+void writeBool(FormatBuffer& buffer, const bool b)
+{
+  writeValue(buffer, std::uint8_t(b ? 1 : 0));
+}
+
+void writeSize(FormatBuffer& buffer, const size_t size)
+{
+  writeValue(buffer, static_cast<std::uint32_t>(size));
+}
+
+void writeString(FormatBuffer& buffer, const std::string_view str)
+{
+  writeSize(buffer, str.size());
+  buffer.append(str);
+}
+
+void writeInputFileInfo(FormatBuffer& buffer, const InputFileInfo& info)
+{
+  writeString(buffer, pathToString(info.path));
+  writeBool(buffer, info.exists);
+  writeValue(buffer, info.size);
+  writeValue(buffer, info.hash);
+}
+
+void writeELValue(
+  FormatBuffer& buffer, const el::EvaluationContext& context, const el::Value& value)
+{
+  writeValue(buffer, static_cast<std::uint8_t>(value.type()));
+  switch (value.type())
+  {
+  case el::ValueType::Boolean:
+    writeBool(buffer, value.booleanValue(context));
+    break;
+  case el::ValueType::String:
+    writeString(buffer, value.stringValue(context));
+    break;
+  case el::ValueType::Number:
+    writeValue(buffer, value.numberValue(context));
+    break;
+  case el::ValueType::Array: {
+    const auto& array = value.arrayValue(context);
+    writeSize(buffer, array.size());
+    for (const auto& element : array)
+    {
+      writeELValue(buffer, context, element);
+    }
+    break;
+  }
+  case el::ValueType::Map: {
+    const auto& map = value.mapValue(context);
+    writeSize(buffer, map.size());
+    for (const auto& [key, element] : map)
+    {
+      writeString(buffer, key);
+      writeELValue(buffer, context, element);
+    }
+    break;
+  }
+  case el::ValueType::Range:
+    std::visit(
+      kdl::overload(
+        [&](const el::LeftBoundedRange& range) {
+          writeValue(buffer, RangeKind::LeftBounded);
+          writeValue(buffer, std::int64_t(range.first));
+        },
+        [&](const el::RightBoundedRange& range) {
+          writeValue(buffer, RangeKind::RightBounded);
+          writeValue(buffer, std::int64_t(range.last));
+        },
+        [&](const el::BoundedRange& range) {
+          writeValue(buffer, RangeKind::Bounded);
+          writeValue(buffer, std::int64_t(range.first));
+          writeValue(buffer, std::int64_t(range.last));
+        }),
+      value.rangeValue(context));
+    break;
+  case el::ValueType::Null:
+  case el::ValueType::Undefined:
+    break;
+    switchDefault();
+  }
+}
+
+void writeExpression(
+  FormatBuffer& buffer,
+  const el::EvaluationContext& context,
+  const el::ExpressionNode& expression)
+{
+  const auto writeHeader = [&](const ExpressionKind kind) {
+    writeValue(buffer, kind);
+
+    const auto& location = expression.location();
+    writeBool(buffer, location.has_value());
+    if (location)
+    {
+      writeValue(buffer, std::uint64_t(location->line));
+      writeBool(buffer, location->column.has_value());
+      if (location->column)
+      {
+        writeValue(buffer, std::uint64_t(*location->column));
+      }
+    }
+  };
+
+  expression.accept(kdl::overload(
+    [&](const el::LiteralExpression& literal) {
+      writeHeader(ExpressionKind::Literal);
+      writeELValue(buffer, context, literal.value);
+    },
+    [&](const el::VariableExpression& variable) {
+      writeHeader(ExpressionKind::Variable);
+      writeString(buffer, variable.variableName);
+    },
+    [&](const el::ArrayExpression& array) {
+      writeHeader(ExpressionKind::Array);
+      writeSize(buffer, array.elements.size());
+      for (const auto& element : array.elements)
+      {
+        writeExpression(buffer, context, element);
+      }
+    },
+    [&](const el::MapExpression& map) {
+      writeHeader(ExpressionKind::Map);
+      writeSize(buffer, map.elements.size());
+      for (const auto& [key, element] : map.elements)
+      {
+        writeString(buffer, key);
+        writeExpression(buffer, context, element);
+      }
+    },
+    [&](const el::UnaryExpression& unary) {
+      writeHeader(ExpressionKind::Unary);
+      writeValue(buffer, static_cast<std::uint8_t>(unary.operation));
+      writeExpression(buffer, context, unary.operand);
+    },
+    [&](const el::BinaryExpression& binary) {
+      writeHeader(ExpressionKind::Binary);
+      writeValue(buffer, static_cast<std::uint8_t>(binary.operation));
+      writeExpression(buffer, context, binary.leftOperand);
+      writeExpression(buffer, context, binary.rightOperand);
+    },
+    [&](const el::SubscriptExpression& subscript) {
+      writeHeader(ExpressionKind::Subscript);
+      writeExpression(buffer, context, subscript.leftOperand);
+      writeExpression(buffer, context, subscript.rightOperand);
+    },
+    [&](const el::SwitchExpression& switch_) {
+      writeHeader(ExpressionKind::Switch);
+      writeSize(buffer, switch_.cases.size());
+      for (const auto& case_ : switch_.cases)
+      {
+        writeExpression(buffer, context, case_);
+      }
+    }));
+}
+
+void writePropertyValue(FormatBuffer& buffer, const std::string& value)
+{
+  writeString(buffer, value);
+}
+
+void writePropertyValue(FormatBuffer& buffer, const bool value)
+{
+  writeBool(buffer, value);
+}
+
+void writePropertyValue(FormatBuffer& buffer, const int value)
+{
+  writeValue(buffer, std::int32_t(value));
+}
+
+void writePropertyValue(FormatBuffer& buffer, const float value)
+{
+  writeValue(buffer, value);
+}
+
+template <typename T>
+void writeDefaultValue(
+  FormatBuffer& buffer, const mdl::PropertyDefinitionWithDefaultValue<T>& definition)
+{
+  writeBool(buffer, definition.hasDefaultValue());
+  if (definition.hasDefaultValue())
+  {
+    writePropertyValue(buffer, definition.defaultValue());
+  }
+}
+
+PropertyKind propertyKind(const mdl::PropertyDefinition& definition)
+{
+  if (dynamic_cast<const mdl::UnknownPropertyDefinition*>(&definition))
+  {
+    return PropertyKind::Unknown;
+  }
+
+  switch (definition.type())
+  {
+  case mdl::PropertyDefinitionType::TargetSourceProperty:
+    return PropertyKind::TargetSource;
+  case mdl::PropertyDefinitionType::TargetDestinationProperty:
+    return PropertyKind::TargetDestination;
+  case mdl::PropertyDefinitionType::StringProperty:
+    return PropertyKind::String;
+  case mdl::PropertyDefinitionType::BooleanProperty:
+    return PropertyKind::Boolean;
+  case mdl::PropertyDefinitionType::IntegerProperty:
+    return PropertyKind::Integer;
+  case mdl::PropertyDefinitionType::FloatProperty:
+    return PropertyKind::Float;
+  case mdl::PropertyDefinitionType::ChoiceProperty:
+    return PropertyKind::Choice;
+  case mdl::PropertyDefinitionType::FlagsProperty:
+    return PropertyKind::Flags;
+    switchDefault();
+  }
+}
+
+void writePropertyDefinition(
+  FormatBuffer& buffer, const mdl::PropertyDefinition& definition)
+{
+  const auto kind = propertyKind(definition);
+  writeValue(buffer, kind);
+  writeString(buffer, definition.key());
+  writeString(buffer, definition.shortDescription());
+  writeString(buffer, definition.longDescription());
+  writeBool(buffer, definition.readOnly());
+
+  switch (kind)
+  {
+  case PropertyKind::TargetSource:
+  case PropertyKind::TargetDestination:
+    break;
+  case PropertyKind::String:
+  case PropertyKind::Unknown:
+    writeDefaultValue(
+      buffer, static_cast<const mdl::StringPropertyDefinition&>(definition));
+    break;
+  case PropertyKind::Boolean:
+    writeDefaultValue(
+      buffer, static_cast<const mdl::BooleanPropertyDefinition&>(definition));
+    break;
+  case PropertyKind::Integer:
+    writeDefaultValue(
+      buffer, static_cast<const mdl::IntegerPropertyDefinition&>(definition));
+    break;
+  case PropertyKind::Float:
+    writeDefaultValue(
+      buffer, static_cast<const mdl::FloatPropertyDefinition&>(definition));
+    break;
+  case PropertyKind::Choice: {
+    const auto& choiceDefinition =
+      static_cast<const mdl::ChoicePropertyDefinition&>(definition);
+    writeSize(buffer, choiceDefinition.options().size());
+    for (const auto& option : choiceDefinition.options())
+    {
+      writeString(buffer, option.value());
+      writeString(buffer, option.description());
+    }
+    writeDefaultValue(buffer, choiceDefinition);
+    break;
+  }
+  case PropertyKind::Flags: {
+    const auto& flagsDefinition =
+      static_cast<const mdl::FlagsPropertyDefinition&>(definition);
+    writeSize(buffer, flagsDefinition.options().size());
+    for (const auto& option : flagsDefinition.options())
+    {
+      writeValue(buffer, std::int32_t(option.value()));
+      writeString(buffer, option.shortDescription());
+      writeString(buffer, option.longDescription());
+      writeBool(buffer, option.isDefault());
+    }
+    break;
+  }
+    switchDefault();
+  }
+}
+
+void writeEntityDefinition(
+  FormatBuffer& buffer,
+  const el::EvaluationContext& context,
+  const mdl::EntityDefinition& definition)
+{
+  writeValue(buffer, static_cast<std::uint8_t>(definition.type()));
+  writeString(buffer, definition.name());
+  writeVec(buffer, definition.color());
+  writeString(buffer, definition.description());
+
+  writeSize(buffer, definition.propertyDefinitions().size());
+  for (const auto& propertyDefinition : definition.propertyDefinitions())
+  {
+    writePropertyDefinition(buffer, *propertyDefinition);
+  }
+
+  if (definition.type() == mdl::EntityDefinitionType::PointEntity)
+  {
+    const auto& pointDefinition =
+      static_cast<const mdl::PointEntityDefinition&>(definition);
+    writeVec(buffer, pointDefinition.bounds().min);
+    writeVec(buffer, pointDefinition.bounds().max);
+    writeExpression(buffer, context, pointDefinition.modelDefinition().expression());
+    writeExpression(buffer, context, pointDefinition.decalDefinition().expression());
+  }
+}
+
+// Reading
+
+bool readBool(Reader& reader)
+{
+  return reader.readBool<std::uint8_t>();
+}
+
+size_t readSize(Reader& reader)
+{
+  return reader.readSize<std::uint32_t>();
+}
+
+std::string readString(Reader& reader)
+{
+  const auto length = readSize(reader);
+  return reader.readString(length);
+}
+
+template <typename T>
+T readEnum(Reader& reader, const T last)
+{
+  const auto value = reader.readUnsignedChar<std::uint8_t>();
+  if (value > static_cast<unsigned char>(last))
+  {
+    throw ReaderException{fmt::format("Invalid enum value {}", value)};
+  }
+  return static_cast<T>(value);
+}
+
+template <typename F>
+auto readOptional(Reader& reader, const F& readValue)
+{
+  using T = decltype(readValue(reader));
+  return readBool(reader) ? std::optional<T>{readValue(reader)} : std::nullopt;
+}
+
+InputFileInfo readInputFileInfo(Reader& reader)
+{
+  auto path = pathFromString(readString(reader));
+  const auto exists = readBool(reader);
+  const auto size = reader.read<std::uint64_t, std::uint64_t>();
+  const auto hash = reader.read<std::uint64_t, std::uint64_t>();
+  return InputFileInfo{std::move(path), exists, size, hash};
+}
+
+el::Value readELValue(Reader& reader)
+{
+  switch (readEnum(reader, el::ValueType::Undefined))
+  {
+  case el::ValueType::Boolean:
+    return el::Value{readBool(reader)};
+  case el::ValueType::String:
+    return el::Value{readString(reader)};
+  case el::ValueType::Number:
+    return el::Value{reader.readDouble<double>()};
+  case el::ValueType::Array: {
+    auto array = el::ArrayType{};
+    const auto count = readSize(reader);
+    for (size_t i = 0; i < count; ++i)
+    {
+      array.push_back(readELValue(reader));
+    }
+    return el::Value{std::move(array)};
+  }
+  case el::ValueType::Map: {
+    auto map = el::MapType{};
+    const auto count = readSize(reader);
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto key = readString(reader);
+      map.emplace(std::move(key), readELValue(reader));
+    }
+    return el::Value{std::move(map)};
+  }
+  case el::ValueType::Range:
+    switch (readEnum(reader, RangeKind::Bounded))
+    {
+    case RangeKind::LeftBounded:
+      return el::Value{
+        el::RangeType{el::LeftBoundedRange{reader.read<std::int64_t, long>()}}};
+    case RangeKind::RightBounded:
+      return el::Value{
+        el::RangeType{el::RightBoundedRange{reader.read<std::int64_t, long>()}}};
+    case RangeKind::Bounded: {
+      const auto first = reader.read<std::int64_t, long>();
+      const auto last = reader.read<std::int64_t, long>();
+      return el::Value{el::RangeType{el::BoundedRange{first, last}}};
+    }
+      switchDefault();
+    }
+  case el::ValueType::Null:
+    return el::Value::Null;
+  case el::ValueType::Undefined:
+    return el::Value::Undefined;
+    switchDefault();
+  }
+}
+
+el::ExpressionNode readExpression(Reader& reader)
+{
+  const auto kind = readEnum(reader, ExpressionKind::Switch);
+
+  auto location = std::optional<FileLocation>{};
+  if (readBool(reader))
+  {
+    const auto line = reader.readSize<std::uint64_t>();
+    const auto column = readOptional(
+      reader, [](auto& r) { return r.template readSize<std::uint64_t>(); });
+    location = FileLocation{line, column};
+  }
+
+  switch (kind)
+  {
+  case ExpressionKind::Literal:
+    return el::ExpressionNode{el::LiteralExpression{readELValue(reader)}, location};
+  case ExpressionKind::Variable:
+    return el::ExpressionNode{el::VariableExpression{readString(reader)}, location};
+  case ExpressionKind::Array: {
+    auto elements = std::vector<el::ExpressionNode>{};
+    const auto count = readSize(reader);
+    for (size_t i = 0; i < count; ++i)
+    {
+      elements.push_back(readExpression(reader));
+    }
+    return el::ExpressionNode{el::ArrayExpression{std::move(elements)}, location};
+  }
+  case ExpressionKind::Map: {
+    auto elements = std::map<std::string, el::ExpressionNode>{};
+    const auto count = readSize(reader);
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto key = readString(reader);
+      elements.emplace(std::move(key), readExpression(reader));
+    }
+    return el::ExpressionNode{el::MapExpression{std::move(elements)}, location};
+  }
+  case ExpressionKind::Unary: {
+    const auto operation = readEnum(reader, el::UnaryOperation::RightBoundedRange);
+    auto operand = readExpression(reader);
+    return el::ExpressionNode{
+      el::UnaryExpression{operation, std::move(operand)}, location};
+  }
+  case ExpressionKind::Binary: {
+    const auto operation = readEnum(reader, el::BinaryOperation::Case);
+    auto leftOperand = readExpression(reader);
+    auto rightOperand = readExpression(reader);
+    return el::ExpressionNode{
+      el::BinaryExpression{operation, std::move(leftOperand), std::move(rightOperand)},
+      location};
+  }
+  case ExpressionKind::Subscript: {
+    auto leftOperand = readExpression(reader);
+    auto rightOperand = readExpression(reader);
+    return el::ExpressionNode{
+      el::SubscriptExpression{std::move(leftOperand), std::move(rightOperand)},
+      location};
+  }
+  case ExpressionKind::Switch: {
+    auto cases = std::vector<el::ExpressionNode>{};
+    const auto count = readSize(reader);
+    for (size_t i = 0; i < count; ++i)
+    {
+      cases.push_back(readExpression(reader));
+    }
+    return el::ExpressionNode{el::SwitchExpression{std::move(cases)}, location};
+  }
+    switchDefault();
+  }
+}
+
+std::shared_ptr<mdl::PropertyDefinition> readPropertyDefinition(Reader& reader)
+{
+  const auto kind = readEnum(reader, PropertyKind::Unknown);
+  auto key = readString(reader);
+  auto shortDescription = readString(reader);
+  auto longDescription = readString(reader);
+  const auto readOnly = readBool(reader);
+
+  switch (kind)
+  {
+  case PropertyKind::TargetSource:
+    return std::make_shared<mdl::PropertyDefinition>(
+      std::move(key),
+      mdl::PropertyDefinitionType::TargetSourceProperty,
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly);
+  case PropertyKind::TargetDestination:
+    return std::make_shared<mdl::PropertyDefinition>(
+      std::move(key),
+      mdl::PropertyDefinitionType::TargetDestinationProperty,
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly);
+  case PropertyKind::String:
+    return std::make_shared<mdl::StringPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readOptional(reader, readString));
+  case PropertyKind::Boolean:
+    return std::make_shared<mdl::BooleanPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readOptional(reader, readBool));
+  case PropertyKind::Integer:
+    return std::make_shared<mdl::IntegerPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readOptional(reader, [](auto& r) { return r.template readInt<std::int32_t>(); }));
+  case PropertyKind::Float:
+    return std::make_shared<mdl::FloatPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readOptional(reader, [](auto& r) { return r.template readFloat<float>(); }));
+  case PropertyKind::Choice: {
+    auto options = mdl::ChoicePropertyOption::List{};
+    const auto count = readSize(reader);
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto value = readString(reader);
+      auto description = readString(reader);
+      options.emplace_back(std::move(value), std::move(description));
+    }
+    return std::make_shared<mdl::ChoicePropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      std::move(options),
+      readOnly,
+      readOptional(reader, readString));
+  }
+  case PropertyKind::Flags: {
+    auto definition = std::make_shared<mdl::FlagsPropertyDefinition>(std::move(key));
+    const auto count = readSize(reader);
+    for (size_t i = 0; i < count; ++i)
+    {
+      const auto value = reader.readInt<std::int32_t>();
+      auto optionShortDescription = readString(reader);
+      auto optionLongDescription = readString(reader);
+      const auto isDefault = readBool(reader);
+      definition->addOption(
+        value,
+        std::move(optionShortDescription),
+        std::move(optionLongDescription),
+        isDefault);
+    }
+    return definition;
+  }
+  case PropertyKind::Unknown:
+    return std::make_shared<mdl::UnknownPropertyDefinition>(
+      std::move(key),
+      std::move(shortDescription),
+      std::move(longDescription),
+      readOnly,
+      readOptional(reader, readString));
+    switchDefault();
+  }
+}
+
+std::unique_ptr<mdl::EntityDefinition> readEntityDefinition(Reader& reader)
+{
+  const auto type = readEnum(reader, mdl::EntityDefinitionType::BrushEntity);
+  auto name = readString(reader);
+  const auto color = Color{reader.readVec<float, 4>()};
+  auto description = readString(reader);
+
+  auto propertyDefinitions = std::vector<std::shared_ptr<mdl::PropertyDefinition>>{};
+  const auto count = readSize(reader);
+  for (size_t i = 0; i < count; ++i)
+  {
+    propertyDefinitions.push_back(readPropertyDefinition(reader));
+  }
+
+  if (type == mdl::EntityDefinitionType::PointEntity)
+  {
+    const auto min = reader.readVec<double, 3>();
+    const auto max = reader.readVec<double, 3>();
+    auto modelExpression = readExpression(reader);
+    auto decalExpression = readExpression(reader);
+    return std::make_unique<mdl::PointEntityDefinition>(
+      std::move(name),
+      color,
+      vm::bbox3d{min, max},
+      std::move(description),
+      std::move(propertyDefinitions),
+      mdl::ModelDefinition{std::move(modelExpression)},
+      mdl::DecalDefinition{std::move(decalExpression)});
+  }
+
+  return std::make_unique<mdl::BrushEntityDefinition>(
+    std::move(name), color, std::move(description), std::move(propertyDefinitions));
+}
+
+Result<std::vector<std::unique_ptr<mdl::EntityDefinition>>> readCache(
+  Reader& reader, const std::filesystem::path& path, const Color& defaultEntityColor)
+{
+  if (reader.readString(Magic.size()) != Magic)
+  {
+    return Error{"Unknown entity definition cache format"};
+  }
+  if (reader.readUnsignedInt<std::uint32_t>() != Version)
+  {
+    return Error{"Unsupported entity definition cache version"};
+  }
+  if (Color{reader.readVec<float, 4>()} != defaultEntityColor)
+  {
+    return Error{"Default entity color has changed"};
+  }
+
+  const auto inputFileCount = readSize(reader);
+  for (size_t i = 0; i < inputFileCount; ++i)
+  {
+    const auto inputFileInfo = readInputFileInfo(reader);
+    if (i == 0 && inputFileInfo.path != path)
+    {
+      return Error{fmt::format("Entity definition cache is not for {}", path)};
+    }
+    if (getInputFileInfo(inputFileInfo.path) != inputFileInfo)
+    {
+      return Error{fmt::format("{} has changed", inputFileInfo.path)};
+    }
+  }
+
+  auto definitions = std::vector<std::unique_ptr<mdl::EntityDefinition>>{};
+  const auto count = readSize(reader);
+  if (count > (reader.size() - reader.position()) / MinEntityDefinitionSize)
+  {
+    return Error{fmt::format("Invalid entity definition count {}", count)};
+  }
+
+  definitions.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    definitions.push_back(readEntityDefinition(reader));
+  }
+  return definitions;
+}
+
+} // namespace
+
+std::filesystem::path entityDefinitionCachePath(
+  const std::filesystem::path& cacheDirectory, const std::filesystem::path& path)
+{
+  return cacheDirectory
+         / fmt::format("{:016x}{}", kdl::fnv1a_64(pathToString(path)), Extension);
+}
+
+Result<std::vector<std::unique_ptr<mdl::EntityDefinition>>> readEntityDefinitionCache(
+  const std::filesystem::path& cacheDirectory,
+  const std::filesystem::path& path,
+  const Color& defaultEntityColor)
+{
+  const auto cachePath = entityDefinitionCachePath(cacheDirectory, path);
+  return Disk::openFile(cachePath)
+         | kdl::and_then(
+           [&](auto file) -> Result<std::vector<std::unique_ptr<mdl::EntityDefinition>>> {
+             try
+             {
+               auto reader = file->reader().buffer();
+               return readCache(reader, path, defaultEntityColor);
+             }
+             catch (const ReaderException& e)
+             {
+               return Error{
+                 fmt::format("Invalid entity definition cache file: {}", e.what())};
+             }
+           })
+         | kdl::transform([&](auto definitions) {
+             // mark the cache file as recently used so that it isn't pruned, failing to
+             // do so is harmless
+             auto error = std::error_code{};
+             std::filesystem::last_write_time(
+               cachePath, std::filesystem::file_time_type::clock::now(), error);
+             return definitions;
+           });
+}
+
+Result<void> writeEntityDefinitionCache(
+  const std::filesystem::path& cacheDirectory,
+  const std::filesystem::path& path,
+  const std::vector<std::filesystem::path>& includedFiles,
+  const Color& defaultEntityColor,
+  const std::vector<std::unique_ptr<mdl::EntityDefinition>>& definitions)
+{
+  auto buffer = FormatBuffer{};
+  buffer.append(Magic);
+  writeValue(buffer, Version);
+  writeVec(buffer, defaultEntityColor);
+
+  const auto inputFiles = kdl::vec_concat(std::vector{path}, includedFiles);
+  writeSize(buffer, inputFiles.size());
+  for (const auto& inputFile : inputFiles)
+  {
+    writeInputFileInfo(buffer, getInputFileInfo(inputFile));
+  }
+
+  return el::withEvaluationContext([&](const auto& context) {
+           writeSize(buffer, definitions.size());
+           for (const auto& definition : definitions)
+           {
+             writeEntityDefinition(buffer, context, *definition);
+           }
+         })
+         | kdl::and_then([&]() { return Disk::createDirectory(cacheDirectory); })
+         | kdl::and_then([&](auto) {
+             // write to a temporary file first so that a reader never sees a partially
+             // written cache file
+             const auto cachePath = entityDefinitionCachePath(cacheDirectory, path);
+             const auto tmpCachePath = kdl::path_add_extension(cachePath, ".tmp");
+             return Disk::withOutputStream(
+                      tmpCachePath,
+                      std::ios::out | std::ios::binary,
+                      [&](auto& stream) {
+                        const auto data = buffer.view();
+                        stream.write(
+                          data.data(), static_cast<std::streamsize>(data.size()));
+                      })
+                    | kdl::and_then(
+                      [&]() { return Disk::moveFile(tmpCachePath, cachePath); });
+           })
+         | kdl::and_then([&]() { return pruneEntityDefinitionCache(cacheDirectory); });
+}
+
+Result<void> pruneEntityDefinitionCache(
+  const std::filesystem::path& cacheDirectory,
+  const std::chrono::hours maxAge,
+  const size_t maxCount)
+{
+  // temporary files are left behind if writing a cache file was interrupted
+  return Disk::find(
+           cacheDirectory,
+           TraversalMode::Flat,
+           makeExtensionPathMatcher({Extension, ".tmp"}))
+         | kdl::and_then([&](auto cachePaths) {
+             using FileTime = std::filesystem::file_time_type;
+
+             auto cacheFiles = std::vector<std::pair<FileTime, std::filesystem::path>>{};
+             for (auto& cachePath : cachePaths)
+             {
+               auto error = std::error_code{};
+               if (const auto lastWriteTime =
+                     std::filesystem::last_write_time(cachePath, error);
+                   !error)
+               {
+                 cacheFiles.emplace_back(lastWriteTime, std::move(cachePath));
+               }
+             }
+
+             // most recently used first
+             std::ranges::sort(cacheFiles, std::greater{});
+
+             const auto now = FileTime::clock::now();
+             auto stalePaths = std::vector<std::filesystem::path>{};
+             for (size_t i = 0; i < cacheFiles.size(); ++i)
+             {
+               const auto& [lastWriteTime, cachePath] = cacheFiles[i];
+               if (i >= maxCount || now - lastWriteTime > maxAge)
+               {
+                 stalePaths.push_back(cachePath);
+               }
+             }
+
+             return kdl::vec_transform(stalePaths, Disk::deleteFile) | kdl::fold;
+           })
+         | kdl::transform([](auto) {});
+}
+
+} // namespace tb::io
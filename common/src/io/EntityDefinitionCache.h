@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Color.h"
+#include "Result.h"
+
+#include <chrono>
+#include <filesystem>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace tb::mdl
+{
+class EntityDefinition;
+} // namespace tb::mdl
+
+namespace tb::io
+{
+
+/**
+ * Returns the path of the cache file for the given entity definition file.
+ */
+std::filesystem::path entityDefinitionCachePath(
+  const std::filesystem::path& cacheDirectory, const std::filesystem::path& path);
+
+/**
+ * Reads the cached entity definitions of the given entity definition file from the given
+ * cache directory.
+ *
+ * Fails if there is no cache file, if the cache file is invalid, if it was written with a
+ * different default entity color, or if the contents of the entity definition file or of
+ * any of the files it includes have changed since the cache file was written.
+ */
+Result<std::vector<std::unique_ptr<mdl::EntityDefinition>>> readEntityDefinitionCache(
+  const std::filesystem::path& cacheDirectory,
+  const std::filesystem::path& path,
+  const Color& defaultEntityColor);
+
+/**
+ * Writes the given entity definitions to a cache file in the given cache directory. The
+ * cache file records the hashes of the entity definition file and of the given included
+ * files so that it can be invalidated if any of them change.
+ *
+ * Afterwards, stale cache files are pruned from the cache directory.
+ */
+Result<void> writeEntityDefinitionCache(
+  const std::filesystem::path& cacheDirectory,
+  const std::filesystem::path& path,
+  const std::vector<std::filesystem::path>& includedFiles,
+  const Color& defaultEntityColor,
+  const std::vector<std::unique_ptr<mdl::EntityDefinition>>& definitions);
+
+/**
+ * Deletes the cache files in the given cache directory that were last used more than the
+ * given maximum age ago. Of the remaining cache files, only the given maximum number of
+ * most recently used files is kept.
+ *
+ * A cache file counts as used when it is written or successfully read.
+ */
+Result<void> pruneEntityDefinitionCache(
+  const std::filesystem::path& cacheDirectory,
+  std::chrono::hours maxAge = std::chrono::days{30},
+  size_t maxCount = 64);
+
+} // namespace tb::io
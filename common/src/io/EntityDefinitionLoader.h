@@ -23,8 +23,14 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb::mdl
 {
 class EntityDefinition;
@@ -39,8 +45,16 @@ class EntityDefinitionLoader
 public:
   virtual ~EntityDefinitionLoader();
 
+  /**
+   * Loads the entity definitions from the given file. If a cache directory is given, the
+   * definitions are read from a cache file in it if none of the files they were loaded
+   * from have changed, and the cache file is updated otherwise.
+   */
   virtual Result<std::vector<std::unique_ptr<mdl::EntityDefinition>>>
   loadEntityDefinitions(
-    ParserStatus& status, const std::filesystem::path& path) const = 0;
+    ParserStatus& status,
+    const std::filesystem::path& path,
+    kdl::task_manager& taskManager,
+    const std::optional<std::filesystem::path>& cacheDirectory) const = 0;
 };
 } // namespace tb::io
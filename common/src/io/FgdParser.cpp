@@ -20,6 +20,7 @@
 #include "FgdParser.h"
 
 #include "el/Expression.h"
+#include "io/BufferedParserStatus.h"
 #include "io/DiskFileSystem.h"
 #include "io/EntityDefinitionClassInfo.h"
 #include "io/LegacyModelDefinitionParser.h"
@@ -28,18 +29,22 @@
 #include "io/ParserStatus.h"
 #include "mdl/PropertyDefinition.h"
 
-#include "kdl/invoke.h"
+#include "kdl/range_to_vector.h"
 #include "kdl/result.h"
 #include "kdl/string_compare.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 #include <fmt/std.h>
 
 #include <algorithm>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <ranges>
 #include <string>
 #include <vector>
 
@@ -48,6 +53,18 @@ namespace tb::io
 namespace
 {
 
+std::filesystem::path currentRoot(const std::vector<std::filesystem::path>& paths)
+{
+  assert(paths.empty() || !paths.back().empty());
+  return !paths.empty() ? paths.back().parent_path() : std::filesystem::path{};
+}
+
+bool isRecursiveInclude(
+  const std::vector<std::filesystem::path>& paths, const std::filesystem::path& path)
+{
+  return std::ranges::find(paths, path) != paths.end();
+}
+
 auto tokenNames()
 {
   using namespace FgdToken;
@@ -177,17 +194,42 @@ FgdTokenizer::Token FgdTokenizer::emitToken()
   return Token{FgdToken::Eof, nullptr, nullptr, length(), line(), column()};
 }
 
+struct FgdParser::IncludeDirective
+{
+  size_t position;
+  std::filesystem::path path;
+  FileLocation location;
+};
+
+struct FgdParser::IncludedFile
+{
+  std::filesystem::path filePath;
+  std::vector<std::filesystem::path> paths;
+  BufferedParserStatus status;
+  std::exception_ptr exception;
+  std::vector<EntityDefinitionClassInfo> classInfos;
+  std::vector<IncludeDirective> includes;
+  std::vector<std::unique_ptr<IncludedFile>> includedFiles;
+
+  explicit IncludedFile(const ParserStatus& hostStatus)
+    : status{hostStatus}
+  {
+  }
+};
+
 FgdParser::FgdParser(
   const std::string_view str,
   const Color& defaultEntityColor,
-  const std::filesystem::path& path)
+  const std::filesystem::path& path,
+  kdl::task_manager* taskManager)
   : EntityDefinitionParser{defaultEntityColor}
+  , m_taskManager{taskManager}
   , m_tokenizer{FgdTokenizer{str}}
 {
   if (!path.empty() && path.is_absolute())
   {
-    m_fs = std::make_unique<DiskFileSystem>(path.parent_path());
-    pushIncludePath(path.filename());
+    m_fs = std::make_shared<DiskFileSystem>(path.parent_path());
+    m_paths.push_back(path.filename());
   }
 }
 
@@ -196,62 +238,58 @@ FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor)
 {
 }
 
-FgdParser::~FgdParser() = default;
-
-class FgdParser::PushIncludePath
-{
-private:
-  FgdParser& m_parser;
-
-public:
-  PushIncludePath(FgdParser& parser, const std::filesystem::path& path)
-    : m_parser{parser}
-  {
-    m_parser.pushIncludePath(path);
-  }
-
-  ~PushIncludePath() { m_parser.popIncludePath(); }
-};
-
-void FgdParser::pushIncludePath(std::filesystem::path path)
+// The default entity color is only used when building the entity definitions, which is
+// never done for included files.
+FgdParser::FgdParser(
+  const std::string_view str,
+  const Color& defaultEntityColor,
+  std::shared_ptr<FileSystem> fs,
+  std::vector<std::filesystem::path> paths)
+  : EntityDefinitionParser{defaultEntityColor}
+  , m_paths{std::move(paths)}
+  , m_fs{std::move(fs)}
+  , m_tokenizer{FgdTokenizer{str}}
 {
-  assert(!isRecursiveInclude(path));
-  m_paths.push_back(std::move(path));
 }
 
-void FgdParser::popIncludePath()
-{
-  assert(!m_paths.empty());
-  m_paths.pop_back();
-}
+FgdParser::~FgdParser() = default;
 
-std::filesystem::path FgdParser::currentRoot() const
+const std::vector<std::filesystem::path>& FgdParser::includedFiles() const
 {
-  assert(m_paths.empty() || !m_paths.back().empty());
-  return !m_paths.empty() ? m_paths.back().parent_path() : std::filesystem::path{};
+  return m_includedFiles;
 }
 
-bool FgdParser::isRecursiveInclude(const std::filesystem::path& path) const
+std::vector<EntityDefinitionClassInfo> FgdParser::parseClassInfos(ParserStatus& status)
 {
-  return std::any_of(m_paths.begin(), m_paths.end(), [&](const auto& includedPath) {
-    return includedPath == path;
-  });
+  auto includes = std::vector<IncludeDirective>{};
+  auto classInfos = parseFileClassInfos(status, includes);
+  if (includes.empty())
+  {
+    return classInfos;
+  }
+
+  auto includedFiles = parseIncludedFiles(status, includes);
+  return spliceIncludedClassInfos(
+    status, std::move(classInfos), includes, includedFiles);
 }
 
-std::vector<EntityDefinitionClassInfo> FgdParser::parseClassInfos(ParserStatus& status)
+std::vector<EntityDefinitionClassInfo> FgdParser::parseFileClassInfos(
+  ParserStatus& status, std::vector<IncludeDirective>& includes)
 {
   auto classInfos = std::vector<EntityDefinitionClassInfo>{};
   auto token = m_tokenizer.peekToken();
   while (!token.hasType(FgdToken::Eof))
   {
-    parseClassInfoOrInclude(status, classInfos);
+    parseClassInfoOrInclude(status, classInfos, includes);
     token = m_tokenizer.peekToken();
   }
   return classInfos;
 }
 
 void FgdParser::parseClassInfoOrInclude(
-  ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos)
+  ParserStatus& status,
+  std::vector<EntityDefinitionClassInfo>& classInfos,
+  std::vector<IncludeDirective>& includes)
 {
   const auto token = m_tokenizer.peekToken(FgdToken::Eof | FgdToken::Word);
   if (token.hasType(FgdToken::Eof))
@@ -261,8 +299,7 @@ void FgdParser::parseClassInfoOrInclude(
 
   if (kdl::ci::str_is_equal(token.data(), "@include"))
   {
-    auto includedClassInfos = parseInclude(status);
-    classInfos = kdl::vec_concat(classInfos, std::move(includedClassInfos));
+    includes.push_back(parseInclude(classInfos.size()));
   }
   else
   {
@@ -958,60 +995,186 @@ std::string FgdParser::parseString()
   }
 }
 
-std::vector<EntityDefinitionClassInfo> FgdParser::parseInclude(ParserStatus& status)
+FgdParser::IncludeDirective FgdParser::parseInclude(const size_t position)
 {
   auto token = m_tokenizer.nextToken(FgdToken::Word);
   assert(kdl::ci::str_is_equal(token.data(), "@include"));
 
   token = m_tokenizer.nextToken(FgdToken::String);
-  return handleInclude(status, token.data());
+  return {position, token.data(), m_tokenizer.location()};
+}
+
+/**
+ * Parses the included files one level of the include tree at a time. The files of each
+ * level are parsed in parallel if a task manager is available, and no task ever waits for
+ * another task.
+ */
+std::vector<std::unique_ptr<FgdParser::IncludedFile>> FgdParser::parseIncludedFiles(
+  const ParserStatus& status, const std::vector<IncludeDirective>& includes)
+{
+  struct PendingInclude
+  {
+    const std::vector<std::filesystem::path>* includingPaths;
+    const IncludeDirective* include;
+    std::unique_ptr<IncludedFile>* includedFile;
+  };
+
+  auto includedFiles = std::vector<std::unique_ptr<IncludedFile>>(includes.size());
+
+  auto pendingIncludes = std::vector<PendingInclude>{};
+  for (size_t i = 0; i < includes.size(); ++i)
+  {
+    pendingIncludes.push_back({&m_paths, &includes[i], &includedFiles[i]});
+  }
+
+  while (!pendingIncludes.empty())
+  {
+    auto tasks = pendingIncludes | std::views::transform([&](const auto& pendingInclude) {
+                   return std::function{[&, pendingInclude]() {
+                     return parseIncludedFile(
+                       status, *pendingInclude.includingPaths, *pendingInclude.include);
+                   }};
+                 })
+                 | kdl::to_vector;
+
+    auto parsedFiles = m_taskManager
+                         ? m_taskManager->run_tasks_and_wait(std::move(tasks))
+                         : tasks | std::views::transform([](const auto& task) {
+                             return task();
+                           }) | kdl::to_vector;
+
+    auto nextPendingIncludes = std::vector<PendingInclude>{};
+    for (size_t i = 0; i < pendingIncludes.size(); ++i)
+    {
+      auto& includedFile = *pendingIncludes[i].includedFile;
+      includedFile = std::move(parsedFiles[i]);
+      includedFile->includedFiles.resize(includedFile->includes.size());
+
+      if (!includedFile->filePath.empty())
+      {
+        if (auto absPath = m_fs->makeAbsolute(includedFile->filePath);
+            absPath.is_success())
+        {
+          m_includedFiles.push_back(std::move(absPath).value());
+        }
+      }
+
+      for (size_t j = 0; j < includedFile->includes.size(); ++j)
+      {
+        nextPendingIncludes.push_back(
+          {&includedFile->paths,
+           &includedFile->includes[j],
+           &includedFile->includedFiles[j]});
+      }
+    }
+    pendingIncludes = std::move(nextPendingIncludes);
+  }
+
+  return includedFiles;
 }
 
-std::vector<EntityDefinitionClassInfo> FgdParser::handleInclude(
-  ParserStatus& status, const std::filesystem::path& path)
+std::unique_ptr<FgdParser::IncludedFile> FgdParser::parseIncludedFile(
+  const ParserStatus& hostStatus,
+  const std::vector<std::filesystem::path>& includingPaths,
+  const IncludeDirective& include) const
 {
+  auto includedFile = std::make_unique<IncludedFile>(hostStatus);
+  auto& status = includedFile->status;
+
   if (!m_fs)
   {
     status.error(
-      m_tokenizer.location(),
-      kdl::str_to_string("Cannot include file without host file path"));
-    return {};
+      include.location, kdl::str_to_string("Cannot include file without host file path"));
+    return includedFile;
   }
 
-  const auto restoreSnapshot =
-    kdl::invoke_later{[&, snapshot = m_tokenizer.snapshotStateAndSource()]() {
-      m_tokenizer.restoreStateAndSource(snapshot);
-    }};
+  status.debug(include.location, fmt::format("Parsing included file '{}'", include.path));
 
-  status.debug(m_tokenizer.location(), fmt::format("Parsing included file '{}'", path));
+  const auto filePath = currentRoot(includingPaths) / include.path;
+  includedFile->filePath = filePath;
 
-  const auto filePath = currentRoot() / path;
   return m_fs->openFile(filePath) | kdl::transform([&](auto file) {
            status.debug(
-             m_tokenizer.location(),
-             fmt::format("Resolved '{}' to '{}'", path, filePath));
+             include.location,
+             fmt::format("Resolved '{}' to '{}'", include.path, filePath));
 
-           if (isRecursiveInclude(filePath))
+           if (isRecursiveInclude(includingPaths, filePath))
            {
              status.error(
-               m_tokenizer.location(),
+               include.location,
                fmt::format(
-                 "Skipping recursively included file: {} ({})", path, filePath));
-             return std::vector<EntityDefinitionClassInfo>{};
+                 "Skipping recursively included file: {} ({})",
+                 include.path,
+                 filePath));
+             return std::move(includedFile);
            }
 
-           const auto pushIncludePath = PushIncludePath{*this, filePath};
-           auto reader = file->reader().buffer();
-           m_tokenizer.replaceState(reader.stringView());
-           return parseClassInfos(status);
+           includedFile->paths = kdl::vec_concat(includingPaths, std::vector{filePath});
+
+           try
+           {
+             auto reader = file->reader().buffer();
+             auto parser =
+               FgdParser{reader.stringView(), Color{}, m_fs, includedFile->paths};
+             includedFile->classInfos =
+               parser.parseFileClassInfos(status, includedFile->includes);
+           }
+           catch (...)
+           {
+             // rethrown on the calling thread when the class infos are spliced
+             includedFile->exception = std::current_exception();
+           }
+           return std::move(includedFile);
          })
          | kdl::transform_error([&](auto e) {
              status.error(
-               m_tokenizer.location(),
-               fmt::format("Failed to parse included file: {}", e.msg));
-             return std::vector<EntityDefinitionClassInfo>{};
+               include.location, fmt::format("Failed to parse included file: {}", e.msg));
+             return std::move(includedFile);
            })
          | kdl::value();
 }
 
+std::vector<EntityDefinitionClassInfo> FgdParser::spliceIncludedClassInfos(
+  ParserStatus& status,
+  std::vector<EntityDefinitionClassInfo> classInfos,
+  const std::vector<IncludeDirective>& includes,
+  std::vector<std::unique_ptr<IncludedFile>>& includedFiles)
+{
+  assert(includes.size() == includedFiles.size());
+
+  auto result = std::vector<EntityDefinitionClassInfo>{};
+  result.reserve(classInfos.size());
+
+  auto first = classInfos.begin();
+  for (size_t i = 0; i < includes.size(); ++i)
+  {
+    const auto last =
+      std::next(classInfos.begin(), static_cast<std::ptrdiff_t>(includes[i].position));
+    result.insert(
+      result.end(), std::make_move_iterator(first), std::make_move_iterator(last));
+    first = last;
+
+    auto& includedFile = *includedFiles[i];
+    includedFile.status.forwardTo(status);
+    if (includedFile.exception)
+    {
+      std::rethrow_exception(includedFile.exception);
+    }
+
+    result = kdl::vec_concat(
+      std::move(result),
+      spliceIncludedClassInfos(
+        status,
+        std::move(includedFile.classInfos),
+        includedFile.includes,
+        includedFile.includedFiles));
+  }
+
+  result.insert(
+    result.end(),
+    std::make_move_iterator(first),
+    std::make_move_iterator(classInfos.end()));
+  return result;
+}
+
 } // namespace tb::io
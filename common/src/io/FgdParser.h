@@ -37,6 +37,11 @@ namespace tb
 struct FileLocation;
 };
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb::mdl
 {
 class DecalDefinition;
@@ -85,32 +90,51 @@ private:
   using Token = FgdTokenizer::Token;
 
   std::vector<std::filesystem::path> m_paths;
-  std::unique_ptr<FileSystem> m_fs;
+  std::shared_ptr<FileSystem> m_fs;
+  kdl::task_manager* m_taskManager = nullptr;
+  std::vector<std::filesystem::path> m_includedFiles;
 
   FgdTokenizer m_tokenizer;
 
 public:
+  /**
+   * Creates a parser for the given file. Included files are resolved relative to the
+   * given path. If a task manager is given, then included files are parsed in parallel.
+   */
   FgdParser(
     std::string_view str,
     const Color& defaultEntityColor,
-    const std::filesystem::path& path);
+    const std::filesystem::path& path,
+    kdl::task_manager* taskManager = nullptr);
   FgdParser(std::string_view str, const Color& defaultEntityColor);
 
   ~FgdParser() override;
 
+  /**
+   * Returns the absolute paths of all files that the parsed file included, directly or
+   * indirectly, including the files that could not be opened.
+   */
+  const std::vector<std::filesystem::path>& includedFiles() const;
+
 private:
-  class PushIncludePath;
-  void pushIncludePath(std::filesystem::path path);
-  void popIncludePath();
+  FgdParser(
+    std::string_view str,
+    const Color& defaultEntityColor,
+    std::shared_ptr<FileSystem> fs,
+    std::vector<std::filesystem::path> paths);
 
-  std::filesystem::path currentRoot() const;
-  bool isRecursiveInclude(const std::filesystem::path& path) const;
+  struct IncludeDirective;
+  struct IncludedFile;
 
 private:
   std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) override;
 
+  std::vector<EntityDefinitionClassInfo> parseFileClassInfos(
+    ParserStatus& status, std::vector<IncludeDirective>& includes);
   void parseClassInfoOrInclude(
-    ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos);
+    ParserStatus& status,
+    std::vector<EntityDefinitionClassInfo>& classInfos,
+    std::vector<IncludeDirective>& includes);
 
   std::optional<EntityDefinitionClassInfo> parseClassInfo(ParserStatus& status);
   EntityDefinitionClassInfo parseSolidClassInfo(ParserStatus& status);
@@ -162,9 +186,19 @@ private:
   Color parseColor();
   std::string parseString();
 
-  std::vector<EntityDefinitionClassInfo> parseInclude(ParserStatus& status);
-  std::vector<EntityDefinitionClassInfo> handleInclude(
-    ParserStatus& status, const std::filesystem::path& path);
+  IncludeDirective parseInclude(size_t position);
+
+  std::vector<std::unique_ptr<IncludedFile>> parseIncludedFiles(
+    const ParserStatus& status, const std::vector<IncludeDirective>& includes);
+  std::unique_ptr<IncludedFile> parseIncludedFile(
+    const ParserStatus& hostStatus,
+    const std::vector<std::filesystem::path>& includingPaths,
+    const IncludeDirective& include) const;
+  static std::vector<EntityDefinitionClassInfo> spliceIncludedClassInfos(
+    ParserStatus& status,
+    std::vector<EntityDefinitionClassInfo> classInfos,
+    const std::vector<IncludeDirective>& includes,
+    std::vector<std::unique_ptr<IncludedFile>>& includedFiles);
 };
 
 } // namespace tb::io
@@ -0,0 +1,191 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FormatBuffer.h"
+
+#if defined(__APPLE__)
+#include <fmt/format.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace tb::io
+{
+namespace
+{
+
+char* copyChars(char* out, const char* first, const char* last)
+{
+  const auto count = static_cast<size_t>(last - first);
+  std::memcpy(out, first, count);
+  return out + count;
+}
+
+#if defined(__APPLE__)
+
+// std::to_chars for floating point values is not available on all supported macOS
+// versions, but fmt uses the same shortest round trip algorithm
+template <typename F>
+char* formatFloat(char* out, const F value)
+{
+  return fmt::format_to(out, "{}", value);
+}
+
+#else
+
+char* fillZeros(char* out, const int count)
+{
+  return std::fill_n(out, count, '0');
+}
+
+template <typename F>
+char* formatFloat(char* out, const F value)
+{
+  // The shortest scientific representation yields the significant digits and the
+  // exponent, which are then laid out in fixed notation if the exponent is small
+  // enough.
+  char buffer[MaxFormattedNumberLength];
+  const auto [end, ec] = std::to_chars(
+    buffer, buffer + MaxFormattedNumberLength, value, std::chars_format::scientific);
+  assert(ec == std::errc{});
+
+  if (!std::isfinite(value))
+  {
+    return copyChars(out, buffer, end);
+  }
+
+  const char* cur = buffer;
+  if (*cur == '-')
+  {
+    *out++ = *cur++;
+  }
+
+  // collect the significant digits, skipping the decimal point
+  char digits[MaxFormattedNumberLength];
+  auto digitCount = 0;
+  for (; *cur != 'e'; ++cur)
+  {
+    if (*cur != '.')
+    {
+      digits[digitCount++] = *cur;
+    }
+  }
+
+  auto exponent = 0;
+  std::from_chars(*(cur + 1) == '+' ? cur + 2 : cur + 1, end, exponent);
+
+  if (exponent < -4 || exponent >= 16)
+  {
+    // scientific notation is already formatted as required
+    return copyChars(out, buffer[0] == '-' ? buffer + 1 : buffer, end);
+  }
+
+  if (exponent < 0)
+  {
+    // 0.000ddd
+    *out++ = '0';
+    *out++ = '.';
+    out = fillZeros(out, -exponent - 1);
+    return copyChars(out, digits, digits + digitCount);
+  }
+
+  const auto integerDigits = exponent + 1;
+  if (digitCount <= integerDigits)
+  {
+    // ddd000
+    out = copyChars(out, digits, digits + digitCount);
+    return fillZeros(out, integerDigits - digitCount);
+  }
+
+  // ddd.ddd
+  out = copyChars(out, digits, digits + integerDigits);
+  *out++ = '.';
+  return copyChars(out, digits + integerDigits, digits + digitCount);
+}
+
+#endif
+
+} // namespace
+
+char* formatNumber(char* out, const double value)
+{
+  return formatFloat(out, value);
+}
+
+char* formatNumber(char* out, const float value)
+{
+  return formatFloat(out, value);
+}
+
+FormatBuffer::FormatBuffer(const size_t capacity)
+{
+  reserve(capacity);
+}
+
+size_t FormatBuffer::size() const
+{
+  return m_size;
+}
+
+bool FormatBuffer::empty() const
+{
+  return m_size == 0;
+}
+
+std::string_view FormatBuffer::view() const
+{
+  return std::string_view{m_data.data(), m_size};
+}
+
+std::string FormatBuffer::str() const
+{
+  return std::string{view()};
+}
+
+void FormatBuffer::reserve(const size_t capacity)
+{
+  if (capacity > m_data.size())
+  {
+    m_data.resize(std::max(capacity, 2 * m_data.size()));
+  }
+}
+
+void FormatBuffer::clear()
+{
+  m_size = 0;
+}
+
+FormatBuffer& FormatBuffer::append(const char c)
+{
+  reserve(m_size + 1);
+  m_data[m_size++] = c;
+  return *this;
+}
+
+FormatBuffer& FormatBuffer::append(const std::string_view str)
+{
+  return write(str.size(), [&](char* out) {
+    return copyChars(out, str.data(), str.data() + str.size());
+  });
+}
+
+} // namespace tb::io
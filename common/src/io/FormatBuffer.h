@@ -0,0 +1,124 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/vec.h"
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tb::io
+{
+
+/**
+ * The maximum number of characters written by formatNumber for a single value.
+ */
+constexpr auto MaxFormattedNumberLength = size_t(32);
+
+/**
+ * Writes the shortest decimal representation of the given value that parses back to the
+ * same value and returns a pointer past the last written character.
+ *
+ * The output is identical to fmt's default formatting: Fixed notation is used if the
+ * decimal exponent is in [-4, 16), otherwise scientific notation is used. Integral
+ * values are written without a fractional part.
+ *
+ * The given buffer must have room for at least MaxFormattedNumberLength characters.
+ */
+char* formatNumber(char* out, double value);
+char* formatNumber(char* out, float value);
+
+template <std::integral T>
+char* formatNumber(char* out, const T value)
+{
+  return std::to_chars(out, out + MaxFormattedNumberLength, value).ptr;
+}
+
+/**
+ * Writes the components of the given vector separated by a single space.
+ *
+ * The given buffer must have room for at least S * (MaxFormattedNumberLength + 1)
+ * characters.
+ */
+template <typename T, size_t S>
+char* formatVector(char* out, const vm::vec<T, S>& vec)
+{
+  out = formatNumber(out, vec[0]);
+  for (size_t i = 1; i < S; ++i)
+  {
+    *out++ = ' ';
+    out = formatNumber(out, vec[i]);
+  }
+  return out;
+}
+
+/**
+ * A growable character buffer for building serialized text. Unlike an output stream,
+ * formatting functions write directly into the buffer's memory, and the buffer keeps its
+ * capacity when it is cleared so that it can be reused without reallocating.
+ */
+class FormatBuffer
+{
+private:
+  std::vector<char> m_data;
+  size_t m_size = 0;
+
+public:
+  explicit FormatBuffer(size_t capacity = 0);
+
+  size_t size() const;
+  bool empty() const;
+  std::string_view view() const;
+  std::string str() const;
+
+  void reserve(size_t capacity);
+  void clear();
+
+  FormatBuffer& append(char c);
+  FormatBuffer& append(std::string_view str);
+
+  template <typename T>
+  FormatBuffer& appendNumber(const T value)
+  {
+    return write(MaxFormattedNumberLength, [&](char* out) {
+      return formatNumber(out, value);
+    });
+  }
+
+  /**
+   * Calls the given function with a pointer to at least maxLength writable characters at
+   * the end of the buffer. The function must return a pointer past the last character it
+   * has written.
+   */
+  template <typename F>
+  FormatBuffer& write(const size_t maxLength, const F& f)
+  {
+    reserve(m_size + maxLength);
+    char* const out = m_data.data() + m_size;
+    m_size += static_cast<size_t>(f(out) - out);
+    return *this;
+  }
+};
+
+} // namespace tb::io
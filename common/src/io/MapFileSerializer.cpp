@@ -22,6 +22,7 @@
 #include "Ensure.h"
 #include "Exceptions.h"
 #include "Macros.h"
+#include "io/FormatBuffer.h"
 #include "mdl/BezierPatch.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -36,11 +37,9 @@
 #include "kdl/string_format.h"
 #include "kdl/task_manager.h"
 
-#include <fmt/format.h>
-
-#include <iterator>
+#include <algorithm>
 #include <memory>
-#include <sstream>
+#include <ostream>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -57,30 +56,29 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(FormatBuffer& buffer, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeMaterialInfo(stream, face);
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    writeFacePoints(buffer, face);
+    writeMaterialInfo(buffer, face);
+    buffer.append('\n');
   }
 
 protected:
-  void writeFacePoints(std::ostream& stream, const mdl::BrushFace& face) const
+  void writeFacePoints(FormatBuffer& buffer, const mdl::BrushFace& face) const
   {
     const mdl::BrushFace::Points& points = face.points();
 
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(stream),
-      "( {} {} {} ) ( {} {} {} ) ( {} {} {} )",
-      points[0].x(),
-      points[0].y(),
-      points[0].z(),
-      points[1].x(),
-      points[1].y(),
-      points[1].z(),
-      points[2].x(),
-      points[2].y(),
-      points[2].z());
+    // format all nine coordinates in one go: ( x y z ) ( x y z ) ( x y z )
+    constexpr auto MaxPointLength = 3 * (MaxFormattedNumberLength + 1) + 4;
+    buffer.write(3 * MaxPointLength, [&](char* out) {
+      for (size_t i = 0; i < points.size(); ++i)
+      {
+        out = std::copy_n(i == 0 ? "( " : " ( ", i == 0 ? 2 : 3, out);
+        out = formatVector(out, points[i]);
+        out = std::copy_n(" )", 2, out);
+      }
+      return out;
+    });
   }
 
   static bool shouldQuoteMaterialName(const std::string& materialName)
@@ -89,56 +87,63 @@ protected:
            || materialName.find_first_of("\"\\ \t") != std::string::npos;
   }
 
-  static std::string quoteMaterialName(const std::string& materialName)
-  {
-    return "\"" + kdl::str_escape(materialName, "\"") + "\"";
-  }
-
-  void writeMaterialInfo(std::ostream& stream, const mdl::BrushFace& face) const
+  static void writeMaterialName(FormatBuffer& buffer, const mdl::BrushFace& face)
   {
     const std::string& materialName = face.attributes().materialName().empty()
                                         ? mdl::BrushFaceAttributes::NoMaterialName
                                         : face.attributes().materialName();
 
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(stream),
-      " {} {} {} {} {} {}",
-      shouldQuoteMaterialName(materialName) ? quoteMaterialName(materialName)
-                                            : materialName,
-      face.attributes().xOffset(),
-      face.attributes().yOffset(),
-      face.attributes().rotation(),
-      face.attributes().xScale(),
-      face.attributes().yScale());
+    buffer.append(' ');
+    if (shouldQuoteMaterialName(materialName))
+    {
+      buffer.append('"').append(kdl::str_escape(materialName, "\"")).append('"');
+    }
+    else
+    {
+      buffer.append(materialName);
+    }
   }
 
-  void writeValveMaterialInfo(std::ostream& stream, const mdl::BrushFace& face) const
+  void writeMaterialInfo(FormatBuffer& buffer, const mdl::BrushFace& face) const
   {
-    const std::string& materialName = face.attributes().materialName().empty()
-                                        ? mdl::BrushFaceAttributes::NoMaterialName
-                                        : face.attributes().materialName();
-    const vm::vec3d uAxis = face.uAxis();
-    const vm::vec3d vAxis = face.vAxis();
-
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(stream),
-      " {} [ {} {} {} {} ] [ {} {} {} {} ] {} {} {}",
-      shouldQuoteMaterialName(materialName) ? quoteMaterialName(materialName)
-                                            : materialName,
-
-      uAxis.x(),
-      uAxis.y(),
-      uAxis.z(),
-      face.attributes().xOffset(),
-
-      vAxis.x(),
-      vAxis.y(),
-      vAxis.z(),
-      face.attributes().yOffset(),
-
-      face.attributes().rotation(),
-      face.attributes().xScale(),
-      face.attributes().yScale());
+    writeMaterialName(buffer, face);
+
+    const auto& attributes = face.attributes();
+    buffer.append(' ')
+      .appendNumber(attributes.xOffset())
+      .append(' ')
+      .appendNumber(attributes.yOffset())
+      .append(' ')
+      .appendNumber(attributes.rotation())
+      .append(' ')
+      .appendNumber(attributes.xScale())
+      .append(' ')
+      .appendNumber(attributes.yScale());
+  }
+
+  void writeValveMaterialInfo(FormatBuffer& buffer, const mdl::BrushFace& face) const
+  {
+    writeMaterialName(buffer, face);
+
+    const auto& attributes = face.attributes();
+    buffer.append(" [ ")
+      .write(3 * (MaxFormattedNumberLength + 1), [&](char* out) {
+        return formatVector(out, face.uAxis());
+      })
+      .append(' ')
+      .appendNumber(attributes.xOffset())
+      .append(" ] [ ")
+      .write(3 * (MaxFormattedNumberLength + 1), [&](char* out) {
+        return formatVector(out, face.vAxis());
+      })
+      .append(' ')
+      .appendNumber(attributes.yOffset())
+      .append(" ] ")
+      .appendNumber(attributes.rotation())
+      .append(' ')
+      .appendNumber(attributes.xScale())
+      .append(' ')
+      .appendNumber(attributes.yScale());
   }
 };
 
@@ -151,28 +156,28 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(FormatBuffer& buffer, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeMaterialInfo(stream, face);
+    writeFacePoints(buffer, face);
+    writeMaterialInfo(buffer, face);
 
     if (face.attributes().hasSurfaceAttributes())
     {
-      writeSurfaceAttributes(stream, face);
+      writeSurfaceAttributes(buffer, face);
     }
 
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    buffer.append('\n');
   }
 
 protected:
-  void writeSurfaceAttributes(std::ostream& stream, const mdl::BrushFace& face) const
+  void writeSurfaceAttributes(FormatBuffer& buffer, const mdl::BrushFace& face) const
   {
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(stream),
-      " {} {} {}",
-      face.resolvedSurfaceContents(),
-      face.resolvedSurfaceFlags(),
-      face.resolvedSurfaceValue());
+    buffer.append(' ')
+      .appendNumber(face.resolvedSurfaceContents())
+      .append(' ')
+      .appendNumber(face.resolvedSurfaceFlags())
+      .append(' ')
+      .appendNumber(face.resolvedSurfaceValue());
   }
 };
 
@@ -185,17 +190,17 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(FormatBuffer& buffer, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeValveMaterialInfo(stream, face);
+    writeFacePoints(buffer, face);
+    writeValveMaterialInfo(buffer, face);
 
     if (face.attributes().hasSurfaceAttributes())
     {
-      writeSurfaceAttributes(stream, face);
+      writeSurfaceAttributes(buffer, face);
     }
 
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    buffer.append('\n');
   }
 };
 
@@ -212,32 +217,32 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(FormatBuffer& buffer, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeMaterialInfo(stream, face);
+    writeFacePoints(buffer, face);
+    writeMaterialInfo(buffer, face);
 
     if (face.attributes().hasSurfaceAttributes() || face.attributes().hasColor())
     {
-      writeSurfaceAttributes(stream, face);
+      writeSurfaceAttributes(buffer, face);
     }
     if (face.attributes().hasColor())
     {
-      writeSurfaceColor(stream, face);
+      writeSurfaceColor(buffer, face);
     }
 
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    buffer.append('\n');
   }
 
 protected:
-  void writeSurfaceColor(std::ostream& stream, const mdl::BrushFace& face) const
+  void writeSurfaceColor(FormatBuffer& buffer, const mdl::BrushFace& face) const
   {
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(stream),
-      " {} {} {}",
-      static_cast<int>(face.resolvedColor().r()),
-      static_cast<int>(face.resolvedColor().g()),
-      static_cast<int>(face.resolvedColor().b()));
+    buffer.append(' ')
+      .appendNumber(static_cast<int>(face.resolvedColor().r()))
+      .append(' ')
+      .appendNumber(static_cast<int>(face.resolvedColor().g()))
+      .append(' ')
+      .appendNumber(static_cast<int>(face.resolvedColor().b()));
   }
 };
 
@@ -250,12 +255,11 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(FormatBuffer& buffer, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeMaterialInfo(stream, face);
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(stream), " 0\n"); // extra value written here
+    writeFacePoints(buffer, face);
+    writeMaterialInfo(buffer, face);
+    buffer.append(" 0\n"); // extra value written here
   }
 };
 
@@ -268,15 +272,18 @@ public:
   }
 
 private:
-  void doWriteBrushFace(std::ostream& stream, const mdl::BrushFace& face) const override
+  void doWriteBrushFace(FormatBuffer& buffer, const mdl::BrushFace& face) const override
   {
-    writeFacePoints(stream, face);
-    writeValveMaterialInfo(stream, face);
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    writeFacePoints(buffer, face);
+    writeValveMaterialInfo(buffer, face);
+    buffer.append('\n');
   }
 };
 
-std::unique_ptr<NodeSerializer> MapFileSerializer::create(
+namespace
+{
+
+std::unique_ptr<MapFileSerializer> createSerializer(
   const mdl::MapFormat format, std::ostream& stream)
 {
   switch (format)
@@ -303,6 +310,24 @@ std::unique_ptr<NodeSerializer> MapFileSerializer::create(
   }
 }
 
+} // namespace
+
+std::unique_ptr<NodeSerializer> MapFileSerializer::create(
+  const mdl::MapFormat format, std::ostream& stream)
+{
+  return createSerializer(format, stream);
+}
+
+std::unique_ptr<NodeSerializer> MapFileSerializer::create(
+  const mdl::MapFormat format, std::ostream& stream, NodeSerializationCache& cache)
+{
+  cache.setFormat(format);
+
+  auto serializer = createSerializer(format, stream);
+  serializer->m_cache = &cache;
+  return serializer;
+}
+
 MapFileSerializer::MapFileSerializer(std::ostream& stream)
   : m_line(1)
   , m_stream(stream)
@@ -312,9 +337,11 @@ MapFileSerializer::MapFileSerializer(std::ostream& stream)
 void MapFileSerializer::doBeginFile(
   const std::vector<const mdl::Node*>& rootNodes, kdl::task_manager& taskManager)
 {
-  ensure(m_nodeToPrecomputedString.empty(), "MapFileSerializer may not be reused");
+  ensure(m_ownCache.empty(), "MapFileSerializer may not be reused");
 
-  // collect nodes
+  auto& nodeCache = cache();
+
+  // collect nodes that are not cached yet
   std::vector<std::variant<const mdl::BrushNode*, const mdl::PatchNode*>>
     nodesToSerialize;
   nodesToSerialize.reserve(rootNodes.size());
@@ -334,9 +361,17 @@ void MapFileSerializer::doBeginFile(
       [](auto&& thisLambda, const mdl::EntityNode* entity) {
         entity->visitChildren(thisLambda);
       },
-      [&](const mdl::BrushNode* brush) { nodesToSerialize.emplace_back(brush); },
+      [&](const mdl::BrushNode* brush) {
+        if (!nodeCache.find(brush))
+        {
+          nodesToSerialize.emplace_back(brush);
+        }
+      },
       [&](const mdl::PatchNode* patchNode) {
-        nodesToSerialize.emplace_back(patchNode);
+        if (!nodeCache.find(patchNode))
+        {
+          nodesToSerialize.emplace_back(patchNode);
+        }
       }));
 
   // serialize brushes to strings in parallel
@@ -355,87 +390,85 @@ void MapFileSerializer::doBeginFile(
                  }};
                });
 
-  // render strings and move them into a map
-  for (auto& entry : taskManager.run_tasks_and_wait(std::move(tasks)))
+  // render strings and move them into the cache
+  for (auto& [node, precomputedString] : taskManager.run_tasks_and_wait(std::move(tasks)))
   {
-    m_nodeToPrecomputedString.insert(std::move(entry));
+    nodeCache.insert(node, std::move(precomputedString));
   }
 }
 
-void MapFileSerializer::doEndFile() {}
+void MapFileSerializer::doEndFile()
+{
+  flush();
+}
 
 void MapFileSerializer::doBeginEntity(const mdl::Node* /* node */)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// entity {}\n", entityNo());
+  m_buffer.append("// entity ").appendNumber(entityNo()).append('\n');
   ++m_line;
   m_startLineStack.push_back(m_line);
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
+  m_buffer.append("{\n");
   ++m_line;
 }
 
 void MapFileSerializer::doEndEntity(const mdl::Node* node)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
+  m_buffer.append("}\n");
   ++m_line;
   setFilePosition(node);
+  flushIfFull();
 }
 
 void MapFileSerializer::doEntityProperty(const mdl::EntityProperty& attribute)
 {
-  fmt::format_to(
-    std::ostreambuf_iterator<char>(m_stream),
-    "\"{}\" \"{}\"\n",
-    escapeEntityProperties(attribute.key()),
-    escapeEntityProperties(attribute.value()));
+  m_buffer.append('"')
+    .append(escapeEntityProperties(attribute.key()))
+    .append("\" \"")
+    .append(escapeEntityProperties(attribute.value()))
+    .append("\"\n");
   ++m_line;
 }
 
 void MapFileSerializer::doBrush(const mdl::BrushNode* brush)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
+  m_buffer.append("// brush ").appendNumber(brushNo()).append('\n');
   ++m_line;
   m_startLineStack.push_back(m_line);
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
+  m_buffer.append("{\n");
   ++m_line;
 
   // write pre-serialized brush faces
-  auto it = m_nodeToPrecomputedString.find(brush);
-  ensure(
-    it != std::end(m_nodeToPrecomputedString),
-    "attempted to serialize a brush which was not passed to doBeginFile");
-  const PrecomputedString& precomputedString = it->second;
-  m_stream << precomputedString.string;
-  m_line += precomputedString.lineCount;
+  const auto& brushString = precomputedString(brush);
+  m_buffer.append(brushString.string);
+  m_line += brushString.lineCount;
 
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
+  m_buffer.append("}\n");
   ++m_line;
   setFilePosition(brush);
+  flushIfFull();
 }
 
 void MapFileSerializer::doBrushFace(const mdl::BrushFace& face)
 {
   const size_t lines = 1u;
-  doWriteBrushFace(m_stream, face);
+  doWriteBrushFace(m_buffer, face);
   face.setFilePosition(m_line, lines);
   m_line += lines;
 }
 
 void MapFileSerializer::doPatch(const mdl::PatchNode* patchNode)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
+  m_buffer.append("// brush ").appendNumber(brushNo()).append('\n');
   ++m_line;
   m_startLineStack.push_back(m_line);
 
   // write pre-serialized patch
-  auto it = m_nodeToPrecomputedString.find(patchNode);
-  ensure(
-    it != std::end(m_nodeToPrecomputedString),
-    "attempted to serialize a patch which was not passed to doBeginFile");
-  const PrecomputedString& precomputedString = it->second;
-  m_stream << precomputedString.string;
-  m_line += precomputedString.lineCount;
+  const auto& patchString = precomputedString(patchNode);
+  m_buffer.append(patchString.string);
+  m_line += patchString.lineCount;
 
   setFilePosition(patchNode);
+  flushIfFull();
 }
 
 void MapFileSerializer::setFilePosition(const mdl::Node* node)
@@ -452,70 +485,100 @@ size_t MapFileSerializer::startLine()
   return result;
 }
 
+void MapFileSerializer::flushIfFull()
+{
+  if (m_buffer.size() >= FlushThreshold)
+  {
+    flush();
+  }
+}
+
+void MapFileSerializer::flush()
+{
+  const auto text = m_buffer.view();
+  m_stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+  m_buffer.clear();
+}
+
+NodeSerializationCache& MapFileSerializer::cache()
+{
+  return m_cache ? *m_cache : m_ownCache;
+}
+
+const MapFileSerializer::PrecomputedString& MapFileSerializer::precomputedString(
+  const mdl::Node* node)
+{
+  const auto* entry = cache().find(node);
+  ensure(
+    entry != nullptr, "attempted to serialize a node which was not passed to doBeginFile");
+  return *entry;
+}
+
 /**
  * Threadsafe
  */
 MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(
   const mdl::Brush& brush) const
 {
-  std::stringstream stream;
+  // reuse one buffer per worker thread to avoid reallocating it for every brush
+  thread_local auto buffer = FormatBuffer{4096};
+  buffer.clear();
+
   for (const mdl::BrushFace& face : brush.faces())
   {
-    doWriteBrushFace(stream, face);
+    doWriteBrushFace(buffer, face);
   }
-  return PrecomputedString{stream.str(), brush.faces().size()};
+  return PrecomputedString{buffer.str(), brush.faces().size()};
 }
 
 MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
   const mdl::BezierPatch& patch) const
 {
+  thread_local auto buffer = FormatBuffer{4096};
+  buffer.clear();
+
   size_t lineCount = 0u;
-  std::stringstream stream;
 
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "{{\n");
+  buffer.append("{\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "patchDef2\n");
+  buffer.append("patchDef2\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "{{\n");
+  buffer.append("{\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "{}\n", patch.materialName());
+  buffer.append(patch.materialName()).append('\n');
   ++lineCount;
-  fmt::format_to(
-    std::ostreambuf_iterator<char>(stream),
-    "( {} {} 0 0 0 )\n",
-    patch.pointRowCount(),
-    patch.pointColumnCount());
+  buffer.append("( ")
+    .appendNumber(patch.pointRowCount())
+    .append(' ')
+    .appendNumber(patch.pointColumnCount())
+    .append(" 0 0 0 )\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "(\n");
+  buffer.append("(\n");
   ++lineCount;
 
   for (size_t row = 0u; row < patch.pointRowCount(); ++row)
   {
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "( ");
+    buffer.append("( ");
     for (size_t col = 0u; col < patch.pointColumnCount(); ++col)
     {
-      const auto& p = patch.controlPoint(row, col);
-      fmt::format_to(
-        std::ostreambuf_iterator<char>(stream),
-        "( {} {} {} {} {} ) ",
-        p[0],
-        p[1],
-        p[2],
-        p[3],
-        p[4]);
+      buffer.append("( ")
+        .write(5 * (MaxFormattedNumberLength + 1), [&](char* out) {
+          return formatVector(out, patch.controlPoint(row, col));
+        })
+        .append(" ) ");
     }
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), ")\n");
+    buffer.append(")\n");
     ++lineCount;
   }
 
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), ")\n");
+  buffer.append(")\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n");
+  buffer.append("}\n");
   ++lineCount;
-  fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n");
+  buffer.append("}\n");
   ++lineCount;
 
-  return PrecomputedString{stream.str(), lineCount};
+  return PrecomputedString{buffer.str(), lineCount};
 }
 
 } // namespace tb::io
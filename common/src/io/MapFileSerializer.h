@@ -19,15 +19,15 @@
 
 #pragma once
 
+#include "io/FormatBuffer.h"
+#include "io/NodeSerializationCache.h"
 #include "io/NodeSerializer.h"
 #include "mdl/MapFormat.h"
 
 #include <iosfwd>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
-
 namespace tb::mdl
 {
 class BezierPatch;
@@ -50,17 +50,28 @@ private:
   size_t m_line;
   std::ostream& m_stream;
 
-  struct PrecomputedString
-  {
-    std::string string;
-    size_t lineCount;
-  };
-  std::unordered_map<const mdl::Node*, PrecomputedString> m_nodeToPrecomputedString;
+  /**
+   * Output is collected here and written to the stream in large contiguous chunks.
+   */
+  static constexpr auto FlushThreshold = size_t(1024 * 1024);
+  FormatBuffer m_buffer;
+
+  using PrecomputedString = NodeSerializationCache::Entry;
+  NodeSerializationCache m_ownCache;
+  NodeSerializationCache* m_cache = nullptr;
 
 public:
   static std::unique_ptr<NodeSerializer> create(
     mdl::MapFormat format, std::ostream& stream);
 
+  /**
+   * Creates a serializer that takes the text of brushes and patches from the given
+   * cache and only serializes nodes which are not cached. Newly serialized nodes are
+   * added to the cache.
+   */
+  static std::unique_ptr<NodeSerializer> create(
+    mdl::MapFormat format, std::ostream& stream, NodeSerializationCache& cache);
+
 protected:
   explicit MapFileSerializer(std::ostream& stream);
 
@@ -82,9 +93,15 @@ private:
   void setFilePosition(const mdl::Node* node);
   size_t startLine();
 
+  void flushIfFull();
+  void flush();
+
+  NodeSerializationCache& cache();
+  const PrecomputedString& precomputedString(const mdl::Node* node);
+
 private: // threadsafe
   virtual void doWriteBrushFace(
-    std::ostream& stream, const mdl::BrushFace& face) const = 0;
+    FormatBuffer& buffer, const mdl::BrushFace& face) const = 0;
   PrecomputedString writeBrushFaces(const mdl::Brush& brush) const;
   PrecomputedString writePatch(const mdl::BezierPatch& patch) const;
 };
@@ -96,6 +96,17 @@ Result<void> MapReader::readBrushes(
          | kdl::transform([&]() { createNodes(status, taskManager); });
 }
 
+void MapReader::readObjectInfos(
+  std::vector<ObjectInfo> objectInfos,
+  const vm::bbox3d& worldBounds,
+  ParserStatus& status,
+  kdl::task_manager& taskManager)
+{
+  m_worldBounds = worldBounds;
+  m_objectInfos = std::move(objectInfos);
+  createNodes(status, taskManager);
+}
+
 Result<void> MapReader::readBrushFaces(
   const vm::bbox3d& worldBounds, ParserStatus& status)
 {
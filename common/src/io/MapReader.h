@@ -144,6 +144,16 @@ protected:
    * Attempts to parse as one or more brush faces.
    */
   Result<void> readBrushFaces(const vm::bbox3d& worldBounds, ParserStatus& status);
+  /**
+   * Creates nodes from object infos that were decoded without parsing map text, e.g.
+   * from a binary map. The parent indices of brushes and patches must refer to entities
+   * in the given vector.
+   */
+  void readObjectInfos(
+    std::vector<ObjectInfo> objectInfos,
+    const vm::bbox3d& worldBounds,
+    ParserStatus& status,
+    kdl::task_manager& taskManager);
 
 protected: // implement MapParser interface
   void onBeginEntity(
@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeSerializationCache.h"
+
+#include "mdl/Node.h"
+
+namespace tb::io
+{
+
+void NodeSerializationCache::setFormat(const mdl::MapFormat format)
+{
+  if (format != m_format)
+  {
+    clear();
+    m_format = format;
+  }
+}
+
+const NodeSerializationCache::Entry* NodeSerializationCache::find(
+  const mdl::Node* node) const
+{
+  const auto it = m_entries.find(node);
+  return it != m_entries.end() ? &it->second : nullptr;
+}
+
+void NodeSerializationCache::insert(const mdl::Node* node, Entry entry)
+{
+  m_entries.insert_or_assign(node, std::move(entry));
+}
+
+void NodeSerializationCache::invalidate(const std::vector<mdl::Node*>& nodes)
+{
+  for (const auto* node : nodes)
+  {
+    invalidate(node);
+  }
+}
+
+void NodeSerializationCache::invalidate(const mdl::Node* node)
+{
+  if (m_entries.empty())
+  {
+    return;
+  }
+
+  m_entries.erase(node);
+  for (const auto* child : node->children())
+  {
+    invalidate(child);
+  }
+}
+
+void NodeSerializationCache::clear()
+{
+  m_entries.clear();
+}
+
+size_t NodeSerializationCache::size() const
+{
+  return m_entries.size();
+}
+
+bool NodeSerializationCache::empty() const
+{
+  return m_entries.empty();
+}
+
+} // namespace tb::io
@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/MapFormat.h"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::mdl
+{
+class Node;
+}
+
+namespace tb::io
+{
+
+/**
+ * Keeps the serialized text of brushes and patches across saves so that only nodes
+ * that have changed since the last save need to be serialized again.
+ *
+ * The cache is keyed by node address, so the owner must invalidate nodes when they
+ * change and before they are removed from the map, and must clear the cache when the
+ * map is cleared. The cached text depends on the map format, so the cache is cleared
+ * when it is used with a different format.
+ *
+ * The cache is not thread safe.
+ */
+class NodeSerializationCache
+{
+public:
+  struct Entry
+  {
+    std::string string;
+    size_t lineCount;
+  };
+
+private:
+  mdl::MapFormat m_format = mdl::MapFormat::Unknown;
+  std::unordered_map<const mdl::Node*, Entry> m_entries;
+
+public:
+  /**
+   * Clears the cache if the given format differs from the format of the cached entries.
+   */
+  void setFormat(mdl::MapFormat format);
+
+  const Entry* find(const mdl::Node* node) const;
+  void insert(const mdl::Node* node, Entry entry);
+
+  /**
+   * Removes the given nodes and their descendants from the cache.
+   */
+  void invalidate(const std::vector<mdl::Node*>& nodes);
+  void invalidate(const mdl::Node* node);
+
+  void clear();
+
+  size_t size() const;
+  bool empty() const;
+};
+
+} // namespace tb::io
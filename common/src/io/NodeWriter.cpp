@@ -92,6 +92,12 @@ NodeWriter::NodeWriter(const mdl::WorldNode& world, std::ostream& stream)
 {
 }
 
+NodeWriter::NodeWriter(
+  const mdl::WorldNode& world, std::ostream& stream, NodeSerializationCache& cache)
+  : NodeWriter{world, MapFileSerializer::create(world.mapFormat(), stream, cache)}
+{
+}
+
 NodeWriter::NodeWriter(
   const mdl::WorldNode& world, std::unique_ptr<NodeSerializer> serializer)
   : m_world{world}
@@ -40,6 +40,7 @@ class WorldNode;
 
 namespace tb::io
 {
+class NodeSerializationCache;
 class NodeSerializer;
 
 class NodeWriter
@@ -52,6 +53,8 @@ private:
 
 public:
   NodeWriter(const mdl::WorldNode& world, std::ostream& stream);
+  NodeWriter(
+    const mdl::WorldNode& world, std::ostream& stream, NodeSerializationCache& cache);
   NodeWriter(const mdl::WorldNode& world, std::unique_ptr<NodeSerializer> serializer);
   ~NodeWriter();
 
@@ -67,6 +67,8 @@ private:
 private:
   virtual void doProgress(double progress) = 0;
   virtual void doLog(LogLevel level, const std::string& str);
+
+  friend class BufferedParserStatus;
 };
 
 } // namespace tb::io
@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrushFacePlanes.h"
+
+#include "mdl/Brush.h"
+#include "mdl/BrushFace.h"
+
+#include "vm/constants.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace tb::mdl
+{
+
+BrushFacePlanes::BrushFacePlanes(const Brush& brush)
+  : m_count{brush.faceCount()}
+  , m_paddedCount{(m_count + Lanes - 1) / Lanes * Lanes}
+  , m_values(4 * m_paddedCount, 0.0)
+{
+  for (size_t i = 0; i < m_count; ++i)
+  {
+    const auto& boundary = brush.face(i).boundary();
+    m_values[i] = boundary.normal.x();
+    m_values[m_paddedCount + i] = boundary.normal.y();
+    m_values[2 * m_paddedCount + i] = boundary.normal.z();
+    m_values[3 * m_paddedCount + i] = boundary.distance;
+  }
+
+  // the padding planes are parallel to every ray and contain every origin
+  for (size_t i = m_count; i < m_paddedCount; ++i)
+  {
+    m_values[3 * m_paddedCount + i] = 1.0;
+  }
+}
+
+size_t BrushFacePlanes::size() const
+{
+  return m_count;
+}
+
+std::optional<std::tuple<double, size_t>> BrushFacePlanes::intersectWithRay(
+  const vm::ray3d& ray) const
+{
+  constexpr auto epsilon = vm::constants<double>::almost_zero();
+  constexpr auto infinity = std::numeric_limits<double>::infinity();
+
+  const auto* normalX = m_values.data();
+  const auto* normalY = normalX + m_paddedCount;
+  const auto* normalZ = normalY + m_paddedCount;
+  const auto* distance = normalZ + m_paddedCount;
+
+  const auto originX = ray.origin.x();
+  const auto originY = ray.origin.y();
+  const auto originZ = ray.origin.z();
+  const auto directionX = ray.direction.x();
+  const auto directionY = ray.direction.y();
+  const auto directionZ = ray.direction.z();
+
+  const auto intersect = [&](const size_t i) {
+    const auto cos =
+      normalX[i] * directionX + normalY[i] * directionY + normalZ[i] * directionZ;
+    const auto dist =
+      distance[i] - (normalX[i] * originX + normalY[i] * originY + normalZ[i] * originZ);
+    return std::tuple{cos, dist, dist / cos};
+  };
+
+  // every lane keeps its own entry and exit distances so that the planes can be
+  // processed in groups of Lanes, the compiler maps the lanes to SIMD registers
+  double entry[Lanes];
+  double exit[Lanes];
+  for (size_t lane = 0; lane < Lanes; ++lane)
+  {
+    entry[lane] = -infinity;
+    exit[lane] = infinity;
+  }
+
+  for (size_t i = 0; i < m_paddedCount; i += Lanes)
+  {
+    for (size_t lane = 0; lane < Lanes; ++lane)
+    {
+      const auto [cos, dist, t] = intersect(i + lane);
+
+      // a plane parallel to the ray misses it if the origin is above the plane
+      const auto parallelExit = dist < -epsilon ? -infinity : infinity;
+
+      entry[lane] = std::max(entry[lane], cos < -epsilon ? t : -infinity);
+      exit[lane] = std::min(
+        exit[lane], cos > epsilon ? t : (cos < -epsilon ? infinity : parallelExit));
+    }
+  }
+
+  const auto maxEntry = *std::max_element(std::begin(entry), std::end(entry));
+  const auto minExit = *std::min_element(std::begin(exit), std::end(exit));
+
+  if (maxEntry < -epsilon || maxEntry > minExit + epsilon)
+  {
+    return std::nullopt;
+  }
+
+  // only hits need to find the face where the ray enters, and there must be one since
+  // the maximum entry distance is finite
+  auto faceEntry = -infinity;
+  auto faceIndex = size_t(0);
+  for (size_t i = 0; i < m_count; ++i)
+  {
+    const auto [cos, dist, t] = intersect(i);
+    if (cos < -epsilon && t > faceEntry)
+    {
+      faceEntry = t;
+      faceIndex = i;
+    }
+  }
+
+  return std::tuple{faceEntry, faceIndex};
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/ray.h"
+
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace tb::mdl
+{
+class Brush;
+
+/**
+ * The boundary planes of the faces of a brush, stored in a structure of arrays layout for
+ * fast ray picking.
+ *
+ * Since a brush is convex, a ray can be intersected with it by clipping the ray against
+ * the face planes without looking at the brush geometry.
+ */
+class BrushFacePlanes
+{
+private:
+  static constexpr size_t Lanes = 4;
+
+  size_t m_count = 0;
+
+  /**
+   * The number of planes rounded up to a multiple of Lanes.
+   */
+  size_t m_paddedCount = 0;
+
+  /**
+   * The x, y and z coordinates of the plane normals, followed by the plane distances,
+   * each stored contiguously and padded to m_paddedCount.
+   */
+  std::vector<double> m_values;
+
+public:
+  /**
+   * Collects the boundary planes of the faces of the given brush.
+   */
+  explicit BrushFacePlanes(const Brush& brush);
+
+  /**
+   * Returns the number of planes.
+   */
+  size_t size() const;
+
+  /**
+   * Intersects the given ray with the convex volume bounded by the planes.
+   *
+   * The ray enters the volume at the largest distance at which it crosses a plane that
+   * faces it, and it exits at the smallest distance at which it crosses a plane that
+   * faces away from it. The ray hits the volume if it enters before it exits.
+   *
+   * The planes are processed in groups without branching so that the compiler can use
+   * SIMD instructions to test several planes at once.
+   *
+   * Returns the distance to the entry point and the index of the face where the ray
+   * enters, or nothing if the ray misses the volume or starts inside of it.
+   */
+  std::optional<std::tuple<double, size_t>> intersectWithRay(const vm::ray3d& ray) const;
+};
+
+} // namespace tb::mdl
@@ -42,6 +42,7 @@
 #include "vm/vec.h"
 
 #include <algorithm>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -52,8 +53,10 @@ const HitType::Type BrushNode::BrushHitType = HitType::freeType();
 BrushNode::BrushNode(Brush brush)
   : m_brushRendererBrushCache(std::make_unique<render::BrushRendererBrushCache>())
   , m_brush(std::move(brush))
+  , m_facePlanes(m_brush)
 {
   clearSelectedFaces();
+  updateFaceTagMasks();
 }
 
 BrushNode::~BrushNode() = default;
@@ -92,12 +95,22 @@ const Brush& BrushNode::brush() const
 Brush BrushNode::setBrush(Brush brush)
 {
   const auto nodeChange = NotifyNodeChange{*this};
-  const auto boundsChange = NotifyPhysicalBoundsChange{*this};
+
+  // changing only face attributes keeps the bounds, so the node tree and the cached
+  // bounds of the ancestors need not be updated
+  auto boundsChange = std::optional<NotifyPhysicalBoundsChange>{};
+  if (brush.bounds() != m_brush.bounds())
+  {
+    boundsChange.emplace(*this);
+  }
 
   using std::swap;
   swap(m_brush, brush);
+  m_facePlanes = BrushFacePlanes{m_brush};
+  m_linkedContentHash = std::nullopt;
 
   updateSelectedFaceCount();
+  updateFaceTagMasks();
   invalidateIssues();
   invalidateVertexCache();
 
@@ -124,6 +137,7 @@ void BrushNode::deselectFace(const size_t faceIndex)
 void BrushNode::updateFaceTags(const size_t faceIndex, TagManager& tagManager)
 {
   m_brush.face(faceIndex).updateTags(tagManager);
+  updateFaceTagMasks();
 }
 
 void BrushNode::setFaceMaterial(const size_t faceIndex, Material* material)
@@ -366,14 +380,7 @@ std::optional<std::tuple<double, size_t>> BrushNode::findFaceHit(
 {
   if (vm::intersect_ray_bbox(ray, logicalBounds()))
   {
-    for (size_t i = 0u; i < m_brush.faceCount(); ++i)
-    {
-      const auto& face = m_brush.face(i);
-      if (const auto distance = face.intersectWithRay(ray))
-      {
-        return std::tuple{*distance, i};
-      }
-    }
+    return m_facePlanes.intersectWithRay(ray);
   }
   return std::nullopt;
 }
@@ -410,6 +417,7 @@ void BrushNode::initializeTags(TagManager& tagManager)
   {
     face.initializeTags(tagManager);
   }
+  updateFaceTagMasks();
 }
 
 void BrushNode::clearTags()
@@ -418,6 +426,7 @@ void BrushNode::clearTags()
   {
     face.clearTags();
   }
+  updateFaceTagMasks();
   Taggable::clearTags();
 }
 
@@ -427,47 +436,34 @@ void BrushNode::updateTags(TagManager& tagManager)
   {
     face.updateTags(tagManager);
   }
+  updateFaceTagMasks();
   Taggable::updateTags(tagManager);
 }
 
 bool BrushNode::allFacesHaveAnyTagInMask(TagType::Type tagMask) const
 {
-  // Possible optimization: Store the shared face tag mask in the brush and updated it
-  // when a face changes.
-
-  TagType::Type sharedFaceTags = TagType::AnyType; // set all bits to 1
-  for (const auto& face : m_brush.faces())
-  {
-    sharedFaceTags &= face.tagMask();
-  }
-  return (sharedFaceTags & tagMask) != 0;
+  return (m_allFacesTagMask & tagMask) != 0;
 }
 
 bool BrushNode::anyFaceHasAnyTag() const
 {
-  for (const auto& face : m_brush.faces())
-  {
-    if (face.hasAnyTag())
-    {
-      return true;
-    }
-  }
-  return false;
+  return m_anyFaceTagMask != 0;
 }
 
 bool BrushNode::anyFacesHaveAnyTagInMask(TagType::Type tagMask) const
 {
-  // Possible optimization: Store the shared face tag mask in the brush and updated it
-  // when a face changes.
+  return (m_anyFaceTagMask & tagMask) != 0;
+}
 
+void BrushNode::updateFaceTagMasks()
+{
+  m_allFacesTagMask = TagType::AnyType; // set all bits to 1
+  m_anyFaceTagMask = 0;
   for (const auto& face : m_brush.faces())
   {
-    if (face.hasTag(tagMask))
-    {
-      return true;
-    }
+    m_allFacesTagMask &= face.tagMask();
+    m_anyFaceTagMask |= face.tagMask();
   }
-  return false;
 }
 
 void BrushNode::doAcceptTagVisitor(TagVisitor& visitor)
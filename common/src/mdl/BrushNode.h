@@ -21,6 +21,7 @@
 
 #include "Macros.h"
 #include "mdl/Brush.h"
+#include "mdl/BrushFacePlanes.h"
 #include "mdl/BrushGeometry.h"
 #include "mdl/HitType.h"
 #include "mdl/Node.h"
@@ -62,6 +63,13 @@ private:
   Brush m_brush;               // must be destroyed before the brush renderer cache
   size_t m_selectedFaceCount = 0u;
 
+  // the face planes of the brush for picking, updated when the brush changes
+  BrushFacePlanes m_facePlanes;
+
+  // the tags shared by all faces and the tags of any face, updated when face tags change
+  TagType::Type m_allFacesTagMask = 0;
+  TagType::Type m_anyFaceTagMask = 0;
+
 public:
   explicit BrushNode(Brush brush);
   ~BrushNode() override;
@@ -157,6 +165,9 @@ public:
    */
   bool anyFacesHaveAnyTagInMask(TagType::Type tagMask) const;
 
+private:
+  void updateFaceTagMasks();
+
 private:
   void doAcceptTagVisitor(TagVisitor& visitor) override;
   void doAcceptTagVisitor(ConstTagVisitor& visitor) const override;
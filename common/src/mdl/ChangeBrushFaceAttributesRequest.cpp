@@ -20,12 +20,20 @@
 #include "ChangeBrushFaceAttributesRequest.h"
 
 #include "Macros.h"
+#include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushFaceHandle.h"
 #include "mdl/BrushNode.h"
 
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <ranges>
 #include <string>
+#include <unordered_map>
 
 namespace tb::mdl
 {
@@ -448,4 +456,85 @@ void ChangeBrushFaceAttributesRequest::setAllExceptContentFlags(
   setColor(attributes.color());
 }
 
+namespace
+{
+
+constexpr size_t ChangeAttributesChunkSize = 256;
+
+} // namespace
+
+std::vector<std::pair<BrushNode*, Brush>> changeBrushFaceAttributes(
+  const ChangeBrushFaceAttributesRequest& request,
+  const std::vector<BrushFaceHandle>& faces,
+  kdl::task_manager& taskManager)
+{
+  // group the face indices by brush, in the order in which the brushes first occur
+  auto brushNodes = std::vector<BrushNode*>{};
+  auto faceIndices = std::vector<std::vector<size_t>>{};
+  auto brushIndices = std::unordered_map<BrushNode*, size_t>{};
+
+  for (const auto& faceHandle : faces)
+  {
+    auto* brushNode = faceHandle.node();
+    const auto [it, inserted] = brushIndices.try_emplace(brushNode, brushNodes.size());
+    if (inserted)
+    {
+      brushNodes.push_back(brushNode);
+      faceIndices.emplace_back();
+    }
+    faceIndices[it->second].push_back(faceHandle.faceIndex());
+  }
+
+  const auto changeBrushes = [&](const size_t first, const size_t last) {
+    auto result = std::vector<std::pair<BrushNode*, Brush>>{};
+    for (size_t i = first; i < last; ++i)
+    {
+      const auto& brush = brushNodes[i]->brush();
+
+      // evaluate the request on copies of the faces first so that brushes which don't
+      // change aren't copied along with their geometry
+      const auto changesBrush =
+        std::ranges::any_of(faceIndices[i], [&](const auto faceIndex) {
+          auto face = brush.face(faceIndex);
+          return request.evaluate(face);
+        });
+
+      if (changesBrush)
+      {
+        // the faces of a brush point into its geometry, so a changed brush needs its own
+        // copy of the geometry
+        auto newBrush = brush;
+        for (const auto faceIndex : faceIndices[i])
+        {
+          request.evaluate(newBrush.face(faceIndex));
+        }
+        result.emplace_back(brushNodes[i], std::move(newBrush));
+      }
+    }
+    return result;
+  };
+
+  if (brushNodes.size() <= ChangeAttributesChunkSize)
+  {
+    return changeBrushes(0, brushNodes.size());
+  }
+
+  auto chunkStarts = std::vector<size_t>{};
+  for (size_t i = 0; i < brushNodes.size(); i += ChangeAttributesChunkSize)
+  {
+    chunkStarts.push_back(i);
+  }
+
+  auto tasks = chunkStarts | std::views::transform([&](const auto first) {
+                 return std::function{[&, first]() {
+                   const auto last =
+                     std::min(first + ChangeAttributesChunkSize, brushNodes.size());
+                   return changeBrushes(first, last);
+                 }};
+               });
+
+  // the chunks are returned in order, so the result is in the order of the given faces
+  return kdl::vec_flatten(taskManager.run_tasks_and_wait(tasks));
+}
+
 } // namespace tb::mdl
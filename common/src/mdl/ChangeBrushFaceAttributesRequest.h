@@ -23,13 +23,22 @@
 
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+}
 
 namespace tb::mdl
 {
 
+class Brush;
 class BrushFace;
 class BrushFaceHandle;
 class BrushFaceAttributes;
+class BrushNode;
 
 class ChangeBrushFaceAttributesRequest
 {
@@ -171,4 +180,17 @@ public:
   void setAllExceptContentFlags(const mdl::BrushFaceAttributes& attributes);
 };
 
+/**
+ * Evaluates the given request on copies of the brushes that contain the given faces. The
+ * brushes are evaluated in parallel chunks using the given task manager.
+ *
+ * Returns the changed brushes together with their nodes, in the order in which the nodes
+ * first occur in the given faces. Brushes where the request doesn't change any of the
+ * given faces are omitted and not copied.
+ */
+std::vector<std::pair<BrushNode*, Brush>> changeBrushFaceAttributes(
+  const ChangeBrushFaceAttributesRequest& request,
+  const std::vector<BrushFaceHandle>& faces,
+  kdl::task_manager& taskManager);
+
 } // namespace tb::mdl
@@ -64,17 +64,19 @@ DecalSpecification convertToDecal(
 kdl_reflect_impl(DecalSpecification);
 
 DecalDefinition::DecalDefinition()
-  : m_expression{el::LiteralExpression{el::Value::Undefined}}
+  : DecalDefinition{el::ExpressionNode{el::LiteralExpression{el::Value::Undefined}}}
 {
 }
 
 DecalDefinition::DecalDefinition(const FileLocation& location)
-  : m_expression{el::LiteralExpression{el::Value::Undefined}, location}
+  : DecalDefinition{
+      el::ExpressionNode{el::LiteralExpression{el::Value::Undefined}, location}}
 {
 }
 
 DecalDefinition::DecalDefinition(el::ExpressionNode expression)
   : m_expression{std::move(expression)}
+  , m_compiledExpression{m_expression}
 {
 }
 
@@ -85,16 +87,26 @@ void DecalDefinition::append(const DecalDefinition& other)
   auto cases =
     std::vector<el::ExpressionNode>{std::move(m_expression), other.m_expression};
   m_expression = el::ExpressionNode{el::SwitchExpression{std::move(cases)}, location};
+  m_compiledExpression =
+    el::CompiledExpression<Result<DecalSpecification>>{m_expression};
+}
+
+const el::ExpressionNode& DecalDefinition::expression() const
+{
+  return m_expression;
 }
 
 Result<DecalSpecification> DecalDefinition::decalSpecification(
   const el::VariableStore& variableStore) const
 {
-  return el::withEvaluationContext(
-    [&](auto& context) {
-      return convertToDecal(context, m_expression.evaluate(context));
-    },
-    variableStore);
+  return m_compiledExpression.evaluate(
+    variableStore, [](const auto& expression, const auto& variables) {
+      return el::withEvaluationContext(
+        [&](auto& context) {
+          return convertToDecal(context, expression.evaluate(context));
+        },
+        variables);
+    });
 }
 
 Result<DecalSpecification> DecalDefinition::defaultDecalSpecification() const
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Result.h"
+#include "el/CompiledExpression.h"
 #include "el/Expression.h"
 
 #include "kdl/reflection_decl.h"
@@ -48,6 +49,7 @@ class DecalDefinition
 {
 private:
   el::ExpressionNode m_expression;
+  el::CompiledExpression<Result<DecalSpecification>> m_compiledExpression;
 
 public:
   DecalDefinition();
@@ -56,9 +58,12 @@ public:
 
   void append(const DecalDefinition& other);
 
+  const el::ExpressionNode& expression() const;
+
   /**
    * Evaluates the decal expresion, using the given variable store to interpolate
-   * variables.
+   * variables. The result is memoized by the values of the variables that the
+   * expression reads.
    *
    * @param variableStore the variable store to use when interpolating variables
    * @return the decal specification or an error if evaluation failed
@@ -43,9 +43,11 @@ EntityDefinitionManager::~EntityDefinitionManager()
 Result<void> EntityDefinitionManager::loadDefinitions(
   const std::filesystem::path& path,
   const io::EntityDefinitionLoader& loader,
-  io::ParserStatus& status)
+  io::ParserStatus& status,
+  kdl::task_manager& taskManager,
+  const std::optional<std::filesystem::path>& cacheDirectory)
 {
-  return loader.loadEntityDefinitions(status, path)
+  return loader.loadEntityDefinitions(status, path, taskManager, cacheDirectory)
          | kdl::transform(
            [&](auto entityDefinitions) { setDefinitions(std::move(entityDefinitions)); });
 }
@@ -23,9 +23,14 @@
 
 #include <filesystem>
 #include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
 
 namespace tb::io
 {
@@ -55,7 +60,9 @@ public:
   Result<void> loadDefinitions(
     const std::filesystem::path& path,
     const io::EntityDefinitionLoader& loader,
-    io::ParserStatus& status);
+    io::ParserStatus& status,
+    kdl::task_manager& taskManager,
+    const std::optional<std::filesystem::path>& cacheDirectory = std::nullopt);
   void setDefinitions(std::vector<std::unique_ptr<EntityDefinition>> newDefinitions);
   void clear();
 
@@ -236,6 +236,7 @@ std::vector<Node*> EntityNode::nodesRequiredForViewSelection()
 
 void EntityNode::doPropertiesDidChange(const vm::bbox3d& /* oldBounds */)
 {
+  m_linkedContentHash = std::nullopt;
   nodePhysicalBoundsDidChange();
 }
 
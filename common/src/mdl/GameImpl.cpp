@@ -26,10 +26,12 @@
 #include "io/DiskFileSystem.h"
 #include "io/DiskIO.h"
 #include "io/EntParser.h"
+#include "io/EntityDefinitionCache.h"
 #include "io/FgdParser.h"
 #include "io/GameConfigParser.h"
 #include "io/LoadEntityModel.h"
 #include "io/NodeReader.h"
+#include "io/ParserStatus.h"
 #include "io/PathInfo.h"
 #include "io/SystemPaths.h"
 #include "io/TraversalMode.h"
@@ -64,7 +66,44 @@ GameImpl::GameImpl(GameConfig& config, std::filesystem::path gamePath, Logger& l
 }
 
 Result<std::vector<std::unique_ptr<EntityDefinition>>> GameImpl::loadEntityDefinitions(
-  io::ParserStatus& status, const std::filesystem::path& path) const
+  io::ParserStatus& status,
+  const std::filesystem::path& path,
+  kdl::task_manager& taskManager,
+  const std::optional<std::filesystem::path>& cacheDirectory) const
+{
+  const auto& defaultColor = m_config.entityConfig.defaultColor;
+
+  if (cacheDirectory)
+  {
+    if (auto cachedDefinitions =
+          io::readEntityDefinitionCache(*cacheDirectory, path, defaultColor);
+        cachedDefinitions.is_success())
+    {
+      return cachedDefinitions;
+    }
+  }
+
+  auto includedFiles = std::vector<std::filesystem::path>{};
+  return parseEntityDefinitions(status, path, taskManager, includedFiles)
+         | kdl::transform([&](auto definitions) {
+             if (cacheDirectory)
+             {
+               io::writeEntityDefinitionCache(
+                 *cacheDirectory, path, includedFiles, defaultColor, definitions)
+                 | kdl::transform_error([&](auto e) {
+                     status.warn(
+                       fmt::format("Could not cache entity definitions: {}", e.msg));
+                   });
+             }
+             return definitions;
+           });
+}
+
+Result<std::vector<std::unique_ptr<EntityDefinition>>> GameImpl::parseEntityDefinitions(
+  io::ParserStatus& status,
+  const std::filesystem::path& path,
+  kdl::task_manager& taskManager,
+  std::vector<std::filesystem::path>& includedFiles) const
 {
   const auto extension = kdl::path_to_lower(path.extension());
   const auto& defaultColor = m_config.entityConfig.defaultColor;
@@ -73,8 +112,11 @@ Result<std::vector<std::unique_ptr<EntityDefinition>>> GameImpl::loadEntityDefin
   {
     return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
              auto reader = file->reader().buffer();
-             auto parser = io::FgdParser{reader.stringView(), defaultColor, path};
-             return parser.parseDefinitions(status);
+             auto parser =
+               io::FgdParser{reader.stringView(), defaultColor, path, &taskManager};
+             auto definitions = parser.parseDefinitions(status);
+             includedFiles = parser.includedFiles();
+             return definitions;
            });
   }
   if (extension == ".def")
@@ -25,6 +25,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -50,7 +51,10 @@ public:
 
 public: // implement EntityDefinitionLoader interface:
   Result<std::vector<std::unique_ptr<EntityDefinition>>> loadEntityDefinitions(
-    io::ParserStatus& status, const std::filesystem::path& path) const override;
+    io::ParserStatus& status,
+    const std::filesystem::path& path,
+    kdl::task_manager& taskManager,
+    const std::optional<std::filesystem::path>& cacheDirectory) const override;
 
 public: // implement Game interface
   const GameConfig& config() const override;
@@ -87,6 +91,12 @@ public: // implement Game interface
 private:
   void initializeFileSystem(Logger& logger);
 
+  Result<std::vector<std::unique_ptr<EntityDefinition>>> parseEntityDefinitions(
+    io::ParserStatus& status,
+    const std::filesystem::path& path,
+    kdl::task_manager& taskManager,
+    std::vector<std::filesystem::path>& includedFiles) const;
+
   EntityPropertyConfig entityPropertyConfig() const;
 
   void writeLongAttribute(
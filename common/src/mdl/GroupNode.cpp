@@ -53,6 +53,7 @@ Group GroupNode::setGroup(Group group)
 {
   using std::swap;
   swap(m_group, group);
+  m_linkedContentHash = std::nullopt;
   return group;
 }
 
@@ -25,15 +25,25 @@
 #include "mdl/Node.h"
 #include "mdl/NodeContents.h"
 #include "mdl/NodeQueries.h"
+#include "mdl/UVCoordSystem.h"
 
 #include "kdl/grouped_range.h"
+#include "kdl/hash_utils.h"
 #include "kdl/result.h"
 #include "kdl/result_fold.h"
 #include "kdl/task_manager.h"
 #include "kdl/zip_iterator.h"
 
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <string_view>
+#include <tuple>
+#include <typeinfo>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace tb::mdl
 {
@@ -200,149 +210,210 @@ FaceSelectionResult faceSelectionWithLinkedGroupConstraints(
 
 namespace
 {
-Result<std::unique_ptr<Node>> cloneAndTransformRecursive(
-  const Node* nodeToClone,
-  std::unordered_map<const Node*, NodeContents>& origNodeToTransformedContents,
-  const vm::bbox3d& worldBounds)
+
+/**
+ * Computes 64 bit FNV-1a hashes of node contents. These are used to decide whether the
+ * contents of a linked node are up to date, so the hash must not be weakened.
+ */
+class ContentHasher
+{
+private:
+  std::uint64_t m_hash = kdl::fnv1a_64_offset_basis;
+
+public:
+  ContentHasher() = default;
+
+  explicit ContentHasher(const std::uint64_t seed)
+    : m_hash{seed}
+  {
+  }
+
+  std::uint64_t hash() const { return m_hash; }
+
+  template <typename T>
+    requires std::is_arithmetic_v<T>
+  ContentHasher& add(const T value)
+  {
+    m_hash =
+      kdl::fnv1a_64(reinterpret_cast<const unsigned char*>(&value), sizeof(T), m_hash);
+    return *this;
+  }
+
+  ContentHasher& add(const std::string& str)
+  {
+    add(str.size());
+    m_hash = kdl::fnv1a_64(str, m_hash);
+    return *this;
+  }
+
+  template <typename T, size_t S>
+  ContentHasher& add(const vm::vec<T, S>& vec)
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      add(vec[i]);
+    }
+    return *this;
+  }
+
+  template <typename T, size_t R, size_t C>
+  ContentHasher& add(const vm::mat<T, R, C>& mat)
+  {
+    for (size_t i = 0; i < C; ++i)
+    {
+      add(mat[i]);
+    }
+    return *this;
+  }
+
+  ContentHasher& add(const vm::bbox3d& bounds) { return add(bounds.min).add(bounds.max); }
+
+  template <typename T>
+  ContentHasher& add(const std::optional<T>& optional)
+  {
+    add(optional.has_value());
+    return optional ? add(*optional) : *this;
+  }
+
+  template <typename T>
+  ContentHasher& add(const std::vector<T>& vector)
+  {
+    add(vector.size());
+    for (const auto& element : vector)
+    {
+      add(element);
+    }
+    return *this;
+  }
+
+  ContentHasher& add(const EntityProperty& property)
+  {
+    return add(property.key()).add(property.value());
+  }
+
+  ContentHasher& add(const Group& group)
+  {
+    return add(group.name()).add(group.transformation());
+  }
+
+  ContentHasher& add(const Entity& entity)
+  {
+    return add(entity.properties())
+      .add(entity.protectedProperties())
+      .add(entity.pointEntity())
+      .add(entity.definitionBounds());
+  }
+
+  ContentHasher& add(const BrushFace& face)
+  {
+    const auto& attributes = face.attributes();
+    return add(face.points()[0])
+      .add(face.points()[1])
+      .add(face.points()[2])
+      .add(attributes.materialName())
+      .add(attributes.offset())
+      .add(attributes.scale())
+      .add(attributes.rotation())
+      .add(attributes.surfaceContents())
+      .add(attributes.surfaceFlags())
+      .add(attributes.surfaceValue())
+      .add(attributes.color())
+      .add(typeid(face.uvCoordSystem()).hash_code())
+      .add(face.uAxis())
+      .add(face.vAxis());
+  }
+
+  ContentHasher& add(const Brush& brush) { return add(brush.faces()); }
+
+  ContentHasher& add(const BezierPatch& patch)
+  {
+    return add(patch.pointRowCount())
+      .add(patch.pointColumnCount())
+      .add(patch.controlPoints())
+      .add(patch.materialName());
+  }
+};
+
+std::uint64_t hashContents(const Node& node)
 {
-  // First, clone `n`, and move in the new (transformed) content which was
-  // prepared for it above
-  auto clone = nodeToClone->accept(kdl::overload(
-    [](const WorldNode*) -> std::unique_ptr<Node> {
+  return node.accept(kdl::overload(
+    [](const WorldNode*) -> std::uint64_t {
       ensure(false, "Linked group structure is valid");
     },
-    [](const LayerNode*) -> std::unique_ptr<Node> {
+    [](const LayerNode*) -> std::uint64_t {
       ensure(false, "Linked group structure is valid");
     },
-    [&](const GroupNode* groupNode) -> std::unique_ptr<Node> {
-      auto& group = std::get<Group>(origNodeToTransformedContents.at(groupNode).get());
-      auto newGroupNode = std::make_unique<GroupNode>(std::move(group));
-      newGroupNode->setLinkId(groupNode->linkId());
-      return newGroupNode;
+    [](const GroupNode* groupNode) {
+      return ContentHasher{}.add(0).add(groupNode->group()).hash();
     },
-    [&](const EntityNode* entityNode) -> std::unique_ptr<Node> {
-      auto& entity = std::get<Entity>(origNodeToTransformedContents.at(entityNode).get());
-      auto newEntityNode = std::make_unique<EntityNode>(std::move(entity));
-      newEntityNode->setLinkId(entityNode->linkId());
-      return newEntityNode;
+    [](const EntityNode* entityNode) {
+      const auto updateAngleProperty =
+        entityNode->entityPropertyConfig().updateAnglePropertyAfterTransform;
+      return ContentHasher{}
+        .add(1)
+        .add(entityNode->entity())
+        .add(updateAngleProperty)
+        .hash();
     },
-    [&](const BrushNode* brushNode) -> std::unique_ptr<Node> {
-      auto& brush = std::get<Brush>(origNodeToTransformedContents.at(brushNode).get());
-      auto newBrushNode = std::make_unique<BrushNode>(std::move(brush));
-      newBrushNode->setLinkId(brushNode->linkId());
-      return newBrushNode;
+    [](const BrushNode* brushNode) {
+      return ContentHasher{}.add(2).add(brushNode->brush()).hash();
     },
-    [&](const PatchNode* patchNode) -> std::unique_ptr<Node> {
-      auto& patch =
-        std::get<BezierPatch>(origNodeToTransformedContents.at(patchNode).get());
-      auto newPatchNode = std::make_unique<PatchNode>(std::move(patch));
-      newPatchNode->setLinkId(patchNode->linkId());
-      return newPatchNode;
+    [](const PatchNode* patchNode) {
+      return ContentHasher{}.add(3).add(patchNode->patch()).hash();
     }));
+}
 
-  if (!worldBounds.contains(clone->logicalBounds()))
-  {
-    return Error{"Updating a linked node would exceed world bounds"};
-  }
-
-  return kdl::vec_transform(
-           nodeToClone->children(),
-           [&](const auto* childNode) {
-             return cloneAndTransformRecursive(
-               childNode, origNodeToTransformedContents, worldBounds);
-           })
-         | kdl::fold | kdl::transform([&](auto childClones) {
-             for (auto& childClone : childClones)
-             {
-               clone->addChild(childClone.release());
-             }
-
-             return std::move(clone);
-           });
+const Object& toObject(const Node& node)
+{
+  return *node.accept(kdl::overload(
+    [](const WorldNode*) -> const Object* {
+      ensure(false, "Linked group structure is valid");
+    },
+    [](const LayerNode*) -> const Object* {
+      ensure(false, "Linked group structure is valid");
+    },
+    [](const Object* object) { return object; }));
 }
 
 /**
- * Given a node, clones its children recursively and applies the given transform.
- *
- * Returns a vector of the cloned direct children of `node`.
+ * A descendant of the source group node. The descendants are stored in preorder, and the
+ * child count is used to restore the tree structure.
  */
-Result<std::vector<std::unique_ptr<Node>>> cloneAndTransformChildren(
-  const Node& node,
-  const vm::bbox3d& worldBounds,
-  const vm::mat4x4d& transformation,
-  kdl::task_manager& taskManager)
+struct SourceNode
 {
-  auto nodesToClone = collectDescendants(std::vector{&node});
-
-  using TransformResult = Result<std::pair<const Node*, NodeContents>>;
-
-  // In parallel, produce pairs { node pointer, transformed contents } from the nodes in
-  // `nodesToClone`
-  auto tasks =
-    nodesToClone | std::views::transform([&](const auto& nodeToTransform) {
-      return std::function{[&]() {
-        return nodeToTransform->accept(kdl::overload(
-          [](const WorldNode*) -> TransformResult {
-            ensure(false, "Linked group structure is valid");
-          },
-          [](const LayerNode*) -> TransformResult {
-            ensure(false, "Linked group structure is valid");
-          },
-          [&](const GroupNode* groupNode) -> TransformResult {
-            auto group = groupNode->group();
-            group.transform(transformation);
-            return std::make_pair(nodeToTransform, NodeContents{std::move(group)});
-          },
-          [&](const EntityNode* entityNode) -> TransformResult {
-            const auto updateAngleProperty =
-              entityNode->entityPropertyConfig().updateAnglePropertyAfterTransform;
-            auto entity = entityNode->entity();
-            entity.transform(transformation, updateAngleProperty);
-            return std::make_pair(nodeToTransform, NodeContents{std::move(entity)});
-          },
-          [&](const BrushNode* brushNode) -> TransformResult {
-            auto brush = brushNode->brush();
-            return brush.transform(worldBounds, transformation, true)
-                   | kdl::and_then([&]() -> TransformResult {
-                       return std::make_pair(
-                         nodeToTransform, NodeContents{std::move(brush)});
-                     });
-          },
-          [&](const PatchNode* patchNode) -> TransformResult {
-            auto patch = patchNode->patch();
-            patch.transform(transformation);
-            return std::make_pair(nodeToTransform, NodeContents{std::move(patch)});
-          }));
-      }};
-    });
+  const Node* node;
+  size_t childCount;
+  std::uint64_t contentHash;
+};
 
-  return taskManager.run_tasks_and_wait(tasks) | kdl::fold
-         | kdl::or_else(
-           [](const auto&) -> Result<std::vector<std::pair<const Node*, NodeContents>>> {
-             return Error{"Failed to transform a linked node"};
-           })
-         | kdl::and_then(
-           [&](auto origNodeAndTransformedContents)
-             -> Result<std::vector<std::unique_ptr<Node>>> {
-             // Move into map for easier lookup
-             auto resultsMap = std::unordered_map<const Node*, NodeContents>{
-               origNodeAndTransformedContents.begin(),
-               origNodeAndTransformedContents.end()};
-             origNodeAndTransformedContents.clear();
-
-             // Do a recursive traversal of the input node tree again,
-             // creating a matching tree structure, and move in the contents
-             // we've transformed above.
-             return kdl::vec_transform(
-                      node.children(),
-                      [&](const auto* childNode) {
-                        return cloneAndTransformRecursive(
-                          childNode, resultsMap, worldBounds);
-                      })
-                    | kdl::fold;
-           });
+void collectSourceNodes(const Node& node, std::vector<SourceNode>& result)
+{
+  for (const auto* childNode : node.children())
+  {
+    result.push_back({childNode, childNode->childCount(), hashContents(*childNode)});
+    collectSourceNodes(*childNode, result);
+  }
 }
 
+struct TargetGroup
+{
+  GroupNode* groupNode;
+  vm::mat4x4d transformation;
+  std::uint64_t transformationHash;
+  std::unordered_map<std::string_view, const Node*> correspondingNodes;
+};
+
+/**
+ * The contents of a node to create in a target group, either transformed from a source
+ * node or copied from the corresponding node if that was up to date.
+ */
+struct TargetContents
+{
+  std::optional<NodeContents> contents;
+  std::uint64_t linkedContentHash = 0;
+  bool upToDate = false;
+};
+
 auto makeLinkIdToNodeMap(const std::vector<Node*>& nodes)
 {
   auto result = std::unordered_map<std::string_view, const Node*>{};
@@ -368,58 +439,23 @@ auto makeLinkIdToNodeMap(const std::vector<Node*>& nodes)
   return result;
 }
 
-template <typename N>
-const N* getCorrespondingNode(
+const Node* getCorrespondingNode(
   const std::unordered_map<std::string_view, const Node*>& correspondingNodes,
   const std::string_view linkId)
 {
   auto it = correspondingNodes.find(linkId);
-  return it != correspondingNodes.end() ? dynamic_cast<const N*>(it->second) : nullptr;
-}
-
-template <typename T>
-void preserveGroupNames(
-  const std::vector<T>& clonedNodes,
-  const std::unordered_map<std::string_view, const Node*>& correspondingNodes)
-{
-  return Node::visitAll(
-    clonedNodes,
-    kdl::overload(
-      [](auto&& thisLambda, const WorldNode* worldNode) {
-        worldNode->visitChildren(thisLambda);
-      },
-      [](auto&& thisLambda, const LayerNode* layerNode) {
-        layerNode->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, GroupNode* groupNode) {
-        if (
-          const auto* correspondingNode =
-            getCorrespondingNode<GroupNode>(correspondingNodes, groupNode->linkId()))
-        {
-          auto group = groupNode->group();
-          group.setName(correspondingNode->group().name());
-          groupNode->setGroup(std::move(group));
-        }
-        groupNode->visitChildren(thisLambda);
-      },
-      [](const EntityNode*) {},
-      [](const BrushNode*) {},
-      [](const PatchNode*) {}));
+  return it != correspondingNodes.end() ? it->second : nullptr;
 }
 
-void preserveEntityProperties(
-  EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode)
+void preserveEntityProperties(Entity& clonedEntity, const Entity& correspondingEntity)
 {
   if (
-    clonedEntityNode.entity().protectedProperties().empty()
-    && correspondingEntityNode.entity().protectedProperties().empty())
+    clonedEntity.protectedProperties().empty()
+    && correspondingEntity.protectedProperties().empty())
   {
     return;
   }
 
-  auto clonedEntity = clonedEntityNode.entity();
-  const auto& correspondingEntity = correspondingEntityNode.entity();
-
   const auto allProtectedProperties = kdl::vec_sort_and_remove_duplicates(kdl::vec_concat(
     clonedEntity.protectedProperties(), correspondingEntity.protectedProperties()));
 
@@ -434,38 +470,290 @@ void preserveEntityProperties(
       clonedEntity.addOrUpdateProperty(propertyKey, *propertyValue);
     }
   }
+}
+
+/**
+ * Transforms the contents of the given source node into a target group. Group names and
+ * protected entity properties are taken from the corresponding node in the target group,
+ * if any.
+ */
+Result<NodeContents> transformContents(
+  const Node& sourceNode,
+  const Node* correspondingNode,
+  const vm::mat4x4d& transformation,
+  const vm::bbox3d& worldBounds)
+{
+  return sourceNode.accept(kdl::overload(
+    [](const WorldNode*) -> Result<NodeContents> {
+      ensure(false, "Linked group structure is valid");
+    },
+    [](const LayerNode*) -> Result<NodeContents> {
+      ensure(false, "Linked group structure is valid");
+    },
+    [&](const GroupNode* groupNode) -> Result<NodeContents> {
+      auto group = groupNode->group();
+      group.transform(transformation);
+      if (
+        const auto* correspondingGroupNode =
+          dynamic_cast<const GroupNode*>(correspondingNode))
+      {
+        group.setName(correspondingGroupNode->group().name());
+      }
+      return NodeContents{std::move(group)};
+    },
+    [&](const EntityNode* entityNode) -> Result<NodeContents> {
+      const auto updateAngleProperty =
+        entityNode->entityPropertyConfig().updateAnglePropertyAfterTransform;
+      auto entity = entityNode->entity();
+      entity.transform(transformation, updateAngleProperty);
+      if (
+        const auto* correspondingEntityNode =
+          dynamic_cast<const EntityNode*>(correspondingNode))
+      {
+        preserveEntityProperties(entity, correspondingEntityNode->entity());
+      }
+      return NodeContents{std::move(entity)};
+    },
+    [&](const BrushNode* brushNode) -> Result<NodeContents> {
+      auto brush = brushNode->brush();
+      return brush.transform(worldBounds, transformation, true)
+             | kdl::and_then(
+               [&]() -> Result<NodeContents> { return NodeContents{std::move(brush)}; });
+    },
+    [&](const PatchNode* patchNode) -> Result<NodeContents> {
+      auto patch = patchNode->patch();
+      patch.transform(transformation);
+      return NodeContents{std::move(patch)};
+    }));
+}
+
+NodeContents copyContents(const Node& node)
+{
+  return node.accept(kdl::overload(
+    [](const WorldNode*) -> NodeContents {
+      ensure(false, "Linked group structure is valid");
+    },
+    [](const LayerNode*) -> NodeContents {
+      ensure(false, "Linked group structure is valid");
+    },
+    [](const GroupNode* groupNode) { return NodeContents{groupNode->group()}; },
+    [](const EntityNode* entityNode) { return NodeContents{entityNode->entity()}; },
+    [](const BrushNode* brushNode) { return NodeContents{brushNode->brush()}; },
+    [](const PatchNode* patchNode) { return NodeContents{patchNode->patch()}; }));
+}
+
+Result<void> computeTargetContents(
+  const SourceNode& sourceNode,
+  const TargetGroup& targetGroup,
+  const vm::bbox3d& worldBounds,
+  TargetContents& targetContents)
+{
+  const auto& linkId = toObject(*sourceNode.node).linkId();
+  const auto* correspondingNode =
+    getCorrespondingNode(targetGroup.correspondingNodes, linkId);
+
+  targetContents.linkedContentHash =
+    ContentHasher{sourceNode.contentHash}.add(targetGroup.transformationHash).hash();
+
+  if (
+    correspondingNode
+    && toObject(*correspondingNode).linkedContentHash()
+         == targetContents.linkedContentHash)
+  {
+    targetContents.contents = copyContents(*correspondingNode);
+    targetContents.upToDate = true;
+    return kdl::void_success;
+  }
+
+  return transformContents(
+           *sourceNode.node, correspondingNode, targetGroup.transformation, worldBounds)
+         | kdl::transform([&](auto contents) {
+             targetContents.contents = std::move(contents);
+             targetContents.upToDate = false;
+           });
+}
+
+/**
+ * Checks whether the children of the given target group node have the same structure as
+ * the source nodes and are all up to date.
+ */
+bool isUpToDate(
+  const Node& targetNode,
+  const std::vector<SourceNode>& sourceNodes,
+  const std::span<const TargetContents> targetContents,
+  size_t& index)
+{
+  for (const auto* childNode : targetNode.children())
+  {
+    if (
+      index >= sourceNodes.size() || !targetContents[index].upToDate
+      || toObject(*childNode).linkId() != toObject(*sourceNodes[index].node).linkId()
+      || childNode->childCount() != sourceNodes[index].childCount)
+    {
+      return false;
+    }
+
+    ++index;
+    if (!isUpToDate(*childNode, sourceNodes, targetContents, index))
+    {
+      return false;
+    }
+  }
+  return true;
+}
 
-  clonedEntityNode.setEntity(std::move(clonedEntity));
+bool isUpToDate(
+  const GroupNode& targetGroupNode,
+  const std::vector<SourceNode>& sourceNodes,
+  const std::span<const TargetContents> targetContents)
+{
+  auto index = size_t(0);
+  return isUpToDate(targetGroupNode, sourceNodes, targetContents, index)
+         && index == sourceNodes.size();
 }
 
-template <typename T>
-void preserveEntityProperties(
-  const std::vector<T>& clonedNodes,
-  const std::unordered_map<std::string_view, const Node*>& correspondingNodes)
+template <typename N, typename C>
+std::unique_ptr<Node> createNode(
+  C contents, const std::string& linkId, const std::uint64_t linkedContentHash)
 {
-  return Node::visitAll(
-    clonedNodes,
+  auto node = std::make_unique<N>(std::move(contents));
+  node->setLinkId(linkId);
+  node->setLinkedContentHash(linkedContentHash);
+  return node;
+}
+
+/**
+ * Creates the node at the given preorder index and its descendants from the given target
+ * contents.
+ */
+Result<std::unique_ptr<Node>> createNodes(
+  const std::vector<SourceNode>& sourceNodes,
+  const std::span<TargetContents> targetContents,
+  const vm::bbox3d& worldBounds,
+  size_t& index)
+{
+  const auto& sourceNode = sourceNodes[index];
+  auto& contents = targetContents[index];
+  ++index;
+
+  const auto& linkId = toObject(*sourceNode.node).linkId();
+  auto node = std::visit(
     kdl::overload(
-      [](auto&& thisLambda, const WorldNode* worldNode) {
-        worldNode->visitChildren(thisLambda);
+      [](Layer&) -> std::unique_ptr<Node> {
+        ensure(false, "Linked group structure is valid");
       },
-      [](auto&& thisLambda, const LayerNode* layerNode) {
-        layerNode->visitChildren(thisLambda);
+      [&](Group& group) {
+        return createNode<GroupNode>(
+          std::move(group), linkId, contents.linkedContentHash);
       },
-      [](auto&& thisLambda, const GroupNode* groupNode) {
-        groupNode->visitChildren(thisLambda);
+      [&](Entity& entity) {
+        return createNode<EntityNode>(
+          std::move(entity), linkId, contents.linkedContentHash);
+      },
+      [&](Brush& brush) {
+        return createNode<BrushNode>(
+          std::move(brush), linkId, contents.linkedContentHash);
       },
-      [&](EntityNode* entityNode) {
-        if (
-          const auto* correspondingNode =
-            getCorrespondingNode<EntityNode>(correspondingNodes, entityNode->linkId()))
+      [&](BezierPatch& patch) {
+        return createNode<PatchNode>(
+          std::move(patch), linkId, contents.linkedContentHash);
+      }),
+    contents.contents->get());
+  contents.contents = std::nullopt;
+
+  if (!contents.upToDate && !worldBounds.contains(node->logicalBounds()))
+  {
+    return Error{"Updating a linked node would exceed world bounds"};
+  }
+
+  for (size_t i = 0; i < sourceNode.childCount; ++i)
+  {
+    auto childNode = createNodes(sourceNodes, targetContents, worldBounds, index);
+    if (childNode.is_error())
+    {
+      return childNode;
+    }
+    node->addChild(std::move(childNode).value().release());
+  }
+
+  return node;
+}
+
+Result<std::vector<std::unique_ptr<Node>>> createChildNodes(
+  const GroupNode& sourceGroupNode,
+  const std::vector<SourceNode>& sourceNodes,
+  const std::span<TargetContents> targetContents,
+  const vm::bbox3d& worldBounds)
+{
+  auto index = size_t(0);
+  return sourceGroupNode.children() | std::views::transform([&](const auto*) {
+           return createNodes(sourceNodes, targetContents, worldBounds, index);
+         })
+         | kdl::fold;
+}
+
+template <typename N>
+void collectDescendantsInPreorder(N& node, std::vector<N*>& result)
+{
+  for (auto* childNode : node.children())
+  {
+    result.push_back(childNode);
+    collectDescendantsInPreorder<N>(*childNode, result);
+  }
+}
+
+bool hasSameStructure(
+  const std::vector<const Node*>& sourceNodes, const std::vector<Node*>& targetNodes)
+{
+  return sourceNodes.size() == targetNodes.size()
+         && std::ranges::equal(
+           sourceNodes, targetNodes, [](const auto* sourceNode, const auto* targetNode) {
+             return toObject(*sourceNode).linkId() == toObject(*targetNode).linkId()
+                    && sourceNode->childCount() == targetNode->childCount();
+           });
+}
+
+/**
+ * Returns the logical bounds the given target node will have once its contents have been
+ * replaced by the given contents, or nothing if the bounds are determined by the node's
+ * children.
+ *
+ * The bounds of layers, groups and brush entities are the union of the bounds of their
+ * children. Swapping contents doesn't change the children, and any changed children are
+ * checked separately.
+ */
+std::optional<vm::bbox3d> logicalBoundsAfterSwap(
+  const Node& targetNode, const NodeContents& contents)
+{
+  return std::visit(
+    kdl::overload(
+      [](const Layer&) -> std::optional<vm::bbox3d> { return std::nullopt; },
+      [](const Group&) -> std::optional<vm::bbox3d> { return std::nullopt; },
+      [&](const Entity& entity) -> std::optional<vm::bbox3d> {
+        const auto* entityNode = dynamic_cast<const EntityNode*>(&targetNode);
+        if (!entityNode || entityNode->hasChildren())
+        {
+          return std::nullopt;
+        }
+
+        // The logical bounds of a point entity are the bounds of its definition at its
+        // origin, regardless of its angles or model. The swapped contents don't have a
+        // definition, but the node keeps its definition if the classname is unchanged.
+        if (entity.classname() == entityNode->entity().classname())
         {
-          preserveEntityProperties(*entityNode, *correspondingNode);
+          return entityNode->entity().definitionBounds().translate(entity.origin());
         }
+
+        // Otherwise, check the bounds like those of a newly created node
+        return EntityNode{entity}.logicalBounds();
       },
-      [](const BrushNode*) {},
-      [](const PatchNode*) {}));
+      [](const Brush& brush) -> std::optional<vm::bbox3d> { return brush.bounds(); },
+      [](const BezierPatch& patch) -> std::optional<vm::bbox3d> {
+        return patch.bounds();
+      }),
+    contents.get());
 }
+
 } // namespace
 
 Result<UpdateLinkedGroupsResult> updateLinkedGroups(
@@ -483,23 +771,181 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
 
   const auto targetGroupNodesToUpdate =
     kdl::vec_erase(targetGroupNodes, &sourceGroupNode);
-  return kdl::vec_transform(
-           targetGroupNodesToUpdate,
-           [&](auto* targetGroupNode) {
-             const auto transformation =
-               targetGroupNode->group().transformation() * *invertedSourceTransformation;
-             return cloneAndTransformChildren(
-                      sourceGroupNode, worldBounds, transformation, taskManager)
-                    | kdl::transform([&](auto newChildren) {
-                        const auto linkIdToNodeMap =
-                          makeLinkIdToNodeMap(targetGroupNode->children());
-                        preserveGroupNames(newChildren, linkIdToNodeMap);
-                        preserveEntityProperties(newChildren, linkIdToNodeMap);
-                        return std::pair{
-                          static_cast<Node*>(targetGroupNode), std::move(newChildren)};
-                      });
-           })
-         | kdl::fold;
+  if (targetGroupNodesToUpdate.empty())
+  {
+    return UpdateLinkedGroupsResult{};
+  }
+
+  auto sourceNodes = std::vector<SourceNode>{};
+  collectSourceNodes(sourceGroupNode, sourceNodes);
+
+  auto targetGroupTasks =
+    targetGroupNodesToUpdate | std::views::transform([&](auto* targetGroupNode) {
+      return std::function{[&, targetGroupNode]() {
+        const auto transformation =
+          targetGroupNode->group().transformation() * *invertedSourceTransformation;
+        const auto transformationHash =
+          ContentHasher{}.add(transformation).add(worldBounds).hash();
+        return TargetGroup{
+          targetGroupNode,
+          transformation,
+          transformationHash,
+          makeLinkIdToNodeMap(targetGroupNode->children()),
+        };
+      }};
+    });
+  const auto targetGroups = taskManager.run_tasks_and_wait(targetGroupTasks);
+
+  // Transform the contents of every source node for every target group in one fan-out.
+  // The results are stored by target group and preorder index of the source node.
+  static constexpr auto PairsPerTask = size_t(32);
+
+  const auto sourceNodeCount = sourceNodes.size();
+  const auto pairCount = targetGroups.size() * sourceNodeCount;
+  auto targetContents = std::vector<TargetContents>(pairCount);
+
+  auto transformTasks = std::vector<std::function<Result<void>()>>{};
+  for (size_t first = 0; first < pairCount; first += PairsPerTask)
+  {
+    transformTasks.emplace_back([&, first]() {
+      const auto last = std::min(first + PairsPerTask, pairCount);
+      for (auto i = first; i < last; ++i)
+      {
+        const auto& targetGroup = targetGroups[i / sourceNodeCount];
+        const auto& sourceNode = sourceNodes[i % sourceNodeCount];
+        if (computeTargetContents(sourceNode, targetGroup, worldBounds, targetContents[i])
+              .is_error())
+        {
+          return Result<void>{Error{"Failed to transform a linked node"}};
+        }
+      }
+      return Result<void>{};
+    });
+  }
+
+  const auto targetContentsFor = [&](const size_t targetGroupIndex) {
+    return std::span{targetContents}.subspan(
+      targetGroupIndex * sourceNodeCount, sourceNodeCount);
+  };
+
+  return taskManager.run_tasks_and_wait(transformTasks) | kdl::fold
+         | kdl::and_then([&]() {
+             // Target groups whose children are all up to date are skipped
+             auto targetGroupIndices = std::vector<size_t>{};
+             for (size_t i = 0; i < targetGroups.size(); ++i)
+             {
+               if (!isUpToDate(
+                     *targetGroups[i].groupNode, sourceNodes, targetContentsFor(i)))
+               {
+                 targetGroupIndices.push_back(i);
+               }
+             }
+
+             return kdl::vec_transform(
+                      targetGroupIndices,
+                      [&](const auto i) {
+                        return createChildNodes(
+                                 sourceGroupNode,
+                                 sourceNodes,
+                                 targetContentsFor(i),
+                                 worldBounds)
+                               | kdl::transform([&](auto newChildren) {
+                                   return std::pair{
+                                     static_cast<Node*>(targetGroups[i].groupNode),
+                                     std::move(newChildren)};
+                                 });
+                      })
+                    | kdl::fold;
+           });
+}
+
+Result<UpdateLinkedNodesResult> updateLinkedNodes(
+  const GroupNode& sourceGroupNode,
+  const std::vector<GroupNode*>& targetGroupNodes,
+  const std::vector<Node*>& changedNodes,
+  const vm::bbox3d& worldBounds,
+  kdl::task_manager& taskManager)
+{
+  const auto& sourceGroup = sourceGroupNode.group();
+  const auto invertedSourceTransformation = vm::invert(sourceGroup.transformation());
+  if (!invertedSourceTransformation)
+  {
+    return Error{"Group transformation is not invertible"};
+  }
+
+  const auto targetGroupNodesToUpdate =
+    kdl::vec_erase(targetGroupNodes, &sourceGroupNode);
+
+  auto sourceNodes = std::vector<const Node*>{};
+  collectDescendantsInPreorder<const Node>(sourceGroupNode, sourceNodes);
+
+  const auto changedNodeSet =
+    std::unordered_set<const Node*>{changedNodes.begin(), changedNodes.end()};
+  auto changedIndices = std::vector<size_t>{};
+  for (size_t i = 0; i < sourceNodes.size(); ++i)
+  {
+    if (changedNodeSet.contains(sourceNodes[i]))
+    {
+      changedIndices.push_back(i);
+    }
+  }
+
+  using NodesToSwap = std::vector<std::pair<Node*, NodeContents>>;
+
+  // A target group yields nothing if its structure differs from the source group
+  auto targetGroupTasks =
+    targetGroupNodesToUpdate | std::views::transform([&](auto* targetGroupNode) {
+      return std::function{
+        [&, targetGroupNode]() -> Result<std::optional<NodesToSwap>> {
+          auto targetNodes = std::vector<Node*>{};
+          collectDescendantsInPreorder<Node>(*targetGroupNode, targetNodes);
+          if (!hasSameStructure(sourceNodes, targetNodes))
+          {
+            return std::nullopt;
+          }
+
+          const auto transformation =
+            targetGroupNode->group().transformation() * *invertedSourceTransformation;
+
+          return changedIndices | std::views::transform([&](const auto i) {
+                   auto* targetNode = targetNodes[i];
+                   return transformContents(
+                            *sourceNodes[i], targetNode, transformation, worldBounds)
+                          | kdl::and_then(
+                            [&](auto contents) -> Result<std::pair<Node*, NodeContents>> {
+                              const auto bounds =
+                                logicalBoundsAfterSwap(*targetNode, contents);
+                              if (bounds && !worldBounds.contains(*bounds))
+                              {
+                                return Error{
+                                  "Updating a linked node would exceed world bounds"};
+                              }
+                              return std::pair{targetNode, std::move(contents)};
+                            });
+                 })
+                 | kdl::fold | kdl::transform([](auto nodesToSwap) {
+                     return std::optional{std::move(nodesToSwap)};
+                   });
+        }};
+    });
+
+  return taskManager.run_tasks_and_wait(targetGroupTasks) | kdl::fold
+         | kdl::transform([&](auto targetGroupUpdates) {
+             auto result = UpdateLinkedNodesResult{};
+             for (size_t i = 0; i < targetGroupUpdates.size(); ++i)
+             {
+               if (auto& nodesToSwap = targetGroupUpdates[i])
+               {
+                 result.nodesToSwap = kdl::vec_concat(
+                   std::move(result.nodesToSwap), std::move(*nodesToSwap));
+               }
+               else
+               {
+                 result.groupNodesToReplace.push_back(targetGroupNodesToUpdate[i]);
+               }
+             }
+             return result;
+           });
 }
 
 namespace
@@ -25,6 +25,7 @@
 #include "mdl/EntityNode.h" // IWYU pragma: keep
 #include "mdl/GroupNode.h"
 #include "mdl/LayerNode.h"
+#include "mdl/NodeContents.h"
 #include "mdl/NodeVisitor.h"
 #include "mdl/PatchNode.h" // IWYU pragma: keep
 #include "mdl/WorldNode.h"
@@ -113,7 +114,14 @@ using UpdateLinkedGroupsResult =
  *
  * The children of the source node are cloned (recursively) and transformed into the
  * target nodes by means of the recorded transformations of the source group and the
- * corresponding target groups.
+ * corresponding target groups. All pairs of target group and source node are processed
+ * in parallel.
+ *
+ * Every created node records a hash of the source contents and the transformation it was
+ * created from (see `Object::linkedContentHash`). If the corresponding node in a target
+ * group has a matching hash, then its contents are copied instead of transformed. Target
+ * groups whose children are all up to date and have the same structure as the source
+ * group's children are omitted from the result.
  *
  * Depending on the protected property keys of the cloned entities and their corresponding
  * entities in the target groups, some entity property changes may not be propagated from
@@ -141,6 +149,35 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
   const vm::bbox3d& worldBounds,
   kdl::task_manager& taskManager);
 
+struct UpdateLinkedNodesResult
+{
+  std::vector<std::pair<Node*, NodeContents>> nodesToSwap;
+  std::vector<GroupNode*> groupNodesToReplace;
+};
+
+/**
+ * Updates only those nodes in the given target group nodes that correspond to one of the
+ * given changed nodes.
+ *
+ * For every target group whose descendants have the same structure and link IDs as the
+ * descendants of the source group node, the contents of the changed descendants are
+ * transformed into the target group and paired with their corresponding target nodes.
+ * Swapping these contents into the target nodes updates the target group without
+ * replacing any of its children. Changed nodes that are not descendants of the source
+ * group node are ignored.
+ *
+ * Target groups whose structure differs from the source group are not updated, but are
+ * returned in `groupNodesToReplace`. These must be updated using `updateLinkedGroups`.
+ *
+ * This operation fails under the same conditions as `updateLinkedGroups`.
+ */
+Result<UpdateLinkedNodesResult> updateLinkedNodes(
+  const GroupNode& sourceGroupNode,
+  const std::vector<GroupNode*>& targetGroupNodes,
+  const std::vector<Node*>& changedNodes,
+  const vm::bbox3d& worldBounds,
+  kdl::task_manager& taskManager);
+
 std::vector<Error> initializeLinkIds(const std::vector<Node*>& nodes);
 
 /**
@@ -0,0 +1,208 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MaterialNameIndex.h"
+
+#include "mdl/Material.h"
+
+#include "kdl/string_compare.h"
+#include "kdl/string_format.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace tb::mdl
+{
+namespace
+{
+
+uint32_t trigramAt(const std::string_view str, const size_t i)
+{
+  return uint32_t(uint8_t(str[i])) << 16 | uint32_t(uint8_t(str[i + 1])) << 8
+         | uint32_t(uint8_t(str[i + 2]));
+}
+
+/**
+ * Sorts the given order using insertion sort, which is linear for orders that are
+ * almost sorted already. Gives up after the given number of moves and returns false,
+ * leaving the order as a valid but possibly unsorted permutation.
+ */
+template <typename Less>
+bool repairOrder(std::vector<size_t>& order, const Less& less, const size_t maxMoves)
+{
+  auto moves = size_t(0);
+  for (size_t i = 1; i < order.size(); ++i)
+  {
+    const auto position = order[i];
+    auto j = i;
+    while (j > 0 && less(position, order[j - 1]))
+    {
+      if (moves++ == maxMoves)
+      {
+        order[j] = position;
+        return false;
+      }
+      order[j] = order[j - 1];
+      --j;
+    }
+    order[j] = position;
+  }
+  return true;
+}
+
+} // namespace
+
+MaterialNameIndex::MaterialNameIndex() = default;
+
+MaterialNameIndex::MaterialNameIndex(std::vector<const Material*> materials)
+  : m_materials{kdl::vec_sort(
+      std::move(materials),
+      [](const auto* lhs, const auto* rhs) {
+        return kdl::ci::string_less{}(lhs->name(), rhs->name());
+      })}
+  , m_names{kdl::vec_transform(
+      m_materials,
+      [](const auto* material) { return kdl::str_to_lower(material->name()); })}
+{
+  for (uint32_t position = 0; position < uint32_t(m_names.size()); ++position)
+  {
+    const auto& name = m_names[position];
+    for (size_t i = 0; i + 3 <= name.size(); ++i)
+    {
+      auto& positions = m_trigrams[trigramAt(name, i)];
+      if (positions.empty() || positions.back() != position)
+      {
+        positions.push_back(position);
+      }
+    }
+  }
+}
+
+size_t MaterialNameIndex::size() const
+{
+  return m_materials.size();
+}
+
+bool MaterialNameIndex::empty() const
+{
+  return m_materials.empty();
+}
+
+const std::vector<const Material*>& MaterialNameIndex::materials() const
+{
+  return m_materials;
+}
+
+std::vector<size_t> MaterialNameIndex::find(const std::string_view filterText) const
+{
+  const auto patterns = kdl::str_split(kdl::str_to_lower(filterText), " ");
+
+  auto result = std::vector<size_t>{};
+  for (const auto position : findCandidates(patterns))
+  {
+    const auto& name = m_names[position];
+    if (std::ranges::all_of(patterns, [&](const auto& pattern) {
+          return name.find(pattern) != std::string::npos;
+        }))
+    {
+      result.push_back(position);
+    }
+  }
+  return result;
+}
+
+void MaterialNameIndex::invalidateUsageOrder()
+{
+  m_usageOrderValid = false;
+}
+
+const std::vector<size_t>& MaterialNameIndex::usageOrder()
+{
+  if (!m_usageOrderValid)
+  {
+    // take a snapshot, the usage counts are atomic and may change while we sort
+    m_usageCounts =
+      kdl::vec_transform(m_materials, [](const auto* m) { return m->usageCount(); });
+
+    if (m_usageOrder.size() != m_materials.size())
+    {
+      m_usageOrder.resize(m_materials.size());
+      std::iota(m_usageOrder.begin(), m_usageOrder.end(), size_t(0));
+    }
+
+    const auto less = [&](const auto lhs, const auto rhs) {
+      return m_usageCounts[lhs] != m_usageCounts[rhs]
+               ? m_usageCounts[lhs] > m_usageCounts[rhs]
+               : lhs < rhs;
+    };
+
+    // start from the previous order, fall back to sorting if too much has changed
+    if (!repairOrder(m_usageOrder, less, m_usageOrder.size()))
+    {
+      std::ranges::sort(m_usageOrder, less);
+    }
+    m_usageOrderValid = true;
+  }
+  return m_usageOrder;
+}
+
+std::vector<uint32_t> MaterialNameIndex::findCandidates(
+  const std::vector<std::string>& patterns) const
+{
+  auto postingLists = std::vector<const std::vector<uint32_t>*>{};
+  for (const auto& pattern : patterns)
+  {
+    for (size_t i = 0; i + 3 <= pattern.size(); ++i)
+    {
+      const auto it = m_trigrams.find(trigramAt(pattern, i));
+      if (it == m_trigrams.end())
+      {
+        return {};
+      }
+      postingLists.push_back(&it->second);
+    }
+  }
+
+  if (postingLists.empty())
+  {
+    // no pattern is long enough to use the index, every material is a candidate
+    auto result = std::vector<uint32_t>(m_materials.size());
+    std::iota(result.begin(), result.end(), uint32_t(0));
+    return result;
+  }
+
+  std::ranges::sort(postingLists, [](const auto* lhs, const auto* rhs) {
+    return lhs->size() < rhs->size();
+  });
+
+  auto result = *postingLists.front();
+  auto intersection = std::vector<uint32_t>{};
+  for (size_t i = 1; i < postingLists.size() && !result.empty(); ++i)
+  {
+    intersection.clear();
+    std::ranges::set_intersection(
+      result, *postingLists[i], std::back_inserter(intersection));
+    std::swap(result, intersection);
+  }
+  return result;
+}
+
+} // namespace tb::mdl
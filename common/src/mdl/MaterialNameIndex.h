@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::mdl
+{
+class Material;
+
+/**
+ * A search index over material names.
+ *
+ * The indexed materials are kept sorted by name (case insensitive), and every position
+ * returned by the index refers to that order. Filter queries are answered using a
+ * trigram index built once when the index is created, so that typing into a filter box
+ * does not require scanning and splitting the names of all materials.
+ *
+ * The index also caches the order of the materials by descending usage count. Since
+ * usage counts usually change only for a few materials at a time, the cached order is
+ * repaired from its previous state when it is requested after invalidateUsageOrder was
+ * called.
+ */
+class MaterialNameIndex
+{
+private:
+  std::vector<const Material*> m_materials;
+  std::vector<std::string> m_names;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> m_trigrams;
+
+  std::vector<size_t> m_usageCounts;
+  std::vector<size_t> m_usageOrder;
+  bool m_usageOrderValid = false;
+
+public:
+  MaterialNameIndex();
+  explicit MaterialNameIndex(std::vector<const Material*> materials);
+
+  size_t size() const;
+  bool empty() const;
+
+  /**
+   * Returns the indexed materials sorted by name.
+   */
+  const std::vector<const Material*>& materials() const;
+
+  /**
+   * Returns the positions of all materials whose names contain every whitespace
+   * separated part of the given filter text, ignoring case. The positions are returned
+   * in ascending order, i.e., sorted by material name. An empty filter text matches
+   * every material.
+   */
+  std::vector<size_t> find(std::string_view filterText) const;
+
+  /**
+   * Marks the cached usage order as outdated. Must be called whenever the usage count
+   * of an indexed material changes.
+   */
+  void invalidateUsageOrder();
+
+  /**
+   * Returns the positions of all materials sorted by descending usage count, and by name
+   * for materials with equal usage counts.
+   */
+  const std::vector<size_t>& usageOrder();
+
+private:
+  std::vector<uint32_t> findCandidates(const std::vector<std::string>& patterns) const;
+};
+
+} // namespace tb::mdl
@@ -142,17 +142,19 @@ std::optional<vm::vec3d> convertToScale(
 } // namespace
 
 ModelDefinition::ModelDefinition()
-  : m_expression{el::LiteralExpression{el::Value::Undefined}}
+  : ModelDefinition{el::ExpressionNode{el::LiteralExpression{el::Value::Undefined}}}
 {
 }
 
 ModelDefinition::ModelDefinition(const FileLocation& location)
-  : m_expression{el::LiteralExpression{el::Value::Undefined}, location}
+  : ModelDefinition{
+      el::ExpressionNode{el::LiteralExpression{el::Value::Undefined}, location}}
 {
 }
 
 ModelDefinition::ModelDefinition(el::ExpressionNode expression)
   : m_expression{std::move(expression)}
+  , m_compiledExpression{m_expression}
 {
 }
 
@@ -162,16 +164,26 @@ void ModelDefinition::append(ModelDefinition other)
 
   auto cases = std::vector{std::move(m_expression), std::move(other.m_expression)};
   m_expression = el::ExpressionNode{el::SwitchExpression{std::move(cases)}, location};
+  m_compiledExpression =
+    el::CompiledExpression<Result<ModelSpecification>>{m_expression};
+}
+
+const el::ExpressionNode& ModelDefinition::expression() const
+{
+  return m_expression;
 }
 
 Result<ModelSpecification> ModelDefinition::modelSpecification(
   const el::VariableStore& variableStore) const
 {
-  return el::withEvaluationContext(
-    [&](auto& context) {
-      return convertToModel(context, m_expression.evaluate(context));
-    },
-    variableStore);
+  return m_compiledExpression.evaluate(
+    variableStore, [](const auto& expression, const auto& variables) {
+      return el::withEvaluationContext(
+        [&](auto& context) {
+          return convertToModel(context, expression.evaluate(context));
+        },
+        variables);
+    });
 }
 
 Result<ModelSpecification> ModelDefinition::defaultModelSpecification() const
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Result.h"
+#include "el/CompiledExpression.h"
 #include "el/Expression.h"
 #include "mdl/ModelSpecification.h"
 
@@ -49,6 +50,7 @@ class ModelDefinition
 {
 private:
   el::ExpressionNode m_expression;
+  el::CompiledExpression<Result<ModelSpecification>> m_compiledExpression;
 
 public:
   ModelDefinition();
@@ -58,9 +60,12 @@ public:
 
   void append(ModelDefinition other);
 
+  const el::ExpressionNode& expression() const;
+
   /**
    * Evaluates the model expresion, using the given variable store to interpolate
-   * variables.
+   * variables. The result is memoized by the values of the variables that the
+   * expression reads.
    *
    * @param variableStore the variable store to use when interpolating variables
    * @return the model specification or an error if evaluation failed
@@ -25,8 +25,15 @@
 #include "mdl/EditorContext.h"
 #include "mdl/NodeQueries.h"
 
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -161,6 +168,29 @@ std::map<Node*, std::vector<Node*>> parentChildrenMap(const std::vector<Node*>&
   return result;
 }
 
+namespace
+{
+
+constexpr size_t MatchChunkSize = 256;
+
+/**
+ * Returns the nodes indexed in the node tree of the given world whose bounds intersect
+ * the bounds of any of the given brushes.
+ */
+std::unordered_set<const Node*> findCandidates(
+  const WorldNode& world, const std::vector<BrushNode*>& brushes)
+{
+  auto candidates = std::unordered_set<const Node*>{};
+  for (const auto* brush : brushes)
+  {
+    world.nodeTree().find_intersectors(
+      brush->physicalBounds(), std::inserter(candidates, candidates.end()));
+  }
+  return candidates;
+}
+
+} // namespace
+
 /**
  * Recursively collect brushes and entities from the given vector of node trees such that
  * the returned nodes match the given predicate. A matching brush is only returned if it
@@ -169,30 +199,38 @@ std::map<Node*, std::vector<Node*>> parentChildrenMap(const std::vector<Node*>&
  * pair of node and brush.
  *
  * The given predicate must be a function that maps a node and a brush to true or false.
+ * It must only return true if the node's bounds intersect the brush's bounds. This allows
+ * nodes below a world node to be culled using the world's node tree before the predicate
+ * is evaluated on the task manager.
  */
 template <typename P>
 static std::vector<Node*> collectMatchingNodes(
   const std::vector<Node*>& nodes,
   const std::vector<BrushNode*>& brushes,
-  const P& predicate)
+  const P& predicate,
+  kdl::task_manager& taskManager)
 {
-  auto result = std::vector<Node*>{};
+  auto candidates = std::optional<std::unordered_set<const Node*>>{};
+  auto nodesToTest = std::vector<Node*>{};
 
-  const auto collectIfMatching = [&](auto* node) {
-    for (const auto* brush : brushes)
+  const auto addIfCandidate = [&](auto* node) {
+    if (!candidates || candidates->contains(node))
     {
-      if (predicate(node, brush))
-      {
-        result.push_back(node);
-        return;
-      }
+      // the bounds of groups and entities are cached lazily, so they must be computed
+      // here before the nodes are tested concurrently
+      node->logicalBounds();
+      nodesToTest.push_back(node);
     }
   };
 
   for (auto* node : nodes)
   {
     node->accept(kdl::overload(
-      [](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
+      [&](auto&& thisLambda, WorldNode* world) {
+        candidates = findCandidates(*world, brushes);
+        world->visitChildren(thisLambda);
+        candidates = std::nullopt;
+      },
       [](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
       [&](auto&& thisLambda, GroupNode* group) {
         if (group->opened() || group->hasOpenedDescendant())
@@ -201,7 +239,9 @@ static std::vector<Node*> collectMatchingNodes(
         }
         else
         {
-          collectIfMatching(group);
+          // groups are not indexed in the node tree
+          group->logicalBounds();
+          nodesToTest.push_back(group);
         }
       },
       [&](auto&& thisLambda, EntityNode* entity) {
@@ -211,39 +251,77 @@ static std::vector<Node*> collectMatchingNodes(
         }
         else
         {
-          collectIfMatching(entity);
+          addIfCandidate(entity);
         }
       },
       [&](BrushNode* brush) {
         // if `brush` is one of the search query nodes, don't count it as touching
         if (!kdl::vec_contains(brushes, brush))
         {
-          collectIfMatching(brush);
+          addIfCandidate(brush);
         }
       },
-      [&](PatchNode* patch) {
-        // if `patch` is one of the search query nodes, don't count it as touching
-        collectIfMatching(patch);
-      }));
+      [&](PatchNode* patch) { addIfCandidate(patch); }));
   }
 
-  return result;
+  const auto collectMatching = [&](const size_t first, const size_t last) {
+    auto result = std::vector<Node*>{};
+    for (size_t i = first; i < last; ++i)
+    {
+      auto* node = nodesToTest[i];
+      if (std::ranges::any_of(
+            brushes, [&](const auto* brush) { return predicate(node, brush); }))
+      {
+        result.push_back(node);
+      }
+    }
+    return result;
+  };
+
+  if (nodesToTest.size() <= MatchChunkSize)
+  {
+    return collectMatching(0, nodesToTest.size());
+  }
+
+  auto chunkStarts = std::vector<size_t>{};
+  for (size_t i = 0; i < nodesToTest.size(); i += MatchChunkSize)
+  {
+    chunkStarts.push_back(i);
+  }
+
+  auto tasks = chunkStarts | std::views::transform([&](const auto first) {
+                 return std::function{[&, first]() {
+                   return collectMatching(
+                     first, std::min(first + MatchChunkSize, nodesToTest.size()));
+                 }};
+               });
+
+  // the chunks are returned in order, so the result is in traversal order
+  return kdl::vec_flatten(taskManager.run_tasks_and_wait(tasks));
 }
 
 std::vector<Node*> collectTouchingNodes(
-  const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes)
+  const std::vector<Node*>& nodes,
+  const std::vector<BrushNode*>& brushes,
+  kdl::task_manager& taskManager)
 {
-  return collectMatchingNodes(nodes, brushes, [](const auto* node, const auto* brush) {
-    return brush->intersects(node);
-  });
+  return collectMatchingNodes(
+    nodes,
+    brushes,
+    [](const auto* node, const auto* brush) { return brush->intersects(node); },
+    taskManager);
 }
 
 std::vector<Node*> collectContainedNodes(
-  const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes)
+  const std::vector<Node*>& nodes,
+  const std::vector<BrushNode*>& brushes,
+  kdl::task_manager& taskManager)
 {
-  return collectMatchingNodes(nodes, brushes, [](const auto* node, const auto* brush) {
-    return brush->contains(node);
-  });
+  return collectMatchingNodes(
+    nodes,
+    brushes,
+    [](const auto* node, const auto* brush) { return brush->contains(node); },
+    taskManager);
 }
 
 std::vector<Node*> collectSelectedNodes(const std::vector<Node*>& nodes)
@@ -26,6 +26,11 @@
 #include <map>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb::mdl
 {
 
@@ -59,9 +64,13 @@ std::vector<GroupNode*> collectGroups(const std::vector<Node*>& nodes);
 std::map<Node*, std::vector<Node*>> parentChildrenMap(const std::vector<Node*>& nodes);
 
 std::vector<Node*> collectTouchingNodes(
-  const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes);
+  const std::vector<Node*>& nodes,
+  const std::vector<BrushNode*>& brushes,
+  kdl::task_manager& taskManager);
 std::vector<Node*> collectContainedNodes(
-  const std::vector<Node*>& nodes, const std::vector<BrushNode*>& brushes);
+  const std::vector<Node*>& nodes,
+  const std::vector<BrushNode*>& brushes,
+  kdl::task_manager& taskManager);
 
 std::vector<Node*> collectSelectedNodes(const std::vector<Node*>& nodes);
 
@@ -0,0 +1,353 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeContentsDelta.h"
+
+#include "mdl/BrushFace.h"
+#include "mdl/BrushGeometry.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/ParallelUVCoordSystem.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+
+#include <optional>
+#include <typeinfo>
+
+namespace tb::mdl
+{
+namespace
+{
+
+using ContentsReference = std::
+  variant<const Layer*, const Group*, const Entity*, const Brush*, const BezierPatch*>;
+
+ContentsReference getContentsReference(const Node& node)
+{
+  return node.accept(kdl::overload(
+    [](const WorldNode* worldNode) -> ContentsReference { return &worldNode->entity(); },
+    [](const LayerNode* layerNode) -> ContentsReference { return &layerNode->layer(); },
+    [](const GroupNode* groupNode) -> ContentsReference { return &groupNode->group(); },
+    [](const EntityNode* entityNode) -> ContentsReference {
+      return &entityNode->entity();
+    },
+    [](const BrushNode* brushNode) -> ContentsReference { return &brushNode->brush(); },
+    [](const PatchNode* patchNode) -> ContentsReference { return &patchNode->patch(); }));
+}
+
+ContentsReference getContentsReference(const NodeContents& contents)
+{
+  return std::visit(
+    [](const auto& object) -> ContentsReference { return &object; }, contents.get());
+}
+
+template <typename T>
+const T* getReference(const ContentsReference& reference)
+{
+  const auto* const* object = std::get_if<const T*>(&reference);
+  return object ? *object : nullptr;
+}
+
+template <typename ChangedFace>
+void restoreFace(BrushFace& face, const ChangedFace& changedFace)
+{
+  face.setAttributes(changedFace.attributes);
+  if (changedFace.uvCoordSystemSnapshot)
+  {
+    face.restoreUVCoordSystemSnapshot(*changedFace.uvCoordSystemSnapshot);
+  }
+}
+
+bool hasSameUVAxes(const BrushFace& lhs, const BrushFace& rhs)
+{
+  return lhs.uAxis() == rhs.uAxis() && lhs.vAxis() == rhs.vAxis();
+}
+
+size_t estimateMemorySize(const std::string& str)
+{
+  return str.size();
+}
+
+size_t estimateMemorySize(const EntityProperty& property)
+{
+  return sizeof(EntityProperty) + estimateMemorySize(property.key())
+         + estimateMemorySize(property.value());
+}
+
+size_t estimateMemorySize(const Layer& layer)
+{
+  return sizeof(Layer) + estimateMemorySize(layer.name());
+}
+
+size_t estimateMemorySize(const Group& group)
+{
+  return sizeof(Group) + estimateMemorySize(group.name());
+}
+
+size_t estimateMemorySize(const Entity& entity)
+{
+  auto result = sizeof(Entity);
+  for (const auto& property : entity.properties())
+  {
+    result += estimateMemorySize(property);
+  }
+  for (const auto& key : entity.protectedProperties())
+  {
+    result += sizeof(std::string) + estimateMemorySize(key);
+  }
+  return result;
+}
+
+size_t estimateMemorySize(const Brush& brush)
+{
+  auto result = sizeof(Brush) + sizeof(BrushGeometry);
+  for (const auto& face : brush.faces())
+  {
+    result += sizeof(BrushFace) + sizeof(ParallelUVCoordSystem)
+              + estimateMemorySize(face.attributes().materialName());
+  }
+  result += brush.faceCount() * sizeof(BrushFaceGeometry);
+  result += brush.edgeCount() * (sizeof(BrushEdge) + 2 * sizeof(BrushHalfEdge));
+  result += brush.vertexCount() * sizeof(BrushVertex);
+  return result;
+}
+
+size_t estimateMemorySize(const BezierPatch& patch)
+{
+  return sizeof(BezierPatch) + patch.controlPoints().size() * sizeof(BezierPatch::Point)
+         + estimateMemorySize(patch.materialName());
+}
+
+} // namespace
+
+size_t memorySize(const NodeContents& contents)
+{
+  return std::visit(
+    [](const auto& object) { return estimateMemorySize(object); }, contents.get());
+}
+
+size_t memorySize(const Node& node)
+{
+  auto result = std::visit(
+    [](const auto* object) { return estimateMemorySize(*object); },
+    getContentsReference(node));
+  for (const auto* child : node.children())
+  {
+    result += memorySize(*child);
+  }
+  return result;
+}
+
+NodeContentsDelta::NodeContentsDelta(NodeContents contents)
+  : NodeContentsDelta{Delta{std::move(contents)}}
+{
+}
+
+NodeContentsDelta::NodeContentsDelta(Delta delta)
+  : m_delta{std::move(delta)}
+  , m_memorySize{std::visit(
+      kdl::overload(
+        [](const NodeContents& contents) { return mdl::memorySize(contents); },
+        [](const BrushFacesDelta& brushFacesDelta) {
+          auto result = sizeof(BrushFacesDelta);
+          for (const auto& changedFace : brushFacesDelta.changedFaces)
+          {
+            result += sizeof(ChangedFace)
+                      + estimateMemorySize(changedFace.attributes.materialName())
+                      + (changedFace.uvCoordSystemSnapshot
+                           ? sizeof(ParallelUVCoordSystemSnapshot)
+                           : 0);
+          }
+          return result;
+        },
+        [](const EntityPropertiesDelta& entityPropertiesDelta) {
+          auto result = sizeof(EntityPropertiesDelta);
+          for (const auto& changedProperty : entityPropertiesDelta.changedProperties)
+          {
+            result += sizeof(size_t) + estimateMemorySize(changedProperty.property);
+          }
+          return result;
+        }),
+      m_delta)}
+{
+}
+
+NodeContentsDelta::NodeContentsDelta(NodeContentsDelta&& other) noexcept = default;
+
+NodeContentsDelta& NodeContentsDelta::operator=(NodeContentsDelta&& other) noexcept =
+  default;
+
+NodeContentsDelta::~NodeContentsDelta() = default;
+
+NodeContentsDelta NodeContentsDelta::encode(NodeContents contents, const Node& reference)
+{
+  return encode(std::move(contents), getContentsReference(reference));
+}
+
+NodeContentsDelta NodeContentsDelta::encode(
+  NodeContents contents, const NodeContents& reference)
+{
+  return encode(std::move(contents), getContentsReference(reference));
+}
+
+NodeContents NodeContentsDelta::decode(const Node& reference) &&
+{
+  return std::move(*this).decode(getContentsReference(reference));
+}
+
+NodeContents NodeContentsDelta::decode(const NodeContents& reference) &&
+{
+  return std::move(*this).decode(getContentsReference(reference));
+}
+
+bool NodeContentsDelta::full() const
+{
+  return std::holds_alternative<NodeContents>(m_delta);
+}
+
+size_t NodeContentsDelta::memorySize() const
+{
+  return sizeof(NodeContentsDelta) + m_memorySize;
+}
+
+NodeContentsDelta NodeContentsDelta::encode(
+  NodeContents contents, const Reference& contentsReference)
+{
+  return std::visit(
+    kdl::overload(
+      [&](const Entity& entity) -> NodeContentsDelta {
+        const auto* referenceEntity = getReference<Entity>(contentsReference);
+        if (
+          !referenceEntity
+          || entity.protectedProperties() != referenceEntity->protectedProperties()
+          || entity.pointEntity() != referenceEntity->pointEntity())
+        {
+          return NodeContentsDelta{std::move(contents)};
+        }
+
+        const auto& properties = entity.properties();
+        const auto& referenceProperties = referenceEntity->properties();
+
+        auto changedProperties = std::vector<ChangedProperty>{};
+        for (size_t i = 0; i < properties.size(); ++i)
+        {
+          if (i >= referenceProperties.size() || properties[i] != referenceProperties[i])
+          {
+            changedProperties.push_back({i, properties[i]});
+          }
+        }
+
+        return NodeContentsDelta{
+          EntityPropertiesDelta{properties.size(), std::move(changedProperties)}};
+      },
+      [&](const Brush& brush) -> NodeContentsDelta {
+        const auto* referenceBrush = getReference<Brush>(contentsReference);
+        if (!referenceBrush || brush.faceCount() != referenceBrush->faceCount())
+        {
+          return NodeContentsDelta{std::move(contents)};
+        }
+
+        auto changedFaces = std::vector<ChangedFace>{};
+        for (size_t i = 0; i < brush.faceCount(); ++i)
+        {
+          const auto& face = brush.face(i);
+          const auto& referenceFace = referenceBrush->face(i);
+          if (
+            face.points() != referenceFace.points()
+            || typeid(face.uvCoordSystem()) != typeid(referenceFace.uvCoordSystem()))
+          {
+            return NodeContentsDelta{std::move(contents)};
+          }
+
+          if (
+            face.attributes() != referenceFace.attributes()
+            || !hasSameUVAxes(face, referenceFace))
+          {
+            auto changedFace =
+              ChangedFace{i, face.attributes(), face.takeUVCoordSystemSnapshot()};
+
+            // check that the face can be restored exactly
+            auto restoredFace = referenceFace;
+            restoreFace(restoredFace, changedFace);
+            if (!hasSameUVAxes(restoredFace, face))
+            {
+              return NodeContentsDelta{std::move(contents)};
+            }
+
+            changedFaces.push_back(std::move(changedFace));
+          }
+        }
+
+        return NodeContentsDelta{BrushFacesDelta{std::move(changedFaces)}};
+      },
+      [&](const auto&) { return NodeContentsDelta{std::move(contents)}; }),
+    contents.get());
+}
+
+NodeContents NodeContentsDelta::decode(const Reference& contentsReference) &&
+{
+  return std::visit(
+    kdl::overload(
+      [](NodeContents& contents) { return std::move(contents); },
+      [&](const BrushFacesDelta& brushFacesDelta) {
+        const auto* referenceBrush = getReference<Brush>(contentsReference);
+        assert(referenceBrush);
+
+        auto brush = *referenceBrush;
+        for (const auto& changedFace : brushFacesDelta.changedFaces)
+        {
+          restoreFace(brush.face(changedFace.index), changedFace);
+        }
+        return NodeContents{std::move(brush)};
+      },
+      [&](const EntityPropertiesDelta& entityPropertiesDelta) {
+        const auto* referenceEntity = getReference<Entity>(contentsReference);
+        assert(referenceEntity);
+
+        const auto& referenceProperties = referenceEntity->properties();
+        auto properties = std::vector<EntityProperty>{
+          referenceProperties.begin(),
+          referenceProperties.begin()
+            + std::ptrdiff_t(std::min(
+              referenceProperties.size(), entityPropertiesDelta.propertyCount))};
+
+        for (const auto& changedProperty : entityPropertiesDelta.changedProperties)
+        {
+          if (changedProperty.index < properties.size())
+          {
+            properties[changedProperty.index] = changedProperty.property;
+          }
+          else
+          {
+            properties.push_back(changedProperty.property);
+          }
+        }
+
+        auto entity = *referenceEntity;
+        entity.setProperties(std::move(properties));
+        return NodeContents{std::move(entity)};
+      }),
+    m_delta);
+}
+
+} // namespace tb::mdl
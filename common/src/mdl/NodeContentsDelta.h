@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/BrushFaceAttributes.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/NodeContents.h"
+
+#include <memory>
+#include <variant>
+#include <vector>
+
+namespace tb::mdl
+{
+class Node;
+class UVCoordSystemSnapshot;
+
+/**
+ * Stores node contents compactly by recording how they differ from a reference, which is
+ * usually the current contents of the node they belong to.
+ *
+ * - If a brush has the same faces as the reference brush, only the attributes and the UV
+ *   coordinate systems of the changed faces are stored. The brush geometry is copied from
+ *   the reference when the contents are restored.
+ * - If an entity differs from the reference entity only in its properties, only the
+ *   changed properties are stored.
+ * - All other contents are stored in full.
+ *
+ * A delta can only be decoded using the same reference that it was encoded with. The undo
+ * stack ensures this because it restores node contents in the reverse order in which they
+ * were changed.
+ */
+class NodeContentsDelta
+{
+private:
+  struct ChangedFace
+  {
+    size_t index;
+    BrushFaceAttributes attributes;
+    std::unique_ptr<UVCoordSystemSnapshot> uvCoordSystemSnapshot;
+  };
+
+  struct BrushFacesDelta
+  {
+    std::vector<ChangedFace> changedFaces;
+  };
+
+  struct ChangedProperty
+  {
+    size_t index;
+    EntityProperty property;
+  };
+
+  struct EntityPropertiesDelta
+  {
+    size_t propertyCount;
+    std::vector<ChangedProperty> changedProperties;
+  };
+
+  using Delta = std::variant<NodeContents, BrushFacesDelta, EntityPropertiesDelta>;
+  using Reference = std::
+    variant<const Layer*, const Group*, const Entity*, const Brush*, const BezierPatch*>;
+
+  Delta m_delta;
+  size_t m_memorySize;
+
+public:
+  /**
+   * Creates a delta that stores the given contents in full.
+   */
+  explicit NodeContentsDelta(NodeContents contents);
+
+  NodeContentsDelta(NodeContentsDelta&& other) noexcept;
+  NodeContentsDelta& operator=(NodeContentsDelta&& other) noexcept;
+
+  ~NodeContentsDelta();
+
+  /**
+   * Encodes the given contents relative to the current contents of the given node.
+   */
+  static NodeContentsDelta encode(NodeContents contents, const Node& reference);
+
+  /**
+   * Encodes the given contents relative to the given reference contents.
+   */
+  static NodeContentsDelta encode(NodeContents contents, const NodeContents& reference);
+
+  /**
+   * Restores the encoded contents using the current contents of the given node as the
+   * reference.
+   */
+  NodeContents decode(const Node& reference) &&;
+
+  /**
+   * Restores the encoded contents using the given reference contents.
+   */
+  NodeContents decode(const NodeContents& reference) &&;
+
+  /**
+   * Indicates whether this delta stores its contents in full.
+   */
+  bool full() const;
+
+  /**
+   * Returns an estimate of the number of bytes used by this delta.
+   */
+  size_t memorySize() const;
+
+private:
+  explicit NodeContentsDelta(Delta delta);
+
+  static NodeContentsDelta encode(NodeContents contents, const Reference& reference);
+  NodeContents decode(const Reference& reference) &&;
+};
+
+/**
+ * Returns an estimate of the number of bytes used by the given node contents.
+ */
+size_t memorySize(const NodeContents& contents);
+
+/**
+ * Returns an estimate of the number of bytes used by the contents of the given node and
+ * of its descendants.
+ */
+size_t memorySize(const Node& node);
+
+} // namespace tb::mdl
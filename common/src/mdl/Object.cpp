@@ -47,6 +47,16 @@ void Object::cloneLinkId(Object& object) const
   object.setLinkId(linkId());
 }
 
+const std::optional<std::uint64_t>& Object::linkedContentHash() const
+{
+  return m_linkedContentHash;
+}
+
+void Object::setLinkedContentHash(std::optional<std::uint64_t> linkedContentHash)
+{
+  m_linkedContentHash = std::move(linkedContentHash);
+}
+
 Node* Object::container()
 {
   return doGetContainer();
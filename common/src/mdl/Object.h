@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
 
 namespace tb::mdl
@@ -33,6 +35,13 @@ class Object
 protected:
   std::string m_linkId;
 
+  /**
+   * A hash of the source contents and the transformation from which the contents of this
+   * object were created when its linked group was last updated. It is unset whenever the
+   * contents change, so a matching hash proves that the contents are up to date.
+   */
+  std::optional<std::uint64_t> m_linkedContentHash;
+
   Object();
 
 public:
@@ -42,6 +51,9 @@ public:
   void setLinkId(std::string linkId);
   void cloneLinkId(Object& object) const;
 
+  const std::optional<std::uint64_t>& linkedContentHash() const;
+  void setLinkedContentHash(std::optional<std::uint64_t> linkedContentHash);
+
   Node* container();
   const Node* container() const;
 
@@ -336,6 +336,7 @@ BezierPatch PatchNode::setPatch(BezierPatch patch)
   const auto boundsChange = NotifyPhysicalBoundsChange{*this};
 
   auto previousPatch = std::exchange(m_patch, std::move(patch));
+  m_linkedContentHash = std::nullopt;
   m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
   return previousPatch;
 }
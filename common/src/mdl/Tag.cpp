@@ -280,6 +280,11 @@ SmartTag& SmartTag::operator=(const SmartTag& other)
 
 SmartTag& SmartTag::operator=(SmartTag&& other) = default;
 
+const TagMatcher& SmartTag::matcher() const
+{
+  return *m_matcher;
+}
+
 bool SmartTag::matches(const Taggable& taggable) const
 {
   return m_matcher->matches(taggable);
@@ -359,6 +359,11 @@ public:
   SmartTag& operator=(const SmartTag& other);
   SmartTag& operator=(SmartTag&& other);
 
+  /**
+   * Returns the matcher of this smart tag.
+   */
+  const TagMatcher& matcher() const;
+
   /**
    * Indicates whether this smart tag matches the given taggable.
    *
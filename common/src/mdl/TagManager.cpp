@@ -20,8 +20,11 @@
 #include "TagManager.h"
 
 #include "Ensure.h"
+#include "mdl/BrushFace.h"
 #include "mdl/Tag.h"
+#include "mdl/TagMatcher.h"
 #include "mdl/TagType.h"
+#include "mdl/TagVisitor.h"
 
 #include <fmt/format.h>
 
@@ -31,6 +34,21 @@
 
 namespace tb::mdl
 {
+namespace
+{
+
+class FindBrushFaceVisitor : public TagVisitor
+{
+private:
+  BrushFace* m_face = nullptr;
+
+public:
+  BrushFace* face() const { return m_face; }
+
+  void visit(BrushFace& face) override { m_face = &face; }
+};
+
+} // namespace
 
 bool TagManager::TagCmp::operator()(const SmartTag& lhs, const SmartTag& rhs) const
 {
@@ -91,6 +109,8 @@ const SmartTag& TagManager::smartTag(const size_t index) const
 void TagManager::registerSmartTags(const std::vector<SmartTag>& tags)
 {
   m_smartTags = kdl::vector_set<SmartTag, TagCmp>(tags.size());
+  m_materialNameTags = 0;
+  m_materialTags = 0;
   for (const auto& tag : tags)
   {
     const size_t nextIndex = freeTagIndex();
@@ -103,20 +123,111 @@ void TagManager::registerSmartTags(const std::vector<SmartTag>& tags)
     }
 
     it->setIndex(nextIndex);
+
+    if (
+      const auto* materialTagMatcher =
+        dynamic_cast<const MaterialTagMatcher*>(&it->matcher()))
+    {
+      auto& materialTags = materialTagMatcher->matchesByMaterialName()
+                             ? m_materialNameTags
+                             : m_materialTags;
+      materialTags |= it->type();
+    }
   }
+
+  clearMaterialTagMasks();
 }
 
 void TagManager::clearSmartTags()
 {
   m_smartTags.clear();
+  m_materialNameTags = 0;
+  m_materialTags = 0;
+  clearMaterialTagMasks();
 }
 
-void TagManager::updateTags(Taggable& taggable) const
+void TagManager::updateTags(Taggable& taggable)
 {
+  const auto materialTags = m_materialNameTags | m_materialTags;
+
+  // only brush faces can match material tags
+  auto visitor = FindBrushFaceVisitor{};
+  taggable.accept(visitor);
+  const auto* face = visitor.face();
+  const auto faceMaterialTagMask = face ? materialTagMask(*face) : TagType::Type(0);
+
   for (const auto& tag : m_smartTags)
   {
-    tag.update(taggable);
+    if ((tag.type() & materialTags) == 0)
+    {
+      tag.update(taggable);
+    }
+    else if ((tag.type() & faceMaterialTagMask) != 0)
+    {
+      taggable.addTag(tag);
+    }
+    else
+    {
+      taggable.removeTag(tag);
+    }
+  }
+}
+
+TagType::Type TagManager::materialTagMask(const BrushFace& face)
+{
+  auto result = TagType::Type(0);
+
+  if (m_materialNameTags != 0)
+  {
+    const auto& materialName = face.attributes().materialName();
+    auto it = m_materialNameTagMasks.find(materialName);
+    if (it == m_materialNameTagMasks.end())
+    {
+      it = m_materialNameTagMasks
+             .emplace(materialName, computeMaterialTagMask(face, m_materialNameTags))
+             .first;
+    }
+    result |= it->second;
+  }
+
+  if (m_materialTags != 0)
+  {
+    const auto* material = face.material();
+    auto it = m_materialTagMasks.find(material);
+    if (it == m_materialTagMasks.end())
+    {
+      it = m_materialTagMasks
+             .emplace(material, computeMaterialTagMask(face, m_materialTags))
+             .first;
+    }
+    result |= it->second;
+  }
+
+  return result;
+}
+
+void TagManager::clearMaterialTagMasks()
+{
+  m_materialNameTagMasks.clear();
+  m_materialTagMasks.clear();
+}
+
+TagType::Type TagManager::computeMaterialTagMask(
+  const BrushFace& face, const TagType::Type tags) const
+{
+  auto result = TagType::Type(0);
+  for (const auto& tag : m_smartTags)
+  {
+    if ((tag.type() & tags) != 0)
+    {
+      const auto& matcher = static_cast<const MaterialTagMatcher&>(tag.matcher());
+      if (matcher.matchesFace(face))
+      {
+        result |= tag.type();
+      }
+    }
   }
+  return result;
 }
 
 size_t TagManager::freeTagIndex()
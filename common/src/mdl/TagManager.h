@@ -20,13 +20,17 @@
 #pragma once
 
 #include "mdl/Tag.h"
+#include "mdl/TagType.h"
 
 #include "kdl/vector_set.h"
 
 #include <string>
+#include <unordered_map>
 
 namespace tb::mdl
 {
+class BrushFace;
+class Material;
 
 /**
  * Manages the tags used in a document and updates smart tags on taggable objects.
@@ -44,6 +48,19 @@ private:
 
   kdl::vector_set<SmartTag, TagCmp> m_smartTags;
 
+  /**
+   * The smart tags whose matchers only depend on the material name of a face.
+   */
+  TagType::Type m_materialNameTags = 0;
+
+  /**
+   * The smart tags whose matchers depend on the material of a face.
+   */
+  TagType::Type m_materialTags = 0;
+
+  std::unordered_map<std::string, TagType::Type> m_materialNameTagMasks;
+  std::unordered_map<const Material*, TagType::Type> m_materialTagMasks;
+
 public:
   /**
    * Returns a vector containing all smart tags registered with this manager.
@@ -109,11 +126,30 @@ public:
   /**
    * Update the smart tags of the given taggable object.
    *
+   * Smart tags that match brush faces by their material are not evaluated for every
+   * face. Instead, the tags matching a material are computed once and cached per
+   * material name or per material.
+   *
    * @param taggable the object to update
    */
-  void updateTags(Taggable& taggable) const;
+  void updateTags(Taggable& taggable);
+
+  /**
+   * Returns the mask of the smart tags that match the given face by its material.
+   *
+   * @param face the face to match
+   * @return the mask of matching smart tags
+   */
+  TagType::Type materialTagMask(const BrushFace& face);
+
+  /**
+   * Clears the cached material tag masks. Must be called whenever the materials are
+   * reloaded.
+   */
+  void clearMaterialTagMasks();
 
 private:
+  TagType::Type computeMaterialTagMask(const BrushFace& face, TagType::Type tags) const;
   size_t freeTagIndex();
 };
 
@@ -98,6 +98,15 @@ public:
 
 } // namespace
 
+bool MaterialTagMatcher::matches(const Taggable& taggable) const
+{
+  auto visitor =
+    BrushFaceMatchVisitor{[&](const auto& face) { return matchesFace(face); }};
+
+  taggable.accept(visitor);
+  return visitor.matches();
+}
+
 void MaterialTagMatcher::enable(TagMatcherCallback& callback, MapFacade& facade) const
 {
   const auto& materialManager = facade.materialManager();
@@ -165,14 +174,14 @@ std::unique_ptr<TagMatcher> MaterialNameTagMatcher::clone() const
   return std::make_unique<MaterialNameTagMatcher>(m_pattern);
 }
 
-bool MaterialNameTagMatcher::matches(const Taggable& taggable) const
+bool MaterialNameTagMatcher::matchesByMaterialName() const
 {
-  auto visitor = BrushFaceMatchVisitor{[&](const auto& face) {
-    return matchesMaterialName(face.attributes().materialName());
-  }};
+  return true;
+}
 
-  taggable.accept(visitor);
-  return visitor.matches();
+bool MaterialNameTagMatcher::matchesFace(const BrushFace& face) const
+{
+  return matchesMaterialName(face.attributes().materialName());
 }
 
 void MaterialNameTagMatcher::appendToStream(std::ostream& str) const
@@ -217,13 +226,14 @@ std::unique_ptr<TagMatcher> SurfaceParmTagMatcher::clone() const
   return std::make_unique<SurfaceParmTagMatcher>(m_parameters);
 }
 
-bool SurfaceParmTagMatcher::matches(const Taggable& taggable) const
+bool SurfaceParmTagMatcher::matchesByMaterialName() const
 {
-  auto visitor = BrushFaceMatchVisitor{
-    [&](const auto& face) { return matchesMaterial(face.material()); }};
+  return false;
+}
 
-  taggable.accept(visitor);
-  return visitor.matches();
+bool SurfaceParmTagMatcher::matchesFace(const BrushFace& face) const
+{
+  return matchesMaterial(face.material());
 }
 
 void SurfaceParmTagMatcher::appendToStream(std::ostream& str) const
@@ -43,6 +43,21 @@ class MapFacade;
 class MaterialTagMatcher : public TagMatcher
 {
 public:
+  /**
+   * Indicates whether this matcher only depends on the material name of a brush face.
+   * Otherwise, it depends on the material itself.
+   *
+   * The tag manager uses this to cache the result of matchesFace per material name or per
+   * material.
+   */
+  virtual bool matchesByMaterialName() const = 0;
+
+  /**
+   * Indicates whether this matcher matches the given brush face.
+   */
+  virtual bool matchesFace(const BrushFace& face) const = 0;
+
+  bool matches(const Taggable& taggable) const override;
   void enable(TagMatcherCallback& callback, MapFacade& facade) const override;
   bool canEnable() const override;
   void appendToStream(std::ostream& str) const override;
@@ -59,7 +74,8 @@ private:
 public:
   explicit MaterialNameTagMatcher(std::string pattern);
   std::unique_ptr<TagMatcher> clone() const override;
-  bool matches(const Taggable& taggable) const override;
+  bool matchesByMaterialName() const override;
+  bool matchesFace(const BrushFace& face) const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
@@ -76,7 +92,8 @@ public:
   explicit SurfaceParmTagMatcher(std::string parameter);
   explicit SurfaceParmTagMatcher(kdl::vector_set<std::string> parameters);
   std::unique_ptr<TagMatcher> clone() const override;
-  bool matches(const Taggable& taggable) const override;
+  bool matchesByMaterialName() const override;
+  bool matchesFace(const BrushFace& face) const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
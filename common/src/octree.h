@@ -630,6 +630,52 @@ public:
     }
   }
 
+  /**
+   * Finds every data item in this tree that is stored in a node whose bounds satisfy the
+   * given predicate and returns a list of those items.
+   *
+   * @tparam P the predicate type, a function that maps a bounding box to a boolean
+   * @param predicate the predicate to test the node bounds with
+   * @return a list containing all found data items
+   */
+  template <typename P>
+  std::vector<U> find_if(const P& predicate) const
+  {
+    auto result = std::vector<U>{};
+    find_if(predicate, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree that is stored in a node whose bounds satisfy the
+   * given predicate and appends it to the given output iterator.
+   *
+   * The predicate is only evaluated for the children of nodes whose bounds satisfy it, so
+   * it must be satisfied by the bounds of a node if it is satisfied by the bounds of any
+   * of its children, e.g. an intersection test.
+   *
+   * @tparam P the predicate type, a function that maps a bounding box to a boolean
+   * @tparam O the output iterator type
+   * @param predicate the predicate to test the node bounds with
+   * @param out the output iterator to append to
+   */
+  template <typename P, typename O>
+  void find_if(const P& predicate, O out) const
+  {
+    if (m_root)
+    {
+      visit_node_if(
+        *m_root,
+        [&](const auto& node) {
+          const auto& data = get_data(node);
+          std::copy(data.begin(), data.end(), out);
+        },
+        [&](const auto& node) {
+          return predicate(get_address(node).to_bounds(m_min_size));
+        });
+    }
+  }
+
   kdl_reflect_inline(octree, m_root, m_min_size, m_node_address_for_data);
 
 private:
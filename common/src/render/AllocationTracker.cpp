@@ -36,6 +36,16 @@ AllocationTracker::Range::Range(Index p, Index s)
 {
 }
 
+AllocationTracker::Index AllocationTracker::Stats::scatteredFreeSize() const
+{
+  return freeSize - largestFreeBlockSize;
+}
+
+double AllocationTracker::Stats::fragmentation() const
+{
+  return freeSize > 0 ? double(scatteredFreeSize()) / double(freeSize) : 0.0;
+}
+
 static std::vector<AllocationTracker::Block*>::iterator findFirstLargerOrEqualBin(
   std::vector<AllocationTracker::Block*>& bins, const size_t desiredSize)
 {
@@ -190,10 +200,14 @@ AllocationTracker::Block* AllocationTracker::allocate(const size_t needed)
   block->nextOfSameSize = nullptr;
   block->prevOfSameSize = nullptr;
 
+  m_usedSize += needed;
+  ++m_usedBlockCount;
+
   if (block->size == needed)
   {
     // lucky case: exact size. we're done
     block->free = false;
+    --m_freeBlockCount;
 
     checkInvariants();
     return block;
@@ -246,6 +260,9 @@ void AllocationTracker::free(Block* block)
   Block* left = block->left;
   Block* right = block->right;
 
+  m_usedSize -= block->size;
+  --m_usedBlockCount;
+
   // 3 possible cases for merging blocks:
   // a) merge left, block, and right
   if (left != nullptr && left->free && right != nullptr && right->free)
@@ -267,6 +284,7 @@ void AllocationTracker::free(Block* block)
 
     recycle(block);
     recycle(right);
+    --m_freeBlockCount;
 
     linkToBinList(left);
 
@@ -342,6 +360,7 @@ void AllocationTracker::free(Block* block)
 
   block->free = true;
   linkToBinList(block);
+  ++m_freeBlockCount;
 
   checkInvariants();
 }
@@ -413,6 +432,7 @@ void AllocationTracker::expand(const Index newCapacity)
     m_rightmostBlock = newBlock;
 
     linkToBinList(newBlock);
+    ++m_freeBlockCount;
 
     checkInvariants();
     return;
@@ -447,6 +467,7 @@ void AllocationTracker::expand(const Index newCapacity)
     newBlock->free = true;
 
     linkToBinList(newBlock);
+    ++m_freeBlockCount;
 
     lastBlock->right = newBlock;
 
@@ -472,6 +493,110 @@ bool AllocationTracker::hasAllocations() const
   return false;
 }
 
+std::vector<AllocationTracker::BlockMove> AllocationTracker::compact(const Index budget)
+{
+  checkInvariants();
+
+  auto result = std::vector<BlockMove>{};
+  Index movedSize = 0;
+
+  Block* freeBlock = m_leftmostBlock;
+  while (freeBlock != nullptr && !freeBlock->free)
+  {
+    freeBlock = freeBlock->right;
+  }
+
+  // the free block travels to the right, swapping places with the used block to its right
+  while (freeBlock != nullptr && freeBlock->right != nullptr)
+  {
+    Block* usedBlock = freeBlock->right;
+
+    // adjacent free blocks are always merged
+    assert(!usedBlock->free);
+
+    if (movedSize > 0 && movedSize + usedBlock->size > budget)
+    {
+      break;
+    }
+
+    unlinkFromBinList(freeBlock);
+
+    // swap positions: left, free, used, right -> left, used, free, right
+    const Index oldPos = usedBlock->pos;
+    usedBlock->pos = freeBlock->pos;
+    freeBlock->pos = usedBlock->pos + usedBlock->size;
+
+    Block* left = freeBlock->left;
+    Block* right = usedBlock->right;
+
+    usedBlock->left = left;
+    usedBlock->right = freeBlock;
+    freeBlock->left = usedBlock;
+    freeBlock->right = right;
+
+    if (left == nullptr)
+    {
+      assert(m_leftmostBlock == freeBlock);
+      m_leftmostBlock = usedBlock;
+    }
+    else
+    {
+      left->right = usedBlock;
+    }
+
+    if (right == nullptr)
+    {
+      assert(m_rightmostBlock == usedBlock);
+      m_rightmostBlock = freeBlock;
+    }
+    else
+    {
+      right->left = freeBlock;
+    }
+
+    // merge with the free block that followed the used block, if any
+    if (right != nullptr && right->free)
+    {
+      unlinkFromBinList(right);
+
+      freeBlock->size += right->size;
+      freeBlock->right = right->right;
+      if (right->right != nullptr)
+      {
+        right->right->left = freeBlock;
+      }
+      else
+      {
+        assert(m_rightmostBlock == right);
+        m_rightmostBlock = freeBlock;
+      }
+
+      recycle(right);
+      --m_freeBlockCount;
+    }
+
+    linkToBinList(freeBlock);
+
+    result.push_back(BlockMove{usedBlock, oldPos, usedBlock->pos, usedBlock->size});
+    movedSize += usedBlock->size;
+  }
+
+  checkInvariants();
+  return result;
+}
+
+AllocationTracker::Stats AllocationTracker::stats() const
+{
+  return Stats{
+    m_capacity,
+    m_usedSize,
+    m_capacity - m_usedSize,
+    largestPossibleAllocation(),
+    m_usedBlockCount,
+    m_freeBlockCount,
+  };
+}
+
 // Testing / debugging
 
 std::vector<AllocationTracker::Range> AllocationTracker::freeBlocks() const
@@ -551,6 +676,26 @@ void AllocationTracker::checkInvariants() const
   }
   assert(m_capacity == totalSize);
 
+  // check the statistics
+  size_t usedSize = 0;
+  size_t usedBlockCount = 0;
+  size_t freeBlockCount = 0;
+  for (Block* block = m_leftmostBlock; block != nullptr; block = block->right)
+  {
+    if (block->free)
+    {
+      ++freeBlockCount;
+    }
+    else
+    {
+      usedSize += block->size;
+      ++usedBlockCount;
+    }
+  }
+  assert(m_usedSize == usedSize);
+  assert(m_usedBlockCount == usedBlockCount);
+  assert(m_freeBlockCount == freeBlockCount);
+
   // check the size map
   for (const auto& headBlock : m_freeBlockSizeBins)
   {
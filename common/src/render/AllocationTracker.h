@@ -66,6 +66,39 @@ public:
     Block* nextRecycledBlock;
   };
 
+  /**
+   * Describes how compact() relocated a used block.
+   */
+  struct BlockMove
+  {
+    Block* block;
+    Index oldPos;
+    Index newPos;
+    Index size;
+  };
+
+  struct Stats
+  {
+    Index capacity = 0;
+    Index usedSize = 0;
+    Index freeSize = 0;
+    Index largestFreeBlockSize = 0;
+    size_t usedBlockCount = 0;
+    size_t freeBlockCount = 0;
+
+    /**
+     * The amount of free memory that is not part of the largest free block.
+     */
+    Index scatteredFreeSize() const;
+
+    /**
+     * Returns a value between 0 and 1, where 0 means that all free memory is in a single
+     * block, and values close to 1 mean that the free memory is split into many small
+     * blocks.
+     */
+    double fragmentation() const;
+  };
+
 private:
   /**
    * Size of memory managed by this AllocationTracker.
@@ -97,6 +130,13 @@ private:
    */
   std::vector<Block*> m_freeBlockSizeBins;
 
+  /**
+   * Kept up to date by all operations so that stats() runs in constant time.
+   */
+  Index m_usedSize = 0;
+  size_t m_usedBlockCount = 0;
+  size_t m_freeBlockCount = 0;
+
   /**
    * Unlinks a Block from m_freeBlockSizeBins. Must be called before modifying
    * Block::size.
@@ -133,6 +173,24 @@ public:
    */
   bool hasAllocations() const;
 
+  /**
+   * Relocates used blocks towards the front, merging the free blocks between them
+   * towards the end. Starting at the leftmost free block, each used block that follows a
+   * free block is moved left into that free block. The blocks are moved in order until
+   * the total size of the moved blocks would exceed `budget`, but at least one block is
+   * moved if there is any free block followed by a used block.
+   *
+   * The Block objects themselves remain valid, only their `pos` changes. The caller must
+   * apply the returned moves to its buffer in the returned order, since the source and
+   * target ranges of a move can overlap ranges of previous moves.
+   */
+  std::vector<BlockMove> compact(Index budget);
+
+  /**
+   * Returns statistics about the used and free memory. Constant time.
+   */
+  Stats stats() const;
+
   // Testing / debugging
 
   class Range
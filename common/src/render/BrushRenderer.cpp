@@ -31,8 +31,13 @@
 #include "render/BrushRendererBrushCache.h"
 #include "render/RenderContext.h"
 
+#include "kdl/task_manager.h"
+
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <functional>
+#include <ranges>
 #include <vector>
 
 namespace tb::render
@@ -63,6 +68,20 @@ public:
   }
 };
 
+/**
+ * The maximum number of bytes moved per array and frame by BrushRenderer::compact.
+ */
+constexpr size_t CompactionByteBudget = 1024 * 1024;
+
+/**
+ * An array is compacted if more than 1/8 of its capacity is free memory that is not part
+ * of the largest free block.
+ */
+bool shouldCompact(const AllocationTracker::Stats& stats)
+{
+  return stats.scatteredFreeSize() > stats.capacity / 8;
+}
+
 } // namespace
 
 // Filter
@@ -173,15 +192,17 @@ BrushRenderer::BrushRenderer()
   clear();
 }
 
+BrushRenderer::BrushRenderer(kdl::task_manager& taskManager)
+  : m_filter{std::make_unique<NoFilter>()}
+  , m_taskManager{&taskManager}
+{
+  clear();
+}
+
 void BrushRenderer::invalidate()
 {
-  for (auto* brushNode : m_allBrushes)
-  {
-    // this will also invalidate already invalid brushes, which
-    // is unnecessary
-    removeBrushFromVbo(*brushNode);
-  }
   m_invalidBrushes = m_allBrushes;
+  resetBuffers();
 
   assert(m_brushInfo.empty());
   assert(m_transparentFaces->empty());
@@ -193,6 +214,8 @@ void BrushRenderer::invalidateMaterials(
 {
   const auto materialSet =
     std::unordered_set<const mdl::Material*>{materials.begin(), materials.end()};
+
+  auto brushesToInvalidate = std::vector<const mdl::BrushNode*>{};
   for (auto* brush : m_allBrushes)
   {
     for (const auto& face : brush->brush().faces())
@@ -200,10 +223,13 @@ void BrushRenderer::invalidateMaterials(
       if (materialSet.count(face.material()) > 0)
       {
         brush->brushRendererBrushCache().invalidateVertexCache();
-        invalidateBrush(brush);
+        brushesToInvalidate.push_back(brush);
+        break;
       }
     }
   }
+
+  invalidateBrushes(brushesToInvalidate);
 }
 
 void BrushRenderer::invalidateBrush(const mdl::BrushNode* brushNode)
@@ -222,6 +248,36 @@ void BrushRenderer::invalidateBrush(const mdl::BrushNode* brushNode)
   }
 }
 
+void BrushRenderer::invalidateBrushes(
+  const std::vector<const mdl::BrushNode*>& brushNodes)
+{
+  auto brushesToRemove = std::vector<const mdl::BrushNode*>{};
+  for (const auto* brushNode : brushNodes)
+  {
+    // skip brushes that are not in the renderer or that are already invalid
+    if (
+      m_allBrushes.find(brushNode) != std::end(m_allBrushes)
+      && m_invalidBrushes.insert(brushNode).second)
+    {
+      brushesToRemove.push_back(brushNode);
+    }
+  }
+
+  if (!brushesToRemove.empty() && m_invalidBrushes.size() == m_allBrushes.size())
+  {
+    // no valid brush is left, so the buffers can be reset instead of removing the
+    // brushes from them one by one
+    resetBuffers();
+  }
+  else
+  {
+    for (const auto* brushNode : brushesToRemove)
+    {
+      removeBrushFromVbo(*brushNode);
+    }
+  }
+}
+
 bool BrushRenderer::valid() const
 {
   return m_invalidBrushes.empty();
@@ -229,9 +285,14 @@ bool BrushRenderer::valid() const
 
 void BrushRenderer::clear()
 {
-  m_brushInfo.clear();
   m_allBrushes.clear();
   m_invalidBrushes.clear();
+  resetBuffers();
+}
+
+void BrushRenderer::resetBuffers()
+{
+  m_brushInfo.clear();
 
   m_vertexArray = std::make_shared<BrushVertexArray>();
   m_edgeIndices = std::make_shared<BrushIndexArray>();
@@ -325,6 +386,7 @@ void BrushRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& rend
     {
       validate();
     }
+    compact(CompactionByteBudget);
     if (renderContext.showFaces())
     {
       renderOpaqueFaces(renderBatch);
@@ -378,43 +440,27 @@ void BrushRenderer::renderEdges(RenderBatch& renderBatch)
   m_edgeRenderer.render(renderBatch, m_edgeColor);
 }
 
-void BrushRenderer::validate()
+namespace
 {
-  assert(!valid());
 
-  for (auto* brushNode : m_invalidBrushes)
-  {
-    validateBrush(*brushNode);
-  }
-  m_invalidBrushes.clear();
-  assert(valid());
-
-  m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
-  m_transparentFaceRenderer =
-    FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
-  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
-}
-
-static size_t triIndicesCountForPolygon(const size_t vertexCount)
-{
-  assert(vertexCount >= 3);
-  const size_t indexCount = 3 * (vertexCount - 2);
-  return indexCount;
-}
+/**
+ * The number of brushes that are prepared by a single task in BrushRenderer::validate.
+ */
+constexpr size_t PrepareChunkSize = 256;
 
-static void addTriIndicesForPolygon(
-  GLuint* dest, const GLuint baseIndex, const size_t vertexCount)
+void addTriIndicesForPolygon(
+  std::vector<GLuint>& dest, const GLuint baseIndex, const size_t vertexCount)
 {
   assert(vertexCount >= 3);
   for (size_t i = 0; i < vertexCount - 2; ++i)
   {
-    *(dest++) = baseIndex;
-    *(dest++) = baseIndex + static_cast<GLuint>(i + 1);
-    *(dest++) = baseIndex + static_cast<GLuint>(i + 2);
+    dest.push_back(baseIndex);
+    dest.push_back(baseIndex + static_cast<GLuint>(i + 1));
+    dest.push_back(baseIndex + static_cast<GLuint>(i + 2));
   }
 }
 
-static inline bool shouldRenderEdge(
+bool shouldRenderEdge(
   const BrushRendererBrushCache::CachedEdge& edge,
   const BrushRenderer::Filter::EdgeRenderPolicy policy)
 {
@@ -436,32 +482,10 @@ static inline bool shouldRenderEdge(
   }
 }
 
-static size_t countMarkedEdgeIndices(
-  const mdl::BrushNode& brushNode, const BrushRenderer::Filter::EdgeRenderPolicy policy)
-{
-  using EdgeRenderPolicy = BrushRenderer::Filter::EdgeRenderPolicy;
-
-  if (policy == EdgeRenderPolicy::RenderNone)
-  {
-    return 0;
-  }
-
-  size_t indexCount = 0;
-  for (const auto& edge : brushNode.brushRendererBrushCache().cachedEdges())
-  {
-    if (shouldRenderEdge(edge, policy))
-    {
-      indexCount += 2;
-    }
-  }
-  return indexCount;
-}
-
-static void getMarkedEdgeIndices(
+void addMarkedEdgeIndices(
   const mdl::BrushNode& brushNode,
   const BrushRenderer::Filter::EdgeRenderPolicy policy,
-  const GLuint brushVerticesStartIndex,
-  GLuint* dest)
+  std::vector<GLuint>& dest)
 {
   using EdgeRenderPolicy = BrushRenderer::Filter::EdgeRenderPolicy;
 
@@ -470,30 +494,30 @@ static void getMarkedEdgeIndices(
     return;
   }
 
-  size_t i = 0;
   for (const auto& edge : brushNode.brushRendererBrushCache().cachedEdges())
   {
     if (shouldRenderEdge(edge, policy))
     {
-      dest[i++] =
-        static_cast<GLuint>(brushVerticesStartIndex + edge.vertexIndex1RelativeToBrush);
-      dest[i++] =
-        static_cast<GLuint>(brushVerticesStartIndex + edge.vertexIndex2RelativeToBrush);
+      dest.push_back(static_cast<GLuint>(edge.vertexIndex1RelativeToBrush));
+      dest.push_back(static_cast<GLuint>(edge.vertexIndex2RelativeToBrush));
     }
   }
 }
 
-bool BrushRenderer::shouldDrawFaceInTransparentPass(
-  const mdl::BrushNode& brushNode, const mdl::BrushFace& face) const
+bool shouldDrawFaceInTransparentPass(
+  const mdl::BrushNode& brushNode,
+  const mdl::BrushFace& face,
+  const float transparencyAlpha,
+  const bool forceTransparent)
 {
-  if (m_transparencyAlpha >= 1.0f)
+  if (transparencyAlpha >= 1.0f)
   {
     // In this case, draw everything in the opaque pass
     // see: https://github.com/TrenchBroom/TrenchBroom/issues/2848
     return false;
   }
 
-  if (m_forceTransparent)
+  if (forceTransparent)
   {
     return true;
   }
@@ -508,168 +532,333 @@ bool BrushRenderer::shouldDrawFaceInTransparentPass(
   return false;
 }
 
-void BrushRenderer::validateBrush(const mdl::BrushNode& brushNode)
+/**
+ * Copies the given indices, which are relative to a brush's first vertex, to the given
+ * destination and offsets them by the given index of the brush's first vertex.
+ */
+void copyIndices(
+  const std::vector<GLuint>& indices,
+  const size_t offset,
+  const size_t count,
+  const GLuint brushVerticesStartIndex,
+  GLuint* dest)
 {
-  assert(m_allBrushes.find(&brushNode) != std::end(m_allBrushes));
-  assert(m_invalidBrushes.find(&brushNode) != std::end(m_invalidBrushes));
-  assert(m_brushInfo.find(&brushNode) == std::end(m_brushInfo));
-
-  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
-
-  // evaluate filter. only evaluate the filter once per brush.
-  const auto settings = wrapper.markFaces(brushNode);
-  const auto [facePolicy, edgePolicy] = settings;
-
-  if (
-    facePolicy == Filter::FaceRenderPolicy::RenderNone
-    && edgePolicy == Filter::EdgeRenderPolicy::RenderNone)
+  for (size_t i = 0; i < count; ++i)
   {
-    // NOTE: this skips inserting the brush into m_brushInfo
-    return;
+    dest[i] = brushVerticesStartIndex + indices[offset + i];
   }
+}
 
-  BrushInfo& info = m_brushInfo[&brushNode];
+} // namespace
 
-  // collect vertices
-  auto& brushCache = brushNode.brushRendererBrushCache();
-  brushCache.validateVertexCache(brushNode);
-  const auto& cachedVertices = brushCache.cachedVertices();
-  ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+/**
+ * The result of preparing a chunk of brushes for insertion into the vertex and index
+ * arrays. All indices of the brushes in the chunk are stored in one buffer to avoid
+ * allocating a buffer for every brush.
+ */
+struct BrushRenderer::PreparedBrushes
+{
+  struct FaceIndices
+  {
+    const mdl::Material* material;
+    bool transparent;
+    size_t offset;
+    size_t count;
+  };
+
+  struct Brush
+  {
+    const mdl::BrushNode* brushNode;
+    size_t edgeIndexOffset;
+    size_t edgeIndexCount;
+    size_t faceIndicesOffset;
+    size_t faceIndicesCount;
+  };
+
+  /**
+   * Only contains the brushes that are to be rendered.
+   */
+  std::vector<Brush> brushes;
+  std::vector<FaceIndices> faceIndices;
+  std::vector<GLuint> indices;
+};
 
-  assert(m_vertexArray != nullptr);
-  auto [vertBlock, dest] =
-    m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
-  std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
-  info.vertexHolderKey = vertBlock;
+void BrushRenderer::validate()
+{
+  assert(!valid());
 
-  const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
+  const auto invalidBrushes =
+    std::vector<const mdl::BrushNode*>{m_invalidBrushes.begin(), m_invalidBrushes.end()};
 
-  // insert edge indices into VBO
+  if (m_taskManager && invalidBrushes.size() > PrepareChunkSize)
   {
-    const auto edgeIndexCount = countMarkedEdgeIndices(brushNode, edgePolicy);
-    if (edgeIndexCount > 0)
+    // prepare the brushes in parallel
+    auto chunkStarts = std::vector<size_t>{};
+    for (size_t i = 0; i < invalidBrushes.size(); i += PrepareChunkSize)
     {
-      auto [key, insertDest] =
-        m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
-      info.edgeIndicesKey = key;
-      getMarkedEdgeIndices(brushNode, edgePolicy, brushVerticesStartIndex, insertDest);
+      chunkStarts.push_back(i);
     }
-    else
+
+    auto tasks = chunkStarts | std::views::transform([&](const auto first) {
+                   return std::function{[&, first]() {
+                     const auto last =
+                       std::min(first + PrepareChunkSize, invalidBrushes.size());
+                     return prepareBrushes(
+                       invalidBrushes.begin() + std::ptrdiff_t(first),
+                       invalidBrushes.begin() + std::ptrdiff_t(last));
+                   }};
+                 });
+
+    // inserting into the arrays is cheap and must happen on this thread
+    for (const auto& preparedBrushes : m_taskManager->run_tasks_and_wait(tasks))
     {
-      // it's possible to have no edges to render
-      // e.g. select all faces of a brush, and the unselected brush renderer
-      // will hit this branch.
-      ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
+      insertPreparedBrushes(preparedBrushes);
     }
   }
+  else
+  {
+    insertPreparedBrushes(prepareBrushes(invalidBrushes.begin(), invalidBrushes.end()));
+  }
+
+  m_invalidBrushes.clear();
+  assert(valid());
 
-  // insert face indices
+  m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
+  m_transparentFaceRenderer =
+    FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
+  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+}
 
-  auto& facesSortedByMaterial = brushCache.cachedFacesSortedByMaterial();
-  const auto facesSortedByMaterialCount = facesSortedByMaterial.size();
+BrushRenderer::PreparedBrushes BrushRenderer::prepareBrushes(
+  const std::vector<const mdl::BrushNode*>::const_iterator begin,
+  const std::vector<const mdl::BrushNode*>::const_iterator end) const
+{
+  auto result = PreparedBrushes{};
+  result.brushes.reserve(size_t(std::distance(begin, end)));
+
+  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
 
-  size_t nextI;
-  for (size_t i = 0; i < facesSortedByMaterialCount; i = nextI)
+  for (auto it = begin; it != end; ++it)
   {
-    const auto* material = facesSortedByMaterial[i].material;
+    const auto& brushNode = **it;
 
-    size_t opaqueIndexCount = 0;
-    size_t transparentIndexCount = 0;
+    assert(m_allBrushes.find(&brushNode) != std::end(m_allBrushes));
+    assert(m_invalidBrushes.find(&brushNode) != std::end(m_invalidBrushes));
+    assert(m_brushInfo.find(&brushNode) == std::end(m_brushInfo));
 
-    // find the i value for the next material
-    for (nextI = i + 1; nextI < facesSortedByMaterialCount
-                        && facesSortedByMaterial[nextI].material == material;
-         ++nextI)
+    // evaluate filter. only evaluate the filter once per brush.
+    const auto settings = wrapper.markFaces(brushNode);
+    const auto [facePolicy, edgePolicy] = settings;
+
+    if (
+      facePolicy == Filter::FaceRenderPolicy::RenderNone
+      && edgePolicy == Filter::EdgeRenderPolicy::RenderNone)
     {
+      // NOTE: this skips inserting the brush into m_brushInfo
+      continue;
     }
 
-    // process all faces with this material (they'll be consecutive)
-    for (size_t j = i; j < nextI; ++j)
+    // collect vertices
+    auto& brushCache = brushNode.brushRendererBrushCache();
+    brushCache.validateVertexCache(brushNode);
+    ensure(!brushCache.cachedVertices().empty(), "Brush must have cached vertices");
+
+    // collect edge indices
+    const auto edgeIndexOffset = result.indices.size();
+    addMarkedEdgeIndices(brushNode, edgePolicy, result.indices);
+    const auto edgeIndexCount = result.indices.size() - edgeIndexOffset;
+
+    // collect face indices
+    const auto faceIndicesOffset = result.faceIndices.size();
+
+    const auto& facesSortedByMaterial = brushCache.cachedFacesSortedByMaterial();
+    const auto facesSortedByMaterialCount = facesSortedByMaterial.size();
+
+    size_t nextI;
+    for (size_t i = 0; i < facesSortedByMaterialCount; i = nextI)
     {
-      const auto& cache = facesSortedByMaterial[j];
-      if (cache.face->isMarked())
+      const auto* material = facesSortedByMaterial[i].material;
+
+      // find the i value for the next material
+      for (nextI = i + 1; nextI < facesSortedByMaterialCount
+                          && facesSortedByMaterial[nextI].material == material;
+           ++nextI)
       {
-        assert(cache.material == material);
-        if (shouldDrawFaceInTransparentPass(brushNode, *cache.face))
+      }
+
+      // process all faces with this material (they'll be consecutive), once for the
+      // transparent pass and once for the opaque pass
+      for (const auto transparent : {true, false})
+      {
+        const auto offset = result.indices.size();
+        for (size_t j = i; j < nextI; ++j)
         {
-          transparentIndexCount += triIndicesCountForPolygon(cache.vertexCount);
+          const auto& cache = facesSortedByMaterial[j];
+          if (
+            cache.face->isMarked()
+            && shouldDrawFaceInTransparentPass(
+                 brushNode, *cache.face, m_transparencyAlpha, m_forceTransparent)
+                 == transparent)
+          {
+            assert(cache.material == material);
+            addTriIndicesForPolygon(
+              result.indices,
+              static_cast<GLuint>(cache.indexOfFirstVertexRelativeToBrush),
+              cache.vertexCount);
+          }
         }
-        else
+
+        if (const auto count = result.indices.size() - offset; count > 0)
         {
-          opaqueIndexCount += triIndicesCountForPolygon(cache.vertexCount);
+          result.faceIndices.push_back({material, transparent, offset, count});
         }
       }
     }
 
-    if (transparentIndexCount > 0)
-    {
-      auto& faceVboMap = *m_transparentFaces;
-      auto& holderPtr = faceVboMap[material];
-      if (holderPtr == nullptr)
-      {
-        // inserts into map!
-        holderPtr = std::make_shared<BrushIndexArray>();
-      }
+    result.brushes.push_back({
+      &brushNode,
+      edgeIndexOffset,
+      edgeIndexCount,
+      faceIndicesOffset,
+      result.faceIndices.size() - faceIndicesOffset,
+    });
+  }
 
-      auto [key, insertDest] =
-        holderPtr->getPointerToInsertElementsAt(transparentIndexCount);
-      info.transparentFaceIndicesKeys.emplace_back(material, key);
+  return result;
+}
 
-      // process all faces with this material (they'll be consecutive)
-      auto* currentDest = insertDest;
-      for (size_t j = i; j < nextI; ++j)
-      {
-        const auto& cache = facesSortedByMaterial[j];
-        if (
-          cache.face->isMarked()
-          && shouldDrawFaceInTransparentPass(brushNode, *cache.face))
-        {
-          addTriIndicesForPolygon(
-            currentDest,
-            static_cast<GLuint>(
-              brushVerticesStartIndex + cache.indexOfFirstVertexRelativeToBrush),
-            cache.vertexCount);
+void BrushRenderer::insertPreparedBrushes(const PreparedBrushes& preparedBrushes)
+{
+  assert(m_vertexArray != nullptr);
 
-          currentDest += triIndicesCountForPolygon(cache.vertexCount);
-        }
-      }
-      assert(currentDest == (insertDest + transparentIndexCount));
+  for (const auto& preparedBrush : preparedBrushes.brushes)
+  {
+    const auto& brushNode = *preparedBrush.brushNode;
+    auto& info = m_brushInfo[&brushNode];
+
+    // insert vertices into VBO
+    const auto& cachedVertices = brushNode.brushRendererBrushCache().cachedVertices();
+
+    auto [vertBlock, dest] =
+      m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
+    std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
+    info.vertexHolderKey = vertBlock;
+
+    const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
+
+    // insert edge indices into VBO
+    if (preparedBrush.edgeIndexCount > 0)
+    {
+      auto [key, insertDest] =
+        m_edgeIndices->getPointerToInsertElementsAt(preparedBrush.edgeIndexCount);
+      info.edgeIndicesKey = key;
+      copyIndices(
+        preparedBrushes.indices,
+        preparedBrush.edgeIndexOffset,
+        preparedBrush.edgeIndexCount,
+        brushVerticesStartIndex,
+        insertDest);
+    }
+    else
+    {
+      // it's possible to have no edges to render
+      // e.g. select all faces of a brush, and the unselected brush renderer
+      // will hit this branch.
+      ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
     }
 
-    if (opaqueIndexCount > 0)
+    // insert face indices into VBO
+    for (size_t i = 0; i < preparedBrush.faceIndicesCount; ++i)
     {
-      auto& faceVboMap = *m_opaqueFaces;
-      auto& holderPtr = faceVboMap[material];
+      const auto& faceIndices =
+        preparedBrushes.faceIndices[preparedBrush.faceIndicesOffset + i];
+
+      auto& faceVboMap = faceIndices.transparent ? *m_transparentFaces : *m_opaqueFaces;
+      auto& holderPtr = faceVboMap[faceIndices.material];
       if (holderPtr == nullptr)
       {
         // inserts into map!
         holderPtr = std::make_shared<BrushIndexArray>();
       }
 
-      auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(opaqueIndexCount);
-      info.opaqueFaceIndicesKeys.emplace_back(material, key);
+      auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(faceIndices.count);
+      auto& keys = faceIndices.transparent ? info.transparentFaceIndicesKeys
+                                           : info.opaqueFaceIndicesKeys;
+      keys.emplace_back(faceIndices.material, key);
+
+      copyIndices(
+        preparedBrushes.indices,
+        faceIndices.offset,
+        faceIndices.count,
+        brushVerticesStartIndex,
+        insertDest);
+    }
+  }
+}
+
+void BrushRenderer::compact(const size_t byteBudget)
+{
+  if (shouldCompact(m_vertexArray->allocationStats()))
+  {
+    const auto moves = m_vertexArray->compact(byteBudget);
+
+    auto movesByBlock = std::unordered_map<
+      const AllocationTracker::Block*,
+      const AllocationTracker::BlockMove*>{};
+    for (const auto& move : moves)
+    {
+      movesByBlock.emplace(move.block, &move);
+    }
 
-      // process all faces with this material (they'll be consecutive)
-      auto* currentDest = insertDest;
-      for (size_t j = i; j < nextI; ++j)
+    // the indices of the moved brushes refer to the old vertex positions
+    for (const auto& [brushNode, info] : m_brushInfo)
+    {
+      if (const auto it = movesByBlock.find(info.vertexHolderKey);
+          it != movesByBlock.end())
       {
-        const auto& cache = facesSortedByMaterial[j];
-        if (
-          cache.face->isMarked()
-          && !shouldDrawFaceInTransparentPass(brushNode, *cache.face))
-        {
-          addTriIndicesForPolygon(
-            currentDest,
-            static_cast<GLuint>(
-              brushVerticesStartIndex + cache.indexOfFirstVertexRelativeToBrush),
-            cache.vertexCount);
+        const auto oldBaseIndex = static_cast<GLuint>(it->second->oldPos);
+        const auto newBaseIndex = static_cast<GLuint>(it->second->newPos);
 
-          currentDest += triIndicesCountForPolygon(cache.vertexCount);
+        if (info.edgeIndicesKey != nullptr)
+        {
+          m_edgeIndices->rebaseElementsWithKey(
+            info.edgeIndicesKey, oldBaseIndex, newBaseIndex);
+        }
+        for (const auto& [material, key] : info.opaqueFaceIndicesKeys)
+        {
+          m_opaqueFaces->at(material)->rebaseElementsWithKey(
+            key, oldBaseIndex, newBaseIndex);
+        }
+        for (const auto& [material, key] : info.transparentFaceIndicesKeys)
+        {
+          m_transparentFaces->at(material)->rebaseElementsWithKey(
+            key, oldBaseIndex, newBaseIndex);
         }
       }
-      assert(currentDest == (insertDest + opaqueIndexCount));
     }
   }
+
+  const auto compactIndices = [&](BrushIndexArray& indexArray) {
+    if (shouldCompact(indexArray.allocationStats()))
+    {
+      indexArray.compact(byteBudget);
+    }
+  };
+
+  compactIndices(*m_edgeIndices);
+  for (auto& [material, indexArray] : *m_opaqueFaces)
+  {
+    compactIndices(*indexArray);
+  }
+  for (auto& [material, indexArray] : *m_transparentFaces)
+  {
+    compactIndices(*indexArray);
+  }
+}
+
+AllocationTracker::Stats BrushRenderer::vertexArrayStats() const
+{
+  return m_vertexArray->allocationStats();
 }
 
 void BrushRenderer::addBrush(const mdl::BrushNode* brushNode)
@@ -32,6 +32,11 @@
 #include <unordered_set>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb::mdl
 {
 class BrushNode;
@@ -119,6 +124,12 @@ public:
 private:
   std::unique_ptr<Filter> m_filter;
 
+  /**
+   * Used to prepare the vertices and indices of invalid brushes in parallel. If this is
+   * null, the brushes are prepared on the calling thread.
+   */
+  kdl::task_manager* m_taskManager = nullptr;
+
   struct BrushInfo
   {
     AllocationTracker::Block* vertexHolderKey;
@@ -176,7 +187,16 @@ public:
     clear();
   }
 
+  template <typename FilterT>
+  BrushRenderer(FilterT filter, kdl::task_manager& taskManager)
+    : m_filter{std::make_unique<FilterT>(std::move(filter))}
+    , m_taskManager{&taskManager}
+  {
+    clear();
+  }
+
   BrushRenderer();
+  explicit BrushRenderer(kdl::task_manager& taskManager);
 
   /**
    * Remove all brushes.
@@ -200,6 +220,13 @@ public:
   void invalidate();
   void invalidateMaterials(const std::vector<const mdl::Material*>& materials);
   void invalidateBrush(const mdl::BrushNode* brush);
+
+  /**
+   * Invalidates the given brushes in one batch. Brushes that are not in the renderer are
+   * ignored. If no valid brush is left afterwards, the vertex and index arrays are reset
+   * instead of removing each brush from them.
+   */
+  void invalidateBrushes(const std::vector<const mdl::BrushNode*>& brushes);
   void invalidateMaterial(const mdl::Material& material);
   bool valid() const;
 
@@ -282,14 +309,50 @@ private:
 
 public:
   /**
+   * Validates all invalid brushes. This happens in two phases: First, the filter is
+   * evaluated and the vertices and indices of every invalid brush are computed in
+   * parallel chunks. Then the blocks in the vertex and index arrays are allocated and the
+   * prepared data is copied into them on the calling thread.
+   *
    * Only exposed for benchmarking.
    */
   void validate();
 
 private:
-  bool shouldDrawFaceInTransparentPass(
-    const mdl::BrushNode& brushNode, const mdl::BrushFace& face) const;
-  void validateBrush(const mdl::BrushNode& brushNode);
+  struct PreparedBrushes;
+
+  /**
+   * Evaluates the filter for the given brushes and computes their vertices and their
+   * edge and face indices. The indices are relative to the brush's first vertex.
+   *
+   * Does not modify the state of this renderer, so it can be called concurrently for
+   * disjoint sets of brushes.
+   */
+  PreparedBrushes prepareBrushes(
+    std::vector<const mdl::BrushNode*>::const_iterator begin,
+    std::vector<const mdl::BrushNode*>::const_iterator end) const;
+
+  /**
+   * Allocates blocks for the given prepared brushes and copies their vertices and indices
+   * into the vertex and index arrays.
+   */
+  void insertPreparedBrushes(const PreparedBrushes& preparedBrushes);
+
+public:
+  /**
+   * Incrementally defragments the vertex and index arrays by moving the allocations of
+   * the brushes towards the start of the arrays. At most (roughly) `byteBudget` bytes are
+   * moved per array; the indices of brushes whose vertices were moved are updated.
+   *
+   * Only arrays where a significant part of the free space is scattered in holes are
+   * compacted. This is called once per frame by the render methods.
+   */
+  void compact(size_t byteBudget);
+
+  /**
+   * Returns the fragmentation statistics of the vertex array.
+   */
+  AllocationTracker::Stats vertexArrayStats() const;
 
 public:
   /**
@@ -311,6 +374,12 @@ private:
    */
   void removeBrushFromVbo(const mdl::BrushNode& brush);
 
+  /**
+   * Removes all brushes from the VBO by replacing the vertex and index arrays with empty
+   * ones. The "valid" state of the brushes is not touched inside here.
+   */
+  void resetBuffers();
+
   deleteCopyAndMove(BrushRenderer);
 };
 
@@ -19,6 +19,8 @@
 
 #include "render/BrushRendererArrays.h"
 
+#include "render/RenderStatistics.h"
+
 #include <algorithm>
 #include <cassert>
 #include <cstring>
@@ -63,16 +65,69 @@ void DirtyRangeTracker::markDirty(const size_t pos, const size_t size)
     throw std::invalid_argument{"markDirty provided range out of bounds"};
   }
 
-  const auto newPos = std::min(pos, m_dirtyPos);
-  const auto newEnd = std::max(pos + size, m_dirtyPos + m_dirtySize);
+  if (size == 0)
+  {
+    return;
+  }
+
+  // find the first range that ends at or after pos, it's the first one we might touch
+  auto first = std::lower_bound(
+    m_dirtyRanges.begin(), m_dirtyRanges.end(), pos, [](const auto& range, const auto p) {
+      return range.pos + range.size < p;
+    });
 
-  m_dirtyPos = newPos;
-  m_dirtySize = newEnd - newPos;
+  // merge all ranges that overlap or touch the new range
+  auto newRange = Range{pos, size};
+  auto last = first;
+  while (last != m_dirtyRanges.end() && last->pos <= newRange.pos + newRange.size)
+  {
+    const auto newEnd = std::max(newRange.pos + newRange.size, last->pos + last->size);
+    newRange.pos = std::min(newRange.pos, last->pos);
+    newRange.size = newEnd - newRange.pos;
+    ++last;
+  }
+
+  first = m_dirtyRanges.erase(first, last);
+  m_dirtyRanges.insert(first, newRange);
+
+  if (m_dirtyRanges.size() > MaxDirtyRanges)
+  {
+    // merge the two ranges with the smallest gap between them
+    auto closest = m_dirtyRanges.begin();
+    for (auto it = m_dirtyRanges.begin(); it + 1 != m_dirtyRanges.end(); ++it)
+    {
+      const auto gap = (it + 1)->pos - (it->pos + it->size);
+      const auto closestGap = (closest + 1)->pos - (closest->pos + closest->size);
+      if (gap < closestGap)
+      {
+        closest = it;
+      }
+    }
+
+    const auto next = closest + 1;
+    closest->size = next->pos + next->size - closest->pos;
+    m_dirtyRanges.erase(next);
+  }
 }
 
 bool DirtyRangeTracker::clean() const
 {
-  return m_dirtySize == 0;
+  return m_dirtyRanges.empty();
+}
+
+const std::vector<DirtyRangeTracker::Range>& DirtyRangeTracker::dirtyRanges() const
+{
+  return m_dirtyRanges;
+}
+
+size_t DirtyRangeTracker::dirtySize() const
+{
+  auto result = size_t(0);
+  for (const auto& range : m_dirtyRanges)
+  {
+    result += range.size;
+  }
+  return result;
 }
 
 // IndexHolder
@@ -100,6 +155,7 @@ void IndexHolder::render(const PrimType primType, const size_t offset, size_t co
     reinterpret_cast<GLvoid*>(m_vbo->offset() + sizeof(Index) * offset);
 
   glAssert(glDrawElements(toGL(primType), renderCount, glType<Index>(), renderOffset));
+  recordDrawCall(count);
 }
 
 std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index>& elements)
@@ -151,6 +207,40 @@ void BrushIndexArray::zeroElementsWithKey(AllocationTracker::Block* key)
   m_indexHolder.zeroRange(pos, size);
 }
 
+void BrushIndexArray::rebaseElementsWithKey(
+  AllocationTracker::Block* key, const GLuint oldBaseIndex, const GLuint newBaseIndex)
+{
+  auto* dest = m_indexHolder.getPointerToWriteElementsTo(key->pos, key->size);
+  for (size_t i = 0; i < key->size; ++i)
+  {
+    dest[i] = dest[i] - oldBaseIndex + newBaseIndex;
+  }
+}
+
+AllocationTracker::Stats BrushIndexArray::allocationStats() const
+{
+  return m_allocationTracker.stats();
+}
+
+size_t BrushIndexArray::compact(const size_t byteBudget)
+{
+  const auto elementBudget = std::max(byteBudget / sizeof(GLuint), size_t(1));
+
+  size_t movedBytes = 0;
+  for (const auto& move : m_allocationTracker.compact(elementBudget))
+  {
+    assert(move.newPos < move.oldPos);
+    m_indexHolder.moveElements(move.oldPos, move.newPos, move.size);
+
+    // zero the part of the old range that is not covered by the new range
+    const auto vacatedPos = std::max(move.newPos + move.size, move.oldPos);
+    m_indexHolder.zeroRange(vacatedPos, move.oldPos + move.size - vacatedPos);
+
+    movedBytes += move.size * sizeof(GLuint);
+  }
+  return movedBytes;
+}
+
 void BrushIndexArray::render(const PrimType primType) const
 {
   assert(m_indexHolder.prepared());
@@ -182,6 +272,24 @@ void BrushIndexArray::cleanupIndices()
 
 BrushVertexArray::BrushVertexArray() = default;
 
+AllocationTracker::Stats BrushVertexArray::allocationStats() const
+{
+  return m_allocationTracker.stats();
+}
+
+std::vector<AllocationTracker::BlockMove> BrushVertexArray::compact(
+  const size_t byteBudget)
+{
+  const auto elementBudget = std::max(byteBudget / sizeof(Vertex), size_t(1));
+
+  auto moves = m_allocationTracker.compact(elementBudget);
+  for (const auto& move : moves)
+  {
+    m_vertexHolder.moveElements(move.oldPos, move.newPos, move.size);
+  }
+  return moves;
+}
+
 std::pair<AllocationTracker::Block*, BrushVertexArray::Vertex*> BrushVertexArray::
   getPointerToInsertVerticesAt(const size_t vertexCount)
 {
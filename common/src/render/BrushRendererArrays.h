@@ -29,15 +29,34 @@
 #include "render/VboManager.h"
 
 #include <cassert>
+#include <cstring>
 #include <memory>
 #include <vector>
 
 namespace tb::render
 {
+/**
+ * Tracks the ranges of a buffer that must be uploaded to the GPU.
+ *
+ * Overlapping and adjacent ranges are coalesced. To keep the number of upload calls low,
+ * the two closest ranges are merged whenever more than MaxDirtyRanges ranges are tracked.
+ */
 struct DirtyRangeTracker
 {
-  size_t m_dirtyPos = 0;
-  size_t m_dirtySize = 0;
+  struct Range
+  {
+    size_t pos = 0;
+    size_t size = 0;
+
+    bool operator==(const Range& other) const = default;
+  };
+
+  static constexpr size_t MaxDirtyRanges = 32;
+
+  /**
+   * Sorted by position, disjoint and non-adjacent.
+   */
+  std::vector<Range> m_dirtyRanges;
   size_t m_capacity = 0;
 
   /**
@@ -53,6 +72,13 @@ struct DirtyRangeTracker
   size_t capacity() const;
   void markDirty(size_t pos, size_t size);
   bool clean() const;
+
+  const std::vector<Range>& dirtyRanges() const;
+
+  /**
+   * Returns the total number of dirty elements.
+   */
+  size_t dirtySize() const;
 };
 
 /**
@@ -61,8 +87,9 @@ struct DirtyRangeTracker
  * Non-copyable; meant to be held in a std::shared_ptr.
  * Able to be resized, and handles copying edits made in the local std::vector to the VBO.
  *
- * Currently uses a single range to track the modified region which might upload much more
- * than necessary; it might be worth mapping the VBO and editing it directly.
+ * The modified regions are tracked as a small set of coalesced ranges, and only these
+ * ranges are uploaded by prepare(). Uploads go through VboManager::writeToVbo, which
+ * streams them through a persistently mapped buffer if the driver supports it.
  */
 template <typename T>
 class VboHolder
@@ -100,7 +127,7 @@ private:
       m_type, m_snapshot.size() * sizeof(T), VboUsage::DynamicDraw);
     assert(m_vbo != nullptr);
 
-    m_vbo->writeElements(0, m_snapshot);
+    m_vboManager->writeToVbo(*m_vbo, 0, m_snapshot.data(), m_snapshot.size());
 
     m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
     assert(m_dirtyRange.clean());
@@ -166,6 +193,19 @@ public:
     return m_snapshot.data() + offsetWithinBlock;
   }
 
+  /**
+   * Moves the given range of elements to the given offset. The ranges may overlap.
+   */
+  void moveElements(const size_t fromOffset, const size_t toOffset, const size_t count)
+  {
+    assert(fromOffset + count <= m_snapshot.size());
+    assert(toOffset + count <= m_snapshot.size());
+
+    std::memmove(
+      m_snapshot.data() + toOffset, m_snapshot.data() + fromOffset, count * sizeof(T));
+    m_dirtyRange.markDirty(toOffset, count);
+  }
+
   bool prepared() const
   {
     // NOTE: this returns true if the capacity is 0
@@ -202,14 +242,11 @@ public:
     }
 
     // otherwise, it's an incremental update of the dirty ranges.
-
-    if (!m_dirtyRange.clean())
+    for (const auto& range : m_dirtyRange.dirtyRanges())
     {
-      const size_t pos = m_dirtyRange.m_dirtyPos;
-      const size_t size = m_dirtyRange.m_dirtySize;
-
-      const size_t bytesFromStart = pos * sizeof(T);
-      m_vbo->writeArray(bytesFromStart, m_snapshot.data() + pos, size);
+      const size_t bytesFromStart = range.pos * sizeof(T);
+      m_vboManager->writeToVbo(
+        *m_vbo, bytesFromStart, m_snapshot.data() + range.pos, range.size);
     }
 
     m_dirtyRange = DirtyRangeTracker(m_snapshot.size());
@@ -278,6 +315,23 @@ public:
    */
   void zeroElementsWithKey(AllocationTracker::Block* key);
 
+  /**
+   * Adds `newBaseIndex - oldBaseIndex` to the indices of the given allocation. Used to
+   * update the indices of a brush whose vertices were moved by BrushVertexArray::compact.
+   */
+  void rebaseElementsWithKey(
+    AllocationTracker::Block* key, GLuint oldBaseIndex, GLuint newBaseIndex);
+
+  AllocationTracker::Stats allocationStats() const;
+
+  /**
+   * Moves allocations towards the start of the array, see AllocationTracker::compact.
+   * The ranges vacated by the moved allocations are zeroed.
+   *
+   * Returns the number of bytes that were moved.
+   */
+  size_t compact(size_t byteBudget);
+
   void render(PrimType primType) const;
   bool prepared() const;
   void prepare(VboManager& vboManager);
@@ -369,6 +423,16 @@ public:
 
   void deleteVerticesWithKey(AllocationTracker::Block* key);
 
+  AllocationTracker::Stats allocationStats() const;
+
+  /**
+   * Moves allocations towards the start of the array, see AllocationTracker::compact.
+   *
+   * The caller must update the indices referring to the moved vertices, see
+   * BrushIndexArray::rebaseElementsWithKey.
+   */
+  std::vector<AllocationTracker::BlockMove> compact(size_t byteBudget);
+
   // setting up GL attributes
   bool setupVertices();
   void cleanupVertices();
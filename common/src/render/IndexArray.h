@@ -22,6 +22,7 @@
 #include "Ensure.h"
 #include "render/GL.h"
 #include "render/PrimType.h"
+#include "render/RenderStatistics.h"
 #include "render/Vbo.h"
 #include "render/VboManager.h"
 
@@ -124,6 +125,7 @@ private:
         static_cast<GLsizei>(count),
         GL_UNSIGNED_INT,
         reinterpret_cast<void*>(offset * 4u)));
+      recordDrawCall(count);
     }
 
   private:
@@ -166,6 +166,7 @@ std::unique_ptr<ObjectRenderer> createDefaultRenderer(
     *kdl::mem_lock(document),
     kdl::mem_lock(document)->entityModelManager(),
     kdl::mem_lock(document)->editorContext(),
+    kdl::mem_lock(document)->taskManager(),
     UnselectedBrushRendererFilter{kdl::mem_lock(document)->editorContext()});
 }
 
@@ -176,6 +177,7 @@ std::unique_ptr<ObjectRenderer> createSelectionRenderer(
     *kdl::mem_lock(document),
     kdl::mem_lock(document)->entityModelManager(),
     kdl::mem_lock(document)->editorContext(),
+    kdl::mem_lock(document)->taskManager(),
     SelectedBrushRendererFilter{kdl::mem_lock(document)->editorContext()});
 }
 
@@ -186,6 +188,7 @@ std::unique_ptr<ObjectRenderer> createLockRenderer(
     *kdl::mem_lock(document),
     kdl::mem_lock(document)->entityModelManager(),
     kdl::mem_lock(document)->editorContext(),
+    kdl::mem_lock(document)->taskManager(),
     LockedBrushRendererFilter{kdl::mem_lock(document)->editorContext()});
 }
 
@@ -235,16 +238,24 @@ void MapRenderer::restoreSelectionColors()
 void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
   setupGL(renderBatch);
+  renderBatch.beginPass("Decals");
   renderEntityDecals(renderContext, renderBatch);
+  renderBatch.beginPass("Links");
   renderEntityLinks(renderContext, renderBatch);
   renderGroupLinks(renderContext, renderBatch);
 
+  renderBatch.beginPass("Default opaque");
   renderDefaultOpaque(renderContext, renderBatch);
+  renderBatch.beginPass("Locked opaque");
   renderLockedOpaque(renderContext, renderBatch);
+  renderBatch.beginPass("Selection opaque");
   renderSelectionOpaque(renderContext, renderBatch);
 
+  renderBatch.beginPass("Default transparent");
   renderDefaultTransparent(renderContext, renderBatch);
+  renderBatch.beginPass("Locked transparent");
   renderLockedTransparent(renderContext, renderBatch);
+  renderBatch.beginPass("Selection transparent");
   renderSelectionTransparent(renderContext, renderBatch);
 }
 
@@ -487,9 +498,11 @@ int MapRenderer::determineDesiredRenderers(mdl::Node* node)
  * - Determine which renderers the given node should be in
  * - Remove from any renderers the node shouldn't be in
  * - Add to desired renderers, if not already present
- * - Invalidate, for any renderers it was already present in
+ *
+ * Returns the renderers that the node was already present in and must be invalidated
+ * in.
  */
-void MapRenderer::updateAndInvalidateNode(mdl::Node* node)
+int MapRenderer::updateNode(mdl::Node* node)
 {
   const auto desiredRenderers = determineDesiredRenderers(node);
   int currentRenderers = 0;
@@ -511,10 +524,6 @@ void MapRenderer::updateAndInvalidateNode(mdl::Node* node)
     {
       o->addNode(node);
     }
-    else if (isRCurrent && isRDesired)
-    {
-      o->invalidateNode(node);
-    }
   };
 
   updateForRenderer(Renderer::Default, m_defaultRenderer.get());
@@ -525,6 +534,63 @@ void MapRenderer::updateAndInvalidateNode(mdl::Node* node)
   m_trackedNodes[node] = desiredRenderers;
 
   m_entityDecalRenderer->updateNode(node);
+
+  return currentRenderers & desiredRenderers;
+}
+
+/**
+ * - Update the renderers of the given node, see updateNode()
+ * - Invalidate, for any renderers it was already present in
+ */
+void MapRenderer::updateAndInvalidateNode(mdl::Node* node)
+{
+  const auto renderersToInvalidate = updateNode(node);
+
+  if ((renderersToInvalidate & int(Renderer::Default)) != 0)
+  {
+    m_defaultRenderer->invalidateNode(node);
+  }
+  if ((renderersToInvalidate & int(Renderer::Selection)) != 0)
+  {
+    m_selectionRenderer->invalidateNode(node);
+  }
+  if ((renderersToInvalidate & int(Renderer::Locked)) != 0)
+  {
+    m_lockedRenderer->invalidateNode(node);
+  }
+}
+
+/**
+ * Like updateAndInvalidateNode(), but invalidates the given nodes in one batch per
+ * renderer.
+ */
+void MapRenderer::updateAndInvalidateNodes(const std::vector<mdl::Node*>& nodes)
+{
+  auto defaultNodes = std::vector<mdl::Node*>{};
+  auto selectionNodes = std::vector<mdl::Node*>{};
+  auto lockedNodes = std::vector<mdl::Node*>{};
+
+  for (auto* node : nodes)
+  {
+    const auto renderersToInvalidate = updateNode(node);
+
+    if ((renderersToInvalidate & int(Renderer::Default)) != 0)
+    {
+      defaultNodes.push_back(node);
+    }
+    if ((renderersToInvalidate & int(Renderer::Selection)) != 0)
+    {
+      selectionNodes.push_back(node);
+    }
+    if ((renderersToInvalidate & int(Renderer::Locked)) != 0)
+    {
+      lockedNodes.push_back(node);
+    }
+  }
+
+  m_defaultRenderer->invalidateNodes(defaultNodes);
+  m_selectionRenderer->invalidateNodes(selectionNodes);
+  m_lockedRenderer->invalidateNodes(lockedNodes);
 }
 
 void MapRenderer::updateAndInvalidateNodeRecursive(mdl::Node* node)
@@ -733,13 +799,10 @@ void MapRenderer::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
 
 void MapRenderer::nodesDidChange(const std::vector<mdl::Node*>& nodes)
 {
-  for (auto* node : nodes)
-  {
-    // nodesDidChange() will report ancestors changing, e.g. the world and layer are
-    // reported as changing when a brush is dragged. So, don't update recursively here as
-    // it would cause the entire map to be invalidated on every change.
-    updateAndInvalidateNode(node);
-  }
+  // nodesDidChange() will report ancestors changing, e.g. the world and layer are
+  // reported as changing when a brush is dragged. So, don't update recursively here as
+  // it would cause the entire map to be invalidated on every change.
+  updateAndInvalidateNodes(nodes);
   invalidateEntityLinkRenderer();
   invalidateGroupLinkRenderer();
 }
@@ -114,7 +114,9 @@ private:
   void setupLockedRenderer(ObjectRenderer& renderer);
 
   static int determineDesiredRenderers(mdl::Node* node);
+  int updateNode(mdl::Node* node);
   void updateAndInvalidateNode(mdl::Node* node);
+  void updateAndInvalidateNodes(const std::vector<mdl::Node*>& nodes);
   void updateAndInvalidateNodeRecursive(mdl::Node* node);
   void removeNode(mdl::Node* node);
   void removeNodeRecursive(mdl::Node* node);
@@ -72,6 +72,23 @@ void ObjectRenderer::invalidateNode(mdl::Node* node)
     [&](mdl::PatchNode* patch) { m_patchRenderer.invalidatePatch(patch); }));
 }
 
+void ObjectRenderer::invalidateNodes(const std::vector<mdl::Node*>& nodes)
+{
+  auto brushes = std::vector<const mdl::BrushNode*>{};
+  for (auto* node : nodes)
+  {
+    node->accept(kdl::overload(
+      [](mdl::WorldNode*) {},
+      [](mdl::LayerNode*) {},
+      [&](mdl::GroupNode* group) { m_groupRenderer.invalidateGroup(group); },
+      [&](mdl::EntityNode* entity) { m_entityRenderer.invalidateEntity(entity); },
+      [&](mdl::BrushNode* brush) { brushes.push_back(brush); },
+      [&](mdl::PatchNode* patch) { m_patchRenderer.invalidatePatch(patch); }));
+  }
+
+  m_brushRenderer.invalidateBrushes(brushes);
+}
+
 void ObjectRenderer::invalidate()
 {
   m_groupRenderer.invalidate();
@@ -27,6 +27,11 @@
 
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb
 {
 class Color;
@@ -64,10 +69,11 @@ public:
     Logger& logger,
     mdl::EntityModelManager& entityModelManager,
     const mdl::EditorContext& editorContext,
+    kdl::task_manager& taskManager,
     const BrushFilterT& brushFilter)
     : m_groupRenderer{editorContext}
     , m_entityRenderer{logger, entityModelManager, editorContext}
-    , m_brushRenderer{brushFilter}
+    , m_brushRenderer{brushFilter, taskManager}
     , m_patchRenderer{editorContext}
   {
   }
@@ -78,6 +84,7 @@ public: // object management
   void invalidateMaterials(const std::vector<const mdl::Material*>& materials);
   void invalidateEntityModels(const std::vector<const mdl::EntityModel*>& entityModels);
   void invalidateNode(mdl::Node* node);
+  void invalidateNodes(const std::vector<mdl::Node*>& nodes);
   void invalidate();
   void clear();
   void reloadModels();
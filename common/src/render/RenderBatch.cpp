@@ -20,6 +20,7 @@
 #include "RenderBatch.h"
 
 #include "Ensure.h"
+#include "render/RenderStatistics.h"
 #include "render/Renderable.h"
 #include "render/VboManager.h"
 
@@ -55,9 +56,17 @@ private:
 
 } // namespace
 
-RenderBatch::RenderBatch(VboManager& vboManager)
+RenderBatch::RenderBatch(VboManager& vboManager, RenderStatistics* statistics)
   : m_vboManager{vboManager}
+  , m_statistics{statistics && statistics->inFrame() ? statistics : nullptr}
 {
+  if (m_statistics)
+  {
+    // renderables added before the first pass is started go into the frame's default
+    // pass
+    m_passes.push_back(Pass{0, 0});
+    m_passStart = Clock::now();
+  }
 }
 
 RenderBatch::~RenderBatch()
@@ -105,10 +114,35 @@ void RenderBatch::addOneShot(IndexedRenderable* renderable)
   m_oneshots.push_back(renderable);
 }
 
+void RenderBatch::beginPass(std::string name)
+{
+  if (m_statistics)
+  {
+    endCollectingPass();
+    m_passes.push_back(Pass{m_statistics->addPass(std::move(name)), m_batch.size()});
+    m_passStart = Clock::now();
+  }
+}
+
 void RenderBatch::render(RenderContext& renderContext)
 {
+  if (!m_statistics)
+  {
+    prepareRenderables();
+    renderRenderables(renderContext);
+    return;
+  }
+
+  endCollectingPass();
+
+  m_statistics->setCurrentPass(m_passes.front().statisticsIndex);
+  const auto prepareStart = Clock::now();
+  const auto uploadedBytes = m_vboManager.uploadStats().uploadedBytes;
   prepareRenderables();
-  renderRenderables(renderContext);
+  m_statistics->recordUpload(m_vboManager.uploadStats().uploadedBytes - uploadedBytes);
+  m_statistics->setPrepareTime(Clock::now() - prepareStart);
+
+  renderPasses(renderContext);
 }
 
 void RenderBatch::doAdd(Renderable* renderable)
@@ -117,6 +151,15 @@ void RenderBatch::doAdd(Renderable* renderable)
   m_batch.push_back(renderable);
 }
 
+void RenderBatch::endCollectingPass()
+{
+  if (!m_passes.empty())
+  {
+    auto& pass = m_statistics->pass(m_passes.back().statisticsIndex);
+    pass.collectTime += Clock::now() - m_passStart;
+  }
+}
+
 void RenderBatch::prepareRenderables()
 {
   for (auto* renderable : m_directRenderables)
@@ -131,9 +174,35 @@ void RenderBatch::prepareRenderables()
 
 void RenderBatch::renderRenderables(RenderContext& renderContext)
 {
-  for (auto* renderable : m_batch)
+  renderRenderables(renderContext, 0, m_batch.size());
+}
+
+void RenderBatch::renderRenderables(
+  RenderContext& renderContext, const size_t firstRenderable, const size_t lastRenderable)
+{
+  for (size_t i = firstRenderable; i < lastRenderable; ++i)
+  {
+    m_batch[i]->render(renderContext);
+  }
+}
+
+void RenderBatch::renderPasses(RenderContext& renderContext)
+{
+  for (size_t i = 0; i < m_passes.size(); ++i)
   {
-    renderable->render(renderContext);
+    const auto firstRenderable = m_passes[i].firstRenderable;
+    const auto lastRenderable =
+      i + 1 < m_passes.size() ? m_passes[i + 1].firstRenderable : m_batch.size();
+
+    m_statistics->setCurrentPass(m_passes[i].statisticsIndex);
+    const auto renderStart = Clock::now();
+    const auto uploadedBytes = m_vboManager.uploadStats().uploadedBytes;
+    renderRenderables(renderContext, firstRenderable, lastRenderable);
+    m_statistics->recordUpload(m_vboManager.uploadStats().uploadedBytes - uploadedBytes);
+
+    auto& pass = m_statistics->pass(m_passes[i].statisticsIndex);
+    pass.renderTime += Clock::now() - renderStart;
+    pass.renderableCount += lastRenderable - firstRenderable;
   }
 }
 
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <string>
 #include <vector>
 
 namespace tb::render
@@ -27,6 +29,7 @@ class Renderable;
 class DirectRenderable;
 class IndexedRenderable;
 class RenderContext;
+class RenderStatistics;
 class VboManager;
 
 class RenderBatch
@@ -44,8 +47,24 @@ private:
   RenderableList m_batch;
   RenderableList m_oneshots;
 
+  struct Pass
+  {
+    size_t statisticsIndex;
+    size_t firstRenderable;
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  RenderStatistics* m_statistics;
+  std::vector<Pass> m_passes;
+  Clock::time_point m_passStart;
+
 public:
-  explicit RenderBatch(VboManager& vboManager);
+  /**
+   * If statistics are given and a frame is being recorded, the batch attributes its
+   * renderables to the passes started with `beginPass()` and records their timings.
+   */
+  explicit RenderBatch(VboManager& vboManager, RenderStatistics* statistics = nullptr);
   ~RenderBatch();
 
   void add(Renderable* renderable);
@@ -60,14 +79,26 @@ public:
   void addOneShot(DirectRenderable* renderable);
   void addOneShot(IndexedRenderable* renderable);
 
+  /**
+   * Starts a new named pass. All renderables added until the next pass is started
+   * belong to this pass. Passes are only used for statistics and do not affect the
+   * order in which renderables are rendered.
+   */
+  void beginPass(std::string name);
+
   void render(RenderContext& renderContext);
 
 private:
   void doAdd(Renderable* renderable);
 
+  void endCollectingPass();
+
   void prepareRenderables();
 
   void renderRenderables(RenderContext& renderContext);
+  void renderRenderables(
+    RenderContext& renderContext, size_t firstRenderable, size_t lastRenderable);
+  void renderPasses(RenderContext& renderContext);
 };
 
 } // namespace tb::render
@@ -0,0 +1,318 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RenderStatistics.h"
+
+#include "Ensure.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+#include <ostream>
+
+namespace tb::render
+{
+namespace
+{
+
+thread_local RenderStatistics* currentStatistics = nullptr;
+
+double toMillis(const std::chrono::nanoseconds duration)
+{
+  return std::chrono::duration<double, std::milli>{duration}.count();
+}
+
+double toMicros(const std::chrono::nanoseconds duration)
+{
+  return std::chrono::duration<double, std::micro>{duration}.count();
+}
+
+RenderPassStatistics makePass(std::string name)
+{
+  auto result = RenderPassStatistics{};
+  result.name = std::move(name);
+  return result;
+}
+
+} // namespace
+
+RenderPassStatistics& RenderPassStatistics::operator+=(const RenderPassStatistics& other)
+{
+  renderableCount += other.renderableCount;
+  drawCallCount += other.drawCallCount;
+  elementCount += other.elementCount;
+  programChangeCount += other.programChangeCount;
+  uploadedBytes += other.uploadedBytes;
+  collectTime += other.collectTime;
+  renderTime += other.renderTime;
+  return *this;
+}
+
+RenderPassStatistics RenderFrameStatistics::total() const
+{
+  auto result = makePass("Total");
+  for (const auto& pass : passes)
+  {
+    result += pass;
+  }
+  return result;
+}
+
+RenderStatistics::RenderStatistics(const size_t maxHistorySize)
+  : m_maxHistorySize{maxHistorySize}
+{
+  ensure(m_maxHistorySize > 0, "history size must be positive");
+}
+
+void RenderStatistics::beginFrame()
+{
+  assert(!m_inFrame);
+
+  m_currentFrame = RenderFrameStatistics{};
+  m_currentFrame.frameIndex = m_nextFrameIndex++;
+  m_currentFrame.passes.push_back(makePass("Other"));
+  m_currentPass = 0;
+  m_frameStart = Clock::now();
+  m_inFrame = true;
+}
+
+void RenderStatistics::endFrame()
+{
+  assert(m_inFrame);
+
+  m_currentFrame.frameTime = Clock::now() - m_frameStart;
+  m_inFrame = false;
+
+  m_history.push_back(std::move(m_currentFrame));
+  while (m_history.size() > m_maxHistorySize)
+  {
+    m_history.pop_front();
+  }
+}
+
+bool RenderStatistics::inFrame() const
+{
+  return m_inFrame;
+}
+
+size_t RenderStatistics::addPass(std::string name)
+{
+  assert(m_inFrame);
+
+  m_currentPass = m_currentFrame.passes.size();
+  m_currentFrame.passes.push_back(makePass(std::move(name)));
+  return m_currentPass;
+}
+
+void RenderStatistics::setCurrentPass(const size_t passIndex)
+{
+  assert(passIndex < m_currentFrame.passes.size());
+  m_currentPass = passIndex;
+}
+
+RenderPassStatistics& RenderStatistics::pass(const size_t passIndex)
+{
+  assert(passIndex < m_currentFrame.passes.size());
+  return m_currentFrame.passes[passIndex];
+}
+
+void RenderStatistics::setPrepareTime(const std::chrono::nanoseconds prepareTime)
+{
+  m_currentFrame.prepareTime = prepareTime;
+}
+
+void RenderStatistics::recordDrawCall(const size_t elementCount)
+{
+  if (m_inFrame)
+  {
+    auto& currentPass = m_currentFrame.passes[m_currentPass];
+    ++currentPass.drawCallCount;
+    currentPass.elementCount += elementCount;
+  }
+}
+
+void RenderStatistics::recordProgramChange()
+{
+  if (m_inFrame)
+  {
+    ++m_currentFrame.passes[m_currentPass].programChangeCount;
+  }
+}
+
+void RenderStatistics::recordUpload(const size_t byteCount)
+{
+  if (m_inFrame)
+  {
+    m_currentFrame.passes[m_currentPass].uploadedBytes += byteCount;
+  }
+}
+
+const std::deque<RenderFrameStatistics>& RenderStatistics::history() const
+{
+  return m_history;
+}
+
+void RenderStatistics::clearHistory()
+{
+  m_history.clear();
+}
+
+RenderFrameStatistics RenderStatistics::average(size_t frameCount) const
+{
+  frameCount = std::min(frameCount, m_history.size());
+
+  auto result = RenderFrameStatistics{};
+  if (frameCount == 0)
+  {
+    return result;
+  }
+
+  const auto first = m_history.end() - static_cast<std::ptrdiff_t>(frameCount);
+  result.frameIndex = m_history.back().frameIndex;
+  for (auto it = first; it != m_history.end(); ++it)
+  {
+    result.prepareTime += it->prepareTime;
+    result.frameTime += it->frameTime;
+
+    for (const auto& pass : it->passes)
+    {
+      auto resultPass = std::find_if(
+        result.passes.begin(), result.passes.end(), [&](const auto& p) {
+          return p.name == pass.name;
+        });
+      if (resultPass == result.passes.end())
+      {
+        result.passes.push_back(makePass(pass.name));
+        resultPass = std::prev(result.passes.end());
+      }
+      *resultPass += pass;
+    }
+  }
+
+  const auto divisor = static_cast<std::chrono::nanoseconds::rep>(frameCount);
+  result.prepareTime /= divisor;
+  result.frameTime /= divisor;
+  for (auto& pass : result.passes)
+  {
+    pass.renderableCount /= frameCount;
+    pass.drawCallCount /= frameCount;
+    pass.elementCount /= frameCount;
+    pass.programChangeCount /= frameCount;
+    pass.uploadedBytes /= frameCount;
+    pass.collectTime /= divisor;
+    pass.renderTime /= divisor;
+  }
+
+  return result;
+}
+
+std::string RenderStatistics::summary(const size_t frameCount) const
+{
+  const auto frame = average(frameCount);
+  const auto total = frame.total();
+
+  auto result = fmt::format(
+    "Frame {:.2f}ms (prepare {:.2f}ms), {} draw calls, {} elements, {} program "
+    "changes, {} KiB uploaded",
+    toMillis(frame.frameTime),
+    toMillis(frame.prepareTime),
+    total.drawCallCount,
+    total.elementCount,
+    total.programChangeCount,
+    total.uploadedBytes / 1024u);
+
+  for (const auto& pass : frame.passes)
+  {
+    if (pass.renderableCount > 0 || pass.drawCallCount > 0)
+    {
+      result += fmt::format(
+        "\n{}: collect {:.2f}ms, render {:.2f}ms, {} renderables, {} draw calls, {} "
+        "elements",
+        pass.name,
+        toMillis(pass.collectTime),
+        toMillis(pass.renderTime),
+        pass.renderableCount,
+        pass.drawCallCount,
+        pass.elementCount);
+    }
+  }
+
+  return result;
+}
+
+void RenderStatistics::writeCsv(std::ostream& str) const
+{
+  str << "frame,pass,renderables,draw_calls,elements,program_changes,uploaded_bytes,"
+         "collect_us,render_us,prepare_us,frame_us\n";
+
+  for (const auto& frame : m_history)
+  {
+    for (const auto& pass : frame.passes)
+    {
+      str << fmt::format(
+        "{},\"{}\",{},{},{},{},{},{:.1f},{:.1f},{:.1f},{:.1f}\n",
+        frame.frameIndex,
+        pass.name,
+        pass.renderableCount,
+        pass.drawCallCount,
+        pass.elementCount,
+        pass.programChangeCount,
+        pass.uploadedBytes,
+        toMicros(pass.collectTime),
+        toMicros(pass.renderTime),
+        toMicros(frame.prepareTime),
+        toMicros(frame.frameTime));
+    }
+  }
+}
+
+ScopedRenderStatistics::ScopedRenderStatistics(RenderStatistics& statistics)
+  : m_previous{currentStatistics}
+{
+  currentStatistics = &statistics;
+}
+
+ScopedRenderStatistics::~ScopedRenderStatistics()
+{
+  currentStatistics = m_previous;
+}
+
+RenderStatistics* currentRenderStatistics()
+{
+  return currentStatistics;
+}
+
+void recordDrawCall(const size_t elementCount)
+{
+  if (currentStatistics)
+  {
+    currentStatistics->recordDrawCall(elementCount);
+  }
+}
+
+void recordProgramChange()
+{
+  if (currentStatistics)
+  {
+    currentStatistics->recordProgramChange();
+  }
+}
+
+} // namespace tb::render
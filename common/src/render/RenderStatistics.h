@@ -0,0 +1,149 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace tb::render
+{
+
+/**
+ * Counters and timings collected for one render pass. Timings are measured on the CPU,
+ * so the render time is the time spent submitting the pass to the driver, not the time
+ * the GPU spends executing it.
+ */
+struct RenderPassStatistics
+{
+  std::string name;
+  size_t renderableCount = 0;
+  size_t drawCallCount = 0;
+  size_t elementCount = 0;
+  size_t programChangeCount = 0;
+  size_t uploadedBytes = 0;
+  std::chrono::nanoseconds collectTime = std::chrono::nanoseconds{0};
+  std::chrono::nanoseconds renderTime = std::chrono::nanoseconds{0};
+
+  RenderPassStatistics& operator+=(const RenderPassStatistics& other);
+};
+
+struct RenderFrameStatistics
+{
+  size_t frameIndex = 0;
+  std::chrono::nanoseconds prepareTime = std::chrono::nanoseconds{0};
+  std::chrono::nanoseconds frameTime = std::chrono::nanoseconds{0};
+  std::vector<RenderPassStatistics> passes;
+
+  RenderPassStatistics total() const;
+};
+
+/**
+ * Collects per frame and per pass render statistics and keeps a bounded history of
+ * completed frames.
+ *
+ * The draw sites have no access to the render batch, so they report to the statistics
+ * that are installed on the current thread using ScopedRenderStatistics. Recording is a
+ * no-op if no statistics are installed. Uploads are not reported by the draw sites; the
+ * render batch attributes the VboManager's upload counters to its passes instead.
+ */
+class RenderStatistics
+{
+private:
+  using Clock = std::chrono::steady_clock;
+
+  size_t m_maxHistorySize;
+  std::deque<RenderFrameStatistics> m_history;
+
+  size_t m_nextFrameIndex = 0;
+  bool m_inFrame = false;
+  Clock::time_point m_frameStart;
+  RenderFrameStatistics m_currentFrame;
+  size_t m_currentPass = 0;
+
+public:
+  static constexpr size_t DefaultHistorySize = 600;
+
+  explicit RenderStatistics(size_t maxHistorySize = DefaultHistorySize);
+
+  void beginFrame();
+  void endFrame();
+  bool inFrame() const;
+
+  /**
+   * Adds a pass to the current frame and makes it the pass that recorded counters are
+   * attributed to. Returns the index of the new pass.
+   */
+  size_t addPass(std::string name);
+  void setCurrentPass(size_t passIndex);
+  RenderPassStatistics& pass(size_t passIndex);
+
+  void setPrepareTime(std::chrono::nanoseconds prepareTime);
+
+  void recordDrawCall(size_t elementCount);
+  void recordProgramChange();
+  void recordUpload(size_t byteCount);
+
+  const std::deque<RenderFrameStatistics>& history() const;
+  void clearHistory();
+
+  /**
+   * Averages the per pass statistics of the given number of most recent frames. Passes
+   * are matched by name.
+   */
+  RenderFrameStatistics average(size_t frameCount) const;
+
+  /**
+   * Returns a multi line summary of the average of the given number of most recent
+   * frames, suitable for displaying in a heads up overlay.
+   */
+  std::string summary(size_t frameCount) const;
+
+  /**
+   * Writes the history as CSV with one row per frame and pass.
+   */
+  void writeCsv(std::ostream& str) const;
+};
+
+/**
+ * Installs the given statistics for the current thread for the lifetime of this object.
+ */
+class ScopedRenderStatistics
+{
+private:
+  RenderStatistics* m_previous;
+
+public:
+  explicit ScopedRenderStatistics(RenderStatistics& statistics);
+  ~ScopedRenderStatistics();
+
+  ScopedRenderStatistics(const ScopedRenderStatistics&) = delete;
+  ScopedRenderStatistics& operator=(const ScopedRenderStatistics&) = delete;
+};
+
+RenderStatistics* currentRenderStatistics();
+
+void recordDrawCall(size_t elementCount);
+void recordProgramChange();
+
+} // namespace tb::render
@@ -20,6 +20,7 @@
 #include "ShaderProgram.h"
 
 #include "Ensure.h"
+#include "render/RenderStatistics.h"
 #include "render/Shader.h"
 #include "render/ShaderManager.h"
 
@@ -108,6 +109,7 @@ void ShaderProgram::activate(ShaderManager& shaderManager)
 
   glAssert(glUseProgram(m_programId));
   assert(checkActive());
+  recordProgramChange();
 
   shaderManager.setCurrentProgram(this);
 }
@@ -0,0 +1,156 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StreamingBuffer.h"
+
+#include "render/Vbo.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace tb::render
+{
+namespace
+{
+
+constexpr GLbitfield MapFlags =
+  GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+/**
+ * Keep the offsets of the writes aligned so that the memcpy into mapped memory stays
+ * fast.
+ */
+constexpr size_t WriteAlignment = 16;
+
+size_t alignUp(const size_t value)
+{
+  return (value + WriteAlignment - 1) / WriteAlignment * WriteAlignment;
+}
+
+/**
+ * The timeout when waiting for a fence, in nanoseconds.
+ */
+constexpr GLuint64 FenceTimeout = 1'000'000'000;
+
+} // namespace
+
+bool StreamingBuffer::isSupported()
+{
+  return GLEW_ARB_buffer_storage && GLEW_ARB_sync
+         && (GLEW_ARB_copy_buffer || GLEW_VERSION_3_1);
+}
+
+StreamingBuffer::StreamingBuffer(const size_t segmentSize)
+  : m_segmentSize{alignUp(segmentSize)}
+{
+  assert(isSupported());
+
+  const auto capacity = static_cast<GLsizeiptr>(m_segmentSize * SegmentCount);
+
+  glAssert(glGenBuffers(1, &m_bufferId));
+  glAssert(glBindBuffer(GL_COPY_READ_BUFFER, m_bufferId));
+  glAssert(glBufferStorage(GL_COPY_READ_BUFFER, capacity, nullptr, MapFlags));
+  m_mappedMemory = static_cast<std::byte*>(
+    glMapBufferRange(GL_COPY_READ_BUFFER, 0, capacity, MapFlags));
+  glAssert(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+
+  assert(m_mappedMemory != nullptr);
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+  for (auto& fence : m_fences)
+  {
+    if (fence != nullptr)
+    {
+      glAssert(glDeleteSync(fence));
+      fence = nullptr;
+    }
+  }
+
+  if (m_bufferId != 0)
+  {
+    glAssert(glBindBuffer(GL_COPY_READ_BUFFER, m_bufferId));
+    glAssert(glUnmapBuffer(GL_COPY_READ_BUFFER));
+    glAssert(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+    glAssert(glDeleteBuffers(1, &m_bufferId));
+    m_bufferId = 0;
+  }
+}
+
+size_t StreamingBuffer::segmentSize() const
+{
+  return m_segmentSize;
+}
+
+bool StreamingBuffer::write(
+  Vbo& vbo, const size_t address, const void* data, const size_t size)
+{
+  if (m_mappedMemory == nullptr || m_currentOffset + size > m_segmentSize)
+  {
+    return false;
+  }
+
+  const auto sourceAddress = m_currentSegment * m_segmentSize + m_currentOffset;
+  std::memcpy(m_mappedMemory + sourceAddress, data, size);
+  vbo.copyBufferSubData(m_bufferId, sourceAddress, address, size);
+
+  m_currentOffset = alignUp(m_currentOffset + size);
+  return true;
+}
+
+bool StreamingBuffer::endFrame()
+{
+  if (m_currentOffset == 0)
+  {
+    // nothing was written during this frame, so we can keep using the current segment
+    return false;
+  }
+
+  auto& currentFence = m_fences[m_currentSegment];
+  assert(currentFence == nullptr);
+  currentFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  m_currentSegment = (m_currentSegment + 1) % SegmentCount;
+  m_currentOffset = 0;
+
+  auto& nextFence = m_fences[m_currentSegment];
+  if (nextFence == nullptr)
+  {
+    return false;
+  }
+
+  // check whether the GPU is done with the next segment without blocking first
+  auto stalled = false;
+  auto waitResult = glClientWaitSync(nextFence, 0, 0);
+  if (waitResult == GL_TIMEOUT_EXPIRED)
+  {
+    stalled = true;
+    waitResult = glClientWaitSync(nextFence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout);
+  }
+  assert(waitResult != GL_WAIT_FAILED);
+  unused(waitResult);
+
+  glAssert(glDeleteSync(nextFence));
+  nextFence = nullptr;
+
+  return stalled;
+}
+
+} // namespace tb::render
@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "render/GL.h"
+
+#include <array>
+#include <cstddef>
+
+namespace tb::render
+{
+class Vbo;
+
+/**
+ * A persistently mapped staging buffer that is used to stream small updates into VBOs.
+ *
+ * The buffer is divided into SegmentCount segments, one for each frame in flight. Data
+ * written during a frame is copied into the current segment and then copied into the
+ * target VBO on the GPU. At the end of a frame, the current segment is fenced and the
+ * next segment becomes current. Before a segment is reused, its fence is waited on, so
+ * that the GPU has finished reading from it.
+ *
+ * Requires ARB_buffer_storage, ARB_sync and ARB_copy_buffer, see isSupported().
+ */
+class StreamingBuffer
+{
+public:
+  static constexpr size_t SegmentCount = 3;
+
+private:
+  size_t m_segmentSize;
+  GLuint m_bufferId = 0;
+  std::byte* m_mappedMemory = nullptr;
+  std::array<GLsync, SegmentCount> m_fences = {};
+  size_t m_currentSegment = 0;
+  size_t m_currentOffset = 0;
+
+public:
+  /**
+   * Returns whether the current OpenGL context supports persistently mapped buffers.
+   */
+  static bool isSupported();
+
+  /**
+   * Creates and maps the staging buffer. Must only be called if isSupported() returns
+   * true.
+   */
+  explicit StreamingBuffer(size_t segmentSize);
+  ~StreamingBuffer();
+
+  size_t segmentSize() const;
+
+  /**
+   * Copies the given data into the current segment and schedules a copy into the given
+   * VBO at the given byte offset.
+   *
+   * Returns false if the remaining space in the current segment is too small. In that
+   * case, nothing is written and the caller must upload the data by other means.
+   */
+  bool write(Vbo& vbo, size_t address, const void* data, size_t size);
+
+  /**
+   * Fences the current segment and advances to the next one, waiting for the GPU to
+   * finish reading from it if necessary.
+   *
+   * Returns true if the wait blocked, i.e. if the CPU stalled on the GPU.
+   */
+  bool endFrame();
+
+  deleteCopyAndMove(StreamingBuffer);
+};
+
+} // namespace tb::render
@@ -69,4 +69,25 @@ void Vbo::unbind() const
   glAssert(glBindBuffer(m_type, 0));
 }
 
+void Vbo::copyBufferSubData(
+  const GLuint sourceBufferId,
+  const size_t sourceAddress,
+  const size_t address,
+  const size_t size)
+{
+  assert(m_bufferId != 0);
+  assert(address + size <= m_capacity);
+
+  glAssert(glBindBuffer(GL_COPY_READ_BUFFER, sourceBufferId));
+  glAssert(glBindBuffer(GL_COPY_WRITE_BUFFER, m_bufferId));
+  glAssert(glCopyBufferSubData(
+    GL_COPY_READ_BUFFER,
+    GL_COPY_WRITE_BUFFER,
+    static_cast<GLintptr>(sourceAddress),
+    static_cast<GLintptr>(address),
+    static_cast<GLsizeiptr>(size)));
+  glAssert(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+  glAssert(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+}
+
 } // namespace tb::render
@@ -106,6 +106,17 @@ public:
 
     return size;
   }
+
+  /**
+   * Copies bytes from the given buffer object into this VBO on the GPU.
+   *
+   * @param sourceBufferId  the buffer to copy from
+   * @param sourceAddress   byte offset from the start of the source buffer
+   * @param address         byte offset from the start of this block to write at
+   * @param size            number of bytes to copy
+   */
+  void copyBufferSubData(
+    GLuint sourceBufferId, size_t sourceAddress, size_t address, size_t size);
 };
 
 } // namespace tb::render
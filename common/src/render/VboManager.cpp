@@ -21,6 +21,7 @@
 
 #include "GL.h"
 #include "Macros.h"
+#include "StreamingBuffer.h"
 #include "Vbo.h"
 
 #include <algorithm>
@@ -56,6 +57,12 @@ static GLenum usageToOpenGL(const VboUsage usage)
   }
 }
 
+/**
+ * The size of each segment of the streaming buffer. Uploads that are larger than this are
+ * written directly into the VBO.
+ */
+static constexpr size_t StreamingBufferSegmentSize = 4 * 1024 * 1024;
+
 // VboManager
 
 VboManager::VboManager(ShaderManager& shaderManager)
@@ -63,6 +70,8 @@ VboManager::VboManager(ShaderManager& shaderManager)
 {
 }
 
+VboManager::~VboManager() = default;
+
 Vbo* VboManager::allocateVbo(VboType type, const size_t capacity, const VboUsage usage)
 {
   auto result = std::make_unique<Vbo>(typeToOpenGL(type), capacity, usageToOpenGL(usage));
@@ -83,6 +92,24 @@ void VboManager::destroyVbo(Vbo* vbo)
   delete vbo;
 }
 
+void VboManager::endFrame()
+{
+  if (m_streamingBuffer && m_streamingBuffer->endFrame())
+  {
+    ++m_uploadStats.stallCount;
+  }
+}
+
+const VboUploadStats& VboManager::uploadStats() const
+{
+  return m_uploadStats;
+}
+
+void VboManager::resetUploadStats()
+{
+  m_uploadStats = VboUploadStats{};
+}
+
 size_t VboManager::peakVboCount() const
 {
   return m_peakVboCount;
@@ -103,4 +130,33 @@ ShaderManager& VboManager::shaderManager()
   return m_shaderManager;
 }
 
+void VboManager::writeBytesToVbo(
+  Vbo& vbo, const size_t address, const void* data, const size_t size)
+{
+  ++m_uploadStats.uploadCount;
+  m_uploadStats.uploadedBytes += size;
+
+  if (auto* buffer = streamingBuffer(); buffer && buffer->write(vbo, address, data, size))
+  {
+    m_uploadStats.streamedBytes += size;
+    return;
+  }
+
+  vbo.writeArray(address, static_cast<const unsigned char*>(data), size);
+}
+
+StreamingBuffer* VboManager::streamingBuffer()
+{
+  // the buffer can only be created once a context is current, so we do it lazily
+  if (!m_streamingBufferInitialized)
+  {
+    m_streamingBufferInitialized = true;
+    if (StreamingBuffer::isSupported())
+    {
+      m_streamingBuffer = std::make_unique<StreamingBuffer>(StreamingBufferSegmentSize);
+    }
+  }
+  return m_streamingBuffer.get();
+}
+
 } // namespace tb::render
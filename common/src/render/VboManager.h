@@ -20,11 +20,14 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
+#include <type_traits>
 
 namespace tb::render
 {
 class Vbo;
 class ShaderManager;
+class StreamingBuffer;
 
 enum class VboType
 {
@@ -38,6 +41,24 @@ enum class VboUsage
   DynamicDraw
 };
 
+/**
+ * Counts the uploads into VBOs performed by VboManager::writeToVbo.
+ */
+struct VboUploadStats
+{
+  size_t uploadCount = 0;
+  size_t uploadedBytes = 0;
+  /**
+   * The number of bytes that were uploaded through the streaming buffer.
+   */
+  size_t streamedBytes = 0;
+  /**
+   * The number of frames in which the CPU had to wait for the GPU before reusing a
+   * segment of the streaming buffer.
+   */
+  size_t stallCount = 0;
+};
+
 class VboManager
 {
 private:
@@ -46,8 +67,14 @@ private:
   size_t m_currentVboSize = 0;
   ShaderManager& m_shaderManager;
 
+  bool m_streamingBufferInitialized = false;
+  std::unique_ptr<StreamingBuffer> m_streamingBuffer;
+  VboUploadStats m_uploadStats;
+
 public:
   explicit VboManager(ShaderManager& shaderManager);
+  ~VboManager();
+
   /**
    * Immediately creates and binds to an OpenGL buffer of the given type and capacity.
    * The contents are initially unspecified. See Vbo class.
@@ -55,11 +82,37 @@ public:
   Vbo* allocateVbo(VboType type, size_t capacity, VboUsage usage = VboUsage::StaticDraw);
   void destroyVbo(Vbo* vbo);
 
+  /**
+   * Writes the given elements into the given VBO at the given byte offset.
+   *
+   * If persistently mapped buffers are supported, small writes are streamed through a
+   * triple buffered staging buffer and copied into the VBO on the GPU. Otherwise, or if
+   * the data doesn't fit into the staging buffer, the data is written directly.
+   */
+  template <typename T>
+  void writeToVbo(Vbo& vbo, const size_t address, const T* elements, const size_t count)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    writeBytesToVbo(vbo, address, elements, count * sizeof(T));
+  }
+
+  /**
+   * Must be called once after every frame to fence the uploads streamed during the frame.
+   */
+  void endFrame();
+
+  const VboUploadStats& uploadStats() const;
+  void resetUploadStats();
+
   size_t peakVboCount() const;
   size_t currentVboCount() const;
   size_t currentVboSize() const;
 
   ShaderManager& shaderManager();
+
+private:
+  void writeBytesToVbo(Vbo& vbo, size_t address, const void* data, size_t size);
+  StreamingBuffer* streamingBuffer();
 };
 
 } // namespace tb::render
@@ -20,11 +20,26 @@
 #include "VertexArray.h"
 
 #include "render/PrimType.h"
+#include "render/RenderStatistics.h"
 
 #include <cassert>
+#include <numeric>
 
 namespace tb::render
 {
+namespace
+{
+
+size_t countElements(const GLCounts& counts, const GLint primCount)
+{
+  return std::accumulate(
+    counts.begin(),
+    std::next(counts.begin(), primCount),
+    size_t(0),
+    [](const auto sum, const auto count) { return sum + static_cast<size_t>(count); });
+}
+
+} // namespace
 
 VertexArray::BaseHolder::~BaseHolder() = default;
 
@@ -95,12 +110,14 @@ void VertexArray::render(const PrimType primType, const GLint index, const GLsiz
     if (setup())
     {
       glAssert(glDrawArrays(toGL(primType), index, count));
+      recordDrawCall(static_cast<size_t>(count));
       cleanup();
     }
   }
   else
   {
     glAssert(glDrawArrays(toGL(primType), index, count));
+    recordDrawCall(static_cast<size_t>(count));
   }
 }
 
@@ -118,6 +135,7 @@ void VertexArray::render(
       const auto* indexArray = indices.data();
       const auto* countArray = counts.data();
       glAssert(glMultiDrawArrays(toGL(primType), indexArray, countArray, primCount));
+      recordDrawCall(countElements(counts, primCount));
       cleanup();
     }
   }
@@ -126,6 +144,7 @@ void VertexArray::render(
     const auto* indexArray = indices.data();
     const auto* countArray = counts.data();
     glAssert(glMultiDrawArrays(toGL(primType), indexArray, countArray, primCount));
+    recordDrawCall(countElements(counts, primCount));
   }
 }
 
@@ -139,6 +158,7 @@ void VertexArray::render(
     {
       const auto* indexArray = indices.data();
       glAssert(glDrawElements(toGL(primType), count, GL_UNSIGNED_INT, indexArray));
+      recordDrawCall(static_cast<size_t>(count));
       cleanup();
     }
   }
@@ -146,6 +166,7 @@ void VertexArray::render(
   {
     const auto* indexArray = indices.data();
     glAssert(glDrawElements(toGL(primType), count, GL_UNSIGNED_INT, indexArray));
+    recordDrawCall(static_cast<size_t>(count));
   }
 }
 
@@ -2035,6 +2035,24 @@ void ActionManager::createViewMenu()
     },
   }));
   viewMenu.addSeparator();
+  viewMenu.addItem(addAction(Action{
+    "Menu/View/Show Render Statistics",
+    QObject::tr("Show Render Statistics"),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto& context) { context.frame()->toggleRenderStatistics(); },
+    [](const auto& context) { return context.hasDocument(); },
+    [](const auto&) { return pref(Preferences::ShowRenderStatistics); },
+  }));
+  viewMenu.addItem(addAction(Action{
+    "Menu/View/Dump Render Statistics...",
+    QObject::tr("Dump Render Statistics..."),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto& context) { context.frame()->dumpRenderStatistics(); },
+    [](const auto& context) { return context.hasDocument(); },
+  }));
+  viewMenu.addSeparator();
   viewMenu.addItem(addAction(Action{
     "Menu/File/Preferences...",
     QObject::tr("Preferences..."),
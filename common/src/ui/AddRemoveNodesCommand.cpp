@@ -22,6 +22,7 @@
 #include "Ensure.h"
 #include "Macros.h"
 #include "mdl/Node.h"
+#include "mdl/NodeContentsDelta.h"
 #include "ui/MapDocumentCommandFacade.h"
 
 #include "kdl/map_utils.h"
@@ -73,6 +74,25 @@ AddRemoveNodesCommand::AddRemoveNodesCommand(
   }
 }
 
+size_t AddRemoveNodesCommand::memorySize() const
+{
+  // the nodes to add are owned by this command, whereas the nodes to remove are owned by
+  // the document
+  auto result = UpdateLinkedGroupsCommandBase::memorySize();
+  for (const auto& [parent, children] : m_nodesToAdd)
+  {
+    for (const auto* child : children)
+    {
+      result += sizeof(mdl::Node*) + mdl::memorySize(*child);
+    }
+  }
+  for (const auto& [parent, children] : m_nodesToRemove)
+  {
+    result += children.size() * sizeof(mdl::Node*);
+  }
+  return result;
+}
+
 std::string AddRemoveNodesCommand::makeName(const Action action)
 {
   switch (action)
@@ -33,10 +33,12 @@
 #include "kdl/string_compare.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
 #include <algorithm>
 #include <cassert>
+#include <functional>
 
 namespace tb::ui
 {
@@ -111,6 +113,23 @@ Result<void> cleanBackups(
          | kdl::fold;
 }
 
+Result<std::chrono::milliseconds> writeBackup(
+  const std::filesystem::path& backupFilePath, const std::string& contents)
+{
+  const auto startTime = std::chrono::steady_clock::now();
+
+  // write to a temporary file first so that a backup file is never left half written
+  const auto tmpFilePath = kdl::path_add_extension(backupFilePath, ".tmp");
+  return io::Disk::withOutputStream(
+           tmpFilePath, [&](auto& stream) { stream << contents; })
+         | kdl::and_then(
+           [&]() { return io::Disk::moveFile(tmpFilePath, backupFilePath); })
+         | kdl::transform([&]() {
+             return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - startTime);
+           });
+}
+
 } // namespace
 
 io::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename_)
@@ -141,9 +160,17 @@ Autosaver::Autosaver(
 {
 }
 
+Autosaver::~Autosaver()
+{
+  if (m_pendingAutosave)
+  {
+    m_pendingAutosave->writeTime.wait();
+  }
+}
+
 void Autosaver::triggerAutosave(Logger& logger)
 {
-  if (!kdl::mem_expired(m_document))
+  if (collectPendingAutosave(logger, false) && !kdl::mem_expired(m_document))
   {
     auto document = kdl::mem_lock(m_document);
     if (
@@ -155,6 +182,11 @@ void Autosaver::triggerAutosave(Logger& logger)
   }
 }
 
+void Autosaver::finishPendingAutosave(Logger& logger)
+{
+  collectPendingAutosave(logger, true);
+}
+
 void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
 {
   const auto& mapPath = document->path();
@@ -178,12 +210,60 @@ void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
   }) | kdl::transform([&](const auto& backupFilePath) {
     m_lastSaveTime = Clock::now();
     m_lastModificationCount = document->modificationCount();
-    document->saveDocumentTo(backupFilePath);
 
-    logger.info() << "Created autosave backup at " << backupFilePath;
+    // The document is serialized on the UI thread because the serializer reads the live
+    // nodes and records the file positions of nodes and faces, so it must not run
+    // concurrently with edits. Copying the world to serialize the copy on a worker would
+    // cost about as much as serializing it: the brushes are formatted on the task manager,
+    // and the node serialization cache limits this to nodes which have changed since the
+    // last save. The resulting string is immutable, so the document can be edited while
+    // it is written.
+    const auto snapshotStartTime = std::chrono::steady_clock::now();
+    auto snapshot = std::make_shared<const std::string>(document->serializeDocument());
+    const auto snapshotTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - snapshotStartTime);
+
+    m_pendingAutosave = PendingAutosave{
+      backupFilePath,
+      snapshotTime,
+      document->taskManager().run_task(std::function{
+        [backupFilePath, snapshot = std::move(snapshot)]() {
+          return writeBackup(backupFilePath, *snapshot);
+        }}),
+    };
   }) | kdl::transform_error([&](auto e) {
     logger.error() << "Aborting autosave: " << e.msg;
   });
 }
 
+bool Autosaver::collectPendingAutosave(Logger& logger, const bool wait)
+{
+  if (!m_pendingAutosave)
+  {
+    return true;
+  }
+
+  if (
+    !wait
+    && m_pendingAutosave->writeTime.wait_for(std::chrono::seconds{0})
+         != std::future_status::ready)
+  {
+    return false;
+  }
+
+  auto pendingAutosave = std::move(*m_pendingAutosave);
+  m_pendingAutosave = std::nullopt;
+
+  pendingAutosave.writeTime.get() | kdl::transform([&](const auto writeTime) {
+    logger.info() << "Created autosave backup at " << pendingAutosave.backupFilePath
+                  << " (" << pendingAutosave.snapshotTime.count()
+                  << "ms on the UI thread, " << writeTime.count()
+                  << "ms in the background)";
+  }) | kdl::transform_error([&](auto e) {
+    logger.error() << "Autosave failed: " << e.msg;
+  });
+
+  return true;
+}
+
 } // namespace tb::ui
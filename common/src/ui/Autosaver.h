@@ -19,11 +19,14 @@
 
 #pragma once
 
+#include "Result.h"
 #include "io/PathMatcher.h"
 
 #include <chrono>
 #include <filesystem>
+#include <future>
 #include <memory>
+#include <optional>
 
 namespace tb
 {
@@ -42,6 +45,17 @@ class Autosaver
 private:
   using Clock = std::chrono::system_clock;
 
+  /**
+   * An autosave whose snapshot has been taken on the UI thread and which is being written
+   * to disk on a worker thread.
+   */
+  struct PendingAutosave
+  {
+    std::filesystem::path backupFilePath;
+    std::chrono::milliseconds snapshotTime;
+    std::future<Result<std::chrono::milliseconds>> writeTime;
+  };
+
   std::weak_ptr<MapDocument> m_document;
 
   /**
@@ -65,16 +79,31 @@ private:
    */
   size_t m_lastModificationCount;
 
+  std::optional<PendingAutosave> m_pendingAutosave;
+
 public:
   explicit Autosaver(
     std::weak_ptr<MapDocument> document,
     std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000),
     size_t maxBackups = 50);
 
+  ~Autosaver();
+
+  /**
+   * Takes a snapshot of the document and writes it to a new backup file on a worker
+   * thread if the document was modified and the save interval has elapsed. Does nothing
+   * while a previous autosave is still being written.
+   */
   void triggerAutosave(Logger& logger);
 
+  /**
+   * Blocks until the pending autosave, if any, has been written and logs the result.
+   */
+  void finishPendingAutosave(Logger& logger);
+
 private:
   void autosave(Logger& logger, std::shared_ptr<ui::MapDocument> document);
+  bool collectPendingAutosave(Logger& logger, bool wait);
 };
 
 } // namespace tb::ui
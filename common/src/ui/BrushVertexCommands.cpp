@@ -47,14 +47,13 @@ std::unique_ptr<CommandResult> BrushVertexCommandBase::createCommandResult(
   return swapResult;
 }
 
-static auto collectBrushNodes(
-  const std::vector<std::pair<mdl::Node*, mdl::NodeContents>> nodes)
+static auto collectBrushNodes(const std::vector<mdl::Node*>& nodes)
 {
-  return nodes | std::views::filter([](const auto& pair) {
-           return dynamic_cast<mdl::BrushNode*>(pair.first) != nullptr;
+  return nodes | std::views::filter([](const auto* node) {
+           return dynamic_cast<const mdl::BrushNode*>(node) != nullptr;
          })
          | std::views::transform(
-           [](const auto& pair) { return static_cast<mdl::BrushNode*>(pair.first); })
+           [](auto* node) { return static_cast<mdl::BrushNode*>(node); })
          | kdl::to_vector;
 }
 
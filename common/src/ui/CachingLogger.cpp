@@ -24,36 +24,46 @@ namespace tb::ui
 
 void CachingLogger::setParentLogger(Logger* parentLogger)
 {
-  const auto lock = std::lock_guard{m_cacheMutex};
-
+  m_cacheFlushed = false;
   m_parentLogger = parentLogger;
-  if (m_parentLogger)
+  if (parentLogger)
   {
-    m_cache.getCachedMessages([this](const auto level, const auto& message) {
-      m_parentLogger->log(level, message);
-    });
+    logCachedMessages(*parentLogger);
+    m_cacheFlushed = true;
   }
 }
 
 void CachingLogger::doLog(const LogLevel level, const std::string_view message)
 {
-  if (!cacheMessage(level, message))
+  if (auto* parentLogger = m_parentLogger.load())
   {
-    m_parentLogger->log(level, message);
+    if (!m_cacheFlushed)
+    {
+      // Wait until the messages cached before the parent logger was set are forwarded
+      // so that they aren't overtaken by this message.
+      logCachedMessages(*parentLogger);
+    }
+    parentLogger->log(level, message);
+    return;
   }
-}
 
-bool CachingLogger::cacheMessage(const LogLevel level, const std::string_view message)
-{
-  auto lock = std::lock_guard{m_cacheMutex};
+  m_cache.push(level, message);
 
-  if (!m_parentLogger)
+  // If the parent logger was set after we checked it above, it may have missed the
+  // message we just cached.
+  if (auto* parentLogger = m_parentLogger.load())
   {
-    m_cache.cacheMessage(level, message);
-    return true;
+    logCachedMessages(*parentLogger);
   }
+}
 
-  return false;
+void CachingLogger::logCachedMessages(Logger& parentLogger)
+{
+  // Concurrent flushes would interleave the cached messages.
+  const auto lock = std::lock_guard{m_flushMutex};
+  m_cache.popAll([&](const auto level, const auto& message) {
+    parentLogger.log(level, message);
+  });
 }
 
 } // namespace tb::ui
@@ -19,29 +19,38 @@
 
 #pragma once
 
+#include "LogQueue.h"
 #include "Logger.h"
-#include "LoggerCache.h"
 
+#include <atomic>
 #include <mutex>
 #include <string_view>
 
 namespace tb::ui
 {
 
+/**
+ * Forwards messages to a parent logger, or caches them until a parent logger is set.
+ *
+ * Logging does not block, so worker threads can log concurrently. The only exception is
+ * that the cached messages are forwarded to the parent logger one flush at a time, and a
+ * message is only forwarded directly once the messages cached before the parent logger
+ * was set have been forwarded. This keeps the messages of each thread in order.
+ */
 class CachingLogger : public Logger
 {
 private:
-  LoggerCache m_cache;
-  std::mutex m_cacheMutex;
-
-  Logger* m_parentLogger = nullptr;
+  LogQueue m_cache;
+  std::atomic<Logger*> m_parentLogger = nullptr;
+  std::atomic<bool> m_cacheFlushed = false;
+  std::mutex m_flushMutex;
 
 public:
   void setParentLogger(Logger* logger);
 
 private:
   void doLog(LogLevel level, std::string_view message) override;
-  bool cacheMessage(LogLevel level, std::string_view message);
+  void logCachedMessages(Logger& parentLogger);
 };
 
 } // namespace tb::ui
@@ -24,6 +24,29 @@
 
 namespace tb::ui
 {
+namespace
+{
+
+float cellScale(
+  const float itemWidth,
+  const float itemHeight,
+  const float maxUpScale,
+  const float maxWidth,
+  const float maxHeight)
+{
+  return std::min(std::min(maxWidth / itemWidth, maxHeight / itemHeight), maxUpScale);
+}
+
+float cellWidth(
+  const float scaledItemWidth,
+  const float titleWidth,
+  const float minWidth,
+  const float maxWidth)
+{
+  return std::max(minWidth, std::max(scaledItemWidth, std::min(titleWidth, maxWidth)));
+}
+
+} // namespace
 
 float LayoutBounds::left() const
 {
@@ -150,18 +173,17 @@ void LayoutCell::doLayout(
   assert(minWidth <= maxWidth);
   assert(minHeight <= maxHeight);
 
-  m_scale =
-    std::min(std::min(maxWidth / m_itemWidth, maxHeight / m_itemHeight), maxUpScale);
+  m_scale = cellScale(m_itemWidth, m_itemHeight, maxUpScale, maxWidth, maxHeight);
   const auto scaledItemWidth = m_scale * m_itemWidth;
   const auto scaledItemHeight = m_scale * m_itemHeight;
   const auto clippedTitleWidth = std::min(m_titleWidth, maxWidth);
-  const auto cellWidth = std::max(minWidth, std::max(scaledItemWidth, clippedTitleWidth));
+  const auto width = cellWidth(scaledItemWidth, m_titleWidth, minWidth, maxWidth);
   const auto cellHeight = std::max(
     minHeight, std::max(minHeight, scaledItemHeight) + m_titleHeight + m_titleMargin);
   const auto itemY =
     m_y + std::max(0.0f, cellHeight - m_titleHeight - scaledItemHeight - m_titleMargin);
 
-  m_cellBounds = LayoutBounds{m_x, m_y, cellWidth, cellHeight};
+  m_cellBounds = LayoutBounds{m_x, m_y, width, cellHeight};
   m_itemBounds = LayoutBounds{
     m_x + (m_cellBounds.width - scaledItemWidth) / 2.0f,
     itemY,
@@ -353,7 +375,8 @@ LayoutGroup::LayoutGroup(
   const float minCellWidth,
   const float maxCellWidth,
   const float minCellHeight,
-  const float maxCellHeight)
+  const float maxCellHeight,
+  const bool virtualized)
   : m_title{std::move(title)}
   , m_cellMargin{cellMargin}
   , m_titleMargin{titleMargin}
@@ -366,6 +389,7 @@ LayoutGroup::LayoutGroup(
   , m_maxCellHeight{maxCellHeight}
   , m_titleBounds{0.0f, y, width + 2.0f * x, titleHeight}
   , m_contentBounds{x, y + titleHeight + m_rowMargin, width, 0.0f}
+  , m_virtualized{virtualized}
 {
 }
 
@@ -381,7 +405,8 @@ LayoutGroup::LayoutGroup(
   const float minCellWidth,
   const float maxCellWidth,
   const float minCellHeight,
-  const float maxCellHeight)
+  const float maxCellHeight,
+  const bool virtualized)
   : m_cellMargin{cellMargin}
   , m_titleMargin{titleMargin}
   , m_rowMargin{rowMargin}
@@ -393,6 +418,7 @@ LayoutGroup::LayoutGroup(
   , m_maxCellHeight{maxCellHeight}
   , m_titleBounds{x, y, width, 0.0f}
   , m_contentBounds{x, y, width, 0.0f}
+  , m_virtualized{virtualized}
 {
 }
 
@@ -401,6 +427,11 @@ const std::string& LayoutGroup::title() const
   return m_title;
 }
 
+bool LayoutGroup::virtualized() const
+{
+  return m_virtualized;
+}
+
 const LayoutBounds& LayoutGroup::titleBounds() const
 {
   return m_titleBounds;
@@ -444,8 +475,30 @@ const std::vector<LayoutRow>& LayoutGroup::rows() const
   return m_rows;
 }
 
+size_t LayoutGroup::rowCount() const
+{
+  return m_virtualized ? m_virtualRows.size() : m_rows.size();
+}
+
+LayoutBounds LayoutGroup::rowBounds(const size_t index) const
+{
+  if (m_virtualized)
+  {
+    const auto& row = m_virtualRows[index];
+    return LayoutBounds{m_contentBounds.left(), row.y, row.width, row.height};
+  }
+  return m_rows[index].bounds();
+}
+
 size_t LayoutGroup::indexOfRowAt(const float y) const
 {
+  if (m_virtualized)
+  {
+    const auto it = std::ranges::partition_point(
+      m_virtualRows, [&](const auto& row) { return row.y + row.height <= y; });
+    return size_t(std::distance(m_virtualRows.begin(), it));
+  }
+
   for (size_t i = 0; i < m_rows.size(); ++i)
   {
     const auto& row = m_rows[i];
@@ -482,6 +535,44 @@ const LayoutCell* LayoutGroup::cellAt(const float x, const float y) const
   return nullptr;
 }
 
+const LayoutCell* LayoutGroup::findCell(
+  const std::function<bool(const std::any&)>& predicate)
+{
+  if (!m_virtualized)
+  {
+    for (const auto& row : m_rows)
+    {
+      for (const auto& cell : row.cells())
+      {
+        if (predicate(cell.item()))
+        {
+          return &cell;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  const auto itemIt =
+    std::ranges::find_if(m_items, [&](const auto& item) { return predicate(item.item); });
+  if (itemIt == m_items.end())
+  {
+    return nullptr;
+  }
+
+  const auto itemIndex = size_t(std::distance(m_items.begin(), itemIt));
+  const auto rowIt = std::ranges::partition_point(m_virtualRows, [&](const auto& row) {
+    return row.firstItem + row.itemCount <= itemIndex;
+  });
+  const auto rowIndex = size_t(std::distance(m_virtualRows.begin(), rowIt));
+  if (rowIndex < m_firstRow || rowIndex >= m_firstRow + m_rows.size())
+  {
+    materializeRowRange(rowIndex, rowIndex + 1);
+  }
+
+  return &m_rows[rowIndex - m_firstRow].cells()[itemIndex - rowIt->firstItem];
+}
+
 bool LayoutGroup::hitTest(const float x, const float y) const
 {
   return bounds().containsPoint(x, y);
@@ -492,6 +583,73 @@ bool LayoutGroup::intersectsY(const float y, const float height) const
   return bounds().intersectsY(y, height);
 }
 
+void LayoutGroup::materializeRows(const float y, const float height)
+{
+  if (!m_virtualized)
+  {
+    return;
+  }
+
+  const auto first = std::ranges::partition_point(
+    m_virtualRows, [&](const auto& row) { return row.y + row.height < y; });
+  const auto last = std::ranges::partition_point(
+    m_virtualRows, [&](const auto& row) { return row.y <= y + height; });
+  if (first >= last)
+  {
+    return;
+  }
+
+  const auto firstIndex = size_t(std::distance(m_virtualRows.begin(), first));
+  const auto lastIndex = size_t(std::distance(m_virtualRows.begin(), last));
+  if (firstIndex < m_firstRow || lastIndex > m_firstRow + m_rows.size())
+  {
+    materializeRowRange(firstIndex, lastIndex);
+  }
+}
+
+void LayoutGroup::releaseRows()
+{
+  if (m_virtualized)
+  {
+    m_rows.clear();
+    m_firstRow = 0;
+  }
+}
+
+std::vector<LayoutItem> LayoutGroup::takeItems()
+{
+  auto items = std::vector<LayoutItem>{};
+  if (m_virtualized)
+  {
+    items = std::move(m_items);
+    m_items.clear();
+    m_virtualRows.clear();
+  }
+  else
+  {
+    for (const auto& row : m_rows)
+    {
+      for (const auto& cell : row.cells())
+      {
+        const auto& itemBounds = cell.itemBounds();
+        const auto& titleBounds = cell.titleBounds();
+        const auto scale = cell.scale();
+        items.push_back(LayoutItem{
+          cell.item(),
+          cell.title(),
+          itemBounds.width / scale,
+          itemBounds.height / scale,
+          titleBounds.width,
+          titleBounds.height});
+      }
+    }
+  }
+
+  m_rows.clear();
+  m_firstRow = 0;
+  return items;
+}
+
 void LayoutGroup::addItem(
   std::any item,
   std::string title,
@@ -500,39 +658,22 @@ void LayoutGroup::addItem(
   const float titleWidth,
   const float titleHeight)
 {
+  if (m_virtualized)
+  {
+    addVirtualItem(LayoutItem{
+      std::move(item), std::move(title), itemWidth, itemHeight, titleWidth, titleHeight});
+    return;
+  }
+
   if (m_rows.empty())
   {
-    const auto y = m_contentBounds.top();
-    m_rows.emplace_back(
-      m_contentBounds.left(),
-      y,
-      m_cellMargin,
-      m_titleMargin,
-      m_contentBounds.width,
-      m_maxCellsPerRow,
-      m_maxUpScale,
-      m_minCellWidth,
-      m_maxCellWidth,
-      m_minCellHeight,
-      m_maxCellHeight);
+    m_rows.push_back(makeRow(m_contentBounds.top()));
   }
 
   if (!m_rows.back().canAddItem(itemWidth, itemHeight, titleWidth, titleHeight))
   {
     const auto oldBounds = m_rows.back().bounds();
-    const auto y = oldBounds.bottom() + m_rowMargin;
-    m_rows.emplace_back(
-      m_contentBounds.left(),
-      y,
-      m_cellMargin,
-      m_titleMargin,
-      m_contentBounds.width,
-      m_maxCellsPerRow,
-      m_maxUpScale,
-      m_minCellWidth,
-      m_maxCellWidth,
-      m_minCellHeight,
-      m_maxCellHeight);
+    m_rows.push_back(makeRow(oldBounds.bottom() + m_rowMargin));
 
     const auto newRowHeight = m_rows.back().bounds().height;
     m_contentBounds = LayoutBounds{
@@ -556,6 +697,110 @@ void LayoutGroup::addItem(
     m_contentBounds.height + (newRowHeight - oldRowHeight)};
 }
 
+LayoutRow LayoutGroup::makeRow(const float y) const
+{
+  return LayoutRow{
+    m_contentBounds.left(),
+    y,
+    m_cellMargin,
+    m_titleMargin,
+    m_contentBounds.width,
+    m_maxCellsPerRow,
+    m_maxUpScale,
+    m_minCellWidth,
+    m_maxCellWidth,
+    m_minCellHeight,
+    m_maxCellHeight};
+}
+
+void LayoutGroup::materializeRowRange(const size_t first, const size_t last)
+{
+  auto rows = std::vector<LayoutRow>{};
+  rows.reserve(last - first);
+
+  for (size_t i = first; i < last; ++i)
+  {
+    if (i >= m_firstRow && i < m_firstRow + m_rows.size())
+    {
+      // reuse rows that are already materialized
+      rows.push_back(std::move(m_rows[i - m_firstRow]));
+    }
+    else
+    {
+      const auto& virtualRow = m_virtualRows[i];
+      auto row = makeRow(virtualRow.y);
+      for (size_t j = 0; j < virtualRow.itemCount; ++j)
+      {
+        const auto& item = m_items[virtualRow.firstItem + j];
+        row.addItem(
+          item.item,
+          item.title,
+          item.itemWidth,
+          item.itemHeight,
+          item.titleWidth,
+          item.titleHeight);
+      }
+      rows.push_back(std::move(row));
+    }
+  }
+
+  m_rows = std::move(rows);
+  m_firstRow = first;
+}
+
+void LayoutGroup::addVirtualItem(LayoutItem item)
+{
+  // Mirrors LayoutRow::canAddItem and LayoutRow::addItem, but only tracks the extents of
+  // the rows so that no cells need to be created.
+  const auto scale = cellScale(
+    item.itemWidth, item.itemHeight, m_maxUpScale, m_maxCellWidth, m_maxCellHeight);
+  const auto scaledItemHeight = scale * item.itemHeight;
+  const auto width =
+    cellWidth(scale * item.itemWidth, item.titleWidth, m_minCellWidth, m_maxCellWidth);
+
+  const auto canAddToLastRow = [&]() {
+    const auto& row = m_virtualRows.back();
+    if (m_maxCellsPerRow == 0)
+    {
+      return row.width + m_cellMargin + width <= m_contentBounds.width;
+    }
+    return row.itemCount < m_maxCellsPerRow - 1;
+  };
+
+  if (m_virtualRows.empty())
+  {
+    m_virtualRows.push_back(
+      VirtualRow{m_items.size(), 0, m_contentBounds.top(), 0.0f, 0.0f, m_minCellHeight});
+  }
+  else if (!canAddToLastRow())
+  {
+    const auto& lastRow = m_virtualRows.back();
+    m_virtualRows.push_back(VirtualRow{
+      m_items.size(),
+      0,
+      lastRow.y + lastRow.height + m_rowMargin,
+      0.0f,
+      0.0f,
+      m_minCellHeight});
+    m_contentBounds.height += m_rowMargin;
+  }
+
+  auto& row = m_virtualRows.back();
+  const auto oldRowHeight = row.height;
+
+  row.width = row.itemCount == 0 ? width : row.width + m_cellMargin + width;
+  row.minCellHeight = std::max(row.minCellHeight, scaledItemHeight);
+  row.height =
+    std::max(row.height, row.minCellHeight + item.titleHeight + m_titleMargin);
+  ++row.itemCount;
+
+  m_contentBounds.height += row.height - oldRowHeight;
+  m_items.push_back(std::move(item));
+
+  // the rows may have changed, they are materialized again when needed
+  releaseRows();
+}
+
 CellLayout::CellLayout(const size_t maxCellsPerRow)
   : m_maxCellsPerRow{maxCellsPerRow}
 {
@@ -692,6 +937,20 @@ void CellLayout::setMaxUpScale(const float maxUpScale)
   }
 }
 
+bool CellLayout::virtualized() const
+{
+  return m_virtualized;
+}
+
+void CellLayout::setVirtualized(const bool virtualized)
+{
+  if (m_virtualized != virtualized)
+  {
+    m_virtualized = virtualized;
+    invalidate();
+  }
+}
+
 float CellLayout::width() const
 {
   return m_width;
@@ -748,15 +1007,15 @@ float CellLayout::rowPosition(const float y, const int offset)
   {
     while (newIndex < 0 && groupIndex > 0)
     {
-      newIndex += int(m_groups[--groupIndex].rows().size());
+      newIndex += int(m_groups[--groupIndex].rowCount());
     }
   }
-  else if (newIndex >= int(m_groups[groupIndex].rows().size()))
+  else if (newIndex >= int(m_groups[groupIndex].rowCount()))
   {
     while (groupIndex < m_groups.size() - 1
-           && newIndex >= int(m_groups[groupIndex].rows().size()))
+           && newIndex >= int(m_groups[groupIndex].rowCount()))
     {
-      newIndex -= int(m_groups[groupIndex++].rows().size());
+      newIndex -= int(m_groups[groupIndex++].rowCount());
     }
   }
 
@@ -765,9 +1024,9 @@ float CellLayout::rowPosition(const float y, const int offset)
     if (newIndex >= 0)
     {
       rowIndex = size_t(newIndex);
-      if (rowIndex < m_groups[groupIndex].rows().size())
+      if (rowIndex < m_groups[groupIndex].rowCount())
       {
-        return m_groups[groupIndex].rows()[rowIndex].bounds().top();
+        return m_groups[groupIndex].rowBounds(rowIndex).top();
       }
     }
   }
@@ -808,7 +1067,7 @@ const LayoutCell* CellLayout::cellAt(const float x, const float y)
 
   for (size_t i = 0; i < m_groups.size(); ++i)
   {
-    const auto& group = m_groups[i];
+    auto& group = m_groups[i];
     const auto groupBounds = group.bounds();
     if (y > groupBounds.bottom())
     {
@@ -818,6 +1077,8 @@ const LayoutCell* CellLayout::cellAt(const float x, const float y)
     {
       return nullptr;
     }
+
+    group.materializeRows(y, 0.0f);
     if (const auto* cell = group.cellAt(x, y))
     {
       return cell;
@@ -827,6 +1088,45 @@ const LayoutCell* CellLayout::cellAt(const float x, const float y)
   return nullptr;
 }
 
+const LayoutCell* CellLayout::findCell(
+  const std::function<bool(const std::any&)>& predicate)
+{
+  if (!m_valid)
+  {
+    validate();
+  }
+
+  for (auto& group : m_groups)
+  {
+    if (const auto* cell = group.findCell(predicate))
+    {
+      return cell;
+    }
+  }
+
+  return nullptr;
+}
+
+void CellLayout::materializeRows(const float y, const float height)
+{
+  if (!m_valid)
+  {
+    validate();
+  }
+
+  for (auto& group : m_groups)
+  {
+    if (group.intersectsY(y, height))
+    {
+      group.materializeRows(y, height);
+    }
+    else
+    {
+      group.releaseRows();
+    }
+  }
+}
+
 void CellLayout::addGroup(std::string title, const float titleHeight)
 {
   if (!m_valid)
@@ -855,7 +1155,8 @@ void CellLayout::addGroup(std::string title, const float titleHeight)
     m_minCellWidth,
     m_maxCellWidth,
     m_minCellHeight,
-    m_maxCellHeight);
+    m_maxCellHeight,
+    m_virtualized);
   m_height += m_groups.back().bounds().height;
 }
 
@@ -886,7 +1187,8 @@ void CellLayout::addItem(
       m_minCellWidth,
       m_maxCellWidth,
       m_minCellHeight,
-      m_maxCellHeight);
+      m_maxCellHeight,
+      m_virtualized);
     m_height += titleHeight;
     if (titleHeight > 0.0f)
     {
@@ -919,29 +1221,21 @@ void CellLayout::validate()
   m_valid = true;
   if (!m_groups.empty())
   {
-    auto copy = m_groups;
+    auto groups = std::move(m_groups);
     m_groups.clear();
 
-    for (auto& group : copy)
+    for (auto& group : groups)
     {
       addGroup(group.title(), group.titleBounds().height);
-      for (const auto& row : group.rows())
+      for (auto& item : group.takeItems())
       {
-        for (const auto& cell : row.cells())
-        {
-          const auto& itemBounds = cell.itemBounds();
-          const auto& titleBounds = cell.titleBounds();
-          const auto scale = cell.scale();
-          const auto itemWidth = itemBounds.width / scale;
-          const auto itemHeight = itemBounds.height / scale;
-          addItem(
-            cell.item(),
-            cell.title(),
-            itemWidth,
-            itemHeight,
-            titleBounds.width,
-            titleBounds.height);
-        }
+        addItem(
+          std::move(item.item),
+          std::move(item.title),
+          item.itemWidth,
+          item.itemHeight,
+          item.titleWidth,
+          item.titleHeight);
       }
     }
   }
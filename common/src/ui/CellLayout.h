@@ -20,6 +20,7 @@
 #pragma once
 
 #include <any>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -42,6 +43,20 @@ struct LayoutBounds
   bool intersectsY(float rangeY, float rangeHeight) const;
 };
 
+/**
+ * An item added to a virtualized layout. Cells are only created for the items in the
+ * rows that are currently materialized.
+ */
+struct LayoutItem
+{
+  std::any item;
+  std::string title;
+  float itemWidth;
+  float itemHeight;
+  float titleWidth;
+  float titleHeight;
+};
+
 class LayoutCell
 {
 private:
@@ -162,6 +177,20 @@ private:
 class LayoutGroup
 {
 private:
+  /**
+   * The extent of a row of a virtualized group, computed from the cell metrics without
+   * creating any cells.
+   */
+  struct VirtualRow
+  {
+    size_t firstItem;
+    size_t itemCount;
+    float y;
+    float width;
+    float height;
+    float minCellHeight;
+  };
+
   std::string m_title;
   float m_cellMargin;
   float m_titleMargin;
@@ -174,9 +203,16 @@ private:
   float m_maxCellHeight;
   LayoutBounds m_titleBounds;
   LayoutBounds m_contentBounds;
+  bool m_virtualized;
 
   std::vector<LayoutRow> m_rows;
 
+  // only used if the group is virtualized, m_rows then contains the materialized rows
+  // starting at m_firstRow
+  std::vector<LayoutItem> m_items;
+  std::vector<VirtualRow> m_virtualRows;
+  size_t m_firstRow = 0;
+
 public:
   LayoutGroup(
     std::string title,
@@ -192,7 +228,8 @@ public:
     float minCellWidth,
     float maxCellWidth,
     float minCellHeight,
-    float maxCellHeight);
+    float maxCellHeight,
+    bool virtualized);
 
   LayoutGroup(
     float x,
@@ -206,22 +243,45 @@ public:
     float minCellWidth,
     float maxCellWidth,
     float minCellHeight,
-    float maxCellHeight);
+    float maxCellHeight,
+    bool virtualized);
 
   const std::string& title() const;
+  bool virtualized() const;
 
   const LayoutBounds& titleBounds() const;
   LayoutBounds titleBoundsForVisibleRect(float y, float height, float groupMargin) const;
   const LayoutBounds& contentBounds() const;
   LayoutBounds bounds() const;
 
+  /**
+   * Returns the rows of this group. If the group is virtualized, only the rows that were
+   * materialized by the last call to materializeRows are returned.
+   */
   const std::vector<LayoutRow>& rows() const;
+  size_t rowCount() const;
+  LayoutBounds rowBounds(size_t index) const;
   size_t indexOfRowAt(float y) const;
   const LayoutCell* cellAt(float x, float y) const;
 
+  /**
+   * Returns the first cell whose item matches the given predicate. If the group is
+   * virtualized, the row containing that cell is materialized.
+   */
+  const LayoutCell* findCell(const std::function<bool(const std::any&)>& predicate);
+
   bool hitTest(float x, float y) const;
   bool intersectsY(float y, float height) const;
 
+  /**
+   * Ensures that all rows intersecting the given vertical range are materialized. Does
+   * nothing unless the group is virtualized.
+   */
+  void materializeRows(float y, float height);
+  void releaseRows();
+
+  std::vector<LayoutItem> takeItems();
+
   void addItem(
     std::any item,
     std::string title,
@@ -229,12 +289,18 @@ public:
     float itemHeight,
     float titleWidth,
     float titleHeight);
+
+private:
+  LayoutRow makeRow(float y) const;
+  void materializeRowRange(size_t first, size_t last);
+  void addVirtualItem(LayoutItem item);
 };
 
 class CellLayout
 {
 private:
   size_t m_maxCellsPerRow;
+  bool m_virtualized = false;
   float m_width = 1.0f;
   float m_cellMargin = 0.0f;
   float m_titleMargin = 0.0f;
@@ -280,6 +346,14 @@ public:
   float maxUpScale() const;
   void setMaxUpScale(float maxUpScale);
 
+  /**
+   * In a virtualized layout, the positions of the rows are computed from the cell
+   * metrics when items are added, but rows and cells are only created for the rows
+   * passed to materializeRows, and for the cells returned by cellAt and findCell.
+   */
+  bool virtualized() const;
+  void setVirtualized(bool virtualized);
+
   float width() const;
   float height();
 
@@ -293,6 +367,9 @@ public:
 
   const std::vector<LayoutGroup>& groups();
   const LayoutCell* cellAt(float x, float y);
+  const LayoutCell* findCell(const std::function<bool(const std::any&)>& predicate);
+
+  void materializeRows(float y, float height);
 
   void addGroup(std::string title, float titleHeight);
   void addItem(
@@ -367,6 +367,7 @@ void CellView::renderContents()
   const auto y = float(visibleRect.y());
   const auto h = float(visibleRect.height());
 
+  m_layout.materializeRows(y, h);
   doRender(m_layout, y, h);
 
   const auto viewLeft = float(0);
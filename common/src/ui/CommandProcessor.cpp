@@ -131,6 +131,17 @@ private:
 
     return false;
   }
+
+public:
+  size_t memorySize() const override
+  {
+    auto result = UndoableCommand::memorySize();
+    for (const auto& command : m_commands)
+    {
+      result += command->memorySize();
+    }
+    return result;
+  }
 };
 
 } // namespace
@@ -257,6 +268,38 @@ std::unique_ptr<CommandResult> CommandProcessor::executeAndStore(
   return executeAndStoreCommand(std::move(command), true).commandResult;
 }
 
+size_t CommandProcessor::memoryBudget() const
+{
+  return m_memoryBudget;
+}
+
+void CommandProcessor::setMemoryBudget(const size_t memoryBudget)
+{
+  m_memoryBudget = memoryBudget;
+  enforceMemoryBudget();
+}
+
+size_t CommandProcessor::memoryUsage() const
+{
+  auto result = size_t(0);
+  for (const auto& command : m_undoStack)
+  {
+    result += command->memorySize();
+  }
+  for (const auto& command : m_redoStack)
+  {
+    result += command->memorySize();
+  }
+  return result;
+}
+
+std::vector<CommandMemoryUsage> CommandProcessor::undoStackMemoryUsage() const
+{
+  return kdl::vec_transform(m_undoStack, [](const auto& command) {
+    return CommandMemoryUsage{command->name(), command->memorySize()};
+  });
+}
+
 std::unique_ptr<CommandResult> CommandProcessor::undo()
 {
   if (!m_transactionStack.empty())
@@ -437,11 +480,13 @@ bool CommandProcessor::pushToUndoStack(
     auto& lastCommand = m_undoStack.back();
     if (lastCommand->collateWith(*command))
     {
+      enforceMemoryBudget();
       return false;
     }
   }
 
   m_undoStack.push_back(std::move(command));
+  enforceMemoryBudget();
   return true;
 }
 
@@ -453,6 +498,27 @@ std::unique_ptr<UndoableCommand> CommandProcessor::popFromUndoStack()
   return kdl::vec_pop_back(m_undoStack);
 }
 
+void CommandProcessor::enforceMemoryBudget()
+{
+  if (m_memoryBudget == 0)
+  {
+    return;
+  }
+
+  auto usage = memoryUsage();
+  auto evictCount = size_t(0);
+
+  // always keep the most recently executed command
+  while (usage > m_memoryBudget && evictCount + 1 < m_undoStack.size())
+  {
+    usage -= m_undoStack[evictCount]->memorySize();
+    ++evictCount;
+  }
+
+  m_undoStack.erase(
+    m_undoStack.begin(), m_undoStack.begin() + std::ptrdiff_t(evictCount));
+}
+
 bool CommandProcessor::collatable(
   const bool collate, const std::chrono::system_clock::time_point timestamp) const
 {
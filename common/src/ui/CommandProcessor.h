@@ -34,6 +34,15 @@ class MapDocumentCommandFacade;
 class UndoableCommand;
 enum class TransactionScope;
 
+/**
+ * The estimated memory used by a command on the undo stack.
+ */
+struct CommandMemoryUsage
+{
+  std::string name;
+  size_t memorySize;
+};
+
 /**
  * The command processor is responsible for executing and undoing commands and for
  * maintining the command history in the form of a stack of undo commands and a stack of
@@ -77,6 +86,14 @@ private:
    */
   std::vector<std::unique_ptr<UndoableCommand>> m_redoStack;
 
+  /**
+   * The maximum number of bytes that the commands on the undo and redo stacks may use. If
+   * the budget is exceeded, the oldest commands are removed from the undo stack. Commands
+   * on the redo stack count towards the budget, but they are never removed. A value of 0
+   * disables the budget.
+   */
+  size_t m_memoryBudget = 0;
+
   /**
    * The time stamp of when the last command was executed.
    */
@@ -165,6 +182,34 @@ public:
    */
   const std::string& redoCommandName() const;
 
+  /**
+   * Returns the maximum number of bytes that the commands on the undo and redo stacks may
+   * use, or 0 if there is no limit.
+   */
+  size_t memoryBudget() const;
+
+  /**
+   * Sets the maximum number of bytes that the commands on the undo and redo stacks may
+   * use. If the budget is exceeded, the oldest commands are removed from the undo stack,
+   * but the most recently executed command is always kept. Commands on the redo stack are
+   * never removed.
+   *
+   * @param memoryBudget the budget in bytes, or 0 to disable the budget
+   */
+  void setMemoryBudget(size_t memoryBudget);
+
+  /**
+   * Returns the estimated number of bytes used by the commands on the undo and redo
+   * stacks.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns the estimated memory used by each command on the undo stack, starting with
+   * the oldest command.
+   */
+  std::vector<CommandMemoryUsage> undoStackMemoryUsage() const;
+
   /**
    * Starts a new transaction. If a transaction is currently executing, then the newly
    * started transaction becomes a nested transaction and will be added as a command to
@@ -371,6 +416,12 @@ private:
    */
   std::unique_ptr<UndoableCommand> popFromUndoStack();
 
+  /**
+   * Removes the oldest commands from the undo stack until the memory used by the undo and
+   * redo stacks no longer exceeds the memory budget.
+   */
+  void enforceMemoryBudget();
+
   bool collatable(bool collate, std::chrono::system_clock::time_point timestamp) const;
 
   /**
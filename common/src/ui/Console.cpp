@@ -19,70 +19,70 @@
 
 #include "Console.h"
 
+#include <QAction>
+#include <QApplication>
+#include <QClipboard>
 #include <QDebug>
-#include <QMutexLocker>
+#include <QItemSelectionModel>
+#include <QListView>
 #include <QScrollBar>
-#include <QTextEdit>
 #include <QThread>
 #include <QTimer>
 #include <QVBoxLayout>
 
 #include "Ensure.h"
 #include "FileLogger.h"
-#include "Macros.h"
-#include "ui/ViewConstants.h"
+#include "ui/ConsoleModel.h"
 
+#include <algorithm>
 #include <string>
 
 namespace tb::ui
 {
-namespace
-{
-
-auto getForegroundBrush(const LogLevel level, const QPalette& palette)
-{
-  // NOTE: QPalette::Text is the correct color role for contrast against QPalette::Base
-  // which is the background of text entry widgets
-
-  switch (level)
-  {
-  case LogLevel::Debug:
-    return QBrush{palette.color(QPalette::Disabled, QPalette::Text)};
-  case LogLevel::Info:
-    return QBrush{palette.color(QPalette::Normal, QPalette::Text)};
-  case LogLevel::Warn:
-    return QBrush{palette.color(QPalette::Active, QPalette::Text)};
-  case LogLevel::Error:
-    return QBrush{QColor{250, 30, 60}};
-    switchDefault();
-  }
-}
-
-} // namespace
 
 Console::Console(QWidget* parent)
   : TabBookPage{parent}
   , m_timer{new QTimer{this}}
 {
-  m_textView = new QTextEdit{};
-  m_textView->setReadOnly(true);
-  m_textView->setWordWrapMode(QTextOption::NoWrap);
+  m_listView = new QListView{};
+  m_model = new ConsoleModel{m_listView->palette(), this};
+
+  // all rows have the same height, which lets the view lay out only the visible rows
+  m_listView->setModel(m_model);
+  m_listView->setUniformItemSizes(true);
+  m_listView->setLayoutMode(QListView::Batched);
+  m_listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_listView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+  m_listView->setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
+  m_listView->setTextElideMode(Qt::ElideNone);
+  m_listView->setWordWrap(false);
+
+  auto* copyAction = new QAction{tr("Copy"), m_listView};
+  copyAction->setShortcut(QKeySequence::Copy);
+  copyAction->setShortcutContext(Qt::WidgetShortcut);
+  connect(copyAction, &QAction::triggered, this, &Console::copySelection);
+  m_listView->addAction(copyAction);
+
+  auto* clearAction = new QAction{tr("Clear"), m_listView};
+  connect(clearAction, &QAction::triggered, m_model, &ConsoleModel::clear);
+  m_listView->addAction(clearAction);
+  m_listView->setContextMenuPolicy(Qt::ActionsContextMenu);
 
   auto* sizer = new QVBoxLayout{};
   sizer->setContentsMargins(0, 0, 0, 0);
-  sizer->addWidget(m_textView);
+  sizer->addWidget(m_listView);
   setLayout(sizer);
 
+  // messages are collected lock-free and moved to the view in one batch per frame
   connect(m_timer, &QTimer::timeout, this, &Console::logCachedMessages);
-  m_timer->start(50);
+  m_timer->start(16);
 }
 
 void Console::doLog(const LogLevel level, const std::string_view message)
 {
   if (!message.empty())
   {
-    auto lock = QMutexLocker{&m_cacheMutex};
-    m_cache.cacheMessage(level, message);
+    m_queue.push(level, message);
   }
 }
 
@@ -91,35 +91,51 @@ void Console::logToDebugOut(const LogLevel /* level */, const std::string& messa
   qDebug("%s", message.c_str());
 }
 
-void Console::logToConsole(const LogLevel level, const std::string& message)
+void Console::logToConsole(std::vector<LogMessage> messages)
 {
   ensure(
-    m_textView->thread() == QThread::currentThread(),
+    m_listView->thread() == QThread::currentThread(),
     "Can only log to console from main thread");
 
-  auto format = QTextCharFormat{};
-  format.setForeground(getForegroundBrush(level, m_textView->palette()));
-  format.setFont(Fonts::fixedWidthFont());
-
-  auto cursor = QTextCursor{m_textView->document()};
-  cursor.movePosition(QTextCursor::MoveOperation::End);
+  const auto* scrollBar = m_listView->verticalScrollBar();
+  const auto scrollToBottom = scrollBar->value() == scrollBar->maximum();
 
-  cursor.insertText(QString::fromStdString(message), format);
-  cursor.insertText("\n");
+  m_model->append(std::move(messages));
 
-  m_textView->moveCursor(QTextCursor::MoveOperation::End);
+  if (scrollToBottom)
+  {
+    m_listView->scrollToBottom();
+  }
 }
 
 void Console::logCachedMessages()
 {
-  auto lock = QMutexLocker{&m_cacheMutex};
+  auto messages = m_queue.popAll();
+  if (messages.empty())
+  {
+    return;
+  }
 
-  m_cache.getCachedMessages([this](const auto level, const auto& message) {
-    const auto messageStr = std::string{message};
-    logToDebugOut(level, messageStr);
-    logToConsole(level, messageStr);
+  for (const auto& [level, message] : messages)
+  {
+    logToDebugOut(level, message);
     FileLogger::instance().log(level, message);
-  });
+  }
+  logToConsole(std::move(messages));
+}
+
+void Console::copySelection()
+{
+  auto rows = m_listView->selectionModel()->selectedRows();
+  std::sort(rows.begin(), rows.end());
+
+  auto text = QStringList{};
+  for (const auto& index : rows)
+  {
+    text << m_model->text(index.row());
+  }
+
+  QApplication::clipboard()->setText(text.join("\n"));
 }
 
 } // namespace tb::ui
@@ -19,28 +19,29 @@
 
 #pragma once
 
-#include <QMutex>
-
+#include "LogQueue.h"
 #include "Logger.h"
-#include "LoggerCache.h"
 #include "ui/TabBook.h"
 
 #include <string_view>
+#include <vector>
 
-class QTextEdit;
+class QListView;
 class QTimer;
 class QWidget;
 
 namespace tb::ui
 {
+class ConsoleModel;
+
 class Console : public TabBookPage, public Logger
 {
 private:
-  QTextEdit* m_textView = nullptr;
+  ConsoleModel* m_model = nullptr;
+  QListView* m_listView = nullptr;
   QTimer* m_timer = nullptr;
 
-  LoggerCache m_cache;
-  QMutex m_cacheMutex;
+  LogQueue m_queue;
 
 public:
   explicit Console(QWidget* parent = nullptr);
@@ -48,9 +49,10 @@ public:
 private:
   void doLog(LogLevel level, std::string_view message) override;
   void logToDebugOut(LogLevel level, const std::string& message);
-  void logToConsole(LogLevel level, const std::string& message);
+  void logToConsole(std::vector<LogMessage> messages);
 
   void logCachedMessages();
+  void copySelection();
 };
 
 } // namespace tb::ui
@@ -0,0 +1,176 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ConsoleModel.h"
+
+#include <QBrush>
+
+#include "Logger.h"
+#include "Macros.h"
+#include "ui/ViewConstants.h"
+
+#include <algorithm>
+
+namespace tb::ui
+{
+namespace
+{
+
+auto getForegroundBrush(const LogLevel level, const QPalette& palette)
+{
+  // NOTE: QPalette::Text is the correct color role for contrast against QPalette::Base
+  // which is the background of text entry widgets
+
+  switch (level)
+  {
+  case LogLevel::Debug:
+    return QBrush{palette.color(QPalette::Disabled, QPalette::Text)};
+  case LogLevel::Info:
+    return QBrush{palette.color(QPalette::Normal, QPalette::Text)};
+  case LogLevel::Warn:
+    return QBrush{palette.color(QPalette::Active, QPalette::Text)};
+  case LogLevel::Error:
+    return QBrush{QColor{250, 30, 60}};
+    switchDefault();
+  }
+}
+
+} // namespace
+
+ConsoleModel::ConsoleModel(QPalette palette, QObject* parent)
+  : QAbstractListModel{parent}
+  , m_palette{std::move(palette)}
+{
+}
+
+void ConsoleModel::append(std::vector<LogMessage> messages)
+{
+  auto newRows = std::vector<Row>{};
+  auto firstChangedRow = m_rows.size();
+  auto lastChangedRow = size_t(0);
+
+  for (auto& message : messages)
+  {
+    const auto isSameMessage = [&](const auto& row) { return row.message == message; };
+
+    // new rows follow the existing rows, so they are searched first
+    const auto newCount = std::min(newRows.size(), DuplicateWindow);
+    const auto newEnd = newRows.rbegin() + std::ptrdiff_t(newCount);
+    if (const auto it = std::find_if(newRows.rbegin(), newEnd, isSameMessage);
+        it != newEnd)
+    {
+      ++it->count;
+      continue;
+    }
+
+    const auto count = std::min(m_rows.size(), DuplicateWindow - newCount);
+    const auto end = m_rows.rbegin() + std::ptrdiff_t(count);
+    if (const auto it = std::find_if(m_rows.rbegin(), end, isSameMessage); it != end)
+    {
+      ++it->count;
+
+      const auto rowIndex = size_t(std::distance(it, m_rows.rend()) - 1);
+      firstChangedRow = std::min(firstChangedRow, rowIndex);
+      lastChangedRow = std::max(lastChangedRow, rowIndex);
+      continue;
+    }
+
+    newRows.push_back(Row{std::move(message), 1});
+  }
+
+  if (firstChangedRow < m_rows.size())
+  {
+    emit dataChanged(
+      index(int(firstChangedRow)), index(int(lastChangedRow)), {Qt::DisplayRole});
+  }
+
+  if (!newRows.empty())
+  {
+    // rows that would be removed right away are not inserted in the first place
+    if (newRows.size() > MaxRows)
+    {
+      newRows.erase(newRows.begin(), newRows.end() - std::ptrdiff_t(MaxRows));
+    }
+
+    if (const auto totalRows = m_rows.size() + newRows.size(); totalRows > MaxRows)
+    {
+      const auto excess = totalRows - MaxRows;
+
+      beginRemoveRows({}, 0, int(excess) - 1);
+      m_rows.erase(m_rows.begin(), m_rows.begin() + std::ptrdiff_t(excess));
+      endRemoveRows();
+    }
+
+    const auto first = int(m_rows.size());
+    const auto last = first + int(newRows.size()) - 1;
+
+    beginInsertRows({}, first, last);
+    m_rows.insert(
+      m_rows.end(),
+      std::make_move_iterator(newRows.begin()),
+      std::make_move_iterator(newRows.end()));
+    endInsertRows();
+  }
+}
+
+void ConsoleModel::clear()
+{
+  beginResetModel();
+  m_rows.clear();
+  endResetModel();
+}
+
+size_t ConsoleModel::repeatCount(const int row) const
+{
+  return m_rows[size_t(row)].count;
+}
+
+QString ConsoleModel::text(const int row) const
+{
+  const auto& [message, count] = m_rows[size_t(row)];
+  const auto str = QString::fromStdString(message.str);
+  return count > 1 ? QString{"%1 (%2 times)"}.arg(str).arg(count) : str;
+}
+
+int ConsoleModel::rowCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+QVariant ConsoleModel::data(const QModelIndex& index, const int role) const
+{
+  if (!index.isValid() || index.row() < 0 || index.row() >= rowCount({}))
+  {
+    return QVariant{};
+  }
+
+  switch (role)
+  {
+  case Qt::DisplayRole:
+    return text(index.row());
+  case Qt::ForegroundRole:
+    return getForegroundBrush(m_rows[size_t(index.row())].message.level, m_palette);
+  case Qt::FontRole:
+    return Fonts::fixedWidthFont();
+  default:
+    return QVariant{};
+  }
+}
+
+} // namespace tb::ui
@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QPalette>
+
+#include "LogQueue.h"
+
+#include <deque>
+#include <vector>
+
+class QModelIndex;
+class QVariant;
+
+namespace tb::ui
+{
+
+/**
+ * Holds the messages shown in the console.
+ *
+ * Messages are stored unformatted and are only converted to Qt strings, fonts and colors
+ * when a view requests the data of a row, so the cost of a message does not depend on
+ * the number of messages that are never scrolled into view.
+ *
+ * A message that repeats one of the most recent rows is not added again. Instead, the
+ * repeat count of that row is incremented and shown next to its text.
+ *
+ * At most MaxRows rows are kept. When more rows are appended, the oldest rows are
+ * removed.
+ */
+class ConsoleModel : public QAbstractListModel
+{
+  Q_OBJECT
+public:
+  static constexpr size_t DuplicateWindow = 16;
+  static constexpr size_t MaxRows = 10'000;
+
+private:
+  struct Row
+  {
+    LogMessage message;
+    size_t count;
+  };
+
+  QPalette m_palette;
+  std::deque<Row> m_rows;
+
+public:
+  explicit ConsoleModel(QPalette palette, QObject* parent = nullptr);
+
+  void append(std::vector<LogMessage> messages);
+  void clear();
+
+  size_t repeatCount(int row) const;
+  QString text(int row) const;
+
+  int rowCount(const QModelIndex& parent) const override;
+  QVariant data(const QModelIndex& index, int role) const override;
+};
+
+} // namespace tb::ui
@@ -145,8 +145,8 @@ void EntityBrowser::connectObservers()
     document->modsDidChangeNotifier.connect(this, &EntityBrowser::modsDidChange);
   m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(
     this, &EntityBrowser::entityDefinitionsDidChange);
-  m_notifierConnection +=
-    document->nodesDidChangeNotifier.connect(this, &EntityBrowser::nodesDidChange);
+  m_notifierConnection += document->notificationBatch().connect(
+    document->nodesDidChangeNotifier, this, &EntityBrowser::nodesDidChange);
   m_notifierConnection += document->resourcesWereProcessedNotifier.connect(
     this, &EntityBrowser::resourcesWereProcessed);
 
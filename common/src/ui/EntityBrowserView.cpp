@@ -135,6 +135,7 @@ void EntityBrowserView::doInitLayout(Layout& layout)
   layout.setCellWidth(93.0f, 93.0f);
   layout.setCellHeight(64.0f, 128.0f);
   layout.setMaxUpScale(1.5f);
+  layout.setVirtualized(true);
 }
 
 void EntityBrowserView::doReloadLayout(Layout& layout)
@@ -35,6 +35,7 @@
 #include "Macros.h"
 #include "mdl/EntityNodeBase.h" // IWYU pragma: keep
 #include "mdl/Node.h"
+#include "mdl/NodeQueries.h"
 #include "ui/BorderLine.h"
 #include "ui/EntityPropertyItemDelegate.h"
 #include "ui/EntityPropertyModel.h"
@@ -388,26 +389,42 @@ void EntityPropertyGrid::connectObservers()
     this, &EntityPropertyGrid::documentWasNewed);
   m_notifierConnection += document->documentWasLoadedNotifier.connect(
     this, &EntityPropertyGrid::documentWasLoaded);
+  m_notifierConnection +=
+    document->nodesWereAddedNotifier.connect(this, &EntityPropertyGrid::nodesWereAdded);
   m_notifierConnection +=
     document->nodesDidChangeNotifier.connect(this, &EntityPropertyGrid::nodesDidChange);
   m_notifierConnection += document->selectionWillChangeNotifier.connect(
     this, &EntityPropertyGrid::selectionWillChange);
   m_notifierConnection += document->selectionDidChangeNotifier.connect(
     this, &EntityPropertyGrid::selectionDidChange);
+  m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(
+    this, &EntityPropertyGrid::entityDefinitionsOrModsDidChange);
+  m_notifierConnection += document->modsDidChangeNotifier.connect(
+    this, &EntityPropertyGrid::entityDefinitionsOrModsDidChange);
 }
 
 void EntityPropertyGrid::documentWasNewed(MapDocument*)
 {
+  m_model->invalidateAllNodes();
   updateControls();
 }
 
 void EntityPropertyGrid::documentWasLoaded(MapDocument*)
 {
+  m_model->invalidateAllNodes();
+  updateControls();
+}
+
+void EntityPropertyGrid::nodesWereAdded(const std::vector<mdl::Node*>& nodes)
+{
+  // added nodes may reuse the addresses of deleted nodes
+  m_model->invalidateNodes(mdl::collectNodesAndDescendants(nodes));
   updateControls();
 }
 
-void EntityPropertyGrid::nodesDidChange(const std::vector<mdl::Node*>&)
+void EntityPropertyGrid::nodesDidChange(const std::vector<mdl::Node*>& nodes)
 {
+  m_model->invalidateNodes(nodes);
   updateControls();
 }
 
@@ -418,6 +435,12 @@ void EntityPropertyGrid::selectionDidChange(const Selection&)
   updateControls();
 }
 
+void EntityPropertyGrid::entityDefinitionsOrModsDidChange()
+{
+  m_model->invalidateAllNodes();
+  updateControls();
+}
+
 void EntityPropertyGrid::updateControls()
 {
   // When you change the selected entity in the map, there's a brief intermediate state
@@ -96,6 +96,7 @@ private:
 
   void documentWasNewed(MapDocument* document);
   void documentWasLoaded(MapDocument* document);
+  void nodesWereAdded(const std::vector<mdl::Node*>& nodes);
   void nodesDidChange(const std::vector<mdl::Node*>& nodes);
   void selectionWillChange();
   void selectionDidChange(const Selection& selection);
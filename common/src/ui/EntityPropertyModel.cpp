@@ -47,11 +47,13 @@
 #include "kdl/string_utils.h"
 #include "kdl/vector_set.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iterator>
 #include <map>
 #include <optional>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #define MODEL_LOG(x)
@@ -61,12 +63,9 @@ namespace tb::ui
 namespace
 {
 
-bool isPropertyKeyMutable(const mdl::Entity& entity, const std::string& key)
+bool isPropertyKeyMutable(const bool worldspawn, const std::string& key)
 {
-  assert(!mdl::isGroup(entity.classname(), entity.properties()));
-  assert(!mdl::isLayer(entity.classname(), entity.properties()));
-
-  if (mdl::isWorldspawn(entity.classname()))
+  if (worldspawn)
   {
     return !(
       key == mdl::EntityPropertyKeys::Classname || key == mdl::EntityPropertyKeys::Mods
@@ -83,12 +82,17 @@ bool isPropertyKeyMutable(const mdl::Entity& entity, const std::string& key)
   return true;
 }
 
-bool isPropertyValueMutable(const mdl::Entity& entity, const std::string& key)
+bool isPropertyKeyMutable(const mdl::Entity& entity, const std::string& key)
 {
   assert(!mdl::isGroup(entity.classname(), entity.properties()));
   assert(!mdl::isLayer(entity.classname(), entity.properties()));
 
-  if (mdl::isWorldspawn(entity.classname()))
+  return isPropertyKeyMutable(mdl::isWorldspawn(entity.classname()), key);
+}
+
+bool isPropertyValueMutable(const bool worldspawn, const std::string& key)
+{
+  if (worldspawn)
   {
     return !(
       key == mdl::EntityPropertyKeys::Classname || key == mdl::EntityPropertyKeys::Mods
@@ -104,17 +108,27 @@ bool isPropertyValueMutable(const mdl::Entity& entity, const std::string& key)
   return true;
 }
 
-bool isPropertyProtectable(const mdl::EntityNodeBase& entityNode, const std::string& key)
+bool isPropertyValueMutable(const mdl::Entity& entity, const std::string& key)
+{
+  assert(!mdl::isGroup(entity.classname(), entity.properties()));
+  assert(!mdl::isLayer(entity.classname(), entity.properties()));
+
+  return isPropertyValueMutable(mdl::isWorldspawn(entity.classname()), key);
+}
+
+bool isPropertyProtectable(const mdl::EntityNodeBase& entityNode)
 {
-  return mdl::findContainingGroup(&entityNode) && key != mdl::EntityPropertyKeys::Origin;
+  return mdl::findContainingGroup(&entityNode) != nullptr;
 }
 
 PropertyProtection isPropertyProtected(
-  const mdl::EntityNodeBase& entityNode, const std::string& key)
+  const bool protectable,
+  const std::vector<std::string>& protectedProperties,
+  const std::string& key)
 {
-  if (isPropertyProtectable(entityNode, key))
+  if (protectable && key != mdl::EntityPropertyKeys::Origin)
   {
-    for (const auto& protectedKey : entityNode.entity().protectedProperties())
+    for (const auto& protectedKey : protectedProperties)
     {
       if (mdl::isNumberedProperty(protectedKey, key))
       {
@@ -126,6 +140,19 @@ PropertyProtection isPropertyProtected(
   return PropertyProtection::NotProtectable;
 }
 
+PropertyProtection isPropertyProtected(
+  const mdl::EntityNodeBase& entityNode, const std::string& key)
+{
+  return isPropertyProtected(
+    isPropertyProtectable(entityNode), entityNode.entity().protectedProperties(), key);
+}
+
+std::string propertyTooltip(const mdl::PropertyDefinition* definition)
+{
+  auto tooltip = definition != nullptr ? definition->shortDescription() : "";
+  return !tooltip.empty() ? tooltip : "No description found";
+}
+
 PropertyRow rowForEntityNodes(
   const std::string& key, const std::vector<mdl::EntityNodeBase*>& nodes)
 {
@@ -275,11 +302,25 @@ PropertyRow::PropertyRow(std::string key, const mdl::EntityNodeBase* node)
   m_keyMutable = isPropertyKeyMutable(node->entity(), m_key);
   m_valueMutable = isPropertyValueMutable(node->entity(), m_key);
   m_protected = isPropertyProtected(*node, m_key);
-  m_tooltip = (definition != nullptr ? definition->shortDescription() : "");
-  if (m_tooltip.empty())
-  {
-    m_tooltip = "No description found";
-  }
+  m_tooltip = propertyTooltip(definition);
+}
+
+PropertyRow::PropertyRow(
+  std::string key,
+  std::string value,
+  const ValueType valueType,
+  const bool keyMutable,
+  const bool valueMutable,
+  const PropertyProtection protection,
+  std::string tooltip)
+  : m_key{std::move(key)}
+  , m_value{std::move(value)}
+  , m_valueType{valueType}
+  , m_keyMutable{keyMutable}
+  , m_valueMutable{valueMutable}
+  , m_protected{protection}
+  , m_tooltip{std::move(tooltip)}
+{
 }
 
 void PropertyRow::merge(const mdl::EntityNodeBase* other)
@@ -304,6 +345,7 @@ void PropertyRow::merge(const mdl::EntityNodeBase* other)
     else if (*otherValue != m_value)
     {
       m_valueType = ValueType::MultipleValues;
+      m_value.clear();
     }
   }
   else if (m_valueType == ValueType::SingleValueAndUnset)
@@ -311,6 +353,7 @@ void PropertyRow::merge(const mdl::EntityNodeBase* other)
     if (otherValue && *otherValue != m_value)
     {
       m_valueType = ValueType::MultipleValues;
+      m_value.clear();
     }
   }
 
@@ -384,6 +427,274 @@ bool PropertyRow::subset() const
 
 kdl_reflect_impl(PropertyRow);
 
+// PropertyRowAggregator
+
+PropertyRowAggregator::PropertyRowAggregator(const bool showDefaultRows)
+  : m_showDefaultRows{showDefaultRows}
+{
+}
+
+bool PropertyRowAggregator::showDefaultRows() const
+{
+  return m_showDefaultRows;
+}
+
+bool PropertyRowAggregator::contains(const mdl::EntityNodeBase* node) const
+{
+  return m_nodes.contains(node);
+}
+
+std::vector<const mdl::EntityNodeBase*> PropertyRowAggregator::nodes() const
+{
+  auto result = std::vector<const mdl::EntityNodeBase*>{};
+  result.reserve(m_nodes.size());
+  for (const auto& [node, state] : m_nodes)
+  {
+    result.push_back(node);
+  }
+  return result;
+}
+
+void PropertyRowAggregator::addNode(const mdl::EntityNodeBase& node)
+{
+  assert(!contains(&node));
+
+  auto state = makeNodeState(node);
+  addKeys(state);
+
+  for (auto& [key, counts] : m_keys)
+  {
+    count(counts, state, key, true);
+  }
+
+  m_nodes.emplace(&node, std::move(state));
+}
+
+void PropertyRowAggregator::updateNode(const mdl::EntityNodeBase& node)
+{
+  const auto it = m_nodes.find(&node);
+  assert(it != m_nodes.end());
+
+  auto& state = it->second;
+  auto newState = makeNodeState(node);
+
+  // add the new keys first so that keys shared by both states are not removed
+  addKeys(newState);
+
+  for (auto& [key, counts] : m_keys)
+  {
+    count(counts, state, key, false);
+    count(counts, newState, key, true);
+  }
+
+  removeKeys(state);
+  state = std::move(newState);
+}
+
+void PropertyRowAggregator::removeNode(const mdl::EntityNodeBase* node)
+{
+  const auto it = m_nodes.find(node);
+  if (it == m_nodes.end())
+  {
+    return;
+  }
+
+  const auto& state = it->second;
+  for (auto& [key, counts] : m_keys)
+  {
+    count(counts, state, key, false);
+  }
+
+  removeKeys(state);
+  m_nodes.erase(it);
+}
+
+void PropertyRowAggregator::clear()
+{
+  m_nodes.clear();
+  m_keys.clear();
+}
+
+std::map<std::string, PropertyRow> PropertyRowAggregator::rows(
+  const mdl::EntityNodeBase* firstNode) const
+{
+  assert(m_nodes.empty() || contains(firstNode));
+
+  auto result = std::map<std::string, PropertyRow>{};
+  for (const auto& [key, counts] : m_keys)
+  {
+    const auto* definition = mdl::propertyDefinition(firstNode, key);
+
+    auto valueType = ValueType::Unset;
+    auto value = std::string{};
+    if (counts.setCount == 0)
+    {
+      if (definition != nullptr)
+      {
+        value = mdl::PropertyDefinition::defaultValue(*definition);
+      }
+    }
+    else if (counts.valueCounts.size() > 1)
+    {
+      valueType = ValueType::MultipleValues;
+    }
+    else
+    {
+      valueType = counts.setCount == m_nodes.size() ? ValueType::SingleValue
+                                                    : ValueType::SingleValueAndUnset;
+      value = counts.valueCounts.begin()->first;
+    }
+
+    auto protection = PropertyProtection::NotProtected;
+    if (counts.notProtectableCount > 0)
+    {
+      protection = PropertyProtection::NotProtectable;
+    }
+    else if (counts.protectedCount > 0)
+    {
+      protection = counts.notProtectedCount > 0 ? PropertyProtection::Mixed
+                                                : PropertyProtection::Protected;
+    }
+
+    result.emplace(
+      key,
+      PropertyRow{
+        key,
+        std::move(value),
+        valueType,
+        counts.immutableKeyCount == 0,
+        counts.immutableValueCount == 0,
+        protection,
+        propertyTooltip(definition)});
+  }
+  return result;
+}
+
+PropertyRowAggregator::NodeState PropertyRowAggregator::makeNodeState(
+  const mdl::EntityNodeBase& node) const
+{
+  const auto& entity = node.entity();
+  assert(!mdl::isGroup(entity.classname(), entity.properties()));
+  assert(!mdl::isLayer(entity.classname(), entity.properties()));
+
+  auto keys = kdl::vector_set<std::string>{};
+  for (const auto& property : entity.properties())
+  {
+    keys.insert(property.key());
+  }
+
+  if (m_showDefaultRows)
+  {
+    if (const auto* entityDefinition = entity.definition())
+    {
+      for (const auto& propertyDefinition : entityDefinition->propertyDefinitions())
+      {
+        keys.insert(propertyDefinition->key());
+      }
+    }
+  }
+
+  const auto& protectedProperties = entity.protectedProperties();
+  keys.insert(std::begin(protectedProperties), std::end(protectedProperties));
+
+  return NodeState{
+    entity.properties(),
+    protectedProperties,
+    mdl::isWorldspawn(entity.classname()),
+    isPropertyProtectable(node),
+    keys.release_data(),
+  };
+}
+
+void PropertyRowAggregator::addKeys(const NodeState& state)
+{
+  for (const auto& key : state.keys)
+  {
+    auto [it, inserted] = m_keys.try_emplace(key);
+    if (inserted)
+    {
+      // every node contributes to the row of a key, even if it doesn't require the row
+      for (const auto& [otherNode, otherState] : m_nodes)
+      {
+        count(it->second, otherState, key, true);
+      }
+    }
+    ++it->second.rowCount;
+  }
+}
+
+void PropertyRowAggregator::removeKeys(const NodeState& state)
+{
+  for (const auto& key : state.keys)
+  {
+    const auto it = m_keys.find(key);
+    assert(it != m_keys.end());
+    assert(it->second.rowCount > 0);
+
+    if (--it->second.rowCount == 0)
+    {
+      m_keys.erase(it);
+    }
+  }
+}
+
+void PropertyRowAggregator::count(
+  KeyCounts& counts, const NodeState& state, const std::string& key, const bool add)
+{
+  const auto update = [&](size_t& counter) {
+    if (add)
+    {
+      ++counter;
+    }
+    else
+    {
+      assert(counter > 0);
+      --counter;
+    }
+  };
+
+  const auto property =
+    std::find_if(state.properties.begin(), state.properties.end(), [&](const auto& p) {
+      return p.hasKey(key);
+    });
+  if (property != state.properties.end())
+  {
+    update(counts.setCount);
+
+    auto& valueCount = counts.valueCounts[property->value()];
+    update(valueCount);
+    if (valueCount == 0)
+    {
+      counts.valueCounts.erase(property->value());
+    }
+  }
+
+  if (!isPropertyKeyMutable(state.worldspawn, key))
+  {
+    update(counts.immutableKeyCount);
+  }
+  if (!isPropertyValueMutable(state.worldspawn, key))
+  {
+    update(counts.immutableValueCount);
+  }
+
+  switch (isPropertyProtected(state.protectable, state.protectedProperties, key))
+  {
+  case PropertyProtection::Protected:
+    update(counts.protectedCount);
+    break;
+  case PropertyProtection::NotProtected:
+    update(counts.notProtectedCount);
+    break;
+  case PropertyProtection::NotProtectable:
+    update(counts.notProtectableCount);
+    break;
+  case PropertyProtection::Mixed:
+    // a single node cannot have mixed protection
+    break;
+  }
+}
+
 // EntityPropertyModel
 
 EntityPropertyModel::EntityPropertyModel(
@@ -392,6 +703,7 @@ EntityPropertyModel::EntityPropertyModel(
   , m_showDefaultRows{true}
   , m_shouldShowProtectedProperties{false}
   , m_document{std::move(document)}
+  , m_aggregator{m_showDefaultRows}
 {
   updateFromMapDocument();
 }
@@ -465,6 +777,7 @@ void EntityPropertyModel::setShowDefaultRows(const bool showDefaultRows)
     return;
   }
   m_showDefaultRows = showDefaultRows;
+  m_aggregator = PropertyRowAggregator{m_showDefaultRows};
   updateFromMapDocument();
 }
 
@@ -722,6 +1035,23 @@ static bool computeShouldShowProtectedProperties(
   });
 }
 
+void EntityPropertyModel::invalidateNodes(const std::vector<mdl::Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    if (const auto* entityNode = dynamic_cast<const mdl::EntityNodeBase*>(node))
+    {
+      m_invalidatedNodes.insert(entityNode);
+    }
+  }
+}
+
+void EntityPropertyModel::invalidateAllNodes()
+{
+  m_aggregator.clear();
+  m_invalidatedNodes.clear();
+}
+
 void EntityPropertyModel::updateFromMapDocument()
 {
   MODEL_LOG(qDebug() << "updateFromMapDocument");
@@ -729,9 +1059,37 @@ void EntityPropertyModel::updateFromMapDocument()
   auto document = kdl::mem_lock(m_document);
 
   const auto entityNodes = document->allSelectedEntityNodes();
-  const auto rowsMap = rowsForEntityNodes(entityNodes, m_showDefaultRows, true);
+  const auto selectedNodes = std::unordered_set<const mdl::EntityNodeBase*>{
+    entityNodes.begin(), entityNodes.end()};
+
+  // nodes that are no longer selected may have been deleted, so they must be removed
+  // before any of the invalidated nodes are accessed
+  for (const auto* node : m_aggregator.nodes())
+  {
+    if (!selectedNodes.contains(node))
+    {
+      m_aggregator.removeNode(node);
+    }
+  }
+
+  for (const auto* node : m_invalidatedNodes)
+  {
+    if (m_aggregator.contains(node))
+    {
+      m_aggregator.updateNode(*node);
+    }
+  }
+  m_invalidatedNodes.clear();
+
+  for (const auto* node : entityNodes)
+  {
+    if (!m_aggregator.contains(node))
+    {
+      m_aggregator.addNode(*node);
+    }
+  }
 
-  setRows(rowsMap);
+  setRows(m_aggregator.rows(!entityNodes.empty() ? entityNodes.front() : nullptr));
   m_shouldShowProtectedProperties = computeShouldShowProtectedProperties(entityNodes);
 }
 
@@ -21,17 +21,22 @@
 
 #include <QAbstractTableModel>
 
+#include "mdl/EntityProperties.h"
+
 #include "kdl/reflection_decl.h"
 
 #include <iosfwd>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
 {
 class EntityNodeBase;
+class Node;
 }
 
 namespace tb::ui
@@ -94,6 +99,14 @@ private:
 public:
   PropertyRow();
   PropertyRow(std::string key, const mdl::EntityNodeBase* node);
+  PropertyRow(
+    std::string key,
+    std::string value,
+    ValueType valueType,
+    bool keyMutable,
+    bool valueMutable,
+    PropertyProtection protection,
+    std::string tooltip);
 
   void merge(const mdl::EntityNodeBase* other);
 
@@ -118,6 +131,90 @@ public:
     m_tooltip);
 };
 
+/**
+ * Maintains the property rows for a set of entity nodes incrementally.
+ *
+ * For every property key, the values, mutability and protection of all nodes are
+ * aggregated in counters. Adding, removing or updating a node only visits the keys
+ * known to the aggregator and never the other nodes, unless the node introduces a new
+ * key.
+ *
+ * The aggregator keeps a snapshot of the relevant data of each node, so nodes can be
+ * removed without accessing them, e.g. after they have been deleted.
+ */
+class PropertyRowAggregator
+{
+private:
+  struct NodeState
+  {
+    std::vector<mdl::EntityProperty> properties;
+    std::vector<std::string> protectedProperties;
+    bool worldspawn = false;
+    bool protectable = false;
+
+    /**
+     * The keys for which this node requires a row.
+     */
+    std::vector<std::string> keys;
+  };
+
+  struct KeyCounts
+  {
+    /**
+     * The number of nodes which require a row for this key.
+     */
+    size_t rowCount = 0;
+    size_t setCount = 0;
+    std::map<std::string, size_t> valueCounts;
+    size_t immutableKeyCount = 0;
+    size_t immutableValueCount = 0;
+    size_t protectedCount = 0;
+    size_t notProtectedCount = 0;
+    size_t notProtectableCount = 0;
+  };
+
+  bool m_showDefaultRows;
+  std::unordered_map<const mdl::EntityNodeBase*, NodeState> m_nodes;
+  std::map<std::string, KeyCounts> m_keys;
+
+public:
+  explicit PropertyRowAggregator(bool showDefaultRows);
+
+  bool showDefaultRows() const;
+
+  bool contains(const mdl::EntityNodeBase* node) const;
+  std::vector<const mdl::EntityNodeBase*> nodes() const;
+
+  void addNode(const mdl::EntityNodeBase& node);
+
+  /**
+   * Replaces the snapshot of the given node, which must have been added already.
+   */
+  void updateNode(const mdl::EntityNodeBase& node);
+
+  /**
+   * Removes the given node. The node is not accessed, so it may have been deleted.
+   */
+  void removeNode(const mdl::EntityNodeBase* node);
+
+  void clear();
+
+  /**
+   * Returns the rows for the nodes in this aggregator. The default values and tooltips
+   * of the rows are taken from the entity definition of the given node, which must be
+   * contained in this aggregator unless it is empty.
+   */
+  std::map<std::string, PropertyRow> rows(const mdl::EntityNodeBase* firstNode) const;
+
+private:
+  NodeState makeNodeState(const mdl::EntityNodeBase& node) const;
+  void addKeys(const NodeState& state);
+  void removeKeys(const NodeState& state);
+
+  static void count(
+    KeyCounts& counts, const NodeState& state, const std::string& key, bool add);
+};
+
 /**
  * Model for the QTableView.
  *
@@ -125,8 +222,8 @@ public:
  *
  * 1. MapDocument is modified, or entities are added/removed from the list that
  * EntityPropertyGridTable is observing
- * 2. EntityPropertyGridTable observes the change, and builds a list of PropertyRow for
- * the new state
+ * 2. EntityPropertyGridTable observes the change, and updates the PropertyRowAggregator
+ * with the changed nodes to obtain the list of PropertyRow for the new state
  * 3. The new state and old state are diffed, and the necessary QAbstractTableModel
  * methods called to update the view correctly (preserving selection, etc.)
  *
@@ -151,6 +248,9 @@ private:
   bool m_shouldShowProtectedProperties;
   std::weak_ptr<MapDocument> m_document;
 
+  PropertyRowAggregator m_aggregator;
+  std::unordered_set<const mdl::EntityNodeBase*> m_invalidatedNodes;
+
 public:
   explicit EntityPropertyModel(std::weak_ptr<MapDocument> document, QObject* parent);
 
@@ -173,6 +273,19 @@ private: // autocompletion helpers
   std::vector<std::string> getAllValuesForPropertyKeys(
     const std::vector<std::string>& propertyKeys) const;
   std::vector<std::string> getAllClassnames() const;
+
+public:
+  /**
+   * Marks the entity nodes among the given nodes as changed. Their rows are updated by
+   * the next call to updateFromMapDocument.
+   */
+  void invalidateNodes(const std::vector<mdl::Node*>& nodes);
+
+  /**
+   * Discards all rows so that they are rebuilt by the next call to updateFromMapDocument.
+   */
+  void invalidateAllNodes();
+
 public slots:
   void updateFromMapDocument();
 
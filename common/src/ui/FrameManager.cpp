@@ -21,6 +21,7 @@
 
 #include <QApplication>
 
+#include "io/SystemPaths.h"
 #include "ui/MapDocument.h"
 #include "ui/MapDocumentCommandFacade.h"
 #include "ui/MapFrame.h"
@@ -98,6 +99,8 @@ MapFrame* FrameManager::createOrReuseFrame(kdl::task_manager& taskManager)
   if (!m_singleFrame || m_frames.empty())
   {
     auto document = MapDocumentCommandFacade::newMapDocument(taskManager);
+    document->setEntityDefinitionCacheDirectory(
+      io::SystemPaths::userDataDirectory() / "EntityDefinitionCache");
     createFrame(std::move(document));
   }
   return topFrame();
@@ -83,14 +83,18 @@ void IssueBrowser::connectObservers()
     this, &IssueBrowser::documentWasNewedOrLoaded);
   m_notifierConnection += document->documentWasLoadedNotifier.connect(
     this, &IssueBrowser::documentWasNewedOrLoaded);
-  m_notifierConnection +=
-    document->nodesWereAddedNotifier.connect(this, &IssueBrowser::nodesWereAdded);
-  m_notifierConnection +=
-    document->nodesWereRemovedNotifier.connect(this, &IssueBrowser::nodesWereRemoved);
-  m_notifierConnection +=
-    document->nodesDidChangeNotifier.connect(this, &IssueBrowser::nodesDidChange);
-  m_notifierConnection += document->brushFacesDidChangeNotifier.connect(
-    this, &IssueBrowser::brushFacesDidChange);
+
+  // the issue list is rebuilt on every change, so one notification per transaction is
+  // sufficient
+  auto& batch = document->notificationBatch();
+  m_notifierConnection += batch.connect(
+    document->nodesWereAddedNotifier, this, &IssueBrowser::nodesWereAdded);
+  m_notifierConnection += batch.connect(
+    document->nodesWereRemovedNotifier, this, &IssueBrowser::nodesWereRemoved);
+  m_notifierConnection += batch.connect(
+    document->nodesDidChangeNotifier, this, &IssueBrowser::nodesDidChange);
+  m_notifierConnection += batch.connect(
+    document->brushFacesDidChangeNotifier, this, &IssueBrowser::brushFacesDidChange);
 }
 
 void IssueBrowser::documentWasNewedOrLoaded(MapDocument*)
@@ -217,12 +217,14 @@ void LayerListBox::connectObservers()
     document->documentWasClearedNotifier.connect(this, &LayerListBox::documentDidChange);
   m_notifierConnection += document->currentLayerDidChangeNotifier.connect(
     this, &LayerListBox::currentLayerDidChange);
+
+  auto& batch = document->notificationBatch();
   m_notifierConnection +=
-    document->nodesWereAddedNotifier.connect(this, &LayerListBox::nodesDidChange);
-  m_notifierConnection +=
-    document->nodesWereRemovedNotifier.connect(this, &LayerListBox::nodesDidChange);
+    batch.connect(document->nodesWereAddedNotifier, this, &LayerListBox::nodesDidChange);
+  m_notifierConnection += batch.connect(
+    document->nodesWereRemovedNotifier, this, &LayerListBox::nodesDidChange);
   m_notifierConnection +=
-    document->nodesDidChangeNotifier.connect(this, &LayerListBox::nodesDidChange);
+    batch.connect(document->nodesDidChangeNotifier, this, &LayerListBox::nodesDidChange);
   m_notifierConnection += document->nodeVisibilityDidChangeNotifier.connect(
     this, &LayerListBox::nodesDidChange);
   m_notifierConnection +=
@@ -23,12 +23,16 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Uuid.h"
+#include "io/BinaryMapFormat.h"
+#include "io/BinaryMapReader.h"
+#include "io/BinaryMapSerializer.h"
 #include "io/BrushFaceReader.h"
 #include "io/DiskIO.h"
 #include "io/ExportOptions.h"
 #include "io/GameConfigParser.h"
 #include "io/LoadMaterialCollections.h"
 #include "io/MapHeader.h"
+#include "io/NodeSerializationCache.h"
 #include "io/NodeReader.h"
 #include "io/NodeWriter.h"
 #include "io/ObjSerializer.h"
@@ -403,6 +407,7 @@ MapDocument::MapDocument(kdl::task_manager& taskManager)
   , m_tagManager{std::make_unique<mdl::TagManager>()}
   , m_editorContext{std::make_unique<mdl::EditorContext>()}
   , m_grid{std::make_unique<Grid>(4)}
+  , m_serializationCache{std::make_unique<io::NodeSerializationCache>()}
   , m_repeatStack{std::make_unique<RepeatStack>()}
 {
   connectObservers();
@@ -431,6 +436,11 @@ Logger& MapDocument::logger()
   return *this;
 }
 
+NotificationBatch& MapDocument::notificationBatch()
+{
+  return m_notificationBatch;
+}
+
 std::shared_ptr<mdl::Game> MapDocument::game() const
 {
   return m_game;
@@ -575,6 +585,12 @@ void MapDocument::setViewEffectsService(ViewEffectsService* viewEffectsService)
   m_viewEffectsService = viewEffectsService;
 }
 
+void MapDocument::setEntityDefinitionCacheDirectory(
+  std::optional<std::filesystem::path> entityDefinitionCacheDirectory)
+{
+  m_entityDefinitionCacheDirectory = std::move(entityDefinitionCacheDirectory);
+}
+
 void MapDocument::createTagActions()
 {
   const auto& actionManager = ActionManager::instance();
@@ -609,6 +625,16 @@ Result<std::unique_ptr<mdl::WorldNode>> loadMap(
   auto parserStatus = io::SimpleParserStatus{logger};
   return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
            auto fileReader = file->reader().buffer();
+           if (io::isBinaryMap(fileReader.stringView()))
+           {
+             return io::readBinaryMap(
+               fileReader.stringView(),
+               worldBounds,
+               entityPropertyConfig,
+               parserStatus,
+               taskManager);
+           }
+
            if (mapFormat == mdl::MapFormat::Unknown)
            {
              // Try all formats listed in the game config
@@ -753,17 +779,50 @@ void MapDocument::saveDocumentTo(const std::filesystem::path& path)
   ensure(m_game.get() != nullptr, "game is null");
   ensure(m_world, "world is null");
 
-  io::Disk::withOutputStream(path, [&](auto& stream) {
-    io::writeMapHeader(stream, m_game->config().name, m_world->mapFormat());
+  const auto writeResult =
+    kdl::path_has_extension(kdl::path_to_lower(path), io::BinaryMapFormat::Extension)
+      ? io::Disk::withOutputStream(
+          path,
+          std::ios::out | std::ios::binary,
+          [&](auto& stream) { writeBinaryDocument(stream); })
+      : io::Disk::withOutputStream(
+          path, [&](auto& stream) { writeDocument(stream); });
 
-    auto writer = io::NodeWriter{*m_world, stream};
-    writer.setExporting(false);
-    writer.writeMap(m_taskManager);
-  }) | kdl::transform_error([&](const auto& e) {
+  writeResult | kdl::transform_error([&](const auto& e) {
     error() << "Could not save document: " << e.msg;
   });
 }
 
+std::string MapDocument::serializeDocument()
+{
+  ensure(m_game.get() != nullptr, "game is null");
+  ensure(m_world, "world is null");
+
+  auto stream = std::stringstream{};
+  writeDocument(stream);
+  return stream.str();
+}
+
+void MapDocument::writeDocument(std::ostream& stream)
+{
+  io::writeMapHeader(stream, m_game->config().name, m_world->mapFormat());
+
+  auto writer = io::NodeWriter{*m_world, stream, *m_serializationCache};
+  writer.setExporting(false);
+  writer.writeMap(m_taskManager);
+}
+
+void MapDocument::writeBinaryDocument(std::ostream& stream)
+{
+  io::writeMapHeader(stream, m_game->config().name, m_world->mapFormat());
+
+  auto writer = io::NodeWriter{
+    *m_world,
+    std::make_unique<io::BinaryMapSerializer>(stream, m_world->mapFormat())};
+  writer.setExporting(false);
+  writer.writeMap(m_taskManager);
+}
+
 Result<void> MapDocument::exportDocumentAs(const io::ExportOptions& options)
 {
   return std::visit(
@@ -782,6 +841,19 @@ Result<void> MapDocument::exportDocumentAs(const io::ExportOptions& options)
         });
       },
       [&](const io::MapExportOptions& mapOptions) {
+        if (kdl::path_has_extension(
+              kdl::path_to_lower(mapOptions.exportPath), io::BinaryMapFormat::Extension))
+        {
+          return io::Disk::withOutputStream(
+            mapOptions.exportPath, std::ios::out | std::ios::binary, [&](auto& stream) {
+              auto writer = io::NodeWriter{
+                *m_world,
+                std::make_unique<io::BinaryMapSerializer>(stream, m_world->mapFormat())};
+              writer.setExporting(true);
+              writer.writeMap(m_taskManager);
+            });
+        }
+
         return io::Disk::withOutputStream(mapOptions.exportPath, [&](auto& stream) {
           auto writer = io::NodeWriter{*m_world, stream};
           writer.setExporting(true);
@@ -1422,7 +1494,7 @@ void MapDocument::selectTouching(const bool del)
 {
   const auto nodes = kdl::vec_filter(
     mdl::collectTouchingNodes(
-      std::vector<mdl::Node*>{m_world.get()}, m_selectedNodes.brushes()),
+      std::vector<mdl::Node*>{m_world.get()}, m_selectedNodes.brushes(), m_taskManager),
     [&](mdl::Node* node) { return m_editorContext->selectable(node); });
 
   auto transaction = Transaction{*this, "Select Touching"};
@@ -1442,7 +1514,7 @@ void MapDocument::selectInside(const bool del)
 {
   const auto nodes = kdl::vec_filter(
     mdl::collectContainedNodes(
-      std::vector<mdl::Node*>{m_world.get()}, m_selectedNodes.brushes()),
+      std::vector<mdl::Node*>{m_world.get()}, m_selectedNodes.brushes(), m_taskManager),
     [&](mdl::Node* node) { return m_editorContext->selectable(node); });
 
   auto transaction = Transaction{*this, "Select Inside"};
@@ -1663,7 +1735,8 @@ void MapDocument::selectTall(const vm::axis::type cameraAxis)
         const auto nodesToSelect = kdl::vec_filter(
           mdl::collectContainedNodes(
             {world()},
-            kdl::vec_transform(tallBrushes, [](const auto& b) { return b.get(); })),
+            kdl::vec_transform(tallBrushes, [](const auto& b) { return b.get(); }),
+            m_taskManager),
           [&](const auto* node) { return editorContext().selectable(node); });
         selectNodes(nodesToSelect);
 
@@ -2540,6 +2613,27 @@ void MapDocument::setHasPendingChanges(
   {
     groupNode->setHasPendingChanges(hasPendingChanges);
   }
+
+  if (hasPendingChanges && !groupNodes.empty())
+  {
+    m_hasUntrackedPendingChanges = true;
+  }
+}
+
+void MapDocument::setHasPendingChanges(
+  const std::vector<mdl::GroupNode*>& groupNodes,
+  const std::vector<mdl::Node*>& changedNodes)
+{
+  for (auto* groupNode : groupNodes)
+  {
+    groupNode->setHasPendingChanges(true);
+  }
+
+  if (!groupNodes.empty())
+  {
+    m_nodesWithPendingChanges =
+      kdl::vec_concat(std::move(m_nodesWithPendingChanges), changedNodes);
+  }
 }
 
 static std::vector<mdl::GroupNode*> collectGroupsWithPendingChanges(mdl::Node& node)
@@ -2571,12 +2665,21 @@ bool MapDocument::updateLinkedGroups()
 {
   if (isCurrentDocumentStateObservable())
   {
+    auto changedNodes = std::optional<std::vector<mdl::Node*>>{};
+    if (!m_hasUntrackedPendingChanges)
+    {
+      changedNodes = kdl::vec_sort_and_remove_duplicates(m_nodesWithPendingChanges);
+    }
+    m_nodesWithPendingChanges.clear();
+    m_hasUntrackedPendingChanges = false;
+
     if (const auto allChangedLinkedGroups = collectGroupsWithPendingChanges(*m_world);
         !allChangedLinkedGroups.empty())
     {
       setHasPendingChanges(allChangedLinkedGroups, false);
 
-      auto command = std::make_unique<UpdateLinkedGroupsCommand>(allChangedLinkedGroups);
+      auto command = std::make_unique<UpdateLinkedGroupsCommand>(
+        allChangedLinkedGroups, std::move(changedNodes));
       const auto result = executeAndStore(std::move(command));
       return result->success();
     }
@@ -3036,6 +3139,9 @@ bool MapDocument::swapNodeContents(
     return false;
   }
 
+  const auto changedNodes =
+    kdl::vec_transform(nodesToSwap, [](const auto& p) { return p.first; });
+
   auto transaction = Transaction{*this};
   const auto result = executeAndStore(
     std::make_unique<SwapNodeContentsCommand>(commandName, std::move(nodesToSwap)));
@@ -3046,7 +3152,7 @@ bool MapDocument::swapNodeContents(
     return false;
   }
 
-  setHasPendingChanges(changedLinkedGroups, true);
+  setHasPendingChanges(changedLinkedGroups, changedNodes);
   return transaction.commit();
 }
 
@@ -3852,11 +3958,18 @@ bool MapDocument::setFaceAttributesExceptContentFlags(
 
 bool MapDocument::setFaceAttributes(const mdl::ChangeBrushFaceAttributesRequest& request)
 {
-  return applyAndSwap(
-    *this, request.name(), allSelectedBrushFaces(), [&](mdl::BrushFace& brushFace) {
-      request.evaluate(brushFace);
-      return true;
-    });
+  auto changedBrushes =
+    mdl::changeBrushFaceAttributes(request, allSelectedBrushFaces(), m_taskManager);
+  if (changedBrushes.empty())
+  {
+    return true;
+  }
+
+  auto nodesToSwap = kdl::vec_transform(std::move(changedBrushes), [](auto pair) {
+    return std::pair<mdl::Node*, mdl::NodeContents>{
+      pair.first, mdl::NodeContents{std::move(pair.second)}};
+  });
+  return swapNodeContents(request.name(), std::move(nodesToSwap));
 }
 
 bool MapDocument::copyUVFromFace(
@@ -4020,8 +4133,9 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
       kdl::str_plural(vertexPositions.size(), "Move Brush Vertex", "Move Brush Vertices");
     auto transaction = Transaction{*this, commandName};
 
-    const auto changedLinkedGroups = collectContainingGroups(
-      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = collectContainingGroups(changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushVertexCommand>(
       commandName,
@@ -4035,7 +4149,7 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
       return MoveVerticesResult{false, false};
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    setHasPendingChanges(changedLinkedGroups, changedNodes);
 
     if (!transaction.commit())
     {
@@ -4100,8 +4214,9 @@ bool MapDocument::moveEdges(
       kdl::str_plural(edgePositions.size(), "Move Brush Edge", "Move Brush Edges");
     auto transaction = Transaction{*this, commandName};
 
-    const auto changedLinkedGroups = collectContainingGroups(
-      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = collectContainingGroups(changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushEdgeCommand>(
       commandName,
@@ -4115,7 +4230,7 @@ bool MapDocument::moveEdges(
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    setHasPendingChanges(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -4168,8 +4283,9 @@ bool MapDocument::moveFaces(
       kdl::str_plural(facePositions.size(), "Move Brush Face", "Move Brush Faces");
     auto transaction = Transaction{*this, commandName};
 
-    auto changedLinkedGroups = collectContainingGroups(
-      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = collectContainingGroups(changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushFaceCommand>(
       commandName,
@@ -4183,7 +4299,7 @@ bool MapDocument::moveFaces(
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    setHasPendingChanges(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -4216,8 +4332,9 @@ bool MapDocument::addVertex(const vm::vec3d& vertexPosition)
     const auto commandName = "Add Brush Vertex";
     auto transaction = Transaction{*this, commandName};
 
-    const auto changedLinkedGroups = collectContainingGroups(
-      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = collectContainingGroups(changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushVertexCommand>(
       commandName,
@@ -4231,7 +4348,7 @@ bool MapDocument::addVertex(const vm::vec3d& vertexPosition)
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    setHasPendingChanges(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -4271,8 +4388,9 @@ bool MapDocument::removeVertices(
   {
     auto transaction = Transaction{*this, commandName};
 
-    auto changedLinkedGroups = collectContainingGroups(
-      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = collectContainingGroups(changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushVertexCommand>(
       commandName,
@@ -4286,7 +4404,7 @@ bool MapDocument::removeVertices(
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    setHasPendingChanges(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -4417,6 +4535,7 @@ void MapDocument::clearRepeatableCommands()
 void MapDocument::startTransaction(std::string name, const TransactionScope scope)
 {
   debug("Starting transaction '" + name + "'");
+  m_notificationBatch.begin();
   doStartTransaction(std::move(name), scope);
   m_repeatStack->startTransaction();
 }
@@ -4440,6 +4559,7 @@ bool MapDocument::commitTransaction()
 
   doCommitTransaction();
   m_repeatStack->commitTransaction();
+  m_notificationBatch.end();
   return true;
 }
 
@@ -4450,6 +4570,7 @@ void MapDocument::cancelTransaction()
   m_repeatStack->rollbackTransaction();
   doCommitTransaction();
   m_repeatStack->commitTransaction();
+  m_notificationBatch.end();
 }
 
 std::unique_ptr<CommandResult> MapDocument::execute(std::unique_ptr<Command>&& command)
@@ -4549,6 +4670,7 @@ void MapDocument::setWorld(
 
 void MapDocument::clearWorld()
 {
+  m_serializationCache->clear();
   m_world.reset();
   m_currentLayer = nullptr;
 }
@@ -4684,7 +4806,9 @@ void MapDocument::loadEntityDefinitions()
   const auto path = m_game->findEntityDefinitionFile(spec, externalSearchPaths());
   auto status = io::SimpleParserStatus{logger()};
 
-  m_entityDefinitionManager->loadDefinitions(path, *m_game, status)
+  m_entityDefinitionManager
+    ->loadDefinitions(
+      path, *m_game, status, m_taskManager, m_entityDefinitionCacheDirectory)
     | kdl::transform([&]() {
         info(fmt::format("Loaded entity definition file {}", path.filename()));
         createEntityDefinitionActions();
@@ -4744,12 +4868,14 @@ void MapDocument::loadMaterials()
       return resource;
     },
     m_taskManager);
+  m_tagManager->clearMaterialTagMasks();
 }
 
 void MapDocument::unloadMaterials()
 {
   unsetMaterials();
   m_materialManager->clear();
+  m_tagManager->clearMaterialTagMasks();
 }
 
 static auto makeSetMaterialsVisitor(mdl::MaterialManager& manager)
@@ -5231,6 +5357,20 @@ void MapDocument::updateFaceTagsAfterResourcesWhereProcessed(
     [](mdl::PatchNode*) {}));
 }
 
+void MapDocument::invalidateSerializationCache(const std::vector<mdl::Node*>& nodes)
+{
+  m_serializationCache->invalidate(nodes);
+}
+
+void MapDocument::invalidateSerializationCacheForFaces(
+  const std::vector<mdl::BrushFaceHandle>& faceHandles)
+{
+  for (const auto& faceHandle : faceHandles)
+  {
+    m_serializationCache->invalidate(faceHandle.node());
+  }
+}
+
 bool MapDocument::persistent() const
 {
   return m_path.is_absolute() && io::Disk::pathInfo(m_path) == io::PathInfo::File;
@@ -5324,6 +5464,14 @@ void MapDocument::connectObservers()
     modsDidChangeNotifier.connect(this, &MapDocument::updateAllFaceTags);
   m_notifierConnection += resourcesWereProcessedNotifier.connect(
     this, &MapDocument::updateFaceTagsAfterResourcesWhereProcessed);
+
+  // serialization cache
+  m_notifierConnection += nodesWillBeRemovedNotifier.connect(
+    this, &MapDocument::invalidateSerializationCache);
+  m_notifierConnection +=
+    nodesDidChangeNotifier.connect(this, &MapDocument::invalidateSerializationCache);
+  m_notifierConnection += brushFacesDidChangeNotifier.connect(
+    this, &MapDocument::invalidateSerializationCacheForFaces);
 }
 
 void MapDocument::materialCollectionsWillChange()
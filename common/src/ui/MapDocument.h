@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "NotificationBatch.h"
 #include "Notifier.h"
 #include "NotifierConnection.h"
 #include "Result.h"
@@ -38,6 +39,7 @@
 #include "vm/util.h"
 
 #include <filesystem>
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <optional>
@@ -54,6 +56,11 @@ namespace tb
 class Color;
 } // namespace tb
 
+namespace tb::io
+{
+class NodeSerializationCache;
+} // namespace tb::io
+
 namespace tb::mdl
 {
 class Brush;
@@ -135,6 +142,12 @@ protected:
   std::unique_ptr<mdl::EditorContext> m_editorContext;
   std::unique_ptr<Grid> m_grid;
 
+  /*
+   * Retains the serialized text of brushes and patches between saves so that saving
+   * only needs to serialize the nodes that changed since the last save.
+   */
+  std::unique_ptr<io::NodeSerializationCache> m_serializationCache;
+
   using ActionList = std::vector<Action>;
   ActionList m_tagActions;
   ActionList m_entityDefinitionActions;
@@ -154,6 +167,20 @@ protected:
 
   ViewEffectsService* m_viewEffectsService = nullptr;
 
+  /*
+   * The directory where parsed entity definitions are cached. If unset, entity
+   * definitions are always parsed and no cache files are written.
+   */
+  std::optional<std::filesystem::path> m_entityDefinitionCacheDirectory;
+
+  /*
+   * The nodes whose contents were swapped since the linked groups were last updated. If
+   * no other changes are pending, then only the nodes corresponding to these nodes are
+   * updated in the linked groups.
+   */
+  std::vector<mdl::Node*> m_nodesWithPendingChanges;
+  bool m_hasUntrackedPendingChanges = false;
+
   /*
    * All actions pushed to this stack can be repeated later. The stack must be
    * primed to be cleared whenever the selection changes. The effect is that
@@ -163,6 +190,12 @@ protected:
    */
   std::unique_ptr<RepeatStack> m_repeatStack;
 
+  /*
+   * Collects the notifications for observers that opt into batching while a transaction
+   * is running and delivers them when the outermost transaction ends.
+   */
+  NotificationBatch m_notificationBatch;
+
 public: // notification
   Notifier<Command&> commandDoNotifier;
   Notifier<Command&> commandDoneNotifier;
@@ -234,6 +267,14 @@ public: // accessors and such
 
   Logger& logger();
 
+  /**
+   * Returns the notification batch that is active while a transaction is running.
+   *
+   * Observers that only need to know that something changed can connect to the node
+   * notifiers through this batch to receive a single notification per transaction.
+   */
+  NotificationBatch& notificationBatch();
+
   std::shared_ptr<mdl::Game> game() const override;
   const vm::bbox3d& worldBounds() const;
   mdl::WorldNode* world() const;
@@ -278,6 +319,8 @@ public:
   const mdl::PortalFile* portalFile() const;
 
   void setViewEffectsService(ViewEffectsService* viewEffectsService);
+  void setEntityDefinitionCacheDirectory(
+    std::optional<std::filesystem::path> entityDefinitionCacheDirectory);
 
 public: // tag and entity definition actions
   template <typename ActionVisitor>
@@ -319,10 +362,20 @@ public: // new, load, save document
   void saveDocument();
   void saveDocumentAs(const std::filesystem::path& path);
   void saveDocumentTo(const std::filesystem::path& path);
+
+  /**
+   * Serializes the entire document including the map header into a string. The returned
+   * string is a consistent snapshot of the document that can be written to disk on a
+   * worker thread while the document continues to be edited.
+   */
+  std::string serializeDocument();
+
   Result<void> exportDocumentAs(const io::ExportOptions& options);
 
 private:
   void doSaveDocument(const std::filesystem::path& path);
+  void writeDocument(std::ostream& stream);
+  void writeBinaryDocument(std::ostream& stream);
   void clearDocument();
 
 public: // text encoding
@@ -512,6 +565,9 @@ public:
 protected:
   void setHasPendingChanges(
     const std::vector<mdl::GroupNode*>& groupNodes, bool hasPendingChanges);
+  void setHasPendingChanges(
+    const std::vector<mdl::GroupNode*>& groupNodes,
+    const std::vector<mdl::Node*>& changedNodes);
   bool updateLinkedGroups();
 
 private:
@@ -799,6 +855,11 @@ private:
   void updateFaceTags(const std::vector<mdl::BrushFaceHandle>& faces);
   void updateAllFaceTags();
 
+private: // serialization cache
+  void invalidateSerializationCache(const std::vector<mdl::Node*>& nodes);
+  void invalidateSerializationCacheForFaces(
+    const std::vector<mdl::BrushFaceHandle>& faceHandles);
+
   void updateFaceTagsAfterResourcesWhereProcessed(
     const std::vector<mdl::ResourceId>& resourceIds);
 
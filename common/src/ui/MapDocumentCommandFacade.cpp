@@ -20,6 +20,8 @@
 #include "MapDocumentCommandFacade.h"
 
 #include "Ensure.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -46,6 +48,7 @@
 #include "kdl/vector_set.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -82,6 +85,7 @@ MapDocumentCommandFacade::MapDocumentCommandFacade(kdl::task_manager& taskManage
   , m_commandProcessor{std::make_unique<CommandProcessor>(*this)}
 {
   connectObservers();
+  updateUndoMemoryBudget();
 }
 
 MapDocumentCommandFacade::~MapDocumentCommandFacade() = default;
@@ -624,6 +628,24 @@ void MapDocumentCommandFacade::connectObservers()
     m_commandProcessor->transactionDoneNotifier.connect(transactionDoneNotifier);
   m_notifierConnection +=
     m_commandProcessor->transactionUndoneNotifier.connect(transactionUndoneNotifier);
+
+  auto& prefs = PreferenceManager::instance();
+  m_notifierConnection += prefs.preferenceDidChangeNotifier.connect(
+    this, &MapDocumentCommandFacade::preferenceDidChange);
+}
+
+void MapDocumentCommandFacade::preferenceDidChange(const std::filesystem::path& path)
+{
+  if (path == Preferences::UndoMemoryBudget.path())
+  {
+    updateUndoMemoryBudget();
+  }
+}
+
+void MapDocumentCommandFacade::updateUndoMemoryBudget()
+{
+  const auto memoryBudget = std::max(pref(Preferences::UndoMemoryBudget), 0);
+  m_commandProcessor->setMemoryBudget(size_t(memoryBudget) * 1024 * 1024);
 }
 
 bool MapDocumentCommandFacade::isCurrentDocumentStateObservable() const
@@ -23,6 +23,7 @@
 #include "mdl/NodeContents.h"
 #include "ui/MapDocument.h"
 
+#include <filesystem>
 #include <map>
 #include <memory>
 #include <string>
@@ -115,6 +116,9 @@ private: // notification
   void connectObservers();
   void documentWasNewed(MapDocument* document);
   void documentWasLoaded(MapDocument* document);
+  void preferenceDidChange(const std::filesystem::path& path);
+
+  void updateUndoMemoryBudget();
 
 private: // implement MapDocument interface
   bool isCurrentDocumentStateObservable() const override;
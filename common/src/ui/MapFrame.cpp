@@ -43,6 +43,7 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "TrenchBroomApp.h"
+#include "io/DiskIO.h"
 #include "io/ExportOptions.h"
 #include "io/PathQt.h"
 #include "mdl/BrushFace.h"
@@ -95,6 +96,7 @@
 
 #include "kdl/overload.h"
 #include "kdl/range_to_vector.h"
+#include "kdl/result.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
 
@@ -188,7 +190,9 @@ MapFrame::~MapFrame()
 
   // let's trigger a final autosave before releasing the document
   auto logger = NullLogger{};
+  m_autosaver->finishPendingAutosave(logger);
   m_autosaver->triggerAutosave(logger);
+  m_autosaver->finishPendingAutosave(logger);
 
   m_document->setViewEffectsService(nullptr);
   m_document.reset();
@@ -972,7 +976,10 @@ bool MapFrame::saveDocumentAs()
     const auto fileName = originalPath.filename();
 
     const auto newFileName = QFileDialog::getSaveFileName(
-      this, tr("Save map file"), io::pathAsQPath(originalPath), "Map files (*.map)");
+      this,
+      tr("Save map file"),
+      io::pathAsQPath(originalPath),
+      "Map files (*.map);;Binary map files (*.tbmap)");
     if (newFileName.isEmpty())
     {
       return false;
@@ -1032,7 +1039,10 @@ bool MapFrame::exportDocumentAsMap()
   const auto& originalPath = m_document->path();
 
   const auto newFileName = QFileDialog::getSaveFileName(
-    this, tr("Export Map file"), io::pathAsQPath(originalPath), "Map files (*.map)");
+    this,
+    tr("Export Map file"),
+    io::pathAsQPath(originalPath),
+    "Map files (*.map);;Binary map files (*.tbmap)");
   if (newFileName.isEmpty())
   {
     return false;
@@ -2095,6 +2105,40 @@ bool MapFrame::currentViewMaximized() const
   return m_mapView->currentViewMaximized();
 }
 
+void MapFrame::toggleRenderStatistics()
+{
+  togglePref(Preferences::ShowRenderStatistics);
+}
+
+void MapFrame::dumpRenderStatistics()
+{
+  // statistics are only recorded while they are shown
+  const auto& statistics = currentMapViewBase()->renderStatistics();
+  if (statistics.history().empty())
+  {
+    logger().warn()
+      << "No render statistics were recorded, enable View > Show Render Statistics first";
+    return;
+  }
+
+  const auto fileName = QFileDialog::getSaveFileName(
+    this, tr("Dump Render Statistics"), "RenderStatistics.csv", "CSV files (*.csv)");
+  if (fileName.isEmpty())
+  {
+    return;
+  }
+
+  const auto path = io::pathFromQString(fileName);
+  io::Disk::withOutputStream(path, [&](auto& stream) { statistics.writeCsv(stream); })
+    | kdl::transform([&]() {
+        logger().info() << "Wrote render statistics of " << statistics.history().size()
+                        << " frames to " << path;
+      })
+    | kdl::transform_error([&](const auto& e) {
+        logger().error() << "Could not write render statistics: " << e.msg;
+      });
+}
+
 void MapFrame::showCompileDialog()
 {
   if (!m_compilationDialog)
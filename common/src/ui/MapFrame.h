@@ -383,6 +383,9 @@ public:
   void toggleMaximizeCurrentView();
   bool currentViewMaximized() const;
 
+  void toggleRenderStatistics();
+  void dumpRenderStatistics();
+
   void showCompileDialog();
   bool closeCompileDialog();
 
@@ -74,15 +74,26 @@
 #include "kdl/memory_utils.h"
 #include "kdl/string_compare.h"
 #include "kdl/string_format.h"
+#include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/polygon.h"
 #include "vm/util.h"
 
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace tb::ui
 {
+namespace
+{
+
+// the overlay shows the average of this many frames to keep the numbers readable
+constexpr auto RenderStatisticsOverlayFrameCount = size_t(30);
+
+} // namespace
+
 const int MapViewBase::DefaultCameraAnimationDuration = 250;
 
 MapViewBase::MapViewBase(
@@ -126,6 +137,11 @@ void MapViewBase::setIsCurrent(const bool isCurrent)
   m_isCurrent = isCurrent;
 }
 
+const render::RenderStatistics& MapViewBase::renderStatistics() const
+{
+  return m_renderStatistics;
+}
+
 void MapViewBase::bindEvents()
 {
   connect(
@@ -1011,15 +1027,27 @@ void MapViewBase::renderContents()
       ? vm::bbox3f{document->softMapBounds().bounds.value_or(vm::bbox3d{})}
       : vm::bbox3f{});
 
+  // statistics are only collected while they are shown in the overlay
+  const auto collectStatistics = pref(Preferences::ShowRenderStatistics);
+  auto scopedStatistics = std::optional<render::ScopedRenderStatistics>{};
+  if (collectStatistics)
+  {
+    m_renderStatistics.beginFrame();
+    scopedStatistics.emplace(m_renderStatistics);
+  }
+
   setupGL(renderContext);
   setRenderOptions(renderContext);
 
-  auto renderBatch = render::RenderBatch{vboManager()};
+  auto renderBatch = render::RenderBatch{vboManager(), &m_renderStatistics};
 
+  renderBatch.beginPass("Grid");
   renderGrid(renderContext, renderBatch);
   renderMap(m_renderer, renderContext, renderBatch);
+  renderBatch.beginPass("Tools");
   renderTools(m_toolBox, renderContext, renderBatch);
 
+  renderBatch.beginPass("Overlays");
   renderCoordinateSystem(renderContext, renderBatch);
   renderSoftWorldBounds(renderContext, renderBatch);
   renderPointFile(renderContext, renderBatch);
@@ -1028,6 +1056,10 @@ void MapViewBase::renderContents()
   renderFPS(renderContext, renderBatch);
 
   renderBatch.render(renderContext);
+  if (collectStatistics)
+  {
+    m_renderStatistics.endFrame();
+  }
 
   if (document->needsResourceProcessing())
   {
@@ -1143,10 +1175,20 @@ void MapViewBase::renderCompass(render::RenderBatch& renderBatch)
 void MapViewBase::renderFPS(
   render::RenderContext& renderContext, render::RenderBatch& renderBatch)
 {
+  auto lines = std::vector<std::string>{};
   if (pref(Preferences::ShowFPS))
+  {
+    lines.push_back(m_currentFPS);
+  }
+  if (pref(Preferences::ShowRenderStatistics))
+  {
+    lines.push_back(m_renderStatistics.summary(RenderStatisticsOverlayFrameCount));
+  }
+
+  if (!lines.empty())
   {
     auto renderService = render::RenderService{renderContext, renderBatch};
-    renderService.renderHeadsUp(m_currentFPS);
+    renderService.renderHeadsUp(kdl::str_join(lines, "\n"));
   }
 }
 
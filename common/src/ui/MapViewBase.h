@@ -20,6 +20,7 @@
 #pragma once
 
 #include "NotifierConnection.h"
+#include "render/RenderStatistics.h"
 #include "ui/ActionContext.h"
 #include "ui/CameraLinkHelper.h"
 #include "ui/MapView.h"
@@ -91,6 +92,8 @@ private:
   std::unique_ptr<render::Compass> m_compass;
   std::unique_ptr<render::PrimitiveRenderer> m_portalFileRenderer;
 
+  render::RenderStatistics m_renderStatistics;
+
   /**
    * Tracks whether this map view has most recently gotten the focus. This is tracked and
    * updated by a MapViewActivationTracker instance.
@@ -134,6 +137,8 @@ public:
 
   virtual render::Camera& camera() = 0;
 
+  const render::RenderStatistics& renderStatistics() const;
+
 private:
   void bindEvents();
   void connectObservers();
@@ -215,14 +215,17 @@ void MaterialBrowser::connectObservers()
     document->documentWasNewedNotifier.connect(this, &MaterialBrowser::documentWasNewed);
   m_notifierConnection += document->documentWasLoadedNotifier.connect(
     this, &MaterialBrowser::documentWasLoaded);
-  m_notifierConnection +=
-    document->nodesWereAddedNotifier.connect(this, &MaterialBrowser::nodesWereAdded);
-  m_notifierConnection +=
-    document->nodesWereRemovedNotifier.connect(this, &MaterialBrowser::nodesWereRemoved);
-  m_notifierConnection +=
-    document->nodesDidChangeNotifier.connect(this, &MaterialBrowser::nodesDidChange);
-  m_notifierConnection += document->brushFacesDidChangeNotifier.connect(
-    this, &MaterialBrowser::brushFacesDidChange);
+
+  // node changes only affect the material usage counts, so they are batched
+  auto& batch = document->notificationBatch();
+  m_notifierConnection += batch.connect(
+    document->nodesWereAddedNotifier, this, &MaterialBrowser::nodesWereAdded);
+  m_notifierConnection += batch.connect(
+    document->nodesWereRemovedNotifier, this, &MaterialBrowser::nodesWereRemoved);
+  m_notifierConnection += batch.connect(
+    document->nodesDidChangeNotifier, this, &MaterialBrowser::nodesDidChange);
+  m_notifierConnection += batch.connect(
+    document->brushFacesDidChangeNotifier, this, &MaterialBrowser::brushFacesDidChange);
   m_notifierConnection += document->materialCollectionsDidChangeNotifier.connect(
     this, &MaterialBrowser::materialCollectionsDidChange);
   m_notifierConnection += document->currentMaterialNameDidChangeNotifier.connect(
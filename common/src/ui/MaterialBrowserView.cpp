@@ -41,14 +41,13 @@
 #include "ui/MapDocument.h"
 
 #include "kdl/memory_utils.h"
-#include "kdl/string_compare.h"
-#include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/mat.h"
 #include "vm/mat_ext.h"
 #include "vm/vec.h"
 
+#include <any>
 #include <string>
 #include <vector>
 
@@ -64,7 +63,9 @@ MaterialBrowserView::MaterialBrowserView(
 {
   auto document = kdl::mem_lock(m_document);
   m_notifierConnection += document->materialUsageCountsDidChangeNotifier.connect(
-    this, &MaterialBrowserView::reloadMaterials);
+    this, &MaterialBrowserView::materialUsageCountsDidChange);
+  m_notifierConnection += document->materialCollectionsDidChangeNotifier.connect(
+    this, &MaterialBrowserView::materialCollectionsDidChange);
   m_notifierConnection += document->resourcesWereProcessedNotifier.connect(
     this, &MaterialBrowserView::resourcesWereProcessed);
 }
@@ -126,9 +127,8 @@ void MaterialBrowserView::setSelectedMaterial(const mdl::Material* selectedMater
 
 void MaterialBrowserView::revealMaterial(const mdl::Material* material)
 {
-  scrollToCell([&](const Cell& cell) {
-    const auto& cellMaterial = cellData(cell);
-    return &cellMaterial == material;
+  scrollToCell([&](const std::any& item) {
+    return std::any_cast<const mdl::Material*>(item) == material;
   });
 }
 
@@ -149,6 +149,18 @@ void MaterialBrowserView::resourcesWereProcessed(const std::vector<mdl::Resource
   reloadMaterials();
 }
 
+void MaterialBrowserView::materialUsageCountsDidChange()
+{
+  m_materialIndex.invalidateUsageOrder();
+  reloadMaterials();
+}
+
+void MaterialBrowserView::materialCollectionsDidChange()
+{
+  m_indexedCollections.clear();
+  reloadMaterials();
+}
+
 void MaterialBrowserView::reloadMaterials()
 {
   invalidate();
@@ -166,6 +178,7 @@ void MaterialBrowserView::doInitLayout(Layout& layout)
   layout.setTitleMargin(2.0f);
   layout.setCellWidth(scaleFactor * 64.0f, scaleFactor * 64.0f);
   layout.setCellHeight(scaleFactor * 64.0f, scaleFactor * 128.0f);
+  layout.setVirtualized(true);
 }
 
 void MaterialBrowserView::doReloadLayout(Layout& layout)
@@ -176,22 +189,37 @@ void MaterialBrowserView::doReloadLayout(Layout& layout)
 
   const auto font = render::FontDescriptor{fontPath, size_t(fontSize)};
 
+  validateMaterialIndex();
+
+  const auto& materials = m_materialIndex.materials();
+  const auto positions = getMaterials();
+
   if (m_group)
   {
-    for (const auto* collection : getCollections())
+    auto groupedMaterials =
+      std::vector<std::vector<const mdl::Material*>>(m_indexedCollections.size());
+    for (const auto position : positions)
     {
-      const auto groupName = collection->path().string();
+      groupedMaterials[m_materialCollectionIndices[position]].push_back(
+        materials[position]);
+    }
+
+    for (size_t i = 0; i < m_indexedCollections.size(); ++i)
+    {
+      const auto groupName = m_indexedCollections[i].collection->path().string();
       layout.addGroup(groupName, float(fontSize) + 2.0f);
       
       if (!isGroupCollapsed(groupName))
       {
-        addMaterialsToLayout(layout, getMaterials(*collection), font);
+        addMaterialsToLayout(layout, groupedMaterials[i], font);
       }
     }
   }
   else
   {
-    addMaterialsToLayout(layout, getMaterials(), font);
+    const auto sortedMaterials = kdl::vec_transform(
+      positions, [&](const auto position) { return materials[position]; });
+    addMaterialsToLayout(layout, sortedMaterials, font);
   }
 }
 
@@ -244,66 +272,67 @@ std::vector<const mdl::MaterialCollection*> MaterialBrowserView::getCollections(
   return result;
 }
 
-std::vector<const mdl::Material*> MaterialBrowserView::getMaterials(
-  const mdl::MaterialCollection& collection) const
+void MaterialBrowserView::validateMaterialIndex()
 {
-  return sortMaterials(filterMaterials(
-    kdl::vec_transform(collection.materials(), [](const auto& t) { return &t; })));
-}
+  const auto collections = getCollections();
+  auto indexedCollections = kdl::vec_transform(collections, [](const auto* collection) {
+    return IndexedCollection{
+      collection, collection->materials().data(), collection->materials().size()};
+  });
 
-std::vector<const mdl::Material*> MaterialBrowserView::getMaterials() const
-{
-  auto document = kdl::mem_lock(m_document);
-  auto materials = std::vector<const mdl::Material*>{};
-  for (const auto& collection : getCollections())
+  if (indexedCollections != m_indexedCollections)
   {
-    for (const auto& material : collection->materials())
+    auto materials = std::vector<const mdl::Material*>{};
+    auto collectionIndices = std::unordered_map<const mdl::Material*, size_t>{};
+    for (size_t i = 0; i < collections.size(); ++i)
     {
-      materials.push_back(&material);
+      for (const auto& material : collections[i]->materials())
+      {
+        materials.push_back(&material);
+        collectionIndices[&material] = i;
+      }
     }
+
+    m_materialIndex = mdl::MaterialNameIndex{std::move(materials)};
+    m_materialCollectionIndices = kdl::vec_transform(
+      m_materialIndex.materials(),
+      [&](const auto* material) { return collectionIndices[material]; });
+    m_indexedCollections = std::move(indexedCollections);
   }
-  return sortMaterials(filterMaterials(materials));
 }
 
-std::vector<const mdl::Material*> MaterialBrowserView::filterMaterials(
-  std::vector<const mdl::Material*> materials) const
+std::vector<size_t> MaterialBrowserView::getMaterials()
 {
+  const auto& materials = m_materialIndex.materials();
+
+  // the index returns the matching materials sorted by name
+  auto positions = m_materialIndex.find(m_filterText);
   if (m_hideUnused)
   {
-    materials = kdl::vec_erase_if(std::move(materials), [](const auto* material) {
-      return material->usageCount() == 0;
+    positions = kdl::vec_erase_if(std::move(positions), [&](const auto position) {
+      return materials[position]->usageCount() == 0;
     });
   }
-  if (!m_filterText.empty())
-  {
-    materials = kdl::vec_erase_if(std::move(materials), [&](const auto* material) {
-      return !kdl::all_of(kdl::str_split(m_filterText, " "), [&](const auto& pattern) {
-        return kdl::ci::str_contains(material->name(), pattern);
-      });
-    });
-  }
-  return materials;
-}
-
-std::vector<const mdl::Material*> MaterialBrowserView::sortMaterials(
-  std::vector<const mdl::Material*> materials) const
-{
-  const auto compareNames = [](const auto& lhs, const auto& rhs) {
-    return kdl::ci::string_less{}(lhs->name(), rhs->name());
-  };
 
-  switch (m_sortOrder)
+  if (m_sortOrder == MaterialSortOrder::Usage)
   {
-  case MaterialSortOrder::Name:
-    return kdl::vec_sort(std::move(materials), compareNames);
-  case MaterialSortOrder::Usage:
-    return kdl::vec_sort(std::move(materials), [&](const auto* lhs, const auto* rhs) {
-      return lhs->usageCount() < rhs->usageCount()   ? false
-             : lhs->usageCount() > rhs->usageCount() ? true
-                                                     : compareNames(lhs, rhs);
-    });
-    switchDefault();
+    auto selected = std::vector<bool>(materials.size(), false);
+    for (const auto position : positions)
+    {
+      selected[position] = true;
+    }
+
+    positions.clear();
+    for (const auto position : m_materialIndex.usageOrder())
+    {
+      if (selected[position])
+      {
+        positions.push_back(position);
+      }
+    }
   }
+
+  return positions;
 }
 
 void MaterialBrowserView::doClear() {}
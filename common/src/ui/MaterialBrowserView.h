@@ -20,6 +20,7 @@
 #pragma once
 
 #include "NotifierConnection.h"
+#include "mdl/MaterialNameIndex.h"
 #include "render/FontDescriptor.h"
 #include "ui/CellView.h"
 
@@ -54,6 +55,19 @@ class MaterialBrowserView : public CellView
 {
   Q_OBJECT
 private:
+  /**
+   * Identifies an enabled material collection and the materials it contained when the
+   * material index was built. Used to detect when the index must be rebuilt.
+   */
+  struct IndexedCollection
+  {
+    const mdl::MaterialCollection* collection;
+    const mdl::Material* materials;
+    size_t materialCount;
+
+    bool operator==(const IndexedCollection& other) const = default;
+  };
+
   std::weak_ptr<MapDocument> m_document;
   bool m_group = false;
   bool m_hideUnused = false;
@@ -63,6 +77,11 @@ private:
   const mdl::Material* m_selectedMaterial = nullptr;
   std::unordered_map<std::string, bool> m_collapsedGroups;
 
+  mdl::MaterialNameIndex m_materialIndex;
+  std::vector<IndexedCollection> m_indexedCollections;
+  // the index of the collection of each material, in the order of the material index
+  std::vector<size_t> m_materialCollectionIndices;
+
   NotifierConnection m_notifierConnection;
 
 public:
@@ -87,6 +106,8 @@ public:
 
 private:
   void resourcesWereProcessed(const std::vector<mdl::ResourceId>& resources);
+  void materialUsageCountsDidChange();
+  void materialCollectionsDidChange();
 
   void reloadMaterials();
 
@@ -101,14 +122,13 @@ private:
     Layout& layout, const mdl::Material& material, const render::FontDescriptor& font);
 
   std::vector<const mdl::MaterialCollection*> getCollections() const;
-  std::vector<const mdl::Material*> getMaterials(
-    const mdl::MaterialCollection& collection) const;
-  std::vector<const mdl::Material*> getMaterials() const;
-
-  std::vector<const mdl::Material*> filterMaterials(
-    std::vector<const mdl::Material*> materials) const;
-  std::vector<const mdl::Material*> sortMaterials(
-    std::vector<const mdl::Material*> materials) const;
+  void validateMaterialIndex();
+
+  /**
+   * Returns the positions in the material index of the materials to show, filtered and
+   * sorted according to the current settings.
+   */
+  std::vector<size_t> getMaterials();
 
   void doClear() override;
   void doRender(Layout& layout, float y, float height) override;
@@ -103,13 +103,20 @@ RenderView::RenderView(GLContextManager& contextManager, QWidget* parent)
     m_maxFrameTimeMsecs = 0;
     m_lastFPSCounterUpdate = currentTime;
 
+    auto& vboManager = m_glContext->vboManager();
+    const auto& uploadStats = vboManager.uploadStats();
     m_currentFPS = fmt::format(
-      R"(Avg FPS: {} Max time between frames: {}ms. {} currentVBOS({} peak) totalling {} KiB)",
+      R"(Avg FPS: {} Max time between frames: {}ms. {} currentVBOS({} peak) totalling {} KiB. Uploaded {} KiB in {} writes ({} KiB streamed, {} stalls))",
       avgFps,
       maxFrameTime,
-      m_glContext->vboManager().currentVboCount(),
-      m_glContext->vboManager().peakVboCount(),
-      m_glContext->vboManager().currentVboSize() / 1024u);
+      vboManager.currentVboCount(),
+      vboManager.peakVboCount(),
+      vboManager.currentVboSize() / 1024u,
+      uploadStats.uploadedBytes / 1024u,
+      uploadStats.uploadCount,
+      uploadStats.streamedBytes / 1024u,
+      uploadStats.stallCount);
+    vboManager.resetUploadStats();
   });
 
   fpsCounter->start(1000);
@@ -266,6 +273,7 @@ void RenderView::render()
   clearBackground();
   renderContents();
   renderFocusIndicator();
+  vboManager().endFrame();
 }
 
 void RenderView::processInput()
@@ -41,6 +41,21 @@ ReparentNodesCommand::ReparentNodesCommand(
 {
 }
 
+size_t ReparentNodesCommand::memorySize() const
+{
+  // the reparented nodes are always owned by the document, so only the maps count
+  auto result = UpdateLinkedGroupsCommandBase::memorySize();
+  for (const auto& [parent, children] : m_nodesToAdd)
+  {
+    result += children.size() * sizeof(mdl::Node*);
+  }
+  for (const auto& [parent, children] : m_nodesToRemove)
+  {
+    result += children.size() * sizeof(mdl::Node*);
+  }
+  return result;
+}
+
 std::unique_ptr<CommandResult> ReparentNodesCommand::doPerformDo(
   MapDocumentCommandFacade& document)
 {
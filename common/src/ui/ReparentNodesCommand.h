@@ -50,6 +50,8 @@ public:
     std::map<mdl::Node*, std::vector<mdl::Node*>> nodesToAdd,
     std::map<mdl::Node*, std::vector<mdl::Node*>> nodesToRemove);
 
+  size_t memorySize() const override;
+
 private:
   std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade& document) override;
   std::unique_ptr<CommandResult> doPerformUndo(
@@ -24,13 +24,18 @@
 
 #include "kdl/vector_utils.h"
 
+#include <unordered_map>
+
 namespace tb::ui
 {
 
 SwapNodeContentsCommand::SwapNodeContentsCommand(
   std::string name, std::vector<std::pair<mdl::Node*, mdl::NodeContents>> nodes)
   : UpdateLinkedGroupsCommandBase{std::move(name), true}
-  , m_nodes{std::move(nodes)}
+  , m_nodes{kdl::vec_transform(nodes, [](const auto& pair) { return pair.first; })}
+  , m_contents{kdl::vec_transform(std::move(nodes), [](auto pair) {
+    return mdl::NodeContentsDelta{std::move(pair.second)};
+  })}
 {
 }
 
@@ -39,14 +44,14 @@ SwapNodeContentsCommand::~SwapNodeContentsCommand() = default;
 std::unique_ptr<CommandResult> SwapNodeContentsCommand::doPerformDo(
   MapDocumentCommandFacade& document)
 {
-  document.performSwapNodeContents(m_nodes);
+  swapContents(document);
   return std::make_unique<CommandResult>(true);
 }
 
 std::unique_ptr<CommandResult> SwapNodeContentsCommand::doPerformUndo(
   MapDocumentCommandFacade& document)
 {
-  document.performSwapNodeContents(m_nodes);
+  swapContents(document);
   return std::make_unique<CommandResult>(true);
 }
 
@@ -54,18 +59,67 @@ bool SwapNodeContentsCommand::doCollateWith(UndoableCommand& command)
 {
   if (auto* other = dynamic_cast<SwapNodeContentsCommand*>(&command))
   {
-    auto myNodes =
-      kdl::vec_transform(m_nodes, [](const auto& pair) { return pair.first; });
-    auto theirNodes =
-      kdl::vec_transform(other->m_nodes, [](const auto& pair) { return pair.first; });
+    auto myNodes = m_nodes;
+    auto theirNodes = other->m_nodes;
 
     kdl::vec_sort(myNodes);
     kdl::vec_sort(theirNodes);
 
-    return myNodes == theirNodes;
+    if (myNodes != theirNodes)
+    {
+      return false;
+    }
+
+    // Our contents are encoded relative to the node contents before the other command
+    // was performed, so they must be encoded again relative to the current contents.
+    auto theirIndices = std::unordered_map<mdl::Node*, size_t>{};
+    for (size_t i = 0; i < other->m_nodes.size(); ++i)
+    {
+      theirIndices[other->m_nodes[i]] = i;
+    }
+
+    m_contentsMemorySize = 0;
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+      auto* node = m_nodes[i];
+      auto& theirContents = other->m_contents[theirIndices[node]];
+
+      auto reference = std::move(theirContents).decode(*node);
+      auto contents = std::move(m_contents[i]).decode(reference);
+      m_contents[i] = mdl::NodeContentsDelta::encode(std::move(contents), *node);
+      m_contentsMemorySize += m_contents[i].memorySize();
+    }
+
+    return true;
   }
 
   return false;
 }
 
+size_t SwapNodeContentsCommand::memorySize() const
+{
+  return UpdateLinkedGroupsCommandBase::memorySize() + m_contentsMemorySize;
+}
+
+void SwapNodeContentsCommand::swapContents(MapDocumentCommandFacade& document)
+{
+  auto nodesToSwap = std::vector<std::pair<mdl::Node*, mdl::NodeContents>>{};
+  nodesToSwap.reserve(m_nodes.size());
+  for (size_t i = 0; i < m_nodes.size(); ++i)
+  {
+    nodesToSwap.emplace_back(m_nodes[i], std::move(m_contents[i]).decode(*m_nodes[i]));
+  }
+
+  document.performSwapNodeContents(nodesToSwap);
+
+  // the swapped contents are encoded relative to the new contents of the nodes
+  m_contents.clear();
+  m_contentsMemorySize = 0;
+  for (auto& [node, contents] : nodesToSwap)
+  {
+    m_contents.push_back(mdl::NodeContentsDelta::encode(std::move(contents), *node));
+    m_contentsMemorySize += m_contents.back().memorySize();
+  }
+}
+
 } // namespace tb::ui
@@ -21,6 +21,7 @@
 
 #include "Macros.h"
 #include "mdl/NodeContents.h"
+#include "mdl/NodeContentsDelta.h"
 #include "ui/UpdateLinkedGroupsCommandBase.h"
 
 #include <memory>
@@ -38,7 +39,15 @@ namespace tb::ui
 class SwapNodeContentsCommand : public UpdateLinkedGroupsCommandBase
 {
 protected:
-  std::vector<std::pair<mdl::Node*, mdl::NodeContents>> m_nodes;
+  std::vector<mdl::Node*> m_nodes;
+
+private:
+  /**
+   * The contents to swap into the nodes. Once the command has been performed, the
+   * contents are encoded relative to the current contents of the nodes to save memory.
+   */
+  std::vector<mdl::NodeContentsDelta> m_contents;
+  size_t m_contentsMemorySize = 0;
 
 public:
   SwapNodeContentsCommand(
@@ -51,6 +60,11 @@ public:
 
   bool doCollateWith(UndoableCommand& command) override;
 
+  size_t memorySize() const override;
+
+private:
+  void swapContents(MapDocumentCommandFacade& document);
+
   deleteCopyAndMove(SwapNodeContentsCommand);
 };
 
@@ -73,6 +73,11 @@ bool UndoableCommand::collateWith(UndoableCommand& command)
   return false;
 }
 
+size_t UndoableCommand::memorySize() const
+{
+  return sizeof(UndoableCommand) + name().size();
+}
+
 bool UndoableCommand::doCollateWith(UndoableCommand&)
 {
   return false;
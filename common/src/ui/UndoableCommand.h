@@ -45,6 +45,12 @@ public:
 
   virtual bool collateWith(UndoableCommand& command);
 
+  /**
+   * Returns an estimate of the number of bytes that this command uses to store the
+   * information required to undo and redo it.
+   */
+  virtual size_t memorySize() const;
+
 protected:
   virtual std::unique_ptr<CommandResult> doPerformUndo(
     MapDocumentCommandFacade& document) = 0;
@@ -22,11 +22,13 @@
 #include "Macros.h"
 #include "ui/UpdateLinkedGroupsCommandBase.h"
 
+#include <optional>
 #include <vector>
 
 namespace tb::mdl
 {
 class GroupNode;
+class Node;
 } // namespace tb::mdl
 
 namespace tb::ui
@@ -35,7 +37,9 @@ namespace tb::ui
 class UpdateLinkedGroupsCommand : public UpdateLinkedGroupsCommandBase
 {
 public:
-  explicit UpdateLinkedGroupsCommand(std::vector<mdl::GroupNode*> changedLinkedGroups);
+  explicit UpdateLinkedGroupsCommand(
+    std::vector<mdl::GroupNode*> changedLinkedGroups,
+    std::optional<std::vector<mdl::Node*>> changedNodes = std::nullopt);
   ~UpdateLinkedGroupsCommand() override;
 
   std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade& document) override;
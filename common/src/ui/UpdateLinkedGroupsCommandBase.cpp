@@ -32,9 +32,10 @@ namespace tb::ui
 UpdateLinkedGroupsCommandBase::UpdateLinkedGroupsCommandBase(
   std::string name,
   const bool updateModificationCount,
-  std::vector<mdl::GroupNode*> changedLinkedGroups)
+  std::vector<mdl::GroupNode*> changedLinkedGroups,
+  std::optional<std::vector<mdl::Node*>> changedNodes)
   : UndoableCommand{std::move(name), updateModificationCount}
-  , m_updateLinkedGroupsHelper{std::move(changedLinkedGroups)}
+  , m_updateLinkedGroupsHelper{std::move(changedLinkedGroups), std::move(changedNodes)}
 {
 }
 
@@ -101,4 +102,9 @@ bool UpdateLinkedGroupsCommandBase::collateWith(UndoableCommand& command)
   return false;
 }
 
+size_t UpdateLinkedGroupsCommandBase::memorySize() const
+{
+  return UndoableCommand::memorySize() + m_updateLinkedGroupsHelper.memorySize();
+}
+
 } // namespace tb::ui
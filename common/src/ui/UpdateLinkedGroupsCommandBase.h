@@ -24,7 +24,9 @@
 #include "ui/UpdateLinkedGroupsHelper.h"
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace tb::ui
 {
@@ -39,7 +41,8 @@ protected:
   UpdateLinkedGroupsCommandBase(
     std::string name,
     bool updateModificationCount,
-    std::vector<mdl::GroupNode*> changedLinkedGroups = {});
+    std::vector<mdl::GroupNode*> changedLinkedGroups = {},
+    std::optional<std::vector<mdl::Node*>> changedNodes = std::nullopt);
 
 public:
   ~UpdateLinkedGroupsCommandBase() override;
@@ -49,6 +52,8 @@ public:
 
   bool collateWith(UndoableCommand& command) override;
 
+  size_t memorySize() const override;
+
 private:
   deleteCopyAndMove(UpdateLinkedGroupsCommandBase);
 };
@@ -22,6 +22,7 @@
 #include "mdl/GroupNode.h"
 #include "mdl/LinkedGroupUtils.h"
 #include "mdl/ModelUtils.h"
+#include "mdl/NodeContentsDelta.h"
 #include "ui/MapDocumentCommandFacade.h"
 
 #include "kdl/overload.h"
@@ -60,8 +61,9 @@ bool checkLinkedGroupsToUpdate(const std::vector<mdl::GroupNode*>& changedLinked
 }
 
 UpdateLinkedGroupsHelper::UpdateLinkedGroupsHelper(
-  ChangedLinkedGroups changedLinkedGroups)
+  ChangedLinkedGroups changedLinkedGroups, ChangedNodes changedNodes)
   : m_state{kdl::vec_sort(std::move(changedLinkedGroups), compareByAncestry)}
+  , m_changedNodes{std::move(changedNodes)}
 {
 }
 
@@ -71,18 +73,18 @@ Result<void> UpdateLinkedGroupsHelper::applyLinkedGroupUpdates(
   MapDocumentCommandFacade& document)
 {
   return computeLinkedGroupUpdates(document)
-         | kdl::transform([&]() { doApplyOrUndoLinkedGroupUpdates(document); });
+         | kdl::transform([&]() { doApplyLinkedGroupUpdates(document); });
 }
 
 void UpdateLinkedGroupsHelper::undoLinkedGroupUpdates(MapDocumentCommandFacade& document)
 {
-  doApplyOrUndoLinkedGroupUpdates(document);
+  doUndoLinkedGroupUpdates(document);
 }
 
 void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
 {
   // Both helpers have already applied their changes at this point, so in both helpers,
-  // m_linkedGroups contains pairs p where
+  // childrenToReplace contains pairs p where
   // - p.first is the group node to update
   // - p.second is a vector containing the group node's original children
   //
@@ -94,22 +96,79 @@ void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
   // we will add p_o to our updates and remove it from the other helper's updates to
   // prevent the replaced node to be deleted with the other helper.
 
+  //
+  // Similarly, nodesToSwap contains pairs of nodes and their original contents. We keep
+  // the original contents stored in this helper if both helpers swapped the same node.
+  // If the other helper swapped the contents of a node that was created by one of our
+  // replacements, then undoing our replacement restores the original node anyway, so we
+  // discard the other helper's original contents.
+
   auto& myLinkedGroupUpdates = std::get<LinkedGroupUpdates>(m_state);
   auto& theirLinkedGroupUpdates = std::get<LinkedGroupUpdates>(other.m_state);
 
-  for (auto& [theirGroupNodeToUpdate_, theirOldChildren] : theirLinkedGroupUpdates)
+  auto& myChildrenToReplace = myLinkedGroupUpdates.childrenToReplace;
+  auto& mySwappedNodes = myLinkedGroupUpdates.nodesToSwap;
+
+  for (auto& [theirSwappedNode_, theirOldContents] : theirLinkedGroupUpdates.nodesToSwap)
+  {
+    const auto isSwappedByMe = std::ranges::any_of(
+      mySwappedNodes,
+      [theirSwappedNode = theirSwappedNode_](const auto& p) {
+        return p.first == theirSwappedNode;
+      });
+    const auto isReplacedByMe = std::ranges::any_of(
+      myChildrenToReplace,
+      [theirSwappedNode = theirSwappedNode_](const auto& p) {
+        return p.first->isAncestorOf(theirSwappedNode);
+      });
+    if (!isSwappedByMe && !isReplacedByMe)
+    {
+      mySwappedNodes.emplace_back(theirSwappedNode_, std::move(theirOldContents));
+    }
+  }
+
+  for (auto& [theirGroupNodeToUpdate_, theirOldChildren] :
+       theirLinkedGroupUpdates.childrenToReplace)
   {
     const auto myIt = std::ranges::find_if(
-      myLinkedGroupUpdates,
+      myChildrenToReplace,
       [theirGroupNodeToUpdate = theirGroupNodeToUpdate_](const auto& p) {
         return p.first == theirGroupNodeToUpdate;
       });
-    if (myIt == std::end(myLinkedGroupUpdates))
+    if (myIt == std::end(myChildrenToReplace))
     {
-      myLinkedGroupUpdates.emplace_back(
+      myChildrenToReplace.emplace_back(
         theirGroupNodeToUpdate_, std::move(theirOldChildren));
     }
   }
+
+  theirLinkedGroupUpdates.nodesToSwap.clear();
+}
+
+size_t UpdateLinkedGroupsHelper::memorySize() const
+{
+  return std::visit(
+    kdl::overload(
+      [](const ChangedLinkedGroups& changedLinkedGroups) {
+        return changedLinkedGroups.size() * sizeof(mdl::GroupNode*);
+      },
+      [](const LinkedGroupUpdates& linkedGroupUpdates) {
+        auto result = size_t(0);
+        for (const auto& [node, contents] : linkedGroupUpdates.nodesToSwap)
+        {
+          result += sizeof(mdl::Node*) + mdl::memorySize(contents);
+        }
+        for (const auto& [groupNode, children] : linkedGroupUpdates.childrenToReplace)
+        {
+          result += sizeof(mdl::Node*);
+          for (const auto& child : children)
+          {
+            result += sizeof(std::unique_ptr<mdl::Node>) + mdl::memorySize(*child);
+          }
+        }
+        return result;
+      }),
+    m_state);
 }
 
 Result<void> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
@@ -118,7 +177,7 @@ Result<void> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
   return std::visit(
     kdl::overload(
       [&](const ChangedLinkedGroups& changedLinkedGroups) {
-        return computeLinkedGroupUpdates(changedLinkedGroups, document)
+        return computeLinkedGroupUpdates(changedLinkedGroups, m_changedNodes, document)
                | kdl::transform([&](auto&& linkedGroupUpdates) {
                    m_state =
                      std::forward<decltype(linkedGroupUpdates)>(linkedGroupUpdates);
@@ -130,7 +189,9 @@ Result<void> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
 
 Result<UpdateLinkedGroupsHelper::LinkedGroupUpdates> UpdateLinkedGroupsHelper::
   computeLinkedGroupUpdates(
-    const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document)
+    const ChangedLinkedGroups& changedLinkedGroups,
+    const ChangedNodes& changedNodes,
+    MapDocumentCommandFacade& document)
 {
   if (!checkLinkedGroupsToUpdate(changedLinkedGroups))
   {
@@ -138,30 +199,93 @@ Result<UpdateLinkedGroupsHelper::LinkedGroupUpdates> UpdateLinkedGroupsHelper::
   }
 
   const auto& worldBounds = document.worldBounds();
+  auto& taskManager = document.taskManager();
+
+  const auto computeNodesToSwap =
+    [&](const auto& groupNode, const auto& groupNodesToUpdate) {
+      return changedNodes ? mdl::updateLinkedNodes(
+                              groupNode,
+                              groupNodesToUpdate,
+                              *changedNodes,
+                              worldBounds,
+                              taskManager)
+                          : Result<mdl::UpdateLinkedNodesResult>{
+                              mdl::UpdateLinkedNodesResult{{}, groupNodesToUpdate}};
+    };
+
   return changedLinkedGroups | std::views::transform([&](const auto* groupNode) {
            const auto groupNodesToUpdate = kdl::vec_erase(
              mdl::collectGroupsWithLinkId({document.world()}, groupNode->linkId()),
              groupNode);
 
-           return mdl::updateLinkedGroups(
-             *groupNode, groupNodesToUpdate, worldBounds, document.taskManager());
+           return computeNodesToSwap(*groupNode, groupNodesToUpdate)
+                  | kdl::and_then([&](auto updateLinkedNodesResult) {
+                      return mdl::updateLinkedGroups(
+                               *groupNode,
+                               updateLinkedNodesResult.groupNodesToReplace,
+                               worldBounds,
+                               taskManager)
+                             | kdl::transform([&](auto childrenToReplace) {
+                                 return LinkedGroupUpdates{
+                                   std::move(updateLinkedNodesResult.nodesToSwap),
+                                   std::move(childrenToReplace)};
+                               });
+                    });
          })
-         | kdl::fold
-         | kdl::and_then([&](auto nestedUpdateLists) -> Result<LinkedGroupUpdates> {
-             return kdl::vec_flatten(std::move(nestedUpdateLists));
+         | kdl::fold | kdl::transform([](auto linkedGroupUpdatesList) {
+             auto result = LinkedGroupUpdates{};
+             auto swappedNodes = std::unordered_set<mdl::Node*>{};
+             for (auto& linkedGroupUpdates : linkedGroupUpdatesList)
+             {
+               // Nested linked groups can cause the same node to be updated twice
+               for (auto& [node, contents] : linkedGroupUpdates.nodesToSwap)
+               {
+                 if (swappedNodes.insert(node).second)
+                 {
+                   result.nodesToSwap.emplace_back(node, std::move(contents));
+                 }
+               }
+               result.childrenToReplace = kdl::vec_concat(
+                 std::move(result.childrenToReplace),
+                 std::move(linkedGroupUpdates.childrenToReplace));
+             }
+             return result;
            });
 }
 
-void UpdateLinkedGroupsHelper::doApplyOrUndoLinkedGroupUpdates(
+void UpdateLinkedGroupsHelper::doApplyLinkedGroupUpdates(
   MapDocumentCommandFacade& document)
 {
+  // Swap first because a replacement can detach a swapped node from the document
   std::visit(
     kdl::overload(
       [](const ChangedLinkedGroups&) {},
-      [&](LinkedGroupUpdates&& linkedGroupUpdates) {
-        m_state = document.performReplaceChildren(std::move(linkedGroupUpdates));
+      [&](LinkedGroupUpdates& linkedGroupUpdates) {
+        if (!linkedGroupUpdates.nodesToSwap.empty())
+        {
+          document.performSwapNodeContents(linkedGroupUpdates.nodesToSwap);
+        }
+        linkedGroupUpdates.childrenToReplace = document.performReplaceChildren(
+          std::move(linkedGroupUpdates.childrenToReplace));
       }),
-    std::move(m_state));
+    m_state);
+}
+
+void UpdateLinkedGroupsHelper::doUndoLinkedGroupUpdates(
+  MapDocumentCommandFacade& document)
+{
+  std::visit(
+    kdl::overload(
+      [](const ChangedLinkedGroups&) {},
+      [&](LinkedGroupUpdates& linkedGroupUpdates) {
+        linkedGroupUpdates.childrenToReplace = document.performReplaceChildren(
+          std::move(linkedGroupUpdates.childrenToReplace));
+        if (!linkedGroupUpdates.nodesToSwap.empty())
+        {
+          document.performSwapNodeContents(linkedGroupUpdates.nodesToSwap);
+        }
+      }),
+    m_state);
 }
 
 } // namespace tb::ui
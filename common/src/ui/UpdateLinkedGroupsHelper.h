@@ -20,8 +20,10 @@
 #pragma once
 
 #include "Result.h"
+#include "mdl/NodeContents.h"
 
 #include <memory>
+#include <optional>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -53,29 +55,50 @@ bool checkLinkedGroupsToUpdate(const std::vector<mdl::GroupNode*>& changedLinked
  * updated, and these linked groups are replaced with their replacements. Calling
  * applyLinkedGroupUpdates replaces the replacement nodes with their original
  * corresponding groups again, effectively undoing the change.
+ *
+ * If the helper is also given the nodes whose contents have changed, then only the
+ * corresponding nodes in the linked groups are updated by swapping their contents, as
+ * long as the linked groups have the same structure as the changed groups. The remaining
+ * linked groups have their children replaced as described above.
  */
 class UpdateLinkedGroupsHelper
 {
 private:
   using ChangedLinkedGroups = std::vector<mdl::GroupNode*>;
-  using LinkedGroupUpdates =
-    std::vector<std::pair<mdl::Node*, std::vector<std::unique_ptr<mdl::Node>>>>;
+  using ChangedNodes = std::optional<std::vector<mdl::Node*>>;
+  struct LinkedGroupUpdates
+  {
+    std::vector<std::pair<mdl::Node*, mdl::NodeContents>> nodesToSwap;
+    std::vector<std::pair<mdl::Node*, std::vector<std::unique_ptr<mdl::Node>>>>
+      childrenToReplace;
+  };
   std::variant<ChangedLinkedGroups, LinkedGroupUpdates> m_state;
+  ChangedNodes m_changedNodes;
 
 public:
-  explicit UpdateLinkedGroupsHelper(ChangedLinkedGroups changedLinkedGroups);
+  explicit UpdateLinkedGroupsHelper(
+    ChangedLinkedGroups changedLinkedGroups, ChangedNodes changedNodes = std::nullopt);
   ~UpdateLinkedGroupsHelper();
 
   Result<void> applyLinkedGroupUpdates(MapDocumentCommandFacade& document);
   void undoLinkedGroupUpdates(MapDocumentCommandFacade& document);
   void collateWith(UpdateLinkedGroupsHelper& other);
 
+  /**
+   * Returns an estimate of the number of bytes used by the node contents and the nodes
+   * that this helper has swapped out of the document.
+   */
+  size_t memorySize() const;
+
 private:
   Result<void> computeLinkedGroupUpdates(MapDocumentCommandFacade& document);
   static Result<LinkedGroupUpdates> computeLinkedGroupUpdates(
-    const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document);
+    const ChangedLinkedGroups& changedLinkedGroups,
+    const ChangedNodes& changedNodes,
+    MapDocumentCommandFacade& document);
 
-  void doApplyOrUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
+  void doApplyLinkedGroupUpdates(MapDocumentCommandFacade& document);
+  void doUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
 };
 
 } // namespace tb::ui
@@ -25,13 +25,57 @@
 #include "mdl/Polyhedron.h"
 #include "ui/Grid.h"
 
+#include "vm/bbox.h"
 #include "vm/distance.h"
+#include "vm/intersection.h"
 #include "vm/polygon.h"
 #include "vm/ray.h"
 #include "vm/vec.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace tb::ui
 {
+namespace detail
+{
+
+vm::bbox3d handleBounds(const vm::vec3d& handle)
+{
+  return vm::bbox3d{handle, handle};
+}
+
+vm::bbox3d handleBounds(const vm::segment3d& handle)
+{
+  return vm::merge(vm::bbox3d{handle.start(), handle.start()}, handle.end());
+}
+
+vm::bbox3d handleBounds(const vm::polygon3d& handle)
+{
+  return vm::bbox3d::merge_all(std::begin(handle), std::end(handle));
+}
+
+bool mayPickHandle(
+  const vm::bbox3d& bounds,
+  const vm::ray3d& pickRay,
+  const render::Camera& camera,
+  const double handleRadius)
+{
+  // the perspective scaling factor is linear in the position, so its largest absolute
+  // value within the bounds is attained at one of their corners
+  auto maxScaling = 0.0;
+  for (const auto& corner : bounds.vertices())
+  {
+    const auto scaling = camera.perspectiveScalingFactor(vm::vec3f{corner});
+    maxScaling = std::max(maxScaling, std::abs(double(scaling)));
+  }
+
+  const auto pickBounds = bounds.expand(2.0 * handleRadius * maxScaling);
+  return pickBounds.contains(pickRay.origin)
+         || vm::intersect_ray_bbox(pickRay, pickBounds).has_value();
+}
+
+} // namespace detail
 
 VertexHandleManagerBase::~VertexHandleManagerBase() = default;
 
@@ -42,17 +86,15 @@ void VertexHandleManager::pick(
   const render::Camera& camera,
   mdl::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
-    if (
-      const auto distance = camera.pickPointHandle(
-        pickRay, position, double(pref(Preferences::HandleRadius))))
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
+    if (const auto distance = camera.pickPointHandle(pickRay, position, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *distance);
       const auto error = vm::squared_distance(pickRay, position).distance;
       pickResult.addHit(mdl::Hit(HandleHitType, *distance, hitPoint, position, error));
     }
-  }
+  });
 }
 
 void VertexHandleManager::addHandles(const mdl::BrushNode* brushNode)
@@ -93,19 +135,18 @@ void EdgeHandleManager::pickGridHandle(
   const Grid& grid,
   mdl::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     if (
-      const auto edgeDist = camera.pickLineSegmentHandle(
-        pickRay, position, double(pref(Preferences::HandleRadius))))
+      const auto edgeDist = camera.pickLineSegmentHandle(pickRay, position, handleRadius))
     {
       if (
         const auto pointHandle =
           grid.snap(vm::point_at_distance(pickRay, *edgeDist), position))
       {
         if (
-          const auto pointDist = camera.pickPointHandle(
-            pickRay, *pointHandle, double(pref(Preferences::HandleRadius))))
+          const auto pointDist =
+            camera.pickPointHandle(pickRay, *pointHandle, handleRadius))
         {
           const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
           pickResult.addHit(mdl::Hit{
@@ -113,7 +154,7 @@ void EdgeHandleManager::pickGridHandle(
         }
       }
     }
-  }
+  });
 }
 
 void EdgeHandleManager::pickCenterHandle(
@@ -121,18 +162,16 @@ void EdgeHandleManager::pickCenterHandle(
   const render::Camera& camera,
   mdl::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     const auto pointHandle = position.center();
 
-    if (
-      const auto pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, double(pref(Preferences::HandleRadius))))
+    if (const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
       pickResult.addHit(mdl::Hit{HandleHitType, *pointDist, hitPoint, position});
     }
-  }
+  });
 }
 
 void EdgeHandleManager::addHandles(const mdl::BrushNode* brushNode)
@@ -174,8 +213,8 @@ void FaceHandleManager::pickGridHandle(
   const Grid& grid,
   mdl::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     if (const auto plane = vm::from_points(std::begin(position), std::end(position)))
     {
       if (
@@ -186,8 +225,8 @@ void FaceHandleManager::pickGridHandle(
           grid.snap(vm::point_at_distance(pickRay, *distance), *plane);
 
         if (
-          const auto pointDist = camera.pickPointHandle(
-            pickRay, pointHandle, double(pref(Preferences::HandleRadius))))
+          const auto pointDist =
+            camera.pickPointHandle(pickRay, pointHandle, handleRadius))
         {
           const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
           pickResult.addHit(mdl::Hit{
@@ -195,7 +234,7 @@ void FaceHandleManager::pickGridHandle(
         }
       }
     }
-  }
+  });
 }
 
 void FaceHandleManager::pickCenterHandle(
@@ -203,18 +242,16 @@ void FaceHandleManager::pickCenterHandle(
   const render::Camera& camera,
   mdl::PickResult& pickResult) const
 {
-  for (const auto& [position, info] : m_handles)
-  {
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  forEachPickableHandle(pickRay, camera, handleRadius, [&](const auto& position) {
     const auto pointHandle = position.center();
 
-    if (
-      const auto pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, double(pref(Preferences::HandleRadius))))
+    if (const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
       pickResult.addHit(mdl::Hit{HandleHitType, *pointDist, hitPoint, position});
     }
-  }
+  });
 }
 
 void FaceHandleManager::addHandles(const mdl::BrushNode* brushNode)
@@ -19,13 +19,20 @@
 
 #pragma once
 
+#include "Macros.h"
 #include "mdl/BrushNode.h"
 #include "mdl/HitType.h"
 #include "mdl/PickResult.h"
+#include "octree.h"
 #include "render/Camera.h"
 
 #include "kdl/vector_set.h"
 
+#include "vm/bbox.h"
+#include "vm/polygon.h"
+#include "vm/ray.h"
+#include "vm/segment.h"
+
 #include <iterator>
 #include <map>
 #include <vector>
@@ -39,6 +46,32 @@ namespace tb::ui
 {
 class Grid;
 
+namespace detail
+{
+
+vm::bbox3d handleBounds(const vm::vec3d& handle);
+vm::bbox3d handleBounds(const vm::segment3d& handle);
+vm::bbox3d handleBounds(const vm::polygon3d& handle);
+
+/**
+ * Checks whether the given picking ray may hit a handle whose position lies within the
+ * given bounds. Since the picking radius of a handle depends on its distance to the
+ * camera, the bounds are expanded by the largest picking radius at any of their corners.
+ *
+ * @param bounds the bounds to check
+ * @param pickRay the picking ray
+ * @param camera the camera
+ * @param handleRadius the handle radius
+ * @return true if a handle within the given bounds may be hit by the given picking ray
+ */
+bool mayPickHandle(
+  const vm::bbox3d& bounds,
+  const vm::ray3d& pickRay,
+  const render::Camera& camera,
+  double handleRadius);
+
+} // namespace detail
+
 class VertexHandleManagerBase
 {
 public:
@@ -166,12 +199,21 @@ protected:
 
   using HandleMap = std::map<H, HandleInfo>;
   using HandleEntry = typename HandleMap::value_type;
+  using HandleTree = octree<double, HandleEntry*>;
+
+  static constexpr auto HandleTreeMinSize = 16.0;
 
   /**
    * Maps a handle position to its info.
    */
   HandleMap m_handles;
 
+  /**
+   * Spatial index of the entries of m_handles by the bounds of their handles. Used to
+   * find the handles near a picking ray or a position without visiting every handle.
+   */
+  HandleTree m_handleTree;
+
   /**
    * The total number of selected handles, not counting duplicates.
    */
@@ -179,12 +221,16 @@ protected:
 
 public:
   VertexHandleManagerBaseT()
-    : m_selectedHandleCount(0)
+    : m_handleTree(HandleTreeMinSize)
+    , m_selectedHandleCount(0)
   {
   }
 
   ~VertexHandleManagerBaseT() override {}
 
+  // m_handleTree stores pointers to the entries of m_handles
+  deleteCopyAndMove(VertexHandleManagerBaseT);
+
 public:
   /**
    * Returns the hit type value of the picking hits reported by this manager.
@@ -316,8 +362,15 @@ public:
    */
   void add(const Handle& handle)
   {
-    m_handles[handle].inc(); // unknown value gets value constructed, which for HandleInfo
-                             // means its default constructor is called
+    // unknown value gets value constructed, which for HandleInfo means its default
+    // constructor is called
+    auto [it, inserted] = m_handles.try_emplace(handle);
+    it->second.inc();
+
+    if (inserted)
+    {
+      m_handleTree.insert(detail::handleBounds(handle), &*it);
+    }
   }
 
   /**
@@ -338,6 +391,7 @@ public:
       if (info.count == 0)
       {
         deselect(info);
+        m_handleTree.remove(&*it);
         m_handles.erase(it);
       }
       return true;
@@ -351,6 +405,7 @@ public:
    */
   void clear()
   {
+    m_handleTree.clear();
     m_handles.clear();
     m_selectedHandleCount = 0;
   }
@@ -458,8 +513,10 @@ private:
   void forEachCloseHandle(const H& otherHandle, F fun)
   {
     static const auto epsilon = 0.001 * 0.001;
-    for (auto& [handle, info] : m_handles)
+    const auto bounds = detail::handleBounds(otherHandle).expand(epsilon);
+    for (auto* entry : m_handleTree.find_intersectors(bounds))
     {
+      auto& [handle, info] = *entry;
       if (compare(otherHandle, handle, epsilon) == 0)
       {
         fun(info);
@@ -499,6 +556,34 @@ private:
     }
   }
 
+protected:
+  /**
+   * Calls the given function for every handle in this manager that may be hit by the
+   * given picking ray. The handles are found using the spatial index, so the function is
+   * called for a superset of the handles that are actually hit.
+   *
+   * @tparam F the type of the function, which must accept a handle
+   * @param pickRay the picking ray
+   * @param camera the camera
+   * @param handleRadius the handle radius
+   * @param fun the function to call
+   */
+  template <typename F>
+  void forEachPickableHandle(
+    const vm::ray3d& pickRay,
+    const render::Camera& camera,
+    const double handleRadius,
+    const F& fun) const
+  {
+    const auto entries = m_handleTree.find_if([&](const vm::bbox3d& bounds) {
+      return detail::mayPickHandle(bounds, pickRay, camera, handleRadius);
+    });
+    for (const auto* entry : entries)
+    {
+      fun(entry->first);
+    }
+  }
+
 public:
   /**
    * Applies the given picking test to all handles in this manager and adds all hits to
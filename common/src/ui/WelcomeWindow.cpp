@@ -138,7 +138,7 @@ void WelcomeWindow::openOtherDocument()
     nullptr,
     tr("Open Map"),
     fileDialogDefaultDirectory(FileDialogDir::Map),
-    "Map files (*.map);;Any files (*.*)");
+    "Map files (*.map *.tbmap);;Any files (*.*)");
   const auto path = io::pathFromQString(pathStr);
 
   if (!path.empty())
@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "el/CompiledExpression.h"
+#include "el/EvaluationContext.h"
+#include "el/Expression.h"
+#include "el/Value.h"
+#include "el/VariableStore.h"
+#include "io/ELParser.h"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::el
+{
+namespace
+{
+
+auto compile(const std::string& expression)
+{
+  return CompiledExpression<Value>{io::ELParser::parseStrict(expression).value()};
+}
+
+} // namespace
+
+TEST_CASE("CompiledExpression")
+{
+  SECTION("variableNames")
+  {
+    using T = std::tuple<std::string, std::vector<std::string>>;
+
+    // clang-format off
+    const auto
+    [expression,                                        expectedVariableNames] = GENERATE(values<T>({
+    {R"("asdf")",                                       {}},
+    {R"(x)",                                            {"x"}},
+    {R"([x, y, x])",                                    {"x", "y"}},
+    {R"({ "a": y, "b": x })",                           {"x", "y"}},
+    {R"(-x + (y * z))",                                 {"x", "y", "z"}},
+    {R"(x[y..z])",                                      {"x", "y", "z"}},
+    {R"({{ spawnflags == 1 -> model, "default.mdl" }})", {"model", "spawnflags"}},
+    }));
+    // clang-format on
+
+    CAPTURE(expression);
+
+    CHECK(compile(expression).variableNames() == expectedVariableNames);
+  }
+
+  SECTION("evaluate")
+  {
+    const auto compiledExpression = compile(R"({{ x == "a" -> "first", y }})");
+
+    auto evaluationCount = 0;
+    const auto evaluate = [&](const auto& expression, const auto& variables) {
+      ++evaluationCount;
+      return withEvaluationContext(
+               [&](auto& context) { return expression.evaluate(context); }, variables)
+        .value();
+    };
+
+    SECTION("Memoizes results for string values")
+    {
+      const auto variables1 = VariableTable{{{"x", Value{"a"}}, {"y", Value{"b"}}}};
+      const auto variables2 = VariableTable{
+        {{"x", Value{"a"}}, {"y", Value{"b"}}, {"z", Value{"unrelated"}}}};
+      const auto variables3 = VariableTable{{{"x", Value{"c"}}, {"y", Value{"b"}}}};
+
+      CHECK(compiledExpression.evaluate(variables1, evaluate) == Value{"first"});
+      CHECK(evaluationCount == 1);
+
+      CHECK(compiledExpression.evaluate(variables2, evaluate) == Value{"first"});
+      CHECK(evaluationCount == 1);
+
+      CHECK(compiledExpression.evaluate(variables3, evaluate) == Value{"b"});
+      CHECK(evaluationCount == 2);
+
+      const auto copy = compiledExpression;
+      CHECK(copy.evaluate(variables3, evaluate) == Value{"b"});
+      CHECK(evaluationCount == 2);
+    }
+
+    SECTION("Distinguishes values with equal string representations")
+    {
+      const auto variables1 = VariableTable{{{"x", Value{"c"}}, {"y", Value{true}}}};
+      const auto variables2 = VariableTable{{{"x", Value{"c"}}, {"y", Value{"true"}}}};
+
+      CHECK(compiledExpression.evaluate(variables1, evaluate) == Value{true});
+      CHECK(compiledExpression.evaluate(variables2, evaluate) == Value{"true"});
+      CHECK(evaluationCount == 2);
+    }
+
+    SECTION("Does not memoize results for number values")
+    {
+      const auto variables = VariableTable{{{"x", Value{"c"}}, {"y", Value{1.0}}}};
+
+      CHECK(compiledExpression.evaluate(variables, evaluate) == Value{1.0});
+      CHECK(compiledExpression.evaluate(variables, evaluate) == Value{1.0});
+      CHECK(evaluationCount == 2);
+    }
+  }
+}
+
+} // namespace tb::el
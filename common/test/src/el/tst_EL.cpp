@@ -22,6 +22,7 @@
 #include "el/Types.h"
 #include "el/Value.h"
 
+#include <functional>
 #include <string>
 
 #include "Catch2.h"
@@ -38,6 +39,28 @@ TEST_CASE("ELTest.constructValues")
   CHECK(Value(ArrayType()).type() == ValueType::Array);
   CHECK(Value(MapType()).type() == ValueType::Map);
   CHECK(Value().type() == ValueType::Null);
+  CHECK(Value(RangeType(BoundedRange(1, 2))).type() == ValueType::Range);
+}
+
+TEST_CASE("ELTest.copyValues")
+{
+  const auto number = Value(1.0);
+  const auto string = Value("test");
+  const auto array = Value(ArrayType{number, string});
+
+  const auto numberCopy = number;
+  const auto stringCopy = string;
+  const auto arrayCopy = array;
+
+  CHECK(numberCopy == number);
+  CHECK(stringCopy == string);
+  CHECK(arrayCopy == array);
+  CHECK(Value(1.0) == number);
+  CHECK(Value(2.0) != number);
+
+  CHECK(std::hash<Value>{}(numberCopy) == std::hash<Value>{}(number));
+  CHECK(std::hash<Value>{}(stringCopy) == std::hash<Value>{}(string));
+  CHECK(std::hash<Value>{}(arrayCopy) == std::hash<Value>{}(array));
 }
 
 TEST_CASE("ELTest.typeConversions")
@@ -0,0 +1,351 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/BinaryMapReader.h"
+#include "io/BinaryMapSerializer.h"
+#include "io/MapHeader.h"
+#include "io/NodeWriter.h"
+#include "io/TestParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include "vm/bbox.h"
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "Catch2.h"
+
+namespace tb::io
+{
+namespace
+{
+
+std::unique_ptr<mdl::WorldNode> readTextMap(
+  const std::string& data,
+  const mdl::MapFormat mapFormat,
+  const vm::bbox3d& worldBounds,
+  kdl::task_manager& taskManager)
+{
+  auto status = TestParserStatus{};
+  auto reader = WorldReader{data, mapFormat, {}};
+  return reader.read(worldBounds, status, taskManager) | kdl::value();
+}
+
+std::string writeTextMap(const mdl::WorldNode& world, kdl::task_manager& taskManager)
+{
+  auto stream = std::stringstream{};
+  auto writer = NodeWriter{world, stream};
+  writer.writeMap(taskManager);
+  return stream.str();
+}
+
+std::string writeBinaryMap(const mdl::WorldNode& world, kdl::task_manager& taskManager)
+{
+  auto stream = std::stringstream{};
+  writeMapHeader(stream, "Test", world.mapFormat());
+
+  auto writer = NodeWriter{
+    world, std::make_unique<BinaryMapSerializer>(stream, world.mapFormat())};
+  writer.writeMap(taskManager);
+  return stream.str();
+}
+
+std::string makeCube(const int x, const int y, const std::string& materialName)
+{
+  return fmt::format(
+    R"({{
+( {0} {1} 0 ) ( {0} {3} 0 ) ( {0} {1} 64 ) {4} 0 0 0 1 1
+( {0} {1} 0 ) ( {0} {1} 64 ) ( {2} {1} 0 ) {4} 0 0 0 1 1
+( {0} {1} 0 ) ( {2} {1} 0 ) ( {0} {3} 0 ) {4} 0 0 0 1 1
+( {2} {3} 64 ) ( {2} {1} 64 ) ( {0} {3} 64 ) {4} 0 0 0 1 1
+( {2} {3} 64 ) ( {0} {3} 64 ) ( {2} {3} 0 ) {4} 0 0 0 1 1
+( {2} {3} 64 ) ( {2} {3} 0 ) ( {2} {1} 64 ) {4} 0 0 0 1 1
+}}
+)",
+    x,
+    y,
+    x + 64,
+    y + 64,
+    materialName);
+}
+
+} // namespace
+
+TEST_CASE("BinaryMap")
+{
+  auto taskManager = kdl::task_manager{};
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  SECTION("Round trip")
+  {
+    using T = std::tuple<mdl::MapFormat, std::string>;
+
+    // clang-format off
+    const auto
+    [mapFormat,                  data] = GENERATE(values<T>({
+    {mdl::MapFormat::Standard,   R"(
+{
+"classname" "worldspawn"
+"message" "a \"quoted\" message"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) METAL4_5 64 0 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) METAL4_5 0 0 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) METAL4_5 0 0 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) METAL4_5 64 0 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) METAL4_5 64 0 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) METAL4_5 64 0 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Layer 1"
+"_tb_id" "1"
+"_tb_layer_sort_index" "0"
+"_tb_layer_color" "0.25 0.75 1 1"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group 1"
+"_tb_id" "2"
+"_tb_layer" "1"
+"_tb_linked_group_id" "abcd"
+"_tb_transformation" "1 0 0 32 0 1 0 0 0 0 1 0 0 0 0 1"
+{
+( 0 0 0 ) ( 0 64 0 ) ( 0 0 64 ) rock 0 0 0 1 1
+( 0 0 0 ) ( 0 0 64 ) ( 64 0 0 ) rock 0 0 0 1 1
+( 0 0 0 ) ( 64 0 0 ) ( 0 64 0 ) rock 0 0 0 1 1
+( 64 64 64 ) ( 64 64 128 ) ( 64 0 64 ) rock 0 0 0 1 1
+( 64 64 64 ) ( 0 64 64 ) ( 64 64 128 ) rock 0 0 0 1 1
+( 64 64 64 ) ( 64 0 64 ) ( 0 64 64 ) rock 0 0 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group 1"
+"_tb_id" "3"
+"_tb_layer" "1"
+"_tb_linked_group_id" "abcd"
+"_tb_transformation" "1 0 0 32 0 1 0 128 0 0 1 0 0 0 0 1"
+{
+( 0 128 0 ) ( 0 192 0 ) ( 0 128 64 ) rock 0 0 0 1 1
+( 0 128 0 ) ( 0 128 64 ) ( 64 128 0 ) rock 0 0 0 1 1
+( 0 128 0 ) ( 64 128 0 ) ( 0 192 0 ) rock 0 0 0 1 1
+( 64 192 64 ) ( 64 192 128 ) ( 64 128 64 ) rock 0 0 0 1 1
+( 64 192 64 ) ( 0 192 64 ) ( 64 192 128 ) rock 0 0 0 1 1
+( 64 192 64 ) ( 64 128 64 ) ( 0 192 64 ) rock 0 0 0 1 1
+}
+}
+{
+"classname" "info_player_start"
+"origin" "32 32 24"
+}
+{
+"classname" "func_door"
+"_tb_layer" "1"
+{
+( 0 0 0 ) ( 0 64 0 ) ( 0 0 64 ) door 0 0 45 0.5 2
+( 0 0 0 ) ( 0 0 64 ) ( 64 0 0 ) door 0 0 0 1 1
+( 0 0 0 ) ( 64 0 0 ) ( 0 64 0 ) door 0 0 0 1 1
+( 64 64 64 ) ( 64 64 128 ) ( 64 0 64 ) door 0 0 0 1 1
+( 64 64 64 ) ( 0 64 64 ) ( 64 64 128 ) door 0 0 0 1 1
+( 64 64 64 ) ( 64 0 64 ) ( 0 64 64 ) door 0 0 0 1 1
+}
+}
+)"},
+    {mdl::MapFormat::Valve,      R"(
+{
+"classname" "worldspawn"
+"mapversion" "220"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) METAL4_5 [ 0.6 0.8 0 64 ] [ 0 -1 0 0 ] 17.5 0.25 4
+}
+}
+)"},
+    {mdl::MapFormat::Quake2,     R"(
+{
+"classname" "worldspawn"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) e1u1/metal 64 0 0 1 1 1 8 100
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) e1u1/metal 0 0 0 1 1 0 0 0
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) e1u1/metal 0 0 0 1 1 0 0 0
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) e1u1/metal 64 0 0 1 1 0 0 0
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) e1u1/metal 64 0 0 1 1 0 0 0
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) e1u1/metal 64 0 0 1 1 0 0 0
+}
+}
+)"},
+    {mdl::MapFormat::Quake3,     R"(
+{
+"classname" "worldspawn"
+{
+patchDef2
+{
+common/caulk
+( 5 3 0 0 0 )
+(
+( (-64 -64 4 0   0 ) (-64 0 4 0   -0.25 ) (-64 64 4 0   -0.5 ) )
+( (  0 -64 4 0.2 0 ) (  0 0 4 0.2 -0.25 ) (  0 64 4 0.2 -0.5 ) )
+( ( 64 -64 4 0.4 0 ) ( 64 0 4 0.4 -0.25 ) ( 64 64 4 0.4 -0.5 ) )
+( (128 -64 4 0.6 0 ) (128 0 4 0.6 -0.25 ) (128 64 4 0.6 -0.5 ) )
+( (192 -64 4 0.8 0 ) (192 0 4 0.8 -0.25 ) (192 64 4 0.8 -0.5 ) )
+)
+}
+}
+}
+)"},
+    }));
+    // clang-format on
+
+    CAPTURE(mapFormat);
+
+    const auto textWorld = readTextMap(data, mapFormat, worldBounds, taskManager);
+    const auto expected = writeTextMap(*textWorld, taskManager);
+
+    const auto binaryData = writeBinaryMap(*textWorld, taskManager);
+    CHECK(isBinaryMap(binaryData));
+
+    auto status = TestParserStatus{};
+    const auto binaryWorld =
+      readBinaryMap(binaryData, worldBounds, {}, status, taskManager) | kdl::value();
+
+    CHECK(binaryWorld->mapFormat() == mapFormat);
+    CHECK(writeTextMap(*binaryWorld, taskManager) == expected);
+    CHECK(status.countStatus(LogLevel::Error) == 0);
+  }
+
+  SECTION("Round trip of a map with several chunks")
+  {
+    auto data = std::string{"{\n\"classname\" \"worldspawn\"\n"};
+    for (int i = 0; i < 2000; ++i)
+    {
+      data += makeCube((i % 100) * 64, (i / 100) * 64, fmt::format("material{}", i % 7));
+    }
+    data += "}\n{\n\"classname\" \"func_detail\"\n";
+    for (int i = 0; i < 1000; ++i)
+    {
+      data += makeCube((i % 100) * 64, -(i / 100 + 1) * 64, "detail");
+    }
+    data += "}\n";
+
+    const auto textWorld =
+      readTextMap(data, mdl::MapFormat::Standard, worldBounds, taskManager);
+    const auto expected = writeTextMap(*textWorld, taskManager);
+
+    const auto binaryData = writeBinaryMap(*textWorld, taskManager);
+
+    auto status = TestParserStatus{};
+    const auto binaryWorld =
+      readBinaryMap(binaryData, worldBounds, {}, status, taskManager) | kdl::value();
+
+    CHECK(binaryWorld->defaultLayer()->childCount() == 2001u);
+    CHECK(writeTextMap(*binaryWorld, taskManager) == expected);
+  }
+
+  SECTION("isBinaryMap")
+  {
+    CHECK(isBinaryMap("TBBINMAP"));
+    CHECK(isBinaryMap("// Game: Quake\n// Format: Standard\nTBBINMAP"));
+    CHECK_FALSE(isBinaryMap(""));
+    CHECK_FALSE(isBinaryMap("// Game: Quake\n// Format: Standard\n{\n}"));
+    CHECK_FALSE(isBinaryMap("// Game: Quake"));
+  }
+
+  SECTION("Invalid data")
+  {
+    const auto world = mdl::WorldNode{{}, {}, mdl::MapFormat::Standard};
+    const auto binaryData = writeBinaryMap(world, taskManager);
+
+    auto status = TestParserStatus{};
+
+    SECTION("Truncated data")
+    {
+      const auto truncatedData = binaryData.substr(0, binaryData.size() - 4);
+      CHECK(
+        readBinaryMap(truncatedData, worldBounds, {}, status, taskManager).is_error());
+    }
+
+    SECTION("Unsupported version")
+    {
+      auto invalidData = binaryData;
+      invalidData[invalidData.find("TBBINMAP") + 8] = 99;
+      CHECK(readBinaryMap(invalidData, worldBounds, {}, status, taskManager).is_error());
+    }
+
+    SECTION("Not a binary map")
+    {
+      CHECK(readBinaryMap("{\n}", worldBounds, {}, status, taskManager).is_error());
+    }
+  }
+
+  SECTION("Corrupt counts")
+  {
+    const auto world = mdl::WorldNode{{}, {}, mdl::MapFormat::Standard};
+    const auto binaryData = writeBinaryMap(world, taskManager);
+    const auto magicPosition = binaryData.find("TBBINMAP");
+
+    const auto readOffset = [&](const size_t position) {
+      auto result = std::uint64_t{};
+      std::memcpy(&result, binaryData.data() + magicPosition + position, sizeof(result));
+      return size_t(result);
+    };
+
+    // the offsets of the string table and the chunk table are stored after the magic,
+    // the version and the map format, followed by the chunk count and the object count
+    const auto stringTableOffset = readOffset(16);
+    const auto chunkTableOffset = readOffset(24);
+    const auto firstChunkOffset = readOffset(chunkTableOffset);
+
+    const auto position = GENERATE_COPY(
+      size_t(32),              // chunk count
+      size_t(36),              // object count
+      stringTableOffset,       // string count
+      firstChunkOffset + 1u);  // property count of the worldspawn entity
+
+    CAPTURE(position);
+
+    auto corruptData = binaryData;
+    const auto invalidCount = std::uint32_t(0xffffffff);
+    std::memcpy(
+      corruptData.data() + magicPosition + position, &invalidCount, sizeof(invalidCount));
+
+    auto status = TestParserStatus{};
+    CHECK(readBinaryMap(corruptData, worldBounds, {}, status, taskManager).is_error());
+  }
+}
+
+} // namespace tb::io
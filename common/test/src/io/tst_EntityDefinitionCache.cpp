@@ -0,0 +1,321 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/DiskIO.h"
+#include "io/EntityDefinitionCache.h"
+#include "io/FgdParser.h"
+#include "io/PathMatcher.h"
+#include "io/Reader.h"
+#include "io/TestEnvironment.h"
+#include "io/TestParserStatus.h"
+#include "io/TraversalMode.h"
+#include "mdl/EntityDefinition.h"
+#include "mdl/PropertyDefinition.h"
+
+#include "kdl/result.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::io
+{
+namespace
+{
+
+auto parseFgd(
+  const std::filesystem::path& path, std::vector<std::filesystem::path>& includedFiles)
+{
+  auto file = Disk::openFile(path) | kdl::value();
+  auto reader = file->reader().buffer();
+
+  auto parser = FgdParser{reader.stringView(), Color{1.0f, 1.0f, 1.0f, 1.0f}, path};
+
+  auto status = TestParserStatus{};
+  auto definitions = parser.parseDefinitions(status) | kdl::value();
+  includedFiles = parser.includedFiles();
+  return definitions;
+}
+
+void checkDefinitionsEqual(
+  const std::vector<std::unique_ptr<mdl::EntityDefinition>>& actual,
+  const std::vector<std::unique_ptr<mdl::EntityDefinition>>& expected)
+{
+  REQUIRE(actual.size() == expected.size());
+  for (size_t i = 0; i < actual.size(); ++i)
+  {
+    const auto& actualDefinition = *actual[i];
+    const auto& expectedDefinition = *expected[i];
+    CAPTURE(expectedDefinition.name());
+
+    CHECK(actualDefinition.type() == expectedDefinition.type());
+    CHECK(actualDefinition.name() == expectedDefinition.name());
+    CHECK(actualDefinition.color() == expectedDefinition.color());
+    CHECK(actualDefinition.description() == expectedDefinition.description());
+
+    const auto& actualProperties = actualDefinition.propertyDefinitions();
+    const auto& expectedProperties = expectedDefinition.propertyDefinitions();
+    REQUIRE(actualProperties.size() == expectedProperties.size());
+    for (size_t j = 0; j < actualProperties.size(); ++j)
+    {
+      CAPTURE(expectedProperties[j]->key());
+      CHECK(actualProperties[j]->equals(expectedProperties[j].get()));
+      CHECK(
+        actualProperties[j]->shortDescription()
+        == expectedProperties[j]->shortDescription());
+      CHECK(
+        mdl::PropertyDefinition::defaultValue(*actualProperties[j])
+        == mdl::PropertyDefinition::defaultValue(*expectedProperties[j]));
+    }
+
+    if (expectedDefinition.type() == mdl::EntityDefinitionType::PointEntity)
+    {
+      const auto& actualPoint =
+        static_cast<const mdl::PointEntityDefinition&>(actualDefinition);
+      const auto& expectedPoint =
+        static_cast<const mdl::PointEntityDefinition&>(expectedDefinition);
+      CHECK(actualPoint.bounds() == expectedPoint.bounds());
+      CHECK(actualPoint.modelDefinition() == expectedPoint.modelDefinition());
+      CHECK(actualPoint.decalDefinition() == expectedPoint.decalDefinition());
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("EntityDefinitionCache")
+{
+  const auto defaultColor = Color{1.0f, 1.0f, 1.0f, 1.0f};
+
+  SECTION("Round trip of all game FGD files")
+  {
+    auto env = TestEnvironment{};
+
+    const auto basePath = std::filesystem::current_path() / "fixture/games/";
+    const auto fgdFiles =
+      Disk::find(basePath, TraversalMode::Recursive, makeExtensionPathMatcher({".fgd"}))
+      | kdl::value();
+
+    for (const auto& path : fgdFiles)
+    {
+      CAPTURE(path);
+
+      auto includedFiles = std::vector<std::filesystem::path>{};
+      const auto definitions = parseFgd(path, includedFiles);
+
+      REQUIRE(
+        writeEntityDefinitionCache(
+          env.dir(), path, includedFiles, defaultColor, definitions)
+        .is_success());
+
+      const auto cachedDefinitions =
+        readEntityDefinitionCache(env.dir(), path, defaultColor) | kdl::value();
+      checkDefinitionsEqual(cachedDefinitions, definitions);
+    }
+  }
+
+  SECTION("Cache is invalidated")
+  {
+    auto env = TestEnvironment{[](auto& e) {
+      e.createFile("host.fgd", R"(
+@include "included.fgd"
+@SolidClass = worldspawn : "World entity" []
+)");
+      e.createFile("included.fgd", R"(
+@PointClass size(-16 -16 -24, 16 16 32) model({ "path": "progs/player.mdl" }) = info_player_start : "Player 1 start" []
+)");
+    }};
+
+    const auto cacheDirectory = env.dir() / "cache";
+    const auto path = env.dir() / "host.fgd";
+
+    auto includedFiles = std::vector<std::filesystem::path>{};
+    const auto definitions = parseFgd(path, includedFiles);
+    CHECK(
+      includedFiles == std::vector<std::filesystem::path>{env.dir() / "included.fgd"});
+
+    REQUIRE(
+      writeEntityDefinitionCache(
+        cacheDirectory, path, includedFiles, defaultColor, definitions)
+      .is_success());
+    REQUIRE(
+      readEntityDefinitionCache(cacheDirectory, path, defaultColor).is_success());
+
+    SECTION("if the default entity color changes")
+    {
+      CHECK(
+        readEntityDefinitionCache(
+          cacheDirectory, path, Color{1.0f, 0.0f, 0.0f, 1.0f})
+        .is_error());
+    }
+
+    SECTION("if the entity definition file changes")
+    {
+      env.createFile("host.fgd", R"(
+@include "included.fgd"
+@SolidClass = worldspawn : "World" []
+)");
+      CHECK(
+        readEntityDefinitionCache(cacheDirectory, path, defaultColor).is_error());
+    }
+
+    SECTION("if an included file changes")
+    {
+      env.createFile("included.fgd", "");
+      CHECK(
+        readEntityDefinitionCache(cacheDirectory, path, defaultColor).is_error());
+    }
+
+    SECTION("if there is no cache file for the entity definition file")
+    {
+      CHECK(
+        readEntityDefinitionCache(cacheDirectory, env.dir() / "other.fgd", defaultColor)
+        .is_error());
+    }
+  }
+
+  SECTION("Writing replaces an existing cache file")
+  {
+    auto env = TestEnvironment{[](auto& e) {
+      e.createFile("test.fgd", R"(@SolidClass = worldspawn : "World" [])");
+    }};
+
+    const auto cacheDirectory = env.dir() / "cache";
+    const auto path = env.dir() / "test.fgd";
+
+    auto includedFiles = std::vector<std::filesystem::path>{};
+    const auto definitions = parseFgd(path, includedFiles);
+
+    REQUIRE(
+      writeEntityDefinitionCache(cacheDirectory, path, includedFiles, defaultColor, {})
+      .is_success());
+    REQUIRE(
+      writeEntityDefinitionCache(
+        cacheDirectory, path, includedFiles, defaultColor, definitions)
+      .is_success());
+
+    CHECK(
+      (Disk::find(cacheDirectory, TraversalMode::Flat) | kdl::value())
+      == std::vector{entityDefinitionCachePath(cacheDirectory, path)});
+
+    const auto cachedDefinitions =
+      readEntityDefinitionCache(cacheDirectory, path, defaultColor) | kdl::value();
+    checkDefinitionsEqual(cachedDefinitions, definitions);
+  }
+
+  SECTION("Corrupt definition count")
+  {
+    auto env = TestEnvironment{[](auto& e) { e.createFile("test.fgd", ""); }};
+
+    const auto cacheDirectory = env.dir() / "cache";
+    const auto path = env.dir() / "test.fgd";
+
+    REQUIRE(writeEntityDefinitionCache(cacheDirectory, path, {}, defaultColor, {})
+              .is_success());
+
+    // the definition count is the last value of a cache without definitions
+    {
+      auto stream = std::fstream{
+        entityDefinitionCachePath(cacheDirectory, path),
+        std::ios::in | std::ios::out | std::ios::binary};
+      stream.seekp(-4, std::ios::end);
+      stream.write("\xff\xff\xff\xff", 4);
+    }
+
+    CHECK(readEntityDefinitionCache(cacheDirectory, path, defaultColor).is_error());
+  }
+
+  SECTION("Pruning")
+  {
+    using namespace std::chrono_literals;
+
+    auto env = TestEnvironment{[](auto& e) { e.createFile("test.fgd", ""); }};
+
+    const auto cacheDirectory = env.dir() / "cache";
+    const auto path = env.dir() / "test.fgd";
+
+    // writing prunes the cache directory, so the other files are created afterwards
+    const auto cachePath = entityDefinitionCachePath(cacheDirectory, path);
+    REQUIRE(writeEntityDefinitionCache(cacheDirectory, path, {}, defaultColor, {})
+              .is_success());
+
+    env.createFile("cache/old.tbdefcache", "");
+    env.createFile("cache/older.tbdefcache", "");
+    env.createFile("cache/oldest.tbdefcache", "");
+    env.createFile("cache/oldest.tbdefcache.tmp", "");
+    env.createFile("cache/other.txt", "");
+
+    const auto setAge = [&](const auto& filename, const auto age) {
+      std::filesystem::last_write_time(
+        cacheDirectory / filename, std::filesystem::file_time_type::clock::now() - age);
+    };
+
+    setAge("old.tbdefcache", 24h);
+    setAge("older.tbdefcache", 48h);
+    setAge("oldest.tbdefcache", 24h * 40);
+    setAge("oldest.tbdefcache.tmp", 24h * 40);
+    setAge(cachePath.filename(), 24h * 40);
+
+    SECTION("Reading a cache file marks it as used")
+    {
+      REQUIRE(readEntityDefinitionCache(cacheDirectory, path, defaultColor).is_success());
+      REQUIRE(pruneEntityDefinitionCache(cacheDirectory).is_success());
+
+      CHECK_THAT(
+        Disk::find(cacheDirectory, TraversalMode::Flat) | kdl::value(),
+        Catch::UnorderedEquals(std::vector<std::filesystem::path>{
+          cacheDirectory / "old.tbdefcache",
+          cacheDirectory / "older.tbdefcache",
+          cacheDirectory / "other.txt",
+          cachePath,
+        }));
+    }
+
+    SECTION("Cache files that exceed the maximum age are deleted")
+    {
+      REQUIRE(pruneEntityDefinitionCache(cacheDirectory, 24h * 30).is_success());
+
+      CHECK_THAT(
+        Disk::find(cacheDirectory, TraversalMode::Flat) | kdl::value(),
+        Catch::UnorderedEquals(std::vector<std::filesystem::path>{
+          cacheDirectory / "old.tbdefcache",
+          cacheDirectory / "older.tbdefcache",
+          cacheDirectory / "other.txt",
+        }));
+    }
+
+    SECTION("Least recently used cache files that exceed the maximum count are deleted")
+    {
+      REQUIRE(pruneEntityDefinitionCache(cacheDirectory, 24h * 30, 1).is_success());
+
+      CHECK_THAT(
+        Disk::find(cacheDirectory, TraversalMode::Flat) | kdl::value(),
+        Catch::UnorderedEquals(std::vector<std::filesystem::path>{
+          cacheDirectory / "old.tbdefcache",
+          cacheDirectory / "other.txt",
+        }));
+    }
+  }
+}
+
+} // namespace tb::io
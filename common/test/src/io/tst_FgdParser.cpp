@@ -26,9 +26,16 @@
 #include "mdl/EntityDefinitionTestUtils.h"
 #include "mdl/PropertyDefinition.h"
 
+#include "kdl/range_to_vector.h"
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
 #include <algorithm>
 #include <filesystem>
+#include <ranges>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -1019,6 +1026,45 @@ TEST_CASE("FgdParserTest.parseRecursiveInclude")
     defs.value(), [](const auto& def) { return def->name() == "worldspawn"; }));
 }
 
+TEST_CASE("FgdParserTest.parseIncludesInParallel")
+{
+  auto taskManager = kdl::task_manager{};
+
+  const auto parseNames = [&](const auto& path, kdl::task_manager* taskManager_) {
+    auto file = Disk::openFile(path) | kdl::value();
+    auto reader = file->reader().buffer();
+
+    auto parser = FgdParser{
+      reader.stringView(), Color{1.0f, 1.0f, 1.0f, 1.0f}, path, taskManager_};
+
+    auto status = TestParserStatus{};
+    return parser.parseDefinitions(status) | kdl::transform([&](const auto& defs) {
+             return std::tuple{
+               defs | std::views::transform([](const auto& def) { return def->name(); })
+                 | kdl::to_vector,
+               status.countStatus(LogLevel::Error)};
+           })
+           | kdl::value();
+  };
+
+  SECTION("Nested includes")
+  {
+    const auto path = std::filesystem::current_path()
+                      / "fixture/test/io/Fgd/parseNestedInclude/host.fgd";
+    CHECK(parseNames(path, &taskManager) == parseNames(path, nullptr));
+  }
+
+  SECTION("Recursive includes")
+  {
+    const auto path = std::filesystem::current_path()
+                      / "fixture/test/io/Fgd/parseRecursiveInclude/host.fgd";
+
+    const auto [names, errorCount] = parseNames(path, &taskManager);
+    CHECK(names == std::vector<std::string>{"worldspawn"});
+    CHECK(errorCount > 0u);
+  }
+}
+
 TEST_CASE("FgdParserTest.parseStringContinuations")
 {
   const auto file = R"(
@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/FormatBuffer.h"
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::io
+{
+namespace
+{
+
+template <typename T>
+std::string format(const T value)
+{
+  char buffer[MaxFormattedNumberLength];
+  return std::string(buffer, formatNumber(buffer, value));
+}
+
+} // namespace
+
+TEST_CASE("formatNumber")
+{
+  SECTION("integers")
+  {
+    CHECK(format(0) == "0");
+    CHECK(format(-17) == "-17");
+    CHECK(format(size_t(12345)) == "12345");
+  }
+
+  SECTION("doubles")
+  {
+    CHECK(format(0.0) == "0");
+    CHECK(format(-0.0) == "-0");
+    CHECK(format(64.0) == "64");
+    CHECK(format(-1024.0) == "-1024");
+    CHECK(format(0.5) == "0.5");
+    CHECK(format(0.1) == "0.1");
+    CHECK(format(-12.125) == "-12.125");
+    CHECK(format(100000.0) == "100000");
+    CHECK(format(0.0001) == "0.0001");
+    CHECK(format(0.00001) == "1e-05");
+    CHECK(format(1e15) == "1000000000000000");
+    CHECK(format(1e16) == "1e+16");
+    CHECK(format(-1.5e300) == "-1.5e+300");
+    CHECK(format(1.0 / 3.0) == "0.3333333333333333");
+    CHECK(format(std::numeric_limits<double>::infinity()) == "inf");
+    CHECK(format(-std::numeric_limits<double>::infinity()) == "-inf");
+  }
+
+  SECTION("floats")
+  {
+    CHECK(format(0.0f) == "0");
+    CHECK(format(0.1f) == "0.1");
+    CHECK(format(-0.25f) == "-0.25");
+    CHECK(format(16.0f) == "16");
+    CHECK(format(1.0f / 3.0f) == "0.33333334");
+  }
+
+  SECTION("matches fmt and round trips")
+  {
+    auto rng = std::mt19937{42};
+    auto exponents = std::uniform_int_distribution<int>{-8, 20};
+    auto mantissas = std::uniform_real_distribution<double>{-10.0, 10.0};
+
+    for (size_t i = 0; i < 10000; ++i)
+    {
+      const auto d = std::ldexp(mantissas(rng), exponents(rng)) * std::pow(10.0, i % 5);
+      const auto f = static_cast<float>(d);
+
+      CHECK(format(d) == fmt::format("{}", d));
+      CHECK(std::stod(format(d)) == d);
+      CHECK(std::stof(format(f)) == f);
+
+      // Newer fmt versions use scientific notation for large floats earlier
+      if (std::abs(f) < 1e7f)
+      {
+        CHECK(format(f) == fmt::format("{}", f));
+      }
+    }
+  }
+}
+
+TEST_CASE("formatVector")
+{
+  char buffer[3 * (MaxFormattedNumberLength + 1)];
+  const auto vec = vm::vec3d{-64, 0.5, 128};
+  CHECK(std::string(buffer, formatVector(buffer, vec)) == "-64 0.5 128");
+}
+
+TEST_CASE("FormatBuffer")
+{
+  auto buffer = FormatBuffer{4};
+  CHECK(buffer.empty());
+
+  buffer.append("( ").appendNumber(1.5).append(' ').appendNumber(-2).append(" )");
+  CHECK(buffer.view() == "( 1.5 -2 )");
+  CHECK(buffer.size() == 10);
+
+  buffer.clear();
+  CHECK(buffer.empty());
+
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    buffer.appendNumber(i).append('\n');
+  }
+  CHECK(buffer.str().starts_with("0\n1\n2\n"));
+  CHECK(buffer.str().ends_with("998\n999\n"));
+}
+
+} // namespace tb::io
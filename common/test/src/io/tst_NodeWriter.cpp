@@ -18,6 +18,7 @@
  */
 
 #include "TestUtils.h"
+#include "io/NodeSerializationCache.h"
 #include "io/NodeWriter.h"
 #include "mdl/BrushBuilder.h"
 #include "mdl/BrushFace.h"
@@ -1105,6 +1106,70 @@ TEST_CASE("NodeWriter")
 
     CHECK(actual == expected);
   }
+
+  SECTION("writeWithSerializationCache")
+  {
+    const auto worldBounds = vm::bbox3d{8192.0};
+
+    auto map = mdl::WorldNode{{}, {}, mdl::MapFormat::Standard};
+
+    auto builder = mdl::BrushBuilder{map.mapFormat(), worldBounds};
+    auto* brushNode1 =
+      new mdl::BrushNode{builder.createCube(64.0, "none") | kdl::value()};
+    auto* brushNode2 =
+      new mdl::BrushNode{builder.createCube(32.0, "none") | kdl::value()};
+    map.defaultLayer()->addChild(brushNode1);
+    map.defaultLayer()->addChild(brushNode2);
+
+    auto cache = NodeSerializationCache{};
+
+    const auto writeCached = [&]() {
+      auto str = std::stringstream{};
+      auto writer = NodeWriter{map, str, cache};
+      writer.writeMap(taskManager);
+      return str.str();
+    };
+
+    const auto writeUncached = [&]() {
+      auto str = std::stringstream{};
+      auto writer = NodeWriter{map, str};
+      writer.writeMap(taskManager);
+      return str.str();
+    };
+
+    CHECK(writeCached() == writeUncached());
+    CHECK(cache.size() == 2u);
+
+    auto brush = brushNode1->brush();
+    REQUIRE(brush
+              .transform(worldBounds, vm::translation_matrix(vm::vec3d{16, 0, 0}), false)
+              .is_success());
+    brushNode1->setBrush(std::move(brush));
+
+    SECTION("Cached text is reused until the node is invalidated")
+    {
+      const auto cached = writeCached();
+      CHECK(cached != writeUncached());
+
+      cache.invalidate(brushNode1);
+      CHECK(cache.size() == 1u);
+      CHECK(writeCached() == writeUncached());
+      CHECK(cache.size() == 2u);
+    }
+
+    SECTION("Invalidating a parent invalidates its descendants")
+    {
+      cache.invalidate(map.defaultLayer());
+      CHECK(cache.empty());
+      CHECK(writeCached() == writeUncached());
+    }
+
+    SECTION("Changing the map format clears the cache")
+    {
+      cache.setFormat(mdl::MapFormat::Valve);
+      CHECK(cache.empty());
+    }
+  }
 }
 
 } // namespace tb::io
@@ -142,7 +142,10 @@ std::string TestGame::defaultMod() const
 }
 
 Result<std::vector<std::unique_ptr<EntityDefinition>>> TestGame::loadEntityDefinitions(
-  io::ParserStatus& /* status */, const std::filesystem::path& /* path */) const
+  io::ParserStatus& /* status */,
+  const std::filesystem::path& /* path */,
+  kdl::task_manager& /* taskManager */,
+  const std::optional<std::filesystem::path>& /* cacheDirectory */) const
 {
   return std::vector<std::unique_ptr<EntityDefinition>>{};
 }
@@ -26,6 +26,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -96,7 +97,10 @@ public:
   std::string defaultMod() const override;
 
   Result<std::vector<std::unique_ptr<EntityDefinition>>> loadEntityDefinitions(
-    io::ParserStatus& status, const std::filesystem::path& path) const override;
+    io::ParserStatus& status,
+    const std::filesystem::path& path,
+    kdl::task_manager& taskManager,
+    const std::optional<std::filesystem::path>& cacheDirectory) const override;
 
   void setSmartTags(std::vector<SmartTag> smartTags);
   void setDefaultFaceAttributes(const mdl::BrushFaceAttributes& newDefaults);
@@ -0,0 +1,156 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushFacePlanes.h"
+#include "mdl/MapFormat.h"
+
+#include "kdl/result.h"
+
+#include "vm/approx.h"
+#include "vm/bbox.h"
+#include "vm/plane.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <optional>
+#include <random>
+#include <tuple>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+
+namespace
+{
+
+std::optional<std::tuple<double, size_t>> intersectFacesWithRay(
+  const Brush& brush, const vm::ray3d& ray)
+{
+  for (size_t i = 0; i < brush.faceCount(); ++i)
+  {
+    if (const auto distance = brush.face(i).intersectWithRay(ray))
+    {
+      return std::tuple{*distance, i};
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+TEST_CASE("BrushFacePlanesTest.intersectWithRay")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  const auto brush =
+    builder.createCuboid(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}, "material") | kdl::value();
+  const auto facePlanes = BrushFacePlanes{brush};
+
+  REQUIRE(facePlanes.size() == brush.faceCount());
+
+  SECTION("Ray hits the face facing it")
+  {
+    const auto hit =
+      facePlanes.intersectWithRay(vm::ray3d{{8, -8, 8}, vm::vec3d{0, 1, 0}});
+    REQUIRE(hit);
+
+    const auto [distance, faceIndex] = *hit;
+    CHECK(distance == vm::approx(8.0));
+    CHECK(brush.face(faceIndex).boundary().normal == vm::vec3d{0, -1, 0});
+  }
+
+  SECTION("Ray hits an oblique entry face")
+  {
+    const auto hit = facePlanes.intersectWithRay(
+      vm::ray3d{{-8, -4, 8}, vm::normalize(vm::vec3d{1, 1, 0})});
+    REQUIRE(hit);
+
+    const auto [distance, faceIndex] = *hit;
+    CHECK(distance == vm::approx(vm::length(vm::vec3d{8, 8, 0})));
+    CHECK(brush.face(faceIndex).boundary().normal == vm::vec3d{-1, 0, 0});
+  }
+
+  SECTION("Ray points away")
+  {
+    CHECK(!facePlanes.intersectWithRay(vm::ray3d{{8, -8, 8}, vm::vec3d{0, -1, 0}}));
+  }
+
+  SECTION("Ray passes by")
+  {
+    CHECK(!facePlanes.intersectWithRay(
+      vm::ray3d{{-8, -8, 8}, vm::normalize(vm::vec3d{1, -1, 0})}));
+  }
+
+  SECTION("Ray is parallel to a face and outside")
+  {
+    CHECK(!facePlanes.intersectWithRay(vm::ray3d{{8, -8, 24}, vm::vec3d{0, 1, 0}}));
+  }
+
+  SECTION("Ray starts inside")
+  {
+    CHECK(!facePlanes.intersectWithRay(vm::ray3d{{8, 8, 8}, vm::vec3d{0, 1, 0}}));
+  }
+}
+
+TEST_CASE("BrushFacePlanesTest.intersectWithRayMatchesFaces")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  const auto brush =
+    builder.createIcoSphere(vm::bbox3d{{-64, -64, -64}, {64, 64, 64}}, 2, "material")
+    | kdl::value();
+  const auto facePlanes = BrushFacePlanes{brush};
+
+  auto engine = std::mt19937{};
+  auto coordinate = std::uniform_real_distribution<double>{-128.0, 128.0};
+  const auto randomPoint = [&]() {
+    return vm::vec3d{coordinate(engine), coordinate(engine), coordinate(engine)};
+  };
+
+  auto hitCount = size_t(0);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const auto origin = randomPoint() * 4.0;
+    const auto target = randomPoint() / 2.0;
+    const auto ray = vm::ray3d{origin, vm::normalize(target - origin)};
+
+    const auto expected = intersectFacesWithRay(brush, ray);
+    const auto actual = facePlanes.intersectWithRay(ray);
+    REQUIRE(actual.has_value() == expected.has_value());
+
+    if (expected)
+    {
+      ++hitCount;
+      const auto [distance, faceIndex] = *actual;
+      CHECK(distance == vm::approx(std::get<0>(*expected)));
+
+      // near an edge, either adjacent face may be reported
+      const auto hitPoint = vm::point_at_distance(ray, distance);
+      CHECK(brush.face(faceIndex).boundary().point_distance(hitPoint) == vm::approx(0.0));
+    }
+  }
+
+  CHECK(hitCount > 0u);
+}
+
+} // namespace tb::mdl
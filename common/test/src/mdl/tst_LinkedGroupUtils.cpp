@@ -23,6 +23,7 @@
 #include "mdl/BrushBuilder.h"
 #include "mdl/BrushNode.h"
 #include "mdl/Entity.h"
+#include "mdl/EntityDefinition.h"
 #include "mdl/EntityNode.h"
 #include "mdl/Group.h"
 #include "mdl/GroupNode.h"
@@ -712,6 +713,230 @@ TEST_CASE("updateLinkedGroups")
         })
       | kdl::transform_error([](const auto&) { FAIL(); });
   }
+
+  SECTION("Skip linked nodes that are up to date")
+  {
+    const auto worldBounds = vm::bbox3d{8192.0};
+
+    auto sourceGroupNode = GroupNode{Group{"name"}};
+    auto* sourceEntityNode1 = new EntityNode{Entity{}};
+    auto* sourceEntityNode2 = new EntityNode{Entity{{{"some_key", "some_value"}}}};
+    sourceGroupNode.addChildren({sourceEntityNode1, sourceEntityNode2});
+
+    auto targetGroupNode = std::unique_ptr<GroupNode>{
+      static_cast<GroupNode*>(sourceGroupNode.cloneRecursively(worldBounds))};
+    transformNode(
+      *targetGroupNode, vm::translation_matrix(vm::vec3d{32, 0, 0}), worldBounds);
+
+    const auto applyUpdate = [&]() {
+      return updateLinkedGroups(
+               sourceGroupNode, {targetGroupNode.get()}, worldBounds, taskManager)
+             | kdl::transform([&](UpdateLinkedGroupsResult r) {
+                 if (!r.empty())
+                 {
+                   REQUIRE(r.size() == 1u);
+                   targetGroupNode->replaceChildren(std::move(r.front().second));
+                 }
+                 return r.size();
+               })
+             | kdl::value();
+    };
+
+    REQUIRE(applyUpdate() == 1u);
+
+    const auto targetChildren = targetGroupNode->children();
+    REQUIRE(targetChildren.size() == 2u);
+
+    const auto* targetEntityNode1 = dynamic_cast<EntityNode*>(targetChildren[0]);
+    const auto* targetEntityNode2 = dynamic_cast<EntityNode*>(targetChildren[1]);
+    REQUIRE(targetEntityNode1 != nullptr);
+    REQUIRE(targetEntityNode2 != nullptr);
+    CHECK(targetEntityNode1->linkedContentHash() != std::nullopt);
+    CHECK(targetEntityNode2->linkedContentHash() != std::nullopt);
+
+    // nothing changed, so the target group is omitted from the result
+    CHECK(applyUpdate() == 0u);
+
+    const auto previousEntity2 = targetEntityNode2->entity();
+    const auto previousHash2 = targetEntityNode2->linkedContentHash();
+
+    transformNode(
+      *sourceEntityNode1, vm::translation_matrix(vm::vec3d{0, 16, 0}), worldBounds);
+    REQUIRE(sourceEntityNode1->linkedContentHash() == std::nullopt);
+    REQUIRE(applyUpdate() == 1u);
+
+    const auto* newEntityNode1 =
+      dynamic_cast<EntityNode*>(targetGroupNode->children()[0]);
+    auto* newEntityNode2 =
+      dynamic_cast<EntityNode*>(targetGroupNode->children()[1]);
+    REQUIRE(newEntityNode1 != nullptr);
+    REQUIRE(newEntityNode2 != nullptr);
+
+    CHECK(newEntityNode1->entity().origin() == vm::vec3d{32, 16, 0});
+    CHECK(newEntityNode2->entity() == previousEntity2);
+    CHECK(newEntityNode2->linkedContentHash() == previousHash2);
+
+    // changing a target node invalidates its hash, so it is recomputed
+    {
+      auto entity = newEntityNode2->entity();
+      entity.addOrUpdateProperty("some_key", "other_value");
+      newEntityNode2->setEntity(std::move(entity));
+    }
+    CHECK(newEntityNode2->linkedContentHash() == std::nullopt);
+    REQUIRE(applyUpdate() == 1u);
+
+    const auto* restoredEntityNode2 =
+      dynamic_cast<EntityNode*>(targetGroupNode->children()[1]);
+    REQUIRE(restoredEntityNode2 != nullptr);
+    CHECK(*restoredEntityNode2->entity().property("some_key") == "some_value");
+  }
+}
+
+TEST_CASE("updateLinkedNodes")
+{
+  auto taskManager = kdl::task_manager{};
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+
+  auto pointEntityDefinition =
+    PointEntityDefinition{"point_entity", Color{}, vm::bbox3d{64.0}, "", {}, {}, {}};
+
+  auto sourceGroupNode = GroupNode{Group{"name"}};
+  auto* sourceEntityNode1 = new EntityNode{Entity{}};
+  auto* sourceEntityNode2 = new EntityNode{Entity{}};
+  sourceGroupNode.addChildren({sourceEntityNode1, sourceEntityNode2});
+
+  auto targetGroupNode = std::unique_ptr<GroupNode>{
+    static_cast<GroupNode*>(sourceGroupNode.cloneRecursively(worldBounds))};
+  transformNode(
+    *targetGroupNode, vm::translation_matrix(vm::vec3d{32, 0, 0}), worldBounds);
+
+  auto* targetEntityNode1 = targetGroupNode->children().front();
+
+  transformNode(
+    *sourceEntityNode1, vm::translation_matrix(vm::vec3d{0, 16, 0}), worldBounds);
+  transformNode(
+    *sourceEntityNode2, vm::translation_matrix(vm::vec3d{0, 8, 0}), worldBounds);
+
+  SECTION("Changed nodes are updated")
+  {
+    updateLinkedNodes(
+      sourceGroupNode,
+      {targetGroupNode.get()},
+      {sourceEntityNode1},
+      worldBounds,
+      taskManager)
+      | kdl::transform([&](const UpdateLinkedNodesResult& r) {
+          CHECK(r.groupNodesToReplace.empty());
+          REQUIRE(r.nodesToSwap.size() == 1u);
+
+          const auto& [node, contents] = r.nodesToSwap.front();
+          CHECK(node == targetEntityNode1);
+          CHECK(std::get<Entity>(contents.get()).origin() == vm::vec3d{32, 16, 0});
+        })
+      | kdl::transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Nodes that are not in the source group are ignored")
+  {
+    auto otherEntityNode = EntityNode{Entity{}};
+    updateLinkedNodes(
+      sourceGroupNode,
+      {targetGroupNode.get()},
+      {&otherEntityNode},
+      worldBounds,
+      taskManager)
+      | kdl::transform([&](const UpdateLinkedNodesResult& r) {
+          CHECK(r.groupNodesToReplace.empty());
+          CHECK(r.nodesToSwap.empty());
+        })
+      | kdl::transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Target groups with a different structure must be replaced")
+  {
+    sourceGroupNode.addChild(new EntityNode{Entity{}});
+
+    updateLinkedNodes(
+      sourceGroupNode,
+      {targetGroupNode.get()},
+      {sourceEntityNode1},
+      worldBounds,
+      taskManager)
+      | kdl::transform([&](const UpdateLinkedNodesResult& r) {
+          CHECK(r.nodesToSwap.empty());
+          CHECK(r.groupNodesToReplace == std::vector<GroupNode*>{targetGroupNode.get()});
+        })
+      | kdl::transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Changes that exceed the world bounds fail")
+  {
+    transformNode(
+      *sourceEntityNode1, vm::translation_matrix(vm::vec3d{8192, 0, 0}), worldBounds);
+
+    CHECK(updateLinkedNodes(
+            sourceGroupNode,
+            {targetGroupNode.get()},
+            {sourceEntityNode1},
+            worldBounds,
+            taskManager)
+            .is_error());
+  }
+
+  SECTION("Rotated point entities near the world bounds")
+  {
+    static_cast<EntityNode*>(targetEntityNode1)->setDefinition(&pointEntityDefinition);
+
+    // The target entity ends up 48 units away from the world bounds, which leaves room
+    // for the default bounds, but not for the bounds of its definition
+    transformNode(
+      *sourceEntityNode1,
+      vm::translation_matrix(vm::vec3d{8192 - 80, 0, 0}),
+      worldBounds);
+
+    const auto origin = sourceEntityNode1->entity().origin();
+    transformNode(
+      *sourceEntityNode1,
+      vm::translation_matrix(origin)
+        * vm::rotation_matrix(0.0, 0.0, vm::to_radians(90.0))
+        * vm::translation_matrix(-origin),
+      worldBounds);
+
+    SECTION("The target keeps its definition if the classname is unchanged")
+    {
+      CHECK(updateLinkedNodes(
+              sourceGroupNode,
+              {targetGroupNode.get()},
+              {sourceEntityNode1},
+              worldBounds,
+              taskManager)
+              .is_error());
+    }
+
+    SECTION("The target loses its definition if the classname changes")
+    {
+      auto entity = sourceEntityNode1->entity();
+      entity.setClassname("other_entity");
+      sourceEntityNode1->setEntity(std::move(entity));
+
+      updateLinkedNodes(
+        sourceGroupNode,
+        {targetGroupNode.get()},
+        {sourceEntityNode1},
+        worldBounds,
+        taskManager)
+        | kdl::transform([&](const UpdateLinkedNodesResult& r) {
+            REQUIRE(r.nodesToSwap.size() == 1u);
+
+            const auto& [node, contents] = r.nodesToSwap.front();
+            CHECK(node == targetEntityNode1);
+            CHECK(
+              std::get<Entity>(contents.get()).origin()
+              == vm::vec3d{8192 - 48, 16, 0});
+          })
+        | kdl::transform_error([](const auto&) { FAIL(); });
+    }
+  }
 }
 
 TEST_CASE("initializeLinkIds")
@@ -0,0 +1,164 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Material.h"
+#include "mdl/MaterialNameIndex.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureResource.h"
+
+#include "kdl/string_compare.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+namespace
+{
+
+std::vector<Material> makeMaterials(const std::vector<std::string>& names)
+{
+  return kdl::vec_transform(names, [](const auto& name) {
+    return Material{name, createTextureResource(Texture{1, 1})};
+  });
+}
+
+std::vector<const Material*> findMaterials(
+  const MaterialNameIndex& index, const std::string& filterText)
+{
+  return kdl::vec_transform(
+    index.find(filterText), [&](const auto i) { return index.materials()[i]; });
+}
+
+std::vector<std::string> materialNames(const std::vector<const Material*>& materials)
+{
+  return kdl::vec_transform(
+    materials, [](const auto* material) { return material->name(); });
+}
+
+std::vector<std::string> filterNames(
+  std::vector<std::string> names, const std::string& filterText)
+{
+  names = kdl::vec_erase_if(std::move(names), [&](const auto& name) {
+    return !kdl::all_of(kdl::str_split(filterText, " "), [&](const auto& pattern) {
+      return kdl::ci::str_contains(name, pattern);
+    });
+  });
+  return kdl::vec_sort(std::move(names), kdl::ci::string_less{});
+}
+
+} // namespace
+
+TEST_CASE("MaterialNameIndex")
+{
+  const auto names = std::vector<std::string>{
+    "base/floor_01",
+    "base/FLOOR_02",
+    "base/wall_01",
+    "city/Wall_Brick",
+    "city/floorwall",
+    "sky/sky1",
+    "e1u1/trigger",
+    "e1u1/+0button",
+  };
+  auto materials = makeMaterials(names);
+  const auto index = MaterialNameIndex{
+    kdl::vec_transform(materials, [](const auto& material) { return &material; })};
+
+  SECTION("materials are sorted by name")
+  {
+    CHECK(materialNames(index.materials()) == filterNames(names, ""));
+  }
+
+  using T = std::tuple<std::string>;
+
+  // clang-format off
+  const auto [filterText] = GENERATE(values<T>({
+  {""},
+  {" "},
+  {"f"},
+  {"fl"},
+  {"floor"},
+  {"FLOOR"},
+  {"wall"},
+  {"floor wall"},
+  {"wall floor"},
+  {"  wall   city "},
+  {"base 01"},
+  {"e1u1/+0"},
+  {"doesnotexist"},
+  {"floor doesnotexist"},
+  {"x"},
+  }));
+  // clang-format on
+
+  CAPTURE(filterText);
+
+  CHECK(
+    materialNames(findMaterials(index, filterText)) == filterNames(names, filterText));
+}
+
+TEST_CASE("MaterialNameIndex.usageOrder")
+{
+  auto materials = makeMaterials({"d", "b", "a", "e", "c"});
+  auto index = MaterialNameIndex{
+    kdl::vec_transform(materials, [](const auto& material) { return &material; })};
+
+  const auto usageOrderNames = [&]() {
+    return kdl::vec_transform(
+      index.usageOrder(), [&](const auto i) { return index.materials()[i]->name(); });
+  };
+
+  CHECK(usageOrderNames() == std::vector<std::string>{"a", "b", "c", "d", "e"});
+
+  materials[0].incUsageCount(); // d
+  materials[0].incUsageCount(); // d
+  materials[3].incUsageCount(); // e
+
+  // the cached order is returned until it is invalidated
+  CHECK(usageOrderNames() == std::vector<std::string>{"a", "b", "c", "d", "e"});
+
+  index.invalidateUsageOrder();
+  CHECK(usageOrderNames() == std::vector<std::string>{"d", "e", "a", "b", "c"});
+
+  materials[0].decUsageCount(); // d
+  materials[2].incUsageCount(); // a
+  materials[2].incUsageCount(); // a
+
+  index.invalidateUsageOrder();
+  CHECK(usageOrderNames() == std::vector<std::string>{"a", "d", "e", "b", "c"});
+
+  for (auto& material : materials)
+  {
+    for (size_t i = 0; i < 3; ++i)
+    {
+      material.incUsageCount();
+    }
+  }
+  materials[4].incUsageCount(); // c
+
+  index.invalidateUsageOrder();
+  CHECK(usageOrderNames() == std::vector<std::string>{"a", "c", "d", "e", "b"});
+}
+
+} // namespace tb::mdl
@@ -38,6 +38,8 @@
 #include "mdl/WorldNode.h"
 
 #include "kdl/result.h"
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
 
 #include "vm/bbox.h"
 #include "vm/mat_ext.h"
@@ -182,6 +184,8 @@ TEST_CASE("ModelUtils.collectTouchingNodes")
   constexpr auto worldBounds = vm::bbox3d{8192.0};
   constexpr auto mapFormat = MapFormat::Quake3;
 
+  auto taskManager = kdl::task_manager{};
+
   auto worldNode = WorldNode{{}, {}, mapFormat};
 
   auto layerNode = LayerNode{Layer{"layer"}};
@@ -237,20 +241,20 @@ TEST_CASE("ModelUtils.collectTouchingNodes")
     &worldNode, &layerNode, &groupNode, &entityNode, &brushNode, &patchNode};
 
   CHECK_THAT(
-    collectTouchingNodes(allNodes, {&touchesAll}),
+    collectTouchingNodes(allNodes, {&touchesAll}, taskManager),
     Catch::Matchers::Equals(
       std::vector<Node*>{&groupNode, &entityNode, &brushNode, &patchNode}));
 
   CHECK_THAT(
-    collectTouchingNodes(allNodes, {&touchesNothing}),
+    collectTouchingNodes(allNodes, {&touchesNothing}, taskManager),
     Catch::Matchers::Equals(std::vector<Node*>{}));
 
   CHECK_THAT(
-    collectTouchingNodes(allNodes, {&touchesBrush}),
+    collectTouchingNodes(allNodes, {&touchesBrush}, taskManager),
     Catch::Matchers::Equals(std::vector<Node*>{&brushNode}));
 
   CHECK_THAT(
-    collectTouchingNodes(allNodes, {&touchesBrush, &touchesAll}),
+    collectTouchingNodes(allNodes, {&touchesBrush, &touchesAll}, taskManager),
     Catch::Matchers::Equals(
       std::vector<Node*>{&groupNode, &entityNode, &brushNode, &patchNode}));
 }
@@ -260,6 +264,8 @@ TEST_CASE("ModelUtils.collectContainedNodes")
   constexpr auto worldBounds = vm::bbox3d{8192.0};
   constexpr auto mapFormat = MapFormat::Quake3;
 
+  auto taskManager = kdl::task_manager{};
+
   auto worldNode = WorldNode{{}, {}, mapFormat};
 
   auto layerNode = LayerNode{Layer{"layer"}};
@@ -315,24 +321,72 @@ TEST_CASE("ModelUtils.collectContainedNodes")
     &worldNode, &layerNode, &groupNode, &entityNode, &brushNode, &patchNode};
 
   CHECK_THAT(
-    collectContainedNodes(allNodes, {&containsAll}),
+    collectContainedNodes(allNodes, {&containsAll}, taskManager),
     Catch::Matchers::Equals(
       std::vector<Node*>{&groupNode, &entityNode, &brushNode, &patchNode}));
 
   CHECK_THAT(
-    collectContainedNodes(allNodes, {&containsNothing}),
+    collectContainedNodes(allNodes, {&containsNothing}, taskManager),
     Catch::Matchers::Equals(std::vector<Node*>{}));
 
   CHECK_THAT(
-    collectContainedNodes(allNodes, {&containsPatch}),
+    collectContainedNodes(allNodes, {&containsPatch}, taskManager),
     Catch::Matchers::Equals(std::vector<Node*>{&patchNode}));
 
   CHECK_THAT(
-    collectContainedNodes(allNodes, {&containsPatch, &containsAll}),
+    collectContainedNodes(allNodes, {&containsPatch, &containsAll}, taskManager),
     Catch::Matchers::Equals(
       std::vector<Node*>{&groupNode, &entityNode, &brushNode, &patchNode}));
 }
 
+TEST_CASE("ModelUtils.collectMatchingNodesInWorld")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  auto taskManager = kdl::task_manager{};
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+
+  // overlapping brushes so that enough of them remain after culling to test them in
+  // more than one task
+  auto brushNodes = std::vector<BrushNode*>{};
+  for (size_t x = 0; x < 20; ++x)
+  {
+    for (size_t y = 0; y < 20; ++y)
+    {
+      const auto center = vm::vec3d{double(x) * 16.0, double(y) * 16.0, 0.0};
+      auto* brushNode = new BrushNode{
+        BrushBuilder{mapFormat, worldBounds}.createCuboid(
+          vm::bbox3d{center - vm::vec3d{16, 16, 16}, center + vm::vec3d{16, 16, 16}},
+          "material")
+        | kdl::value()};
+      worldNode.defaultLayer()->addChild(brushNode);
+      brushNodes.push_back(brushNode);
+    }
+  }
+
+  auto queryBrush = BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCuboid(
+      vm::bbox3d{{3, 3, -125}, {253, 253, 125}}, "material")
+    | kdl::value()};
+
+  const auto expectedTouching = kdl::vec_static_cast<Node*>(kdl::vec_filter(
+    brushNodes, [&](const auto* brushNode) { return queryBrush.intersects(brushNode); }));
+  const auto expectedContained = kdl::vec_static_cast<Node*>(kdl::vec_filter(
+    brushNodes, [&](const auto* brushNode) { return queryBrush.contains(brushNode); }));
+
+  // more candidates than fit into a single chunk of nodes to test
+  REQUIRE(expectedTouching.size() == 289u);
+  REQUIRE(expectedContained.size() == 169u);
+
+  CHECK_THAT(
+    collectTouchingNodes({&worldNode}, {&queryBrush}, taskManager),
+    Catch::Matchers::Equals(expectedTouching));
+  CHECK_THAT(
+    collectContainedNodes({&worldNode}, {&queryBrush}, taskManager),
+    Catch::Matchers::Equals(expectedContained));
+}
+
 TEST_CASE("ModelUtils.collectSelectedNodes")
 {
   constexpr auto worldBounds = vm::bbox3d{8192.0};
@@ -0,0 +1,176 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/NodeContents.h"
+#include "mdl/NodeContentsDelta.h"
+
+#include "kdl/result.h"
+
+#include "vm/mat_ext.h"
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+namespace
+{
+
+void checkSameUVAxes(const Brush& lhs, const Brush& rhs)
+{
+  REQUIRE(lhs.faceCount() == rhs.faceCount());
+  for (size_t i = 0; i < lhs.faceCount(); ++i)
+  {
+    CHECK(lhs.face(i).uAxis() == rhs.face(i).uAxis());
+    CHECK(lhs.face(i).vAxis() == rhs.face(i).vAxis());
+  }
+}
+
+} // namespace
+
+TEST_CASE("NodeContentsDelta")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  SECTION("Brushes")
+  {
+    const auto mapFormat = GENERATE(MapFormat::Standard, MapFormat::Valve);
+    CAPTURE(mapFormat);
+
+    auto brushNode = BrushNode{
+      BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+
+    auto brush = brushNode.brush();
+
+    SECTION("Unchanged brush")
+    {
+      auto delta = NodeContentsDelta::encode(NodeContents{brush}, brushNode);
+      CHECK_FALSE(delta.full());
+
+      const auto decoded = std::move(delta).decode(brushNode);
+      CHECK(std::get<Brush>(decoded.get()) == brush);
+    }
+
+    SECTION("Changed face attributes")
+    {
+      auto attributes = brush.face(0).attributes();
+      attributes.setMaterialName("other");
+      attributes.setXOffset(16.0f);
+      brush.face(0).setAttributes(attributes);
+      brush.face(1).rotateUV(15.0f);
+
+      const auto contents = NodeContents{brush};
+      auto delta = NodeContentsDelta::encode(contents, brushNode);
+      CHECK_FALSE(delta.full());
+      CHECK(delta.memorySize() < memorySize(contents));
+
+      const auto decoded = std::move(delta).decode(brushNode);
+      const auto& decodedBrush = std::get<Brush>(decoded.get());
+      CHECK(decodedBrush == brush);
+      checkSameUVAxes(decodedBrush, brush);
+    }
+
+    SECTION("Changed geometry")
+    {
+      REQUIRE(brush
+                .transform(
+                  worldBounds, vm::translation_matrix(vm::vec3d{16.0, 0.0, 0.0}), false)
+                .is_success());
+
+      auto delta = NodeContentsDelta::encode(NodeContents{brush}, brushNode);
+      CHECK(delta.full());
+
+      const auto decoded = std::move(delta).decode(brushNode);
+      const auto& decodedBrush = std::get<Brush>(decoded.get());
+      CHECK(decodedBrush == brush);
+      checkSameUVAxes(decodedBrush, brush);
+    }
+
+    SECTION("Encoding relative to node contents")
+    {
+      brush.face(2).rotateUV(30.0f);
+
+      const auto reference = NodeContents{brushNode.brush()};
+      auto delta = NodeContentsDelta::encode(NodeContents{brush}, reference);
+      CHECK_FALSE(delta.full());
+
+      const auto decoded = std::move(delta).decode(reference);
+      const auto& decodedBrush = std::get<Brush>(decoded.get());
+      CHECK(decodedBrush == brush);
+      checkSameUVAxes(decodedBrush, brush);
+    }
+  }
+
+  SECTION("Entities")
+  {
+    auto entityNode = EntityNode{Entity{{
+      {"classname", "light"},
+      {"origin", "0 0 0"},
+      {"light", "300"},
+    }}};
+
+    auto entity = entityNode.entity();
+
+    SECTION("Changed, added and removed properties")
+    {
+      using T = std::vector<EntityProperty>;
+
+      // clang-format off
+      const auto properties = GENERATE(values<T>({
+        {{"classname", "light"}, {"origin", "0 0 0"}, {"light", "200"}},
+        {{"classname", "light"}, {"origin", "0 0 0"}, {"light", "300"}, {"target", "t1"}},
+        {{"classname", "light"}, {"light", "300"}},
+        {},
+      }));
+      // clang-format on
+
+      CAPTURE(properties);
+
+      entity.setProperties(properties);
+
+      auto delta = NodeContentsDelta::encode(NodeContents{entity}, entityNode);
+      CHECK_FALSE(delta.full());
+
+      const auto decoded = std::move(delta).decode(entityNode);
+      CHECK(std::get<Entity>(decoded.get()).properties() == properties);
+    }
+
+    SECTION("Changed protected properties")
+    {
+      entity.setProtectedProperties({"origin"});
+
+      auto delta = NodeContentsDelta::encode(NodeContents{entity}, entityNode);
+      CHECK(delta.full());
+
+      const auto decoded = std::move(delta).decode(entityNode);
+      CHECK(std::get<Entity>(decoded.get()) == entity);
+    }
+  }
+}
+
+} // namespace tb::mdl
@@ -17,11 +17,15 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "mdl/Brush.h"
 #include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
 #include "mdl/LayerNode.h"
 #include "mdl/MapFormat.h"
 #include "mdl/Tag.h"
+#include "mdl/TagManager.h"
+#include "mdl/TagMatcher.h"
 #include "mdl/WorldNode.h"
 
 #include "kdl/result.h"
@@ -65,4 +69,81 @@ TEST_CASE("TaggingTest.testTagBrush")
   CHECK_FALSE(brushNode->hasTag(tag2));
 }
 
+TEST_CASE("TaggingTest.materialTags")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+  auto worldNode = WorldNode{{}, {}, MapFormat::Standard};
+
+  auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  auto* brushNode = new BrushNode{
+    builder.createCube(
+      64.0, "liquids/water", "clip", "liquids/water", "wall", "wall", "wall")
+    | kdl::value()};
+
+  worldNode.defaultLayer()->addChild(brushNode);
+
+  auto smartTags = std::vector<SmartTag>{};
+  smartTags.emplace_back(
+    "Clip",
+    std::vector<TagAttribute>{},
+    std::make_unique<MaterialNameTagMatcher>("clip"));
+  smartTags.emplace_back(
+    "Liquid",
+    std::vector<TagAttribute>{},
+    std::make_unique<MaterialNameTagMatcher>("liquids/*"));
+  smartTags.emplace_back(
+    "Water",
+    std::vector<TagAttribute>{},
+    std::make_unique<MaterialNameTagMatcher>("WAT*"));
+
+  auto tagManager = TagManager{};
+  tagManager.registerSmartTags(smartTags);
+
+  const auto& clipTag = tagManager.smartTag("Clip");
+  const auto& liquidTag = tagManager.smartTag("Liquid");
+  const auto& waterTag = tagManager.smartTag("Water");
+
+  brushNode->initializeTags(tagManager);
+
+  const auto& brush = brushNode->brush();
+  for (const auto& face : brush.faces())
+  {
+    const auto& materialName = face.attributes().materialName();
+    CHECK(face.hasTag(clipTag) == (materialName == "clip"));
+    CHECK(face.hasTag(liquidTag) == (materialName == "liquids/water"));
+    CHECK(face.hasTag(waterTag) == (materialName == "liquids/water"));
+  }
+
+  // material tags are only applied to faces
+  CHECK_FALSE(brushNode->hasTag(clipTag));
+  CHECK_FALSE(brushNode->hasTag(liquidTag));
+
+  CHECK(brushNode->anyFaceHasAnyTag());
+  CHECK(brushNode->anyFacesHaveAnyTagInMask(clipTag.type()));
+  CHECK(brushNode->anyFacesHaveAnyTagInMask(liquidTag.type() | waterTag.type()));
+  CHECK_FALSE(brushNode->allFacesHaveAnyTagInMask(clipTag.type() | liquidTag.type()));
+
+  SECTION("Changing a face material updates the tags")
+  {
+    auto newBrush = brush;
+    for (auto& face : newBrush.faces())
+    {
+      auto attributes = face.attributes();
+      attributes.setMaterialName("clip");
+      face.setAttributes(attributes);
+    }
+    brushNode->setBrush(std::move(newBrush));
+    brushNode->updateTags(tagManager);
+
+    CHECK(brushNode->allFacesHaveAnyTagInMask(clipTag.type()));
+    CHECK_FALSE(brushNode->anyFacesHaveAnyTagInMask(liquidTag.type()));
+  }
+
+  SECTION("Clearing the tags")
+  {
+    brushNode->clearTags();
+    CHECK_FALSE(brushNode->anyFaceHasAnyTag());
+  }
+}
+
 } // namespace tb::mdl
@@ -278,6 +278,119 @@ TEST_CASE("AllocationTrackerTest.expandWithUsedSpaceAtEnd")
 
 static constexpr size_t NumBrushes = 64'000;
 
+TEST_CASE("AllocationTrackerTest.stats")
+{
+  AllocationTracker t(500);
+  CHECK(t.stats().capacity == 500u);
+  CHECK(t.stats().usedSize == 0u);
+  CHECK(t.stats().freeSize == 500u);
+  CHECK(t.stats().largestFreeBlockSize == 500u);
+  CHECK(t.stats().usedBlockCount == 0u);
+  CHECK(t.stats().freeBlockCount == 1u);
+  CHECK(t.stats().fragmentation() == 0.0);
+
+  auto* b0 = t.allocate(100);
+  auto* b1 = t.allocate(100);
+  auto* b2 = t.allocate(100);
+  auto* b3 = t.allocate(100);
+  REQUIRE(b0 != nullptr);
+  REQUIRE(b1 != nullptr);
+  REQUIRE(b2 != nullptr);
+  REQUIRE(b3 != nullptr);
+
+  t.free(b0);
+  t.free(b2);
+
+  const auto stats = t.stats();
+  CHECK(stats.usedSize == 200u);
+  CHECK(stats.freeSize == 300u);
+  CHECK(stats.largestFreeBlockSize == 100u);
+  CHECK(stats.usedBlockCount == 2u);
+  CHECK(stats.freeBlockCount == 3u);
+  CHECK(stats.scatteredFreeSize() == 200u);
+  CHECK(stats.fragmentation() == Approx(2.0 / 3.0));
+
+  t.free(b1);
+  CHECK(t.stats().freeBlockCount == 2u);
+  CHECK(t.stats().largestFreeBlockSize == 300u);
+}
+
+TEST_CASE("AllocationTrackerTest.compact")
+{
+  AllocationTracker t(500);
+
+  auto* b0 = t.allocate(100);
+  auto* b1 = t.allocate(100);
+  auto* b2 = t.allocate(100);
+  auto* b3 = t.allocate(100);
+
+  t.free(b0);
+  t.free(b2);
+
+  CHECK(
+    t.freeBlocks()
+    == (std::vector<AllocationTracker::Range>{{0, 100}, {200, 100}, {400, 100}}));
+
+  const auto moves = t.compact(1000);
+  REQUIRE(moves.size() == 2u);
+  CHECK(moves[0].block == b1);
+  CHECK(moves[0].oldPos == 100u);
+  CHECK(moves[0].newPos == 0u);
+  CHECK(moves[0].size == 100u);
+  CHECK(moves[1].block == b3);
+  CHECK(moves[1].oldPos == 300u);
+  CHECK(moves[1].newPos == 100u);
+  CHECK(moves[1].size == 100u);
+
+  CHECK(b1->pos == 0u);
+  CHECK(b3->pos == 100u);
+  CHECK(
+    t.usedBlocks() == (std::vector<AllocationTracker::Range>{{0, 100}, {100, 100}}));
+  CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{200, 300}}));
+  CHECK(t.largestPossibleAllocation() == 300u);
+  CHECK(t.stats().fragmentation() == 0.0);
+
+  // nothing left to do
+  CHECK(t.compact(1000).empty());
+
+  // the moved blocks can still be freed
+  t.free(b1);
+  t.free(b3);
+  CHECK_FALSE(t.hasAllocations());
+  CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{0, 500}}));
+}
+
+TEST_CASE("AllocationTrackerTest.compactWithBudget")
+{
+  AllocationTracker t(400);
+
+  auto* b0 = t.allocate(100);
+  auto* b1 = t.allocate(100);
+  auto* b2 = t.allocate(100);
+  auto* b3 = t.allocate(100);
+
+  t.free(b0);
+
+  // moves one block per call
+  auto moves = t.compact(150);
+  REQUIRE(moves.size() == 1u);
+  CHECK(moves[0].block == b1);
+  CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{100, 100}}));
+
+  // moves at least one block even if it exceeds the budget
+  moves = t.compact(10);
+  REQUIRE(moves.size() == 1u);
+  CHECK(moves[0].block == b2);
+  CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{200, 100}}));
+
+  moves = t.compact(150);
+  REQUIRE(moves.size() == 1u);
+  CHECK(moves[0].block == b3);
+  CHECK(t.freeBlocks() == (std::vector<AllocationTracker::Range>{{300, 100}}));
+
+  CHECK(t.compact(150).empty());
+}
+
 // between 12 and 140, inclusive.
 static size_t getBrushSizeFromRandEngine(std::mt19937& engine)
 {
@@ -396,4 +509,91 @@ TEST_CASE("AllocationTrackerTest.benchmarkAllocAndExpand")
   }
 }
 
+TEST_CASE("AllocationTrackerTest.benchmarkAllocFreeCompact")
+{
+  std::mt19937 randEngine;
+
+  // simulate a buffer where every element holds the index of the block it belongs to
+  auto buffer = std::vector<size_t>{};
+
+  AllocationTracker t;
+  auto allocations = std::vector<AllocationTracker::Block*>{};
+
+  const auto allocate = [&]() {
+    const size_t brushSize = getBrushSizeFromRandEngine(randEngine);
+
+    auto* block = t.allocate(brushSize);
+    if (block == nullptr)
+    {
+      const size_t newSize = std::max(2 * t.capacity(), t.capacity() + brushSize);
+      t.expand(newSize);
+      buffer.resize(newSize);
+      block = t.allocate(brushSize);
+    }
+    REQUIRE(block != nullptr);
+
+    std::fill_n(buffer.begin() + long(block->pos), block->size, allocations.size());
+    allocations.push_back(block);
+  };
+
+  const auto checkBuffer = [&]() {
+    for (size_t i = 0; i < allocations.size(); ++i)
+    {
+      if (const auto* block = allocations[i])
+      {
+        const auto begin = buffer.begin() + long(block->pos);
+        const auto end = begin + long(block->size);
+        REQUIRE(std::all_of(begin, end, [&](const auto x) { return x == i; }));
+      }
+    }
+  };
+
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    allocate();
+  }
+
+  for (size_t round = 0; round < 10; ++round)
+  {
+    // free a random half of the remaining allocations
+    for (size_t i = 0; i < allocations.size(); ++i)
+    {
+      if (allocations[i] != nullptr && randEngine() % 2 == 0)
+      {
+        t.free(allocations[i]);
+        allocations[i] = nullptr;
+      }
+    }
+
+    const auto capacity = t.capacity();
+    const auto usedSize = t.stats().usedSize;
+
+    // compact incrementally with a fixed budget
+    while (t.stats().freeBlockCount > 1)
+    {
+      for (const auto& move : t.compact(140 * 64))
+      {
+        CHECK(move.newPos < move.oldPos);
+        std::copy_n(
+          buffer.begin() + long(move.oldPos),
+          move.size,
+          buffer.begin() + long(move.newPos));
+      }
+    }
+
+    checkBuffer();
+    CHECK(t.capacity() == capacity);
+    CHECK(t.stats().usedSize == usedSize);
+    CHECK(t.stats().fragmentation() == 0.0);
+    CHECK(t.largestPossibleAllocation() == capacity - usedSize);
+
+    // refill, this reuses the free space at the end before expanding
+    for (size_t i = 0; i < NumBrushes / 4; ++i)
+    {
+      allocate();
+    }
+    checkBuffer();
+  }
+}
+
 } // namespace tb::render
@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/BrushRendererArrays.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+
+using Range = DirtyRangeTracker::Range;
+
+TEST_CASE("DirtyRangeTrackerTest.constructor")
+{
+  auto t = DirtyRangeTracker{100};
+  CHECK(t.capacity() == 100u);
+  CHECK(t.clean());
+  CHECK(t.dirtyRanges().empty());
+  CHECK(t.dirtySize() == 0u);
+}
+
+TEST_CASE("DirtyRangeTrackerTest.markDirty")
+{
+  auto t = DirtyRangeTracker{100};
+
+  SECTION("Empty ranges are ignored")
+  {
+    t.markDirty(10, 0);
+    CHECK(t.clean());
+  }
+
+  SECTION("Out of bounds ranges are rejected")
+  {
+    CHECK_THROWS_AS(t.markDirty(90, 11), std::invalid_argument);
+    CHECK(t.clean());
+  }
+
+  SECTION("Disjoint ranges are kept sorted")
+  {
+    t.markDirty(50, 10);
+    t.markDirty(10, 10);
+    t.markDirty(80, 5);
+
+    CHECK(t.dirtyRanges() == std::vector<Range>{{10, 10}, {50, 10}, {80, 5}});
+    CHECK(t.dirtySize() == 25u);
+  }
+
+  SECTION("Adjacent ranges are coalesced")
+  {
+    t.markDirty(10, 10);
+    t.markDirty(20, 5);
+    t.markDirty(5, 5);
+
+    CHECK(t.dirtyRanges() == std::vector<Range>{{5, 20}});
+  }
+
+  SECTION("Overlapping ranges are coalesced")
+  {
+    t.markDirty(10, 10);
+    t.markDirty(15, 10);
+    t.markDirty(5, 7);
+
+    CHECK(t.dirtyRanges() == std::vector<Range>{{5, 20}});
+  }
+
+  SECTION("Contained ranges are absorbed")
+  {
+    t.markDirty(10, 20);
+    t.markDirty(15, 5);
+    t.markDirty(10, 20);
+
+    CHECK(t.dirtyRanges() == std::vector<Range>{{10, 20}});
+  }
+
+  SECTION("A range spanning several ranges merges them")
+  {
+    t.markDirty(10, 5);
+    t.markDirty(20, 5);
+    t.markDirty(30, 5);
+    t.markDirty(50, 5);
+    t.markDirty(12, 20);
+
+    CHECK(t.dirtyRanges() == std::vector<Range>{{10, 25}, {50, 5}});
+  }
+
+  SECTION("The closest ranges are merged when there are too many ranges")
+  {
+    auto big = DirtyRangeTracker{1000};
+    for (size_t i = 0; i < DirtyRangeTracker::MaxDirtyRanges; ++i)
+    {
+      big.markDirty(i * 10, 5);
+    }
+    REQUIRE(big.dirtyRanges().size() == DirtyRangeTracker::MaxDirtyRanges);
+
+    // leaves a gap of 2 to the last range, which is the smallest gap
+    big.markDirty(DirtyRangeTracker::MaxDirtyRanges * 10 - 3, 1);
+
+    CHECK(big.dirtyRanges().size() == DirtyRangeTracker::MaxDirtyRanges);
+    CHECK(
+      big.dirtyRanges().back()
+      == Range{(DirtyRangeTracker::MaxDirtyRanges - 1) * 10, 8});
+  }
+}
+
+TEST_CASE("DirtyRangeTrackerTest.expand")
+{
+  auto t = DirtyRangeTracker{100};
+  t.markDirty(95, 5);
+  t.expand(150);
+
+  CHECK(t.capacity() == 150u);
+  CHECK(t.dirtyRanges() == std::vector<Range>{{95, 55}});
+  CHECK_THROWS_AS(t.expand(150), std::invalid_argument);
+}
+
+} // namespace tb::render
@@ -0,0 +1,167 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/RenderStatistics.h"
+
+#include <sstream>
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+
+TEST_CASE("RenderStatisticsTest.recordWithoutFrame")
+{
+  auto statistics = RenderStatistics{};
+  statistics.recordDrawCall(3);
+  statistics.recordUpload(16);
+
+  CHECK(statistics.history().empty());
+}
+
+TEST_CASE("RenderStatisticsTest.recordPasses")
+{
+  auto statistics = RenderStatistics{};
+
+  statistics.beginFrame();
+  statistics.recordUpload(64);
+
+  const auto first = statistics.addPass("first");
+  statistics.recordDrawCall(3);
+  statistics.recordDrawCall(6);
+  statistics.recordProgramChange();
+
+  const auto second = statistics.addPass("second");
+  statistics.recordDrawCall(4);
+
+  statistics.setCurrentPass(first);
+  statistics.recordDrawCall(1);
+  statistics.endFrame();
+
+  CHECK(first == 1u);
+  CHECK(second == 2u);
+
+  REQUIRE(statistics.history().size() == 1u);
+  const auto& frame = statistics.history().front();
+  CHECK(frame.frameIndex == 0u);
+
+  REQUIRE(frame.passes.size() == 3u);
+  CHECK(frame.passes[0].name == "Other");
+  CHECK(frame.passes[0].uploadedBytes == 64u);
+  CHECK(frame.passes[1].name == "first");
+  CHECK(frame.passes[1].drawCallCount == 3u);
+  CHECK(frame.passes[1].elementCount == 10u);
+  CHECK(frame.passes[1].programChangeCount == 1u);
+  CHECK(frame.passes[2].name == "second");
+  CHECK(frame.passes[2].drawCallCount == 1u);
+  CHECK(frame.passes[2].elementCount == 4u);
+
+  const auto total = frame.total();
+  CHECK(total.drawCallCount == 4u);
+  CHECK(total.elementCount == 14u);
+  CHECK(total.uploadedBytes == 64u);
+}
+
+TEST_CASE("RenderStatisticsTest.scopedStatistics")
+{
+  auto outer = RenderStatistics{};
+  auto inner = RenderStatistics{};
+
+  CHECK(currentRenderStatistics() == nullptr);
+  {
+    const auto scopedOuter = ScopedRenderStatistics{outer};
+    CHECK(currentRenderStatistics() == &outer);
+    {
+      const auto scopedInner = ScopedRenderStatistics{inner};
+      CHECK(currentRenderStatistics() == &inner);
+    }
+    CHECK(currentRenderStatistics() == &outer);
+
+    outer.beginFrame();
+    recordDrawCall(5);
+    outer.endFrame();
+  }
+  CHECK(currentRenderStatistics() == nullptr);
+
+  // no statistics installed, must not crash
+  recordDrawCall(5);
+
+  REQUIRE(outer.history().size() == 1u);
+  CHECK(outer.history().front().total().drawCallCount == 1u);
+}
+
+TEST_CASE("RenderStatisticsTest.history")
+{
+  auto statistics = RenderStatistics{3};
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    statistics.beginFrame();
+    statistics.addPass("pass");
+    for (size_t j = 0; j < i; ++j)
+    {
+      statistics.recordDrawCall(2);
+    }
+    statistics.endFrame();
+  }
+
+  REQUIRE(statistics.history().size() == 3u);
+  CHECK(statistics.history().front().frameIndex == 2u);
+  CHECK(statistics.history().back().frameIndex == 4u);
+
+  const auto average = statistics.average(2);
+  REQUIRE(average.passes.size() == 2u);
+  CHECK(average.passes[1].name == "pass");
+  CHECK(average.passes[1].drawCallCount == 3u);
+  CHECK(average.passes[1].elementCount == 7u);
+
+  statistics.clearHistory();
+  CHECK(statistics.history().empty());
+  CHECK(statistics.average(2).passes.empty());
+}
+
+TEST_CASE("RenderStatisticsTest.writeCsv")
+{
+  auto statistics = RenderStatistics{};
+
+  statistics.beginFrame();
+  statistics.addPass("Default opaque");
+  statistics.recordDrawCall(6);
+  statistics.endFrame();
+
+  auto str = std::stringstream{};
+  statistics.writeCsv(str);
+
+  auto line = std::string{};
+  REQUIRE(std::getline(str, line));
+  CHECK(
+    line
+    == "frame,pass,renderables,draw_calls,elements,program_changes,uploaded_bytes,"
+       "collect_us,render_us,prepare_us,frame_us");
+
+  REQUIRE(std::getline(str, line));
+  CHECK(line.starts_with("0,\"Other\",0,0,0,0,0,"));
+
+  REQUIRE(std::getline(str, line));
+  CHECK(line.starts_with("0,\"Default opaque\",0,1,6,0,0,"));
+
+  CHECK_FALSE(std::getline(str, line));
+}
+
+} // namespace tb::render
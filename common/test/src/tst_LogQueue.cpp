@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogQueue.h"
+#include "Logger.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb
+{
+
+TEST_CASE("LogQueue")
+{
+  auto queue = LogQueue{};
+
+  SECTION("Messages are returned in push order")
+  {
+    CHECK(queue.empty());
+
+    queue.push(LogLevel::Info, "a");
+    queue.push(LogLevel::Warn, "b");
+    queue.push(LogLevel::Error, "c");
+    CHECK_FALSE(queue.empty());
+
+    CHECK(
+      queue.popAll()
+      == std::vector<LogMessage>{
+        {LogLevel::Info, "a"},
+        {LogLevel::Warn, "b"},
+        {LogLevel::Error, "c"},
+      });
+    CHECK(queue.empty());
+    CHECK(queue.popAll().empty());
+  }
+
+  SECTION("Messages can be pushed by many threads concurrently")
+  {
+    constexpr auto ThreadCount = 8;
+    constexpr auto MessageCount = 1000;
+
+    auto threads = std::vector<std::thread>{};
+    for (int i = 0; i < ThreadCount; ++i)
+    {
+      threads.emplace_back([&, i]() {
+        for (int j = 0; j < MessageCount; ++j)
+        {
+          queue.push(LogLevel::Info, std::to_string(i) + " " + std::to_string(j));
+        }
+      });
+    }
+
+    auto messages = std::vector<LogMessage>{};
+    while (messages.size() < ThreadCount * MessageCount)
+    {
+      auto batch = queue.popAll();
+      messages.insert(messages.end(), batch.begin(), batch.end());
+    }
+
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    CHECK(queue.empty());
+
+    // the messages of each thread are returned in the order in which they were pushed
+    auto nextMessage = std::vector<int>(ThreadCount, 0);
+    for (const auto& message : messages)
+    {
+      const auto separator = message.str.find(' ');
+      const auto thread = std::stoi(message.str.substr(0, separator));
+      const auto index = std::stoi(message.str.substr(separator + 1));
+
+      REQUIRE(index == nextMessage[size_t(thread)]);
+      ++nextMessage[size_t(thread)];
+    }
+
+    CHECK(nextMessage == std::vector<int>(ThreadCount, MessageCount));
+  }
+}
+
+} // namespace tb
@@ -0,0 +1,159 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NotificationBatch.h"
+#include "Notifier.h"
+#include "NotifierConnection.h"
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb
+{
+namespace
+{
+
+class BatchObserver
+{
+public:
+  std::vector<std::vector<int>> calls;
+
+  void notify(const std::vector<int>& items) { calls.push_back(items); }
+};
+
+} // namespace
+
+TEST_CASE("NotificationBatch")
+{
+  auto batch = NotificationBatch{};
+  auto notifier = Notifier<const std::vector<int>&>{};
+
+  auto observer = BatchObserver{};
+  auto unbatchedCalls = std::vector<std::vector<int>>{};
+
+  auto connection = NotifierConnection{};
+  connection += batch.connect(notifier, &observer, &BatchObserver::notify);
+  connection += notifier.connect(
+    [&](const std::vector<int>& items) { unbatchedCalls.push_back(items); });
+
+  SECTION("Notifications are delivered immediately if no batch is active")
+  {
+    CHECK_FALSE(batch.active());
+
+    notifier(std::vector<int>{2, 1});
+    notifier(std::vector<int>{1});
+
+    CHECK(observer.calls == std::vector<std::vector<int>>{{2, 1}, {1}});
+    CHECK(batch.deferredNotificationCount() == 0u);
+    CHECK(batch.deliveryCount() == 0u);
+  }
+
+  SECTION("Notifications are deduplicated and delivered when the batch ends")
+  {
+    batch.begin();
+    CHECK(batch.active());
+
+    notifier(std::vector<int>{3, 1});
+    notifier(std::vector<int>{1, 2});
+    notifier(std::vector<int>{3});
+
+    CHECK(observer.calls.empty());
+    CHECK(unbatchedCalls.size() == 3u);
+
+    batch.end();
+    CHECK_FALSE(batch.active());
+
+    CHECK(observer.calls == std::vector<std::vector<int>>{{1, 2, 3}});
+    CHECK(batch.deferredNotificationCount() == 3u);
+    CHECK(batch.deliveryCount() == 1u);
+
+    notifier(std::vector<int>{4});
+    CHECK(observer.calls == std::vector<std::vector<int>>{{1, 2, 3}, {4}});
+  }
+
+  SECTION("Nested batches deliver when the outermost batch ends")
+  {
+    batch.begin();
+    notifier(std::vector<int>{1});
+
+    batch.begin();
+    notifier(std::vector<int>{2});
+    batch.end();
+
+    CHECK(observer.calls.empty());
+
+    batch.end();
+    CHECK(observer.calls == std::vector<std::vector<int>>{{1, 2}});
+  }
+
+  SECTION("Disconnected observers are not notified")
+  {
+    batch.begin();
+    notifier(std::vector<int>{1});
+    connection.disconnect();
+    batch.end();
+
+    CHECK(observer.calls.empty());
+    CHECK(batch.deliveryCount() == 1u);
+  }
+
+  SECTION("Observers are notified in the order of their first notification")
+  {
+    auto otherNotifier = Notifier<const std::vector<int>&>{};
+    auto order = std::vector<int>{};
+
+    connection += batch.connect(
+      notifier, [&](const std::vector<int>&) { order.push_back(1); });
+    connection += batch.connect(
+      otherNotifier, [&](const std::vector<int>&) { order.push_back(2); });
+
+    batch.begin();
+    otherNotifier(std::vector<int>{1});
+    notifier(std::vector<int>{1});
+    otherNotifier(std::vector<int>{2});
+    batch.end();
+
+    CHECK(order == std::vector<int>{2, 1});
+  }
+
+  SECTION("A delivery can start another batch")
+  {
+    auto nestedCalls = std::vector<std::vector<int>>{};
+    auto otherNotifier = Notifier<const std::vector<int>&>{};
+
+    connection += batch.connect(otherNotifier, [&](const std::vector<int>& items) {
+      nestedCalls.push_back(items);
+    });
+    connection += batch.connect(notifier, [&](const std::vector<int>&) {
+      batch.begin();
+      otherNotifier(std::vector<int>{5});
+      batch.end();
+    });
+
+    batch.begin();
+    notifier(std::vector<int>{1});
+    batch.end();
+
+    CHECK(observer.calls == std::vector<std::vector<int>>{{1}});
+    CHECK(nestedCalls == std::vector<std::vector<int>>{{5}});
+  }
+}
+
+} // namespace tb
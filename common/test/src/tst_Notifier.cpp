@@ -19,6 +19,7 @@
 
 #include "Notifier.h"
 
+#include <chrono>
 #include <tuple>
 #include <vector>
 
@@ -361,6 +362,42 @@ TEST_CASE("NotifierTest.notifyObservers - test type qualifiers and value categor
   }
 }
 
+TEST_CASE("NotifierTest.statistics")
+{
+  auto o1 = Observer{};
+  auto o2 = Observer{};
+
+  auto obs = Observed{};
+
+  auto con = NotifierConnection{};
+  con += obs.oneArgNotifier.connect(&o1, &Observer::notify1);
+
+  obs.notify1(1);
+
+  con += obs.oneArgNotifier.connect(&o2, &Observer::notify1);
+
+  obs.notify1(2);
+  obs.notify1(3);
+
+  auto statistics = obs.oneArgNotifier.statistics();
+  REQUIRE(statistics.size() == 2u);
+  CHECK(statistics[0].id < statistics[1].id);
+  CHECK(statistics[0].notificationCount == 3u);
+  CHECK(statistics[1].notificationCount == 2u);
+  CHECK(statistics[0].notificationTime >= std::chrono::nanoseconds{0});
+
+  obs.oneArgNotifier.resetStatistics();
+
+  statistics = obs.oneArgNotifier.statistics();
+  REQUIRE(statistics.size() == 2u);
+  CHECK(statistics[0].notificationCount == 0u);
+  CHECK(statistics[1].notificationCount == 0u);
+  CHECK(statistics[0].notificationTime == std::chrono::nanoseconds{0});
+
+  con.disconnect();
+  CHECK(obs.oneArgNotifier.statistics().empty());
+}
+
 TEST_CASE("NotifyAfter")
 {
   auto n = Notifier<const Param&>{};
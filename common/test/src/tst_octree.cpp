@@ -675,6 +675,38 @@ TEST_CASE("octree.find_intersectors-bbox")
   }
 }
 
+TEST_CASE("octree.find_if")
+{
+  auto tree = octree<double, int>{32.0};
+
+  SECTION("empty tree")
+  {
+    CHECK(tree.find_if([](const auto&) { return true; }).empty());
+  }
+
+  SECTION("multiple nodes")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+    tree.insert({{-64, -64, -64}, {-32, -32, -32}}, 2);
+
+    CHECK(tree.find_if([](const auto&) { return false; }).empty());
+
+    CHECK_THAT(
+      tree.find_if([](const auto&) { return true; }),
+      Catch::Matchers::UnorderedEquals(std::vector<int>{1, 2}));
+
+    // only the nodes with positive bounds
+    CHECK(
+      tree.find_if([](const auto& bounds) { return bounds.max.x() > 0.0; })
+      == std::vector<int>{1});
+
+    // a predicate that is not satisfied by any leaf
+    CHECK(
+      tree.find_if([](const auto& bounds) { return bounds.size().x() > 64.0; })
+        .empty());
+  }
+}
+
 TEST_CASE("octree.find_containers")
 {
   auto tree = octree<double, int>{32.0};
@@ -28,12 +28,15 @@
 #include "ui/Autosaver.h"
 #include "ui/MapDocumentTest.h"
 
+#include "kdl/task_manager.h"
 #include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
 #include <chrono>
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <thread>
 
 #include "Catch2.h"
@@ -96,6 +99,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveUntilSaveInter
   document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK_FALSE(env.fileExists("autosave/test.1.map"));
   CHECK_FALSE(env.directoryExists("autosave"));
@@ -113,6 +117,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveOfUnchangedMap
 
   auto autosaver = Autosaver{document, 0s};
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK_FALSE(env.fileExists("autosave/test.1.map"));
   CHECK_FALSE(env.directoryExists("autosave"));
@@ -136,6 +141,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAfterSaveInterv
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.1.map"));
   CHECK(env.directoryExists("autosave"));
@@ -159,6 +165,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.1.map"));
   CHECK(env.directoryExists("autosave"));
@@ -168,15 +175,77 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
   CHECK_FALSE(env.fileExists("autosave/test.2.map"));
 
   // modify the map
   document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
   CHECK(env.fileExists("autosave/test.2.map"));
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverWritesSnapshot")
+{
+  using namespace std::chrono_literals;
+
+  auto env = io::TestEnvironment{};
+  auto logger = NullLogger{};
+
+  document->saveDocumentAs(env.dir() / "test.map");
+  assert(env.fileExists("test.map"));
+
+  auto autosaver = Autosaver{document, 0s};
+
+  // modify the map
+  document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
+  const auto expected = document->serializeDocument();
+
+  autosaver.triggerAutosave(logger);
+
+  // modify the map again while the backup is being written
+  document->addNodes({{document->currentLayer(), {createBrushNode("other_material")}}});
+
+  autosaver.finishPendingAutosave(logger);
+
+  CHECK(env.loadFile("autosave/test.1.map") == expected);
+  CHECK_FALSE(env.fileExists("autosave/test.1.map.tmp"));
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverWritesOnWorkerThread")
+{
+  using namespace std::chrono_literals;
+
+  auto env = io::TestEnvironment{};
+  auto logger = NullLogger{};
+
+  document->saveDocumentAs(env.dir() / "test.map");
+  assert(env.fileExists("test.map"));
+
+  auto autosaver = Autosaver{document, 0s};
+
+  // add a point entity so that serializing the document does not need the task manager
+  document->addNodes({{document->currentLayer(), {new mdl::EntityNode{{}}}}});
+
+  // block the only worker thread of the task manager
+  auto release = std::promise<void>{};
+  auto blocker = taskManager->run_task(
+    std::function{[released = release.get_future().share()]() {
+      released.wait();
+      return true;
+    }});
+
+  autosaver.triggerAutosave(logger);
+  CHECK_FALSE(env.fileExists("autosave/test.1.map"));
+
+  release.set_value();
+  blocker.wait();
+
+  autosaver.finishPendingAutosave(logger);
+  CHECK(env.fileExists("autosave/test.1.map"));
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 {
   using namespace std::chrono_literals;
@@ -219,6 +288,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.finishPendingAutosave(logger);
 
     const auto allPaths = kdl::vec_push_back(initialPaths, "autosave/test.3.map");
 
@@ -245,6 +315,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.finishPendingAutosave(logger);
 
     CHECK(env.directoryContents("autosave") == allPaths);
     CHECK(
@@ -310,6 +381,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.finishPendingAutosave(logger);
 
     const auto allPaths = std::vector<std::filesystem::path>{
       "autosave/test.1.map",
@@ -359,6 +431,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesP
   document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.2.map"));
 }
@@ -0,0 +1,210 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ui/CellLayout.h"
+
+#include <any>
+#include <string>
+
+#include "Catch2.h"
+
+namespace tb::ui
+{
+namespace
+{
+
+void setupLayout(CellLayout& layout, const bool virtualized)
+{
+  layout.setOuterMargin(5.0f);
+  layout.setGroupMargin(5.0f);
+  layout.setRowMargin(15.0f);
+  layout.setCellMargin(10.0f);
+  layout.setTitleMargin(2.0f);
+  layout.setCellWidth(64.0f, 64.0f);
+  layout.setCellHeight(64.0f, 128.0f);
+  layout.setVirtualized(virtualized);
+  layout.setWidth(400.0f);
+}
+
+void addItems(CellLayout& layout, const size_t groupCount, const size_t itemCount)
+{
+  for (size_t i = 0; i < groupCount; ++i)
+  {
+    layout.addGroup("group " + std::to_string(i), 14.0f);
+    for (size_t j = 0; j < itemCount; ++j)
+    {
+      const auto index = int(i * itemCount + j);
+      const auto size = float(16 << (index % 5));
+      layout.addItem(
+        index,
+        std::to_string(index),
+        size,
+        float(16 << ((index / 3) % 4)),
+        float(20 + index % 60),
+        float(12 + index % 3));
+    }
+  }
+}
+
+void checkBounds(const LayoutBounds& actual, const LayoutBounds& expected)
+{
+  CHECK(actual.x == Approx(expected.x));
+  CHECK(actual.y == Approx(expected.y));
+  CHECK(actual.width == Approx(expected.width));
+  CHECK(actual.height == Approx(expected.height));
+}
+
+void checkCell(const LayoutCell& actual, const LayoutCell& expected)
+{
+  CHECK(actual.itemAs<int>() == expected.itemAs<int>());
+  CHECK(actual.title() == expected.title());
+  checkBounds(actual.cellBounds(), expected.cellBounds());
+  checkBounds(actual.itemBounds(), expected.itemBounds());
+  checkBounds(actual.titleBounds(), expected.titleBounds());
+}
+
+void checkLayout(CellLayout& actual, CellLayout& expected)
+{
+  CHECK(actual.height() == Approx(expected.height()));
+
+  actual.materializeRows(0.0f, actual.height());
+
+  const auto& actualGroups = actual.groups();
+  const auto& expectedGroups = expected.groups();
+  REQUIRE(actualGroups.size() == expectedGroups.size());
+
+  for (size_t i = 0; i < actualGroups.size(); ++i)
+  {
+    const auto& actualGroup = actualGroups[i];
+    const auto& expectedGroup = expectedGroups[i];
+    checkBounds(actualGroup.bounds(), expectedGroup.bounds());
+
+    REQUIRE(actualGroup.rowCount() == expectedGroup.rowCount());
+    REQUIRE(actualGroup.rows().size() == expectedGroup.rows().size());
+    for (size_t j = 0; j < actualGroup.rowCount(); ++j)
+    {
+      checkBounds(actualGroup.rowBounds(j), expectedGroup.rowBounds(j));
+
+      const auto& actualCells = actualGroup.rows()[j].cells();
+      const auto& expectedCells = expectedGroup.rows()[j].cells();
+      REQUIRE(actualCells.size() == expectedCells.size());
+      for (size_t k = 0; k < actualCells.size(); ++k)
+      {
+        checkCell(actualCells[k], expectedCells[k]);
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("CellLayout.virtualized")
+{
+  auto eagerLayout = CellLayout{};
+  setupLayout(eagerLayout, false);
+  addItems(eagerLayout, 3, 50);
+
+  auto virtualLayout = CellLayout{};
+  setupLayout(virtualLayout, true);
+  addItems(virtualLayout, 3, 50);
+
+  SECTION("Row and cell positions match the eager layout")
+  {
+    checkLayout(virtualLayout, eagerLayout);
+  }
+
+  SECTION("Changing the width lays out the items again")
+  {
+    eagerLayout.setWidth(650.0f);
+    virtualLayout.setWidth(650.0f);
+    checkLayout(virtualLayout, eagerLayout);
+  }
+
+  SECTION("Only rows intersecting the given range are materialized")
+  {
+    const auto& expectedGroup = eagerLayout.groups()[1];
+    const auto y = expectedGroup.rowBounds(2).top();
+    const auto height = expectedGroup.rowBounds(4).bottom() - y;
+
+    virtualLayout.materializeRows(y, height);
+
+    const auto& groups = virtualLayout.groups();
+    CHECK(groups[0].rows().empty());
+    CHECK(groups[1].rows().size() == 3u);
+    CHECK(groups[2].rows().empty());
+
+    checkCell(
+      groups[1].rows().front().cells().front(),
+      expectedGroup.rows()[2].cells().front());
+  }
+
+  SECTION("cellAt")
+  {
+    for (const auto& group : eagerLayout.groups())
+    {
+      for (const auto& row : group.rows())
+      {
+        for (const auto& cell : row.cells())
+        {
+          const auto& bounds = cell.cellBounds();
+          const auto x = bounds.left() + bounds.width / 2.0f;
+          const auto y = bounds.top() + bounds.height / 2.0f;
+
+          const auto* actualCell = virtualLayout.cellAt(x, y);
+          REQUIRE(actualCell != nullptr);
+          checkCell(*actualCell, cell);
+        }
+      }
+    }
+
+    CHECK(virtualLayout.cellAt(0.0f, 0.0f) == nullptr);
+  }
+
+  SECTION("findCell")
+  {
+    const auto hasIndex = [](const int index) {
+      return [=](const auto& item) { return std::any_cast<int>(item) == index; };
+    };
+
+    const auto* cell = virtualLayout.findCell(hasIndex(77));
+    const auto* expectedCell = eagerLayout.findCell(hasIndex(77));
+
+    REQUIRE(cell != nullptr);
+    REQUIRE(expectedCell != nullptr);
+    checkCell(*cell, *expectedCell);
+
+    CHECK(virtualLayout.findCell(hasIndex(-1)) == nullptr);
+  }
+
+  SECTION("rowPosition")
+  {
+    for (const auto y : {0.0f, 100.0f, 500.0f, 1234.0f})
+    {
+      for (const auto offset : {-3, -1, 0, 1, 2, 10})
+      {
+        CAPTURE(y, offset);
+        CHECK(
+          virtualLayout.rowPosition(y, offset)
+          == Approx(eagerLayout.rowPosition(y, offset)));
+      }
+    }
+  }
+}
+
+} // namespace tb::ui
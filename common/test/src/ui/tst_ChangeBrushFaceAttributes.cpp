@@ -29,7 +29,10 @@
 #include "ui/MapDocument.h"
 #include "ui/MapDocumentTest.h"
 
+#include "kdl/vector_utils.h"
+
 #include <filesystem>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -257,6 +260,49 @@ TEST_CASE_METHOD(
   CHECK(!brushNode->brush().face(0).attributes().hasSurfaceAttributes());
 }
 
+TEST_CASE_METHOD(ValveMapDocumentTest, "ChangeBrushFaceAttributesTest.manyBrushes")
+{
+  // enough brushes to be changed in several parallel chunks
+  auto brushNodes = std::vector<mdl::Node*>{};
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    brushNodes.push_back(createBrushNode(i % 2 == 0 ? "original" : "replacement"));
+  }
+  document->addNodes({{document->parentForNodes(), brushNodes}});
+  document->selectNodes(brushNodes);
+
+  const auto firstFaces = kdl::vec_transform(brushNodes, [](const auto* node) {
+    return &static_cast<const mdl::BrushNode*>(node)->brush().face(0);
+  });
+
+  auto request = mdl::ChangeBrushFaceAttributesRequest{};
+  request.setMaterialName("replacement");
+  CHECK(document->setFaceAttributes(request));
+
+  for (size_t i = 0; i < brushNodes.size(); ++i)
+  {
+    const auto* brushNode = static_cast<const mdl::BrushNode*>(brushNodes[i]);
+    for (const auto& face : brushNode->brush().faces())
+    {
+      REQUIRE(face.attributes().materialName() == "replacement");
+    }
+
+    // unchanged brushes are not replaced
+    CHECK((&brushNode->brush().face(0) == firstFaces[i]) == (i % 2 == 1));
+  }
+
+  document->undoCommand();
+  for (size_t i = 0; i < brushNodes.size(); ++i)
+  {
+    const auto* brushNode = static_cast<const mdl::BrushNode*>(brushNodes[i]);
+    for (const auto& face : brushNode->brush().faces())
+    {
+      REQUIRE(
+        face.attributes().materialName() == (i % 2 == 0 ? "original" : "replacement"));
+    }
+  }
+}
+
 TEST_CASE("ChangeBrushFaceAttributesTest.Quake2IntegrationTest")
 {
   const int WaterFlag = 32;
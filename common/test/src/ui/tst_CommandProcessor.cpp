@@ -20,8 +20,12 @@
 #include "Macros.h"
 #include "NotifierConnection.h"
 #include "TestUtils.h"
+#include "mdl/BrushNode.h"
+#include "mdl/NodeContentsDelta.h"
+#include "ui/AddRemoveNodesCommand.h"
 #include "ui/CommandProcessor.h"
 #include "ui/MapDocumentCommandFacade.h"
+#include "ui/MapDocumentTest.h"
 #include "ui/TransactionScope.h"
 #include "ui/UndoableCommand.h"
 
@@ -244,6 +248,21 @@ public:
   }
 };
 
+class SizedCommand : public NullCommand
+{
+private:
+  size_t m_memorySize;
+
+public:
+  SizedCommand(std::string name, const size_t memorySize)
+    : NullCommand{std::move(name)}
+    , m_memorySize{memorySize}
+  {
+  }
+
+  size_t memorySize() const override { return m_memorySize; }
+};
+
 } // namespace
 
 TEST_CASE("CommandProcessorTest.doAndUndoSuccessfulCommand")
@@ -845,4 +864,86 @@ TEST_CASE("CommandProcessorTest.collateTransactions")
   commandProcessor.undo();
 }
 
+TEST_CASE("CommandProcessorTest.memoryBudget")
+{
+  auto taskManager = createTestTaskManager();
+  auto facade = MapDocumentCommandFacade{*taskManager};
+  auto commandProcessor = CommandProcessor{facade};
+
+  REQUIRE(commandProcessor.memoryBudget() == 0);
+
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd1", 100));
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd2", 200));
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd3", 300));
+
+  CHECK(commandProcessor.memoryUsage() == 600);
+
+  SECTION("Reports memory usage per command")
+  {
+    const auto usage = commandProcessor.undoStackMemoryUsage();
+    CHECK(
+      kdl::vec_transform(usage, [](const auto& u) { return u.name; })
+      == std::vector<std::string>{"cmd1", "cmd2", "cmd3"});
+    CHECK(
+      kdl::vec_transform(usage, [](const auto& u) { return u.memorySize; })
+      == std::vector<size_t>{100, 200, 300});
+  }
+
+  SECTION("Setting a budget evicts the oldest commands")
+  {
+    commandProcessor.setMemoryBudget(500);
+    CHECK(commandProcessor.memoryUsage() == 500);
+    CHECK(commandProcessor.undoStackMemoryUsage().size() == 2);
+
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd4", 150));
+    CHECK(commandProcessor.memoryUsage() == 450);
+
+    CHECK(commandProcessor.undo()->success());
+    CHECK(commandProcessor.undo()->success());
+    CHECK_FALSE(commandProcessor.canUndo());
+  }
+
+  SECTION("The most recent command is always kept")
+  {
+    commandProcessor.setMemoryBudget(1);
+    CHECK(commandProcessor.undoStackMemoryUsage().size() == 1);
+    CHECK(commandProcessor.undoCommandName() == "cmd3");
+  }
+
+  SECTION("Undone commands count towards the budget")
+  {
+    CHECK(commandProcessor.undo()->success());
+    commandProcessor.setMemoryBudget(400);
+
+    CHECK(commandProcessor.undoStackMemoryUsage().size() == 1);
+    CHECK(commandProcessor.undoCommandName() == "cmd2");
+    CHECK(commandProcessor.redoCommandName() == "cmd3");
+  }
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "CommandProcessorTest.memoryBudgetEvictsDeletedNodes")
+{
+  auto& facade = static_cast<MapDocumentCommandFacade&>(*document);
+  auto commandProcessor = CommandProcessor{facade};
+
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+
+  const auto brushNodeSize = mdl::memorySize(*brushNode);
+
+  commandProcessor.executeAndStore(
+    AddRemoveNodesCommand::remove({{brushNode->parent(), {brushNode}}}));
+
+  // the deleted node is owned by the command
+  REQUIRE(commandProcessor.memoryUsage() > brushNodeSize);
+
+  commandProcessor.setMemoryBudget(brushNodeSize);
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("cmd", 100));
+
+  CHECK(
+    kdl::vec_transform(
+      commandProcessor.undoStackMemoryUsage(), [](const auto& u) { return u.name; })
+    == std::vector<std::string>{"cmd"});
+}
+
 } // namespace tb::ui
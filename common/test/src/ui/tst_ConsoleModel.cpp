@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QSignalSpy>
+
+#include "Logger.h"
+#include "ui/ConsoleModel.h"
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::ui
+{
+
+TEST_CASE("ConsoleModel")
+{
+  auto model = ConsoleModel{QPalette{}};
+  auto insertSpy = QSignalSpy{&model, &QAbstractItemModel::rowsInserted};
+  auto changeSpy = QSignalSpy{&model, &QAbstractItemModel::dataChanged};
+
+  SECTION("Messages are appended in one batch")
+  {
+    model.append({
+      {LogLevel::Info, "a"},
+      {LogLevel::Warn, "b"},
+      {LogLevel::Error, "c"},
+    });
+
+    CHECK(model.rowCount({}) == 3);
+    CHECK(model.text(0) == "a");
+    CHECK(model.text(1) == "b");
+    CHECK(model.text(2) == "c");
+    CHECK(insertSpy.count() == 1);
+    CHECK(changeSpy.count() == 0);
+  }
+
+  SECTION("Repeated messages are counted")
+  {
+    model.append({
+      {LogLevel::Warn, "a"},
+      {LogLevel::Warn, "b"},
+      {LogLevel::Warn, "a"},
+      {LogLevel::Error, "a"},
+    });
+
+    CHECK(model.rowCount({}) == 3);
+    CHECK(model.repeatCount(0) == 2);
+    CHECK(model.repeatCount(1) == 1);
+    CHECK(model.repeatCount(2) == 1);
+    CHECK(model.text(0) == "a (2 times)");
+
+    model.append({
+      {LogLevel::Warn, "b"},
+      {LogLevel::Warn, "b"},
+      {LogLevel::Info, "d"},
+    });
+
+    CHECK(model.rowCount({}) == 4);
+    CHECK(model.repeatCount(1) == 3);
+    CHECK(model.text(3) == "d");
+    CHECK(insertSpy.count() == 2);
+    CHECK(changeSpy.count() == 1);
+  }
+
+  SECTION("Only recent messages are counted")
+  {
+    auto messages = std::vector<LogMessage>{};
+    for (size_t i = 0; i < ConsoleModel::DuplicateWindow; ++i)
+    {
+      messages.push_back({LogLevel::Info, std::to_string(i)});
+    }
+    model.append(messages);
+    model.append(messages);
+
+    CHECK(model.rowCount({}) == int(ConsoleModel::DuplicateWindow));
+    CHECK(model.repeatCount(0) == 2);
+
+    model.append({{LogLevel::Info, "x"}, {LogLevel::Info, "0"}});
+
+    CHECK(model.rowCount({}) == int(ConsoleModel::DuplicateWindow) + 2);
+    CHECK(model.repeatCount(0) == 2);
+    CHECK(model.text(int(ConsoleModel::DuplicateWindow) + 1) == "0");
+  }
+
+  SECTION("Oldest rows are removed beyond the row limit")
+  {
+    auto removeSpy = QSignalSpy{&model, &QAbstractItemModel::rowsRemoved};
+
+    auto messages = std::vector<LogMessage>{};
+    for (size_t i = 0; i < ConsoleModel::MaxRows; ++i)
+    {
+      messages.push_back({LogLevel::Info, std::to_string(i)});
+    }
+    model.append(messages);
+
+    CHECK(model.rowCount({}) == int(ConsoleModel::MaxRows));
+    CHECK(removeSpy.count() == 0);
+
+    model.append({{LogLevel::Info, "x"}, {LogLevel::Info, "y"}});
+
+    CHECK(model.rowCount({}) == int(ConsoleModel::MaxRows));
+    CHECK(model.text(0) == "2");
+    CHECK(model.text(int(ConsoleModel::MaxRows) - 1) == "y");
+    CHECK(removeSpy.count() == 1);
+
+    messages.push_back({LogLevel::Info, "z"});
+    model.append(messages);
+
+    CHECK(model.rowCount({}) == int(ConsoleModel::MaxRows));
+    CHECK(model.text(0) == "1");
+    CHECK(model.text(int(ConsoleModel::MaxRows) - 1) == "z");
+  }
+
+  SECTION("Clearing removes all rows")
+  {
+    model.append({{LogLevel::Info, "a"}});
+    model.clear();
+
+    CHECK(model.rowCount({}) == 0);
+  }
+}
+
+} // namespace tb::ui
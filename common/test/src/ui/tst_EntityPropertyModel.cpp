@@ -0,0 +1,169 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/Group.h"
+#include "mdl/GroupNode.h"
+#include "ui/EntityPropertyModel.h"
+
+#include "kdl/vector_set.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::ui
+{
+namespace
+{
+
+/**
+ * Builds the rows by merging the given nodes one by one, in the given order.
+ */
+std::map<std::string, PropertyRow> mergeRows(
+  const std::vector<const mdl::EntityNodeBase*>& nodes)
+{
+  auto keys = kdl::vector_set<std::string>{};
+  for (const auto* node : nodes)
+  {
+    for (const auto& property : node->entity().properties())
+    {
+      keys.insert(property.key());
+    }
+    const auto& protectedProperties = node->entity().protectedProperties();
+    keys.insert(protectedProperties.begin(), protectedProperties.end());
+  }
+
+  auto result = std::map<std::string, PropertyRow>{};
+  for (const auto& key : keys)
+  {
+    auto row = PropertyRow{key, nodes.front()};
+    for (auto it = std::next(nodes.begin()); it != nodes.end(); ++it)
+    {
+      row.merge(*it);
+    }
+    result.emplace(key, std::move(row));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("PropertyRowAggregator")
+{
+  auto groupNode = mdl::GroupNode{mdl::Group{"group"}};
+
+  auto* entityNode1 = new mdl::EntityNode{mdl::Entity{{
+    {"classname", "light"},
+    {"light", "300"},
+    {"target", "door"},
+  }}};
+  auto* entityNode2 = new mdl::EntityNode{mdl::Entity{{
+    {"classname", "light"},
+    {"light", "200"},
+  }}};
+  auto* entityNode3 = new mdl::EntityNode{mdl::Entity{{
+    {"classname", "light"},
+    {"light", "300"},
+    {"style", "1"},
+  }}};
+  groupNode.addChildren({entityNode1, entityNode2, entityNode3});
+
+  auto entity1 = entityNode1->entity();
+  entity1.setProtectedProperties({"target", "light"});
+  entityNode1->setEntity(std::move(entity1));
+
+  auto aggregator = PropertyRowAggregator{false};
+
+  SECTION("Empty aggregator has no rows")
+  {
+    CHECK(aggregator.rows(nullptr).empty());
+  }
+
+  SECTION("Single node")
+  {
+    aggregator.addNode(*entityNode2);
+    CHECK(aggregator.rows(entityNode2) == mergeRows({entityNode2}));
+  }
+
+  SECTION("Multiple nodes")
+  {
+    aggregator.addNode(*entityNode1);
+    aggregator.addNode(*entityNode2);
+    aggregator.addNode(*entityNode3);
+
+    const auto rows = aggregator.rows(entityNode1);
+    CHECK(rows == mergeRows({entityNode1, entityNode2, entityNode3}));
+
+    CHECK(rows.at("classname").value() == "light");
+    CHECK(rows.at("light").multi());
+    CHECK(rows.at("light").isProtected() == PropertyProtection::Mixed);
+    CHECK(rows.at("style").subset());
+    CHECK(rows.at("target").isProtected() == PropertyProtection::Mixed);
+  }
+
+  SECTION("Removing nodes")
+  {
+    aggregator.addNode(*entityNode1);
+    aggregator.addNode(*entityNode2);
+    aggregator.addNode(*entityNode3);
+
+    aggregator.removeNode(entityNode2);
+    CHECK_FALSE(aggregator.contains(entityNode2));
+    CHECK(aggregator.rows(entityNode1) == mergeRows({entityNode1, entityNode3}));
+
+    aggregator.removeNode(entityNode1);
+    CHECK(aggregator.rows(entityNode3) == mergeRows({entityNode3}));
+    CHECK_FALSE(aggregator.rows(entityNode3).contains("target"));
+
+    aggregator.removeNode(entityNode3);
+    CHECK(aggregator.rows(nullptr).empty());
+  }
+
+  SECTION("Updating nodes")
+  {
+    aggregator.addNode(*entityNode1);
+    aggregator.addNode(*entityNode2);
+    aggregator.addNode(*entityNode3);
+
+    auto entity2 = entityNode2->entity();
+    entity2.addOrUpdateProperty("light", "300");
+    entity2.addOrUpdateProperty("wait", "2");
+    entityNode2->setEntity(std::move(entity2));
+    aggregator.updateNode(*entityNode2);
+
+    CHECK(
+      aggregator.rows(entityNode1) == mergeRows({entityNode1, entityNode2, entityNode3}));
+    CHECK(aggregator.rows(entityNode1).at("light").value() == "300");
+
+    auto entity3 = entityNode3->entity();
+    entity3.removeProperty("style");
+    entityNode3->setEntity(std::move(entity3));
+    aggregator.updateNode(*entityNode3);
+
+    CHECK(
+      aggregator.rows(entityNode1) == mergeRows({entityNode1, entityNode2, entityNode3}));
+    CHECK_FALSE(aggregator.rows(entityNode1).contains("style"));
+  }
+}
+
+} // namespace tb::ui
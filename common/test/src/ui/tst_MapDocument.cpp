@@ -20,6 +20,7 @@
 #include "Exceptions.h"
 #include "MapDocumentTest.h"
 #include "TestUtils.h"
+#include "io/BinaryMapReader.h"
 #include "io/MapHeader.h"
 #include "io/TestEnvironment.h"
 #include "io/WorldReader.h"
@@ -802,6 +803,32 @@ TEST_CASE("MapDocumentTest")
         ui::loadMapDocument(env.dir() / newDocumentPath, "Quake", mdl::MapFormat::Valve);
       CHECK(document->world()->customLayers().empty());
     }
+
+    SECTION("export binary map")
+    {
+      const auto newDocumentPath = std::filesystem::path{"test.tbmap"};
+
+      {
+        auto [document, game, gameConfig, taskManager] =
+          ui::newMapDocument("Quake", mdl::MapFormat::Valve);
+
+        auto layer = mdl::Layer{"Layer"};
+        layer.setOmitFromExport(true);
+
+        auto* layerNode = new mdl::LayerNode{std::move(layer)};
+        document->addNodes({{document->world(), {layerNode}}});
+
+        REQUIRE(
+          document->exportDocumentAs(io::MapExportOptions{env.dir() / newDocumentPath})
+            .is_success());
+        REQUIRE(env.fileExists(newDocumentPath));
+        CHECK(io::isBinaryMap(env.loadFile(newDocumentPath)));
+      }
+
+      auto [document, game, gameConfig, taskManager] =
+        ui::loadMapDocument(env.dir() / newDocumentPath, "Quake", mdl::MapFormat::Valve);
+      CHECK(document->world()->customLayers().empty());
+    }
   }
 
   SECTION("reloadMaterialCollections")
@@ -22,8 +22,12 @@
 #include "mdl/EntityNode.h"
 #include "ui/Transaction.h"
 
+#include "kdl/vector_utils.h"
+
 #include "vm/mat_ext.h"
 
+#include <vector>
+
 #include "Catch2.h"
 
 namespace tb::ui
@@ -86,4 +90,38 @@ TEST_CASE_METHOD(MapDocumentTest, "Transaction")
   }
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "Transaction.batchesNotifications")
+{
+  auto batchedCalls = std::vector<std::vector<mdl::Node*>>{};
+  auto connection = document->notificationBatch().connect(
+    document->nodesDidChangeNotifier,
+    [&](const std::vector<mdl::Node*>& nodes) { batchedCalls.push_back(nodes); });
+
+  auto* entityNode = new mdl::EntityNode{mdl::Entity{}};
+  document->addNodes({{document->parentForNodes(), {entityNode}}});
+  document->selectNodes({entityNode});
+
+  auto transaction = Transaction{document};
+  document->transformObjects("translate", vm::translation_matrix(vm::vec3d{1, 0, 0}));
+  document->transformObjects("translate", vm::translation_matrix(vm::vec3d{1, 0, 0}));
+
+  CHECK(batchedCalls.empty());
+
+  SECTION("commit")
+  {
+    transaction.commit();
+    CHECK(batchedCalls.size() == 1u);
+    CHECK(kdl::vec_contains(batchedCalls.front(), entityNode));
+  }
+
+  SECTION("cancel")
+  {
+    transaction.cancel();
+    CHECK(batchedCalls.size() == 1u);
+  }
+
+  document->transformObjects("translate", vm::translation_matrix(vm::vec3d{1, 0, 0}));
+  CHECK(batchedCalls.size() == 2u);
+}
+
 } // namespace tb::ui
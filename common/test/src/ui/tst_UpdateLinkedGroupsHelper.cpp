@@ -218,6 +218,94 @@ TEST_CASE_METHOD(UpdateLinkedGroupsHelperTest, "applyLinkedGroupUpdates")
     == originalBrushBounds.translate(vm::vec3d(32.0, 0.0, 0.0)));
 }
 
+TEST_CASE_METHOD(UpdateLinkedGroupsHelperTest, "applyLinkedNodeUpdates")
+{
+  auto* groupNode = new mdl::GroupNode{mdl::Group{"test"}};
+  setLinkId(*groupNode, "asdf");
+
+  auto* brushNode = createBrushNode();
+  auto* entityNode = new mdl::EntityNode{mdl::Entity{}};
+  groupNode->addChildren({brushNode, entityNode});
+
+  auto* linkedGroupNode =
+    static_cast<mdl::GroupNode*>(groupNode->cloneRecursively(document->worldBounds()));
+
+  REQUIRE(linkedGroupNode->children().size() == 2u);
+  auto* linkedBrushNode =
+    dynamic_cast<mdl::BrushNode*>(linkedGroupNode->children().front());
+  auto* linkedEntityNode =
+    dynamic_cast<mdl::EntityNode*>(linkedGroupNode->children().back());
+  REQUIRE(linkedBrushNode != nullptr);
+  REQUIRE(linkedEntityNode != nullptr);
+
+  transformNode(
+    *linkedGroupNode,
+    vm::translation_matrix(vm::vec3d(32.0, 0.0, 0.0)),
+    document->worldBounds());
+
+  document->addNodes({{document->parentForNodes(), {groupNode, linkedGroupNode}}});
+
+  const auto originalBrushBounds = brushNode->physicalBounds();
+  const auto originalEntityOrigin = linkedEntityNode->entity().origin();
+
+  transformNode(
+    *brushNode,
+    vm::translation_matrix(vm::vec3d(0.0, 16.0, 0.0)),
+    document->worldBounds());
+
+  SECTION("Only the changed nodes are updated")
+  {
+    auto helper = UpdateLinkedGroupsHelper{{groupNode}, {{brushNode}}};
+    REQUIRE(
+      helper
+        .applyLinkedGroupUpdates(*static_cast<MapDocumentCommandFacade*>(document.get()))
+        .is_success());
+
+    // the linked nodes were updated in place
+    CHECK_THAT(
+      linkedGroupNode->children(),
+      Catch::Equals(std::vector<mdl::Node*>{linkedBrushNode, linkedEntityNode}));
+    CHECK(
+      linkedBrushNode->physicalBounds()
+      == originalBrushBounds.translate(vm::vec3d(32.0, 16.0, 0.0)));
+    CHECK(linkedEntityNode->entity().origin() == originalEntityOrigin);
+
+    helper.undoLinkedGroupUpdates(
+      *static_cast<MapDocumentCommandFacade*>(document.get()));
+
+    CHECK_THAT(
+      linkedGroupNode->children(),
+      Catch::Equals(std::vector<mdl::Node*>{linkedBrushNode, linkedEntityNode}));
+    CHECK(
+      linkedBrushNode->physicalBounds()
+      == originalBrushBounds.translate(vm::vec3d(32.0, 0.0, 0.0)));
+  }
+
+  SECTION("Linked groups with a different structure are replaced")
+  {
+    groupNode->addChild(new mdl::EntityNode{mdl::Entity{}});
+
+    auto helper = UpdateLinkedGroupsHelper{{groupNode}, {{brushNode}}};
+    REQUIRE(
+      helper
+        .applyLinkedGroupUpdates(*static_cast<MapDocumentCommandFacade*>(document.get()))
+        .is_success());
+
+    REQUIRE(linkedGroupNode->childCount() == 3u);
+    CHECK(linkedBrushNode->parent() == nullptr);
+    CHECK(
+      linkedGroupNode->children().front()->physicalBounds()
+      == originalBrushBounds.translate(vm::vec3d(32.0, 16.0, 0.0)));
+
+    helper.undoLinkedGroupUpdates(
+      *static_cast<MapDocumentCommandFacade*>(document.get()));
+
+    CHECK_THAT(
+      linkedGroupNode->children(),
+      Catch::Equals(std::vector<mdl::Node*>{linkedBrushNode, linkedEntityNode}));
+  }
+}
+
 static void setGroupName(mdl::GroupNode& groupNode, const std::string& name)
 {
   auto group = groupNode.group();
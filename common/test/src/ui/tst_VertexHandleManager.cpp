@@ -0,0 +1,343 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/PickResult.h"
+#include "render/PerspectiveCamera.h"
+#include "ui/Grid.h"
+#include "ui/VertexHandleManager.h"
+
+#include "kdl/result.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+#include "vm/polygon.h"
+#include "vm/ray.h"
+#include "vm/segment.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::ui
+{
+namespace
+{
+
+const auto CameraPosition = vm::vec3d{512, 0, 0};
+
+render::PerspectiveCamera makeCamera()
+{
+  return render::PerspectiveCamera{
+    90.0f,
+    1.0f,
+    4096.0f,
+    render::Camera::Viewport{0, 0, 800, 600},
+    vm::vec3f{CameraPosition},
+    vm::vec3f{-1, 0, 0},
+    vm::vec3f{0, 0, 1}};
+}
+
+vm::ray3d makePickRay(const vm::vec3d& target)
+{
+  return vm::ray3d{CameraPosition, vm::normalize(target - CameraPosition)};
+}
+
+std::unique_ptr<mdl::BrushNode> makeCube(const vm::vec3d& center, const double size)
+{
+  const auto halfSize = vm::vec3d::fill(size / 2.0);
+  return std::make_unique<mdl::BrushNode>(
+    mdl::BrushBuilder{mdl::MapFormat::Standard, vm::bbox3d{8192.0}}.createCuboid(
+      vm::bbox3d{center - halfSize, center + halfSize}, "material")
+    | kdl::value());
+}
+
+/**
+ * Returns a grid of cubes in front of the camera whose handles are spread out enough to
+ * be indexed in several nodes of the handle tree.
+ */
+std::vector<std::unique_ptr<mdl::BrushNode>> makeCubes()
+{
+  auto result = std::vector<std::unique_ptr<mdl::BrushNode>>{};
+  for (size_t y = 0; y < 4; ++y)
+  {
+    for (size_t z = 0; z < 4; ++z)
+    {
+      result.push_back(makeCube(
+        vm::vec3d{0.0, double(y) * 128.0 - 192.0, double(z) * 128.0 - 192.0}, 64.0));
+    }
+  }
+  return result;
+}
+
+template <typename T>
+std::vector<T> hitTargets(const mdl::PickResult& pickResult)
+{
+  return kdl::vec_sort(kdl::vec_transform(
+    pickResult.all(), [](const auto& hit) { return hit.template target<T>(); }));
+}
+
+/**
+ * Returns the handles whose center would be hit by the given picking ray, computed
+ * without using the handle tree.
+ */
+template <typename H>
+std::vector<H> centerHandlesHitBy(
+  const std::vector<H>& handles,
+  const vm::ray3d& pickRay,
+  const render::Camera& camera)
+{
+  const auto handleRadius = double(pref(Preferences::HandleRadius));
+  return kdl::vec_filter(handles, [&](const auto& handle) {
+    return camera.pickPointHandle(pickRay, handle.center(), handleRadius).has_value();
+  });
+}
+
+} // namespace
+
+TEST_CASE("VertexHandleManager")
+{
+  const auto camera = makeCamera();
+  const auto cubes = makeCubes();
+
+  auto manager = VertexHandleManager{};
+  for (const auto& cube : cubes)
+  {
+    manager.addHandles(cube.get());
+  }
+  REQUIRE(manager.totalHandleCount() == 8u * cubes.size());
+
+  SECTION("pick")
+  {
+    const auto handleRadius = double(pref(Preferences::HandleRadius));
+    const auto handles = manager.allHandles();
+
+    for (const auto& handle : handles)
+    {
+      CAPTURE(handle);
+
+      const auto pickRay = makePickRay(handle);
+      const auto expected = kdl::vec_filter(handles, [&](const auto& h) {
+        return camera.pickPointHandle(pickRay, h, handleRadius).has_value();
+      });
+
+      auto pickResult = mdl::PickResult{};
+      manager.pick(pickRay, camera, pickResult);
+
+      CHECK(kdl::vec_contains(expected, handle));
+      CHECK(hitTargets<vm::vec3d>(pickResult) == expected);
+    }
+
+    auto pickResult = mdl::PickResult{};
+    manager.pick(vm::ray3d{CameraPosition, vm::vec3d{1, 0, 0}}, camera, pickResult);
+    CHECK(pickResult.empty());
+  }
+
+  SECTION("select and deselect")
+  {
+    const auto handle = vm::vec3d{32, -160, -160};
+    REQUIRE(manager.contains(handle));
+
+    // handles are matched with a small tolerance
+    manager.select(handle + vm::vec3d{0, 0, 0.0000001});
+    CHECK(manager.selected(handle));
+    CHECK(manager.selectedHandleCount() == 1u);
+
+    manager.select(vm::vec3d{32, -160, -161});
+    CHECK(manager.selectedHandleCount() == 1u);
+
+    manager.deselect(handle);
+    CHECK_FALSE(manager.selected(handle));
+    CHECK(manager.selectedHandleCount() == 0u);
+  }
+
+  SECTION("duplicate handles")
+  {
+    // a cube that shares only one vertex with the first cube
+    const auto handle = vm::vec3d{32, -160, -160};
+    const auto cube = makeCube(handle + vm::vec3d{8, 8, 8}, 16.0);
+
+    manager.addHandles(cube.get());
+    CHECK(manager.totalHandleCount() == 8u * cubes.size() + 7u);
+
+    manager.select(handle);
+    CHECK(manager.selectedHandleCount() == 1u);
+
+    manager.removeHandles(cube.get());
+    CHECK(manager.contains(handle));
+    CHECK(manager.selected(handle));
+
+    manager.removeHandles(cubes.front().get());
+    CHECK_FALSE(manager.contains(handle));
+    CHECK(manager.selectedHandleCount() == 0u);
+
+    // removed handles are no longer found in the handle tree
+    manager.select(handle);
+    CHECK(manager.selectedHandleCount() == 0u);
+
+    auto pickResult = mdl::PickResult{};
+    manager.pick(makePickRay(handle), camera, pickResult);
+    CHECK_FALSE(kdl::vec_contains(hitTargets<vm::vec3d>(pickResult), handle));
+  }
+
+  SECTION("clear")
+  {
+    manager.select(vm::vec3d{32, -160, -160});
+    manager.clear();
+
+    CHECK(manager.totalHandleCount() == 0u);
+    CHECK(manager.selectedHandleCount() == 0u);
+
+    auto pickResult = mdl::PickResult{};
+    manager.pick(makePickRay(vm::vec3d{32, -160, -160}), camera, pickResult);
+    CHECK(pickResult.empty());
+  }
+}
+
+TEST_CASE("EdgeHandleManager")
+{
+  const auto camera = makeCamera();
+  const auto cubes = makeCubes();
+
+  auto manager = EdgeHandleManager{};
+  for (const auto& cube : cubes)
+  {
+    manager.addHandles(cube.get());
+  }
+  REQUIRE(manager.totalHandleCount() == 12u * cubes.size());
+
+  SECTION("select and deselect")
+  {
+    const auto handle = vm::segment3d{{32, -160, -224}, {32, -160, -160}};
+    REQUIRE(manager.contains(handle));
+
+    manager.select(handle);
+    CHECK(manager.selected(handle));
+    CHECK(manager.selectedHandleCount() == 1u);
+
+    manager.deselect(handle);
+    CHECK(manager.selectedHandleCount() == 0u);
+  }
+
+  SECTION("pickCenterHandle")
+  {
+    const auto handles = manager.allHandles();
+    for (const auto& handle : handles)
+    {
+      CAPTURE(handle);
+
+      const auto pickRay = makePickRay(handle.center());
+      const auto expected = centerHandlesHitBy(handles, pickRay, camera);
+
+      auto pickResult = mdl::PickResult{};
+      manager.pickCenterHandle(pickRay, camera, pickResult);
+
+      CHECK(kdl::vec_contains(expected, handle));
+      CHECK(hitTargets<vm::segment3d>(pickResult) == expected);
+    }
+  }
+
+  SECTION("pickGridHandle")
+  {
+    const auto grid = Grid{4};
+    const auto handle = vm::segment3d{{32, -160, -224}, {32, -160, -160}};
+    const auto gridPoint = vm::vec3d{32, -160, -192};
+
+    auto pickResult = mdl::PickResult{};
+    manager.pickGridHandle(makePickRay(gridPoint), camera, grid, pickResult);
+
+    CHECK(kdl::vec_contains(
+      hitTargets<EdgeHandleManager::HitType>(pickResult),
+      EdgeHandleManager::HitType{handle, gridPoint}));
+  }
+}
+
+TEST_CASE("FaceHandleManager")
+{
+  const auto camera = makeCamera();
+  const auto cubes = makeCubes();
+
+  auto manager = FaceHandleManager{};
+  for (const auto& cube : cubes)
+  {
+    manager.addHandles(cube.get());
+  }
+  REQUIRE(manager.totalHandleCount() == 6u * cubes.size());
+
+  const auto findHandle = [&](const vm::vec3d& center) {
+    const auto handles = manager.allHandles();
+    const auto it = std::ranges::find_if(
+      handles, [&](const auto& handle) { return handle.center() == center; });
+    REQUIRE(it != handles.end());
+    return *it;
+  };
+
+  SECTION("select and deselect")
+  {
+    const auto handle = findHandle(vm::vec3d{32, -192, -192});
+
+    manager.select(handle);
+    CHECK(manager.selected(handle));
+    CHECK(manager.selectedHandleCount() == 1u);
+
+    manager.deselect(handle);
+    CHECK(manager.selectedHandleCount() == 0u);
+  }
+
+  SECTION("pickCenterHandle")
+  {
+    const auto handles = manager.allHandles();
+    for (const auto& handle : handles)
+    {
+      CAPTURE(handle);
+
+      const auto pickRay = makePickRay(handle.center());
+      const auto expected = centerHandlesHitBy(handles, pickRay, camera);
+
+      auto pickResult = mdl::PickResult{};
+      manager.pickCenterHandle(pickRay, camera, pickResult);
+
+      CHECK(kdl::vec_contains(expected, handle));
+      CHECK(hitTargets<vm::polygon3d>(pickResult) == expected);
+    }
+  }
+
+  SECTION("pickGridHandle")
+  {
+    const auto grid = Grid{4};
+    const auto handle = findHandle(vm::vec3d{32, -192, -192});
+    const auto gridPoint = vm::vec3d{32, -176, -208};
+
+    auto pickResult = mdl::PickResult{};
+    manager.pickGridHandle(makePickRay(gridPoint), camera, grid, pickResult);
+
+    CHECK(kdl::vec_contains(
+      hitTargets<FaceHandleManager::HitType>(pickResult),
+      FaceHandleManager::HitType{handle, gridPoint}));
+  }
+}
+
+} // namespace tb::ui
@@ -20,7 +20,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <string_view>
 
 namespace kdl
 {
@@ -49,4 +52,35 @@ auto hash(const A& arg, const Rest&... rest)
   return combine_hash(hash(arg), hash(rest...));
 }
 
+/**
+ * The initial value of a 64 bit FNV-1a hash.
+ */
+constexpr auto fnv1a_64_offset_basis = std::uint64_t(14695981039346656037u);
+
+/**
+ * Adds the given bytes to the given 64 bit FNV-1a hash and returns the result.
+ *
+ * Unlike std::hash, the result is the same on every platform and in every run of the
+ * program, so it is suitable for hashes that are persisted.
+ */
+inline std::uint64_t fnv1a_64(
+  const unsigned char* bytes,
+  const std::size_t size,
+  std::uint64_t hash = fnv1a_64_offset_basis)
+{
+  constexpr auto prime = std::uint64_t(1099511628211u);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    hash = (hash ^ bytes[i]) * prime;
+  }
+  return hash;
+}
+
+inline std::uint64_t fnv1a_64(
+  const std::string_view str, const std::uint64_t hash = fnv1a_64_offset_basis)
+{
+  return fnv1a_64(
+    reinterpret_cast<const unsigned char*>(str.data()), str.size(), hash);
+}
+
 } // namespace kdl
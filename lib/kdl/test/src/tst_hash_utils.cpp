@@ -35,4 +35,15 @@ TEST_CASE("hash")
   CHECK(hash("asdf"s, 12322, "hello"s) == (hash("asdf"s) ^ (hash(12322, "hello"s) << 1)));
 }
 
+TEST_CASE("fnv1a_64")
+{
+  // reference values of the 64 bit FNV-1a hash
+  CHECK(fnv1a_64("") == 0xcbf29ce484222325u);
+  CHECK(fnv1a_64("a") == 0xaf63dc4c8601ec8cu);
+  CHECK(fnv1a_64("foobar") == 0x85944171f73967e8u);
+
+  // hashing in parts yields the same result
+  CHECK(fnv1a_64("bar", fnv1a_64("foo")) == fnv1a_64("foobar"));
+}
+
 } // namespace kdl
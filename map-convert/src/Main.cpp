@@ -0,0 +1,237 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Logger.h"
+#include "io/BinaryMapFormat.h"
+#include "io/BinaryMapReader.h"
+#include "io/BinaryMapSerializer.h"
+#include "io/DiskIO.h"
+#include "io/File.h"
+#include "io/MapHeader.h"
+#include "io/NodeWriter.h"
+#include "io/SimpleParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/MapFormat.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/path_utils.h"
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include "vm/bbox.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+
+namespace tb::io
+{
+namespace
+{
+
+class StdErrLogger : public Logger
+{
+private:
+  void doLog(const LogLevel level, const std::string_view message) override
+  {
+    if (level != LogLevel::Debug)
+    {
+      std::cerr << message << "\n";
+    }
+  }
+};
+
+const auto WorldBounds = vm::bbox3d{32768.0};
+
+const auto AllFormats = std::vector<mdl::MapFormat>{
+  mdl::MapFormat::Standard,
+  mdl::MapFormat::Quake2,
+  mdl::MapFormat::Quake2_Valve,
+  mdl::MapFormat::Valve,
+  mdl::MapFormat::Hexen2,
+  mdl::MapFormat::Daikatana,
+  mdl::MapFormat::Quake3_Legacy,
+  mdl::MapFormat::Quake3_Valve,
+  mdl::MapFormat::Quake3,
+};
+
+bool isBinaryPath(const std::filesystem::path& path)
+{
+  return kdl::path_has_extension(kdl::path_to_lower(path), BinaryMapFormat::Extension);
+}
+
+struct LoadedMap
+{
+  std::optional<std::string> gameName;
+  std::unique_ptr<mdl::WorldNode> world;
+};
+
+Result<LoadedMap> loadMap(
+  const std::filesystem::path& path,
+  const mdl::MapFormat requestedFormat,
+  Logger& logger,
+  kdl::task_manager& taskManager)
+{
+  const auto entityPropertyConfig = mdl::EntityPropertyConfig{};
+  auto parserStatus = SimpleParserStatus{logger};
+
+  return Disk::openFile(path) | kdl::and_then([&](auto file) {
+           auto fileReader = file->reader().buffer();
+           const auto data = fileReader.stringView();
+
+           auto headerStream = std::istringstream{std::string{data.substr(0, 1024)}};
+           return readMapHeader(headerStream) | kdl::and_then([&](auto header) {
+                    auto [gameName, headerFormat] = std::move(header);
+                    const auto mapFormat = requestedFormat != mdl::MapFormat::Unknown
+                                             ? requestedFormat
+                                             : headerFormat;
+
+                    auto world =
+                      isBinaryMap(data)
+                        ? readBinaryMap(
+                            data,
+                            WorldBounds,
+                            entityPropertyConfig,
+                            parserStatus,
+                            taskManager)
+                        : WorldReader::tryRead(
+                            data,
+                            mapFormat != mdl::MapFormat::Unknown
+                              ? std::vector<mdl::MapFormat>{mapFormat}
+                              : AllFormats,
+                            WorldBounds,
+                            entityPropertyConfig,
+                            parserStatus,
+                            taskManager);
+
+                    return std::move(world) | kdl::transform([&](auto worldNode) {
+                             return LoadedMap{std::move(gameName), std::move(worldNode)};
+                           });
+                  });
+         });
+}
+
+Result<void> saveMap(
+  const std::filesystem::path& path,
+  const LoadedMap& map,
+  kdl::task_manager& taskManager)
+{
+  const auto& world = *map.world;
+  const auto gameName = map.gameName.value_or("");
+
+  if (isBinaryPath(path))
+  {
+    return Disk::withOutputStream(
+      path, std::ios::out | std::ios::binary, [&](auto& stream) {
+        writeMapHeader(stream, gameName, world.mapFormat());
+
+        auto writer = NodeWriter{
+          world, std::make_unique<BinaryMapSerializer>(stream, world.mapFormat())};
+        writer.setExporting(false);
+        writer.writeMap(taskManager);
+      });
+  }
+
+  return Disk::withOutputStream(path, [&](auto& stream) {
+    writeMapHeader(stream, gameName, world.mapFormat());
+
+    auto writer = NodeWriter{world, stream};
+    writer.setExporting(false);
+    writer.writeMap(taskManager);
+  });
+}
+
+template <typename Clock>
+auto elapsedMs(const typename Clock::time_point& startTime)
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startTime)
+    .count();
+}
+
+void printUsage()
+{
+  std::cerr << "Usage: map-convert [--format <format>] <input> <output>\n"
+            << "\n"
+            << "Converts between .map and " << BinaryMapFormat::Extension
+            << " files. The output format is chosen by the extension of the output "
+               "file.\n"
+            << "The map format of a .map input is taken from its header comments "
+               "unless --format is given.\n";
+}
+
+} // namespace
+} // namespace tb::io
+
+int main(int argc, char* argv[])
+{
+  using namespace tb;
+  using Clock = std::chrono::steady_clock;
+
+  auto requestedFormat = mdl::MapFormat::Unknown;
+  auto paths = std::vector<std::filesystem::path>{};
+  for (auto i = 1; i < argc; ++i)
+  {
+    const auto arg = std::string_view{argv[i]};
+    if (arg == "--format" && i + 1 < argc)
+    {
+      requestedFormat = mdl::formatFromName(argv[++i]);
+      if (requestedFormat == mdl::MapFormat::Unknown)
+      {
+        std::cerr << "Unknown map format: " << argv[i] << "\n";
+        return 1;
+      }
+    }
+    else
+    {
+      paths.emplace_back(arg);
+    }
+  }
+
+  if (paths.size() != 2)
+  {
+    io::printUsage();
+    return 1;
+  }
+
+  auto logger = io::StdErrLogger{};
+  auto taskManager = kdl::task_manager{};
+
+  const auto loadStartTime = Clock::now();
+  return io::loadMap(paths[0], requestedFormat, logger, taskManager)
+         | kdl::and_then([&](auto map) {
+             logger.info() << "Loaded " << paths[0] << " in "
+                           << io::elapsedMs<Clock>(loadStartTime) << "ms";
+
+             const auto saveStartTime = Clock::now();
+             return io::saveMap(paths[1], map, taskManager) | kdl::transform([&]() {
+                      logger.info() << "Saved " << paths[1] << " in "
+                                    << io::elapsedMs<Clock>(saveStartTime) << "ms";
+                    });
+           })
+         | kdl::transform([]() { return 0; })
+         | kdl::transform_error([&](const auto& e) {
+             logger.error() << e.msg;
+             return 1;
+           })
+         | kdl::value();
+}